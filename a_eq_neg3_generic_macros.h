@@ -34,7 +34,8 @@
 #undef JDBL
 
 #define JDBL(scratch, rx, ry, rz, curve, x, y, z) \
-  vec_jdbl_a_eq_neg3_generic(scratch,             \
-                             rx, ry, rz,          \
-                             curve,               \
-                             x, y, z)
+  (VEC_STATS_INC(curve, dbl),                     \
+   vec_jdbl_a_eq_neg3_generic(scratch,            \
+                              rx, ry, rz,         \
+                              curve,              \
+                              x, y, z))
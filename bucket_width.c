@@ -0,0 +1,106 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gmp.h>
+#include "vec.h"
+
+/*
+ * Amortized cost per base, counted in additions and doublings, of
+ * bucket multiplication with windows of the given width.
+ */
+static double
+bucket_cost(int scalars_bitlen, size_t len, int width)
+{
+  int windows = (scalars_bitlen + width - 1) / width;
+  double width_exp = (double)(1 << width);
+
+  /* Adding each base to a bucket for every non-zero digit, summing
+     the buckets of every window, and the doublings between
+     windows. */
+  return windows * ((1 - 1.0 / width_exp) + (2 * width_exp) / len)
+    + ((double)scalars_bitlen) / len;
+}
+
+/*
+ * Computes a "theoretical" optimal window width for bucket
+ * multiplication with the given number of bases and scalar length.
+ */
+int
+vec_bucket_width(int scalars_bitlen, size_t len) {
+
+  int width = 1;
+  double cost = bucket_cost(scalars_bitlen, len, width);
+  double new_cost;
+
+  /* The number of buckets grows exponentially, so we cap the width
+     in the same way as for fixed basis tables. */
+  while (width < 16)
+    {
+      new_cost = bucket_cost(scalars_bitlen, len, width + 1);
+      if (new_cost >= cost)
+        {
+          break;
+        }
+      cost = new_cost;
+      width++;
+    }
+
+  return width;
+}
+
+/*
+ * Returns non-zero if bucket multiplication is expected to be faster
+ * than simultaneous multiplication with block-wise tables.
+ */
+int
+vec_smul_use_bucket(int scalars_bitlen, size_t len) {
+
+  size_t batch_len = 100;
+  int width;
+  double width_exp;
+  double cost;
+
+  if (len < batch_len)
+    {
+      batch_len = len;
+    }
+  if (batch_len == 0 || scalars_bitlen == 0)
+    {
+      return 0;
+    }
+
+  /* This mirrors the cost model in vec_smul_block_width. */
+  width = vec_smul_block_width(scalars_bitlen, (int)batch_len);
+  width_exp = (double)(1 << width);
+
+  cost = ((double)scalars_bitlen) / batch_len
+    + width_exp / width
+    + (((double)scalars_bitlen) / width) * (1 - 1.0 / width_exp);
+
+  width = vec_bucket_width(scalars_bitlen, len);
+
+  return bucket_cost(scalars_bitlen, len, width) < cost;
+}
@@ -41,5 +41,12 @@ vec_curve_alloc()
   mpz_init(curve->gy);
   mpz_init(curve->n);
 
+  curve->mont = NULL;
+  curve->glv = NULL;
+  curve->sqrt_ctx = NULL;
+  curve->tuning = NULL;
+
+  vec_stats_reset(curve);
+
   return curve;
 }
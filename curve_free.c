@@ -39,5 +39,20 @@ vec_curve_free(vec_curve *curve)
   mpz_clear(curve->gy);
   mpz_clear(curve->n);
 
+  if (curve->mont != NULL)
+    {
+      vec_mont_ctx_free(curve->mont);
+    }
+
+  if (curve->glv != NULL)
+    {
+      vec_glv_ctx_free(curve->glv);
+    }
+
+  if (curve->sqrt_ctx != NULL)
+    {
+      vec_sqrt_ctx_free(curve->sqrt_ctx);
+    }
+
   free(curve);
 }
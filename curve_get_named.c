@@ -243,9 +243,13 @@ vec_curve_get_str(char *name,
                   char *n_str,
                   jdbl_func jdbl, jadd_func jadd, jmul_func jmul,
                   jsmul_func jsmul,
+                  jsmul_func jsmul_bucket,
                   jfmul_precomp_func jfmul_precomp,
                   jfmul_func jfmul,
-                  jfmul_free_func jfmul_free)
+                  jfmul_batch_func jfmul_batch,
+                  jfmul_free_func jfmul_free,
+                  jfmul_save_func jfmul_save,
+                  jfmul_load_func jfmul_load)
 {
   vec_curve *curve = vec_curve_alloc();
 
@@ -258,18 +262,44 @@ vec_curve_get_str(char *name,
   mpz_set_str(curve->gy, gy_str, 16);
   mpz_set_str(curve->n, n_str, 16);
 
+  curve->sqrt_ctx = vec_sqrt_ctx_alloc(curve->modulus);
+
   curve->jdbl = jdbl;
   curve->jadd = jadd;
   curve->jmul = jmul;
+  curve->jdmul = vec_jdmul_generic;
   curve->jsmul = jsmul;
+  curve->jsmul_bucket = jsmul_bucket;
 
   curve->jfmul_precomp = jfmul_precomp;
+  curve->jfmul_precomp_par = vec_jfmul_precomp_par_generic;
   curve->jfmul = jfmul;
+  curve->jfmul_batch = jfmul_batch;
+  curve->jfdmul = vec_jfdmul_generic;
   curve->jfmul_free = jfmul_free;
+  curve->jfmul_save = jfmul_save;
+  curve->jfmul_load = jfmul_load;
+  curve->jfcomb_precomp = vec_jfcomb_precomp_generic;
+  curve->jfcomb = vec_jfcomb_generic;
+  curve->jfcomb_free = vec_jfcomb_free_generic;
+  curve->jfsmul_precomp = vec_jfsmul_precomp_generic;
+  curve->jfsmul = vec_jfsmul_generic;
+  curve->jfsmul_free = vec_jfsmul_free_generic;
+  curve->jfsmul_save = vec_jfsmul_save_generic;
+  curve->jfsmul_load = vec_jfsmul_load_generic;
+  curve->jaff_batch = vec_jaff_batch_generic;
+  curve->fpowm = vec_fpowm_generic;
+  curve->jmul_aff = vec_jmul_aff_generic;
+  curve->jsmul_aff = vec_jsmul_aff_generic;
+  curve->jfmul_aff = vec_jfmul_aff_generic;
+  curve->jtune = vec_jtune_generic;
 
   curve->jdbl_timer = NULL;
   curve->jadd_timer = NULL;
 
+  curve->array_ops = &vec_point_array_ops_generic_inner;
+  curve->arithmetic = "mpz";
+
   return curve;
 }
 
@@ -307,6 +337,12 @@ vec_curve_a_eq_neg3(vec_curve *curve)
   return res;
 }
 
+int
+vec_curve_a_eq_0(vec_curve *curve)
+{
+  return mpz_sgn(curve->a) == 0;
+}
+
 
 vec_curve *
 vec_curve_get_named_len(char *name, int len, int implementation)
@@ -330,23 +366,77 @@ vec_curve_get_named_len(char *name, int len, int implementation)
                                     named_curves[i][6],
                                     vec_jdbl_generic,
                                     vec_jadd_generic,
-                                    vec_jmulsw_generic,
+                                    vec_jmulwnaf_generic,
                                     vec_jsmul_generic,
+                                    vec_jsmul_bucket_generic,
                                     vec_jfmul_precomp_generic,
                                     vec_jfmul_generic,
-                                    vec_jfmul_free_generic);
+                                    vec_jfmul_batch_generic,
+                                    vec_jfmul_free_generic,
+                                    vec_jfmul_save_generic,
+                                    vec_jfmul_load_generic);
 
           /* Use slightly faster GMP code when a = -3. */
           if (vec_curve_a_eq_neg3(curve))
             {
               curve->jadd = vec_jadd_a_eq_neg3_generic;
               curve->jdbl = vec_jdbl_a_eq_neg3_generic;
-              curve->jmul = vec_jmulsw_a_eq_neg3_generic;
+              curve->jmul = vec_jmulwnaf_a_eq_neg3_generic;
+              curve->jdmul = vec_jdmul_a_eq_neg3_generic;
               curve->jsmul = vec_jsmul_a_eq_neg3_generic;
+              curve->jsmul_bucket = vec_jsmul_bucket_a_eq_neg3_generic;
 
               curve->jfmul_precomp = vec_jfmul_precomp_a_eq_neg3_generic;
+              curve->jfmul_precomp_par =
+                vec_jfmul_precomp_par_a_eq_neg3_generic;
               curve->jfmul = vec_jfmul_a_eq_neg3_generic;
+              curve->jfmul_batch = vec_jfmul_batch_a_eq_neg3_generic;
+              curve->jfdmul = vec_jfdmul_a_eq_neg3_generic;
               curve->jfmul_free = vec_jfmul_free_a_eq_neg3_generic;
+              curve->jfmul_save = vec_jfmul_save_a_eq_neg3_generic;
+              curve->jfmul_load = vec_jfmul_load_a_eq_neg3_generic;
+              curve->jfcomb_precomp = vec_jfcomb_precomp_a_eq_neg3_generic;
+              curve->jfcomb = vec_jfcomb_a_eq_neg3_generic;
+              curve->jfcomb_free = vec_jfcomb_free_a_eq_neg3_generic;
+              curve->jfsmul_precomp = vec_jfsmul_precomp_a_eq_neg3_generic;
+              curve->jfsmul = vec_jfsmul_a_eq_neg3_generic;
+              curve->jfsmul_free = vec_jfsmul_free_a_eq_neg3_generic;
+              curve->jfsmul_save = vec_jfsmul_save_a_eq_neg3_generic;
+              curve->jfsmul_load = vec_jfsmul_load_a_eq_neg3_generic;
+              curve->jtune = vec_jtune_a_eq_neg3_generic;
+
+              curve->array_ops = &vec_point_array_ops_a_eq_neg3_generic_inner;
+            }
+
+          /* Avoid multiplying by a when doubling if a = 0. */
+          else if (vec_curve_a_eq_0(curve))
+            {
+              curve->jadd = vec_jadd_a_eq_0_generic;
+              curve->jdbl = vec_jdbl_a_eq_0_generic;
+              curve->jmul = vec_jmulwnaf_a_eq_0_generic;
+              curve->jdmul = vec_jdmul_a_eq_0_generic;
+              curve->jsmul = vec_jsmul_a_eq_0_generic;
+              curve->jsmul_bucket = vec_jsmul_bucket_a_eq_0_generic;
+
+              curve->jfmul_precomp = vec_jfmul_precomp_a_eq_0_generic;
+              curve->jfmul_precomp_par = vec_jfmul_precomp_par_a_eq_0_generic;
+              curve->jfmul = vec_jfmul_a_eq_0_generic;
+              curve->jfmul_batch = vec_jfmul_batch_a_eq_0_generic;
+              curve->jfdmul = vec_jfdmul_a_eq_0_generic;
+              curve->jfmul_free = vec_jfmul_free_a_eq_0_generic;
+              curve->jfmul_save = vec_jfmul_save_a_eq_0_generic;
+              curve->jfmul_load = vec_jfmul_load_a_eq_0_generic;
+              curve->jfcomb_precomp = vec_jfcomb_precomp_a_eq_0_generic;
+              curve->jfcomb = vec_jfcomb_a_eq_0_generic;
+              curve->jfcomb_free = vec_jfcomb_free_a_eq_0_generic;
+              curve->jfsmul_precomp = vec_jfsmul_precomp_a_eq_0_generic;
+              curve->jfsmul = vec_jfsmul_a_eq_0_generic;
+              curve->jfsmul_free = vec_jfsmul_free_a_eq_0_generic;
+              curve->jfsmul_save = vec_jfsmul_save_a_eq_0_generic;
+              curve->jfsmul_load = vec_jfsmul_load_a_eq_0_generic;
+              curve->jtune = vec_jtune_a_eq_0_generic;
+
+              curve->array_ops = &vec_point_array_ops_a_eq_0_generic_inner;
             }
 
           if (implementation > 0)
@@ -356,44 +446,207 @@ vec_curve_get_named_len(char *name, int len, int implementation)
                 {
                   curve->jdbl = vec_jdbl_nistp224;
                   curve->jadd = vec_jadd_nistp224;
-                  curve->jmul = vec_jmulsw_nistp224;
+                  curve->jmul = vec_jmulwnaf_nistp224;
+                  curve->jdmul = vec_jdmul_nistp224;
                   curve->jsmul = vec_jsmul_nistp224;
+                  curve->jsmul_bucket = vec_jsmul_bucket_nistp224;
 
                   curve->jfmul_precomp = vec_jfmul_precomp_nistp224;
+                  curve->jfmul_precomp_par = vec_jfmul_precomp_par_nistp224;
                   curve->jfmul = vec_jfmul_nistp224;
+                  curve->jfmul_batch = vec_jfmul_batch_nistp224;
+                  curve->jfdmul = vec_jfdmul_nistp224;
                   curve->jfmul_free = vec_jfmul_free_nistp224;
+                  curve->jfmul_save = vec_jfmul_save_nistp224;
+                  curve->jfmul_load = vec_jfmul_load_nistp224;
+                  curve->jfcomb_precomp = vec_jfcomb_precomp_nistp224;
+                  curve->jfcomb = vec_jfcomb_nistp224;
+                  curve->jfcomb_free = vec_jfcomb_free_nistp224;
+                  curve->jfsmul_precomp = vec_jfsmul_precomp_nistp224;
+                  curve->jfsmul = vec_jfsmul_nistp224;
+                  curve->jfsmul_free = vec_jfsmul_free_nistp224;
+                  curve->jfsmul_save = vec_jfsmul_save_nistp224;
+                  curve->jfsmul_load = vec_jfsmul_load_nistp224;
+                  curve->jaff_batch = vec_jaff_batch_nistp224;
+                  curve->fpowm = vec_fpowm_nistp224;
+                  curve->jmul_aff = vec_jmul_aff_nistp224;
+                  curve->jsmul_aff = vec_jsmul_aff_nistp224;
+                  curve->jfmul_aff = vec_jfmul_aff_nistp224;
+                  curve->jtune = vec_jtune_nistp224;
+
+                  curve->array_ops = &vec_point_array_ops_nistp224_inner;
+                  curve->arithmetic = vec_arithmetic_nistp224();
 
                   curve->jdbl_timer = time_jdbl_nistp224;
                   curve->jadd_timer = time_jadd_nistp224;
                 }
-              if (strncmp(name, "P-256", len) == 0)
+              else if (strncmp(name, "P-256", len) == 0)
                 {
                   curve->jdbl = vec_jdbl_nistp256;
                   curve->jadd = vec_jadd_nistp256;
-                  curve->jmul = vec_jmulsw_nistp256;
+                  curve->jmul = vec_jmulwnaf_nistp256;
+                  curve->jdmul = vec_jdmul_nistp256;
                   curve->jsmul = vec_jsmul_nistp256;
+                  curve->jsmul_bucket = vec_jsmul_bucket_nistp256;
 
                   curve->jfmul_precomp = vec_jfmul_precomp_nistp256;
+                  curve->jfmul_precomp_par = vec_jfmul_precomp_par_nistp256;
                   curve->jfmul = vec_jfmul_nistp256;
+                  curve->jfmul_batch = vec_jfmul_batch_nistp256;
+                  curve->jfdmul = vec_jfdmul_nistp256;
                   curve->jfmul_free = vec_jfmul_free_nistp256;
+                  curve->jfmul_save = vec_jfmul_save_nistp256;
+                  curve->jfmul_load = vec_jfmul_load_nistp256;
+                  curve->jfcomb_precomp = vec_jfcomb_precomp_nistp256;
+                  curve->jfcomb = vec_jfcomb_nistp256;
+                  curve->jfcomb_free = vec_jfcomb_free_nistp256;
+                  curve->jfsmul_precomp = vec_jfsmul_precomp_nistp256;
+                  curve->jfsmul = vec_jfsmul_nistp256;
+                  curve->jfsmul_free = vec_jfsmul_free_nistp256;
+                  curve->jfsmul_save = vec_jfsmul_save_nistp256;
+                  curve->jfsmul_load = vec_jfsmul_load_nistp256;
+                  curve->jaff_batch = vec_jaff_batch_nistp256;
+                  curve->fpowm = vec_fpowm_nistp256;
+                  curve->jmul_aff = vec_jmul_aff_nistp256;
+                  curve->jsmul_aff = vec_jsmul_aff_nistp256;
+                  curve->jfmul_aff = vec_jfmul_aff_nistp256;
+                  curve->jtune = vec_jtune_nistp256;
+
+                  curve->array_ops = &vec_point_array_ops_nistp256_inner;
+                  curve->arithmetic = vec_arithmetic_nistp256();
 
                   curve->jdbl_timer = time_jdbl_nistp256;
                   curve->jadd_timer = time_jadd_nistp256;
                 }
-              if (strncmp(name, "P-521", len) == 0)
+              else if (strncmp(name, "P-384", len) == 0)
+                {
+                  curve->jdbl = vec_jdbl_nistp384;
+                  curve->jadd = vec_jadd_nistp384;
+                  curve->jmul = vec_jmulwnaf_nistp384;
+                  curve->jdmul = vec_jdmul_nistp384;
+                  curve->jsmul = vec_jsmul_nistp384;
+                  curve->jsmul_bucket = vec_jsmul_bucket_nistp384;
+
+                  curve->jfmul_precomp = vec_jfmul_precomp_nistp384;
+                  curve->jfmul_precomp_par = vec_jfmul_precomp_par_nistp384;
+                  curve->jfmul = vec_jfmul_nistp384;
+                  curve->jfmul_batch = vec_jfmul_batch_nistp384;
+                  curve->jfdmul = vec_jfdmul_nistp384;
+                  curve->jfmul_free = vec_jfmul_free_nistp384;
+                  curve->jfmul_save = vec_jfmul_save_nistp384;
+                  curve->jfmul_load = vec_jfmul_load_nistp384;
+                  curve->jfcomb_precomp = vec_jfcomb_precomp_nistp384;
+                  curve->jfcomb = vec_jfcomb_nistp384;
+                  curve->jfcomb_free = vec_jfcomb_free_nistp384;
+                  curve->jfsmul_precomp = vec_jfsmul_precomp_nistp384;
+                  curve->jfsmul = vec_jfsmul_nistp384;
+                  curve->jfsmul_free = vec_jfsmul_free_nistp384;
+                  curve->jfsmul_save = vec_jfsmul_save_nistp384;
+                  curve->jfsmul_load = vec_jfsmul_load_nistp384;
+                  curve->jaff_batch = vec_jaff_batch_nistp384;
+                  curve->jmul_aff = vec_jmul_aff_nistp384;
+                  curve->jsmul_aff = vec_jsmul_aff_nistp384;
+                  curve->jfmul_aff = vec_jfmul_aff_nistp384;
+                  curve->jtune = vec_jtune_nistp384;
+
+                  curve->array_ops = &vec_point_array_ops_nistp384_inner;
+                  curve->arithmetic = vec_arithmetic_nistp384();
+
+                  curve->jdbl_timer = time_jdbl_nistp384;
+                  curve->jadd_timer = time_jadd_nistp384;
+                }
+
+              else if (strncmp(name, "P-521", len) == 0)
                 {
                   curve->jdbl = vec_jdbl_nistp521;
                   curve->jadd = vec_jadd_nistp521;
-                  curve->jmul = vec_jmulsw_nistp521;
+                  curve->jmul = vec_jmulwnaf_nistp521;
+                  curve->jdmul = vec_jdmul_nistp521;
                   curve->jsmul = vec_jsmul_nistp521;
+                  curve->jsmul_bucket = vec_jsmul_bucket_nistp521;
 
                   curve->jfmul_precomp = vec_jfmul_precomp_nistp521;
+                  curve->jfmul_precomp_par = vec_jfmul_precomp_par_nistp521;
                   curve->jfmul = vec_jfmul_nistp521;
+                  curve->jfmul_batch = vec_jfmul_batch_nistp521;
+                  curve->jfdmul = vec_jfdmul_nistp521;
                   curve->jfmul_free = vec_jfmul_free_nistp521;
+                  curve->jfmul_save = vec_jfmul_save_nistp521;
+                  curve->jfmul_load = vec_jfmul_load_nistp521;
+                  curve->jfcomb_precomp = vec_jfcomb_precomp_nistp521;
+                  curve->jfcomb = vec_jfcomb_nistp521;
+                  curve->jfcomb_free = vec_jfcomb_free_nistp521;
+                  curve->jfsmul_precomp = vec_jfsmul_precomp_nistp521;
+                  curve->jfsmul = vec_jfsmul_nistp521;
+                  curve->jfsmul_free = vec_jfsmul_free_nistp521;
+                  curve->jfsmul_save = vec_jfsmul_save_nistp521;
+                  curve->jfsmul_load = vec_jfsmul_load_nistp521;
+                  curve->jaff_batch = vec_jaff_batch_nistp521;
+                  curve->fpowm = vec_fpowm_nistp521;
+                  curve->jmul_aff = vec_jmul_aff_nistp521;
+                  curve->jsmul_aff = vec_jsmul_aff_nistp521;
+                  curve->jfmul_aff = vec_jfmul_aff_nistp521;
+                  curve->jtune = vec_jtune_nistp521;
+
+                  curve->array_ops = &vec_point_array_ops_nistp521_inner;
+                  curve->arithmetic = vec_arithmetic_nistp521();
 
                   curve->jdbl_timer = time_jdbl_nistp521;
                   curve->jadd_timer = time_jadd_nistp521;
                 }
+
+              /* Otherwise use Montgomery arithmetic if possible. */
+              else
+                {
+                  curve->mont = vec_mont_ctx_alloc(curve);
+
+                  if (curve->mont != NULL)
+                    {
+                      curve->jdbl = vec_jdbl_mont;
+                      curve->jadd = vec_jadd_mont;
+                      curve->jmul = vec_jmulwnaf_mont;
+                      curve->jdmul = vec_jdmul_mont;
+                      curve->jsmul = vec_jsmul_mont;
+                      curve->jsmul_bucket = vec_jsmul_bucket_mont;
+
+                      curve->jfmul_precomp = vec_jfmul_precomp_mont;
+                      curve->jfmul_precomp_par = vec_jfmul_precomp_par_mont;
+                      curve->jfmul = vec_jfmul_mont;
+                      curve->jfmul_batch = vec_jfmul_batch_mont;
+                      curve->jfdmul = vec_jfdmul_mont;
+                      curve->jfmul_free = vec_jfmul_free_mont;
+                      curve->jfmul_save = vec_jfmul_save_mont;
+                      curve->jfmul_load = vec_jfmul_load_mont;
+                      curve->jfcomb_precomp = vec_jfcomb_precomp_mont;
+                      curve->jfcomb = vec_jfcomb_mont;
+                      curve->jfcomb_free = vec_jfcomb_free_mont;
+                      curve->jfsmul_precomp = vec_jfsmul_precomp_mont;
+                      curve->jfsmul = vec_jfsmul_mont;
+                      curve->jfsmul_free = vec_jfsmul_free_mont;
+                      curve->jfsmul_save = vec_jfsmul_save_mont;
+                      curve->jfsmul_load = vec_jfsmul_load_mont;
+                      curve->jaff_batch = vec_jaff_batch_mont;
+                      curve->jmul_aff = vec_jmul_aff_mont;
+                      curve->jsmul_aff = vec_jsmul_aff_mont;
+                      curve->jfmul_aff = vec_jfmul_aff_mont;
+                      curve->jtune = vec_jtune_mont;
+
+                      curve->array_ops = &vec_point_array_ops_mont_inner;
+                      curve->arithmetic = "mpn";
+
+                      /* Halve the doublings using the GLV
+                         endomorphism if the curve has one. */
+                      curve->glv = vec_glv_ctx_alloc(curve);
+
+                      if (curve->glv != NULL)
+                        {
+                          curve->jmul = vec_jmul_glv_mont;
+                          curve->jsmul = vec_jsmul_glv_mont;
+                          curve->jmul_aff = vec_jmul_aff_glv_mont;
+                          curve->jsmul_aff = vec_jsmul_aff_glv_mont;
+                        }
+                    }
+                }
             }
 
           return curve;
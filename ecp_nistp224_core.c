@@ -397,8 +397,6 @@ static void felem_sum(felem out, const felem in)
     out[3] += in[3];
 }
 
-#if 0 /* VERIFICATUM_NISP224_OMITTED */
-
 /* Get negative value: out = -in */
 /* Assumes in[i] < 2^57 */
 static void felem_neg(felem out, const felem in)
@@ -415,8 +413,6 @@ static void felem_neg(felem out, const felem in)
     out[3] = two58m2 - in[3];
 }
 
-#endif /* VERIFICATUM_NISP224_OMITTED */
-
 /* Subtract field elements: out -= in */
 /* Assumes in[i] < 2^57 */
 static void felem_diff(felem out, const felem in)
@@ -615,8 +611,6 @@ static void felem_reduce(felem out, const widefelem in)
     out[3] = output[3];
 }
 
-#if 0 /* VERIFICATUM_NISP224_OMITTED */
-
 static void felem_square_reduce(felem out, const felem in)
 {
     widefelem tmp;
@@ -687,8 +681,6 @@ static void felem_contract(felem out, const felem in)
     out[3] = tmp[3];
 }
 
-#endif /* VERIFICATUM_NISP224_OMITTED */
-
 /*
  * Zero-check: returns 1 if input is 0, and 0 otherwise. We know that field
  * elements are reduced to in < 2^225, so we only need to check three cases:
@@ -927,9 +919,7 @@ point_double(felem x_out, felem y_out, felem z_out,
  */
 static void point_add(felem x3, felem y3, felem z3,
                       const felem x1, const felem y1, const felem z1,
-#if 0 /* VERIFICATUM_NISP224_OMITTED */
                       const int mixed,
-#endif /* VERIFICATUM_NISP224_OMITTED */
                       const felem x2, const felem y2,
                       const felem z2)
 {
@@ -937,10 +927,7 @@ static void point_add(felem x3, felem y3, felem z3,
     widefelem tmp, tmp2;
     limb z1_is_zero, z2_is_zero, x_equal, y_equal;
 
-    /* We have no use for this optimization */
-#if 0 /* VERIFICATUM_NISP224_OMITTED */
     if (!mixed) {
-#endif /* VERIFICATUM_NISP224_OMITTED */
         /* ftmp2 = z2^2 */
         felem_square(tmp, z2);
         felem_reduce(ftmp2, tmp);
@@ -956,7 +943,6 @@ static void point_add(felem x3, felem y3, felem z3,
         /* ftmp2 = z2^2*x1 */
         felem_mul(tmp2, ftmp2, x1);
         felem_reduce(ftmp2, tmp2);
-#if 0 /* VERIFICATUM_NISP224_OMITTED */
     } else {
         /*
          * We'll assume z2 = 1 (special case z2 = 0 is handled later)
@@ -968,7 +954,6 @@ static void point_add(felem x3, felem y3, felem z3,
         /* ftmp2 = z2^2*x1 */
         felem_assign(ftmp2, x1);
     }
-#endif /* VERIFICATUM_NISP224_OMITTED */
 
     /* ftmp = z1^2 */
     felem_square(tmp, z1);
@@ -1010,18 +995,14 @@ static void point_add(felem x3, felem y3, felem z3,
         return;
     }
 
-#if 0 /* VERIFICATUM_NISP224_OMITTED */
     /* ftmp5 = z1*z2 */
     if (!mixed) {
-#endif /* VERIFICATUM_NISP224_OMITTED */
         felem_mul(tmp, z1, z2);
         felem_reduce(ftmp5, tmp);
-#if 0 /* VERIFICATUM_NISP224_OMITTED */
     } else {
         /* special case z2 = 0 is handled later */
         felem_assign(ftmp5, z1);
     }
-#endif /* VERIFICATUM_NISP224_OMITTED */
 
 
     /* z_out = (z1^2*x2 - z2^2*x1)*(z1*z2) */
@@ -3,7 +3,10 @@
  * specific includes at the beginning has been removed, (2) Parts of
  * the code has been deactivated using #if 0....#endif. These are
  * marked with VERIFICATUM_NISTP256_OMITTED. (3) The end of the file
- * has been removed.
+ * has been removed. (4) Versions of smallfelem_square and
+ * smallfelem_mul using the MULX and ADX instructions have been
+ * added and replace the portable code if VEC_NISTP256_MULX is
+ * defined. These are marked with VERIFICATUM_NISTP256_MULX.
  */
 
 /*
@@ -267,8 +270,6 @@ static void longfelem_scalar(longfelem out, const u64 scalar)
 static const felem zero105 =
     { two105m41m9, two105, two105m41p9, two105m41p9 };
 
-#if 0 /* VERIFICATUM_NISTP256_OMITTED */
-
 /*-
  * smallfelem_neg sets |out| to |-small|
  * On exit:
@@ -283,8 +284,6 @@ static void smallfelem_neg(felem out, const smallfelem small)
     out[3] = zero105[3] - small[3];
 }
 
-#endif /* VERIFICATUM_NISTP256_OMITTED */
-
 /*-
  * felem_diff subtracts |in| from |out|
  * On entry:
@@ -495,6 +494,174 @@ static void smallfelem_expand(felem out, const smallfelem in)
     out[3] = in[3];
 }
 
+#ifdef VEC_NISTP256_MULX /* VERIFICATUM_NISTP256_MULX */
+
+/*-
+ * smallfelem_square_mulx is smallfelem_square using MULX and the two
+ * independent carry chains of ADCX and ADOX. The products of distinct
+ * limbs are computed first, doubled and added to the squares of the limbs
+ * in a single pass. The output limbs are fully carried.
+ * On entry:
+ *   small[i] < 2^64
+ * On exit:
+ *   out[i] < 2^64
+ */
+static void smallfelem_square_mulx(longfelem out, const smallfelem a)
+{
+    u64 r0, r1, r2, r3, r4, r5, r6, r7, t0, t1, z;
+    __asm__ (
+      "movq 0(%[a]), %%rdx\n\t"
+      "mulxq 8(%[a]), %[r1], %[r2]\n\t"
+      "mulxq 16(%[a]), %[t0], %[r3]\n\t"
+      "addq %[t0], %[r2]\n\t"
+      "mulxq 24(%[a]), %[t0], %[r4]\n\t"
+      "adcq %[t0], %[r3]\n\t"
+      "adcq $0, %[r4]\n\t"
+
+      "movq 8(%[a]), %%rdx\n\t"
+      "xorl %k[z], %k[z]\n\t"
+      "mulxq 16(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r3]\n\t"
+      "adoxq %[t1], %[r4]\n\t"
+      "mulxq 24(%[a]), %[t0], %[r5]\n\t"
+      "adcxq %[t0], %[r4]\n\t"
+      "adoxq %[z], %[r5]\n\t"
+      "adcxq %[z], %[r5]\n\t"
+
+      "movq 16(%[a]), %%rdx\n\t"
+      "mulxq 24(%[a]), %[t0], %[r6]\n\t"
+      "addq %[t0], %[r5]\n\t"
+      "adcq $0, %[r6]\n\t"
+
+      "movq 0(%[a]), %%rdx\n\t"
+      "xorl %k[z], %k[z]\n\t"
+      "mulxq %%rdx, %[r0], %[t1]\n\t"
+      "adcxq %[r1], %[r1]\n\t"
+      "adoxq %[t1], %[r1]\n\t"
+      "movq 8(%[a]), %%rdx\n\t"
+      "mulxq %%rdx, %[t0], %[t1]\n\t"
+      "adcxq %[r2], %[r2]\n\t"
+      "adoxq %[t0], %[r2]\n\t"
+      "adcxq %[r3], %[r3]\n\t"
+      "adoxq %[t1], %[r3]\n\t"
+      "movq 16(%[a]), %%rdx\n\t"
+      "mulxq %%rdx, %[t0], %[t1]\n\t"
+      "adcxq %[r4], %[r4]\n\t"
+      "adoxq %[t0], %[r4]\n\t"
+      "adcxq %[r5], %[r5]\n\t"
+      "adoxq %[t1], %[r5]\n\t"
+      "movq 24(%[a]), %%rdx\n\t"
+      "mulxq %%rdx, %[t0], %[r7]\n\t"
+      "adcxq %[r6], %[r6]\n\t"
+      "adoxq %[t0], %[r6]\n\t"
+      "adcxq %[z], %[r7]\n\t"
+      "adoxq %[z], %[r7]\n\t"
+      : [r0] "=&r" (r0), [r1] "=&r" (r1), [r2] "=&r" (r2), [r3] "=&r" (r3),
+        [r4] "=&r" (r4), [r5] "=&r" (r5), [r6] "=&r" (r6), [r7] "=&r" (r7),
+        [t0] "=&r" (t0), [t1] "=&r" (t1), [z] "=&r" (z)
+      : [a] "r" (a), "m" (*(const u64 (*)[4]) a)
+      : "rdx", "cc");
+    out[0] = r0;
+    out[1] = r1;
+    out[2] = r2;
+    out[3] = r3;
+    out[4] = r4;
+    out[5] = r5;
+    out[6] = r6;
+    out[7] = r7;
+}
+
+/*-
+ * smallfelem_mul_mulx is smallfelem_mul using MULX and the two
+ * independent carry chains of ADCX and ADOX, i.e., each row of the
+ * schoolbook multiplication adds the low halves of its products using
+ * the carry flag and the high halves using the overflow flag.
+ * On entry:
+ *   small1[i] < 2^64
+ *   small2[i] < 2^64
+ * On exit:
+ *   out[i] < 2^64
+ */
+static void smallfelem_mul_mulx(longfelem out, const smallfelem a,
+                                const smallfelem b)
+{
+    u64 r0, r1, r2, r3, r4, r5, r6, r7, t0, t1, z;
+    __asm__ (
+      "movq 0(%[b]), %%rdx\n\t"
+      "mulxq 0(%[a]), %[r0], %[r1]\n\t"
+      "mulxq 8(%[a]), %[t0], %[r2]\n\t"
+      "addq %[t0], %[r1]\n\t"
+      "mulxq 16(%[a]), %[t0], %[r3]\n\t"
+      "adcq %[t0], %[r2]\n\t"
+      "mulxq 24(%[a]), %[t0], %[r4]\n\t"
+      "adcq %[t0], %[r3]\n\t"
+      "adcq $0, %[r4]\n\t"
+
+      "movq 8(%[b]), %%rdx\n\t"
+      "xorl %k[z], %k[z]\n\t"
+      "mulxq 0(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r1]\n\t"
+      "adoxq %[t1], %[r2]\n\t"
+      "mulxq 8(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r2]\n\t"
+      "adoxq %[t1], %[r3]\n\t"
+      "mulxq 16(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r3]\n\t"
+      "adoxq %[t1], %[r4]\n\t"
+      "mulxq 24(%[a]), %[t0], %[r5]\n\t"
+      "adcxq %[t0], %[r4]\n\t"
+      "adoxq %[z], %[r5]\n\t"
+      "adcxq %[z], %[r5]\n\t"
+
+      "movq 16(%[b]), %%rdx\n\t"
+      "xorl %k[z], %k[z]\n\t"
+      "mulxq 0(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r2]\n\t"
+      "adoxq %[t1], %[r3]\n\t"
+      "mulxq 8(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r3]\n\t"
+      "adoxq %[t1], %[r4]\n\t"
+      "mulxq 16(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r4]\n\t"
+      "adoxq %[t1], %[r5]\n\t"
+      "mulxq 24(%[a]), %[t0], %[r6]\n\t"
+      "adcxq %[t0], %[r5]\n\t"
+      "adoxq %[z], %[r6]\n\t"
+      "adcxq %[z], %[r6]\n\t"
+
+      "movq 24(%[b]), %%rdx\n\t"
+      "xorl %k[z], %k[z]\n\t"
+      "mulxq 0(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r3]\n\t"
+      "adoxq %[t1], %[r4]\n\t"
+      "mulxq 8(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r4]\n\t"
+      "adoxq %[t1], %[r5]\n\t"
+      "mulxq 16(%[a]), %[t0], %[t1]\n\t"
+      "adcxq %[t0], %[r5]\n\t"
+      "adoxq %[t1], %[r6]\n\t"
+      "mulxq 24(%[a]), %[t0], %[r7]\n\t"
+      "adcxq %[t0], %[r6]\n\t"
+      "adoxq %[z], %[r7]\n\t"
+      "adcxq %[z], %[r7]\n\t"
+      : [r0] "=&r" (r0), [r1] "=&r" (r1), [r2] "=&r" (r2), [r3] "=&r" (r3),
+        [r4] "=&r" (r4), [r5] "=&r" (r5), [r6] "=&r" (r6), [r7] "=&r" (r7),
+        [t0] "=&r" (t0), [t1] "=&r" (t1), [z] "=&r" (z)
+      : [a] "r" (a), [b] "r" (b),
+        "m" (*(const u64 (*)[4]) a), "m" (*(const u64 (*)[4]) b)
+      : "rdx", "cc");
+    out[0] = r0;
+    out[1] = r1;
+    out[2] = r2;
+    out[3] = r3;
+    out[4] = r4;
+    out[5] = r5;
+    out[6] = r6;
+    out[7] = r7;
+}
+
+#endif /* VERIFICATUM_NISTP256_MULX */
+
 /*-
  * smallfelem_square sets |out| = |small|^2
  * On entry:
@@ -507,6 +674,11 @@ static void smallfelem_square(longfelem out, const smallfelem small)
     limb a;
     u64 high, low;
 
+#ifdef VEC_NISTP256_MULX /* VERIFICATUM_NISTP256_MULX */
+    smallfelem_square_mulx(out, small);
+    return;
+#endif
+
     a = ((uint128_t) small[0]) * small[0];
     low = a;
     high = a >> 64;
@@ -602,6 +774,11 @@ static void smallfelem_mul(longfelem out, const smallfelem small1,
     limb a;
     u64 high, low;
 
+#ifdef VEC_NISTP256_MULX /* VERIFICATUM_NISTP256_MULX */
+    smallfelem_mul_mulx(out, small1, small2);
+    return;
+#endif
+
     a = ((uint128_t) small1[0]) * small2[0];
     low = a;
     high = a >> 64;
@@ -937,6 +1114,8 @@ static void smallfelem_square_contract(smallfelem out, const smallfelem in)
     felem_contract(out, tmp);
 }
 
+#endif /* VERIFICATUM_NISTP256_OMITTED */
+
 static void smallfelem_mul_contract(smallfelem out, const smallfelem in1,
                                     const smallfelem in2)
 {
@@ -948,7 +1127,13 @@ static void smallfelem_mul_contract(smallfelem out, const smallfelem in1,
     felem_contract(out, tmp);
 }
 
-#endif /* VERIFICATUM_NISTP256_OMITTED */
+static void smallfelem_neg_contract(smallfelem out, const smallfelem small)
+{
+    felem tmp;
+
+    smallfelem_neg(tmp, small);
+    felem_contract(out, tmp);
+}
 
 /*-
  * felem_is_zero returns a limb with all bits set if |in| == 0 (mod p) and 0
@@ -1262,9 +1447,7 @@ static void copy_small_conditional(felem out, const smallfelem in, limb mask)
  */
 static void point_add(felem x3, felem y3, felem z3,
                       const felem x1, const felem y1, const felem z1,
-#if 0 /* VERIFICATUM_NISTP256_OMITTED */
                       const int mixed,
-#endif /* VERIFICATUM_NISTP256_OMITTED */
                       const smallfelem x2,
                       const smallfelem y2, const smallfelem z2)
 {
@@ -1284,9 +1467,7 @@ static void point_add(felem x3, felem y3, felem z3,
     /* ftmp[i] < 2^101 */
     felem_shrink(small1, ftmp);
 
-#if 0 /* VERIFICATUM_NISTP256_OMITTED */
     if (!mixed) {
-#endif /* VERIFICATUM_NISTP256_OMITTED */
 
         /* ftmp2 = z2z2 = z2**2 */
         smallfelem_square(tmp, z2);
@@ -1325,7 +1506,6 @@ static void point_add(felem x3, felem y3, felem z3,
         /* ftmp6[i] < 2^101 */
 
 
-#if 0 /* VERIFICATUM_NISTP256_OMITTED */
     } else {
         /*
          * We'll assume z2 = 1 (special case z2 = 0 is handled later)
@@ -1344,7 +1524,6 @@ static void point_add(felem x3, felem y3, felem z3,
         felem_assign(ftmp6, y1);
         /* ftmp6[i] < 2^106 */
     }
-#endif /* VERIFICATUM_NISTP256_OMITTED */
 
     /* u2 = x2*z1z1 */
     smallfelem_mul(tmp, x2, small1);
@@ -1445,10 +1624,7 @@ static void point_add_small(smallfelem x3, smallfelem y3, smallfelem z3,
     smallfelem_expand(felem_y1, y1);
     smallfelem_expand(felem_z1, z1);
     point_add(felem_x3, felem_y3, felem_z3, felem_x1, felem_y1, felem_z1,
-#if 0 /* VERIFICATUM_NISTP256_OMITTED */
-              0,
-#endif /* VERIFICATUM_NISTP256_OMITTED */
-              x2, y2, z2);
+              0, x2, y2, z2);
     felem_shrink(x3, felem_x3);
     felem_shrink(y3, felem_y3);
     felem_shrink(z3, felem_z3);
@@ -43,6 +43,20 @@ static void felem_one(felem f)
 
 #endif /* VERIFICATUM */
 
+static void felem_mul_reduce(felem out, const felem in1, const felem in2)
+{
+  longfelem tmp;
+  felem_mul(tmp, in1, in2);
+  felem_reduce(out, tmp);
+}
+
+static void felem_square_reduce(felem out, const felem in)
+{
+  longfelem tmp;
+  felem_square(tmp, in);
+  felem_reduce(out, tmp);
+}
+
 static void mpz_t_to_felem(felem rop, const mpz_t op)
 {
   memset(rop, 0, sizeof(felem));
@@ -0,0 +1,519 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * A 64-bit implementation of the NIST P-384 elliptic curve point
+ * multiplication, written for VEC in the style of the OpenSSL cores
+ * for P-224, P-256, and P-521 used by the other optimized backends.
+ *
+ * Field elements are represented with eight signed 48-bit limbs, so
+ * that a felem holds exactly 384 bits and the special form of the
+ * prime,
+ *
+ *   p = 2^384 - 2^128 - 2^96 + 2^32 - 1,
+ *
+ * gives the folding rule 2^384 = 2^128 + 2^96 - 2^32 + 1 mod p, i.e.,
+ * a carry out of the top limb is added back into limbs 0 and 2 with
+ * only a shift by 32 bits.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 1))
+  /* even with gcc, the typedef won't work for 32-bit platforms */
+typedef __int128_t int128_t;  /* nonstandard; implemented by gcc on 64-bit
+                               * platforms */
+#else
+#error "Need GCC 3.1 or later to define type int128_t"
+#endif
+
+/*
+ * The underlying field. P384 operates over GF(p) with p as above. A
+ * field element is a sum of eight limbs in radix 2^48. Limbs are
+ * signed to make subtraction trivial. A reduced felem has limbs of
+ * absolute value less than 2^49. The arithmetic below accepts limbs of
+ * absolute value less than 2^52 as input to multiplication, so a few
+ * additions and subtractions may be applied between reductions.
+ */
+
+#define NLIMBS 8
+
+typedef int64_t limb;
+typedef int128_t widelimb;
+typedef limb felem[NLIMBS];
+typedef widelimb widefelem[2 * NLIMBS - 1];
+
+static const limb bottom48bits = 0xffffffffffff;
+static const limb two32 = 0x100000000;
+
+/* The prime p in radix 2^48. */
+static const felem kPrime = {
+  0x0000ffffffff, 0x000000000000, 0xfffeffffffff, 0xffffffffffff,
+  0xffffffffffff, 0xffffffffffff, 0xffffffffffff, 0xffffffffffff
+};
+
+static void
+felem_assign(felem out, const felem in)
+{
+  memcpy(out, in, sizeof(felem));
+}
+
+/* out = a + b */
+static void
+felem_add(felem out, const felem a, const felem b)
+{
+  int i;
+
+  for (i = 0; i < NLIMBS; i++)
+    {
+      out[i] = a[i] + b[i];
+    }
+}
+
+/* out = a - b */
+static void
+felem_sub(felem out, const felem a, const felem b)
+{
+  int i;
+
+  for (i = 0; i < NLIMBS; i++)
+    {
+      out[i] = a[i] - b[i];
+    }
+}
+
+/* out = -a */
+static void
+felem_neg(felem out, const felem a)
+{
+  int i;
+
+  for (i = 0; i < NLIMBS; i++)
+    {
+      out[i] = -a[i];
+    }
+}
+
+/* out = k * a for a small constant k. */
+static void
+felem_scalar(felem out, const felem a, limb k)
+{
+  int i;
+
+  for (i = 0; i < NLIMBS; i++)
+    {
+      out[i] = a[i] * k;
+    }
+}
+
+/*
+ * Reduces a felem with limbs of absolute value less than 2^62 to one
+ * with limbs of absolute value less than 2^49. Two rounds of carrying
+ * suffice: the carry out of the first round is at most 2^15, and the
+ * carry out of the second round is at most one in absolute value.
+ */
+static void
+felem_reduce_small(felem out, const felem in)
+{
+  limb c;
+  int i;
+  int j;
+
+  felem_assign(out, in);
+
+  for (j = 0; j < 2; j++)
+    {
+      c = 0;
+      for (i = 0; i < NLIMBS; i++)
+        {
+          out[i] += c;
+          c = out[i] >> 48;
+          out[i] &= bottom48bits;
+        }
+      out[0] += c - c * two32;
+      out[2] += c + c * two32;
+    }
+}
+
+/*
+ * Reduces a product with limbs of absolute value less than 2^108 to a
+ * felem with limbs of absolute value less than 2^49.
+ *
+ * The product is first carried into sixteen 48-bit limbs. Then each
+ * of the top eight limbs is folded into the limbs eight and six
+ * positions below it, from the top down, so every limb is folded at
+ * most once. Finally the result is carried twice as in
+ * felem_reduce_small, which folds the remaining carry out of the top
+ * limb.
+ */
+static void
+felem_reduce(felem out, const widefelem in)
+{
+  widelimb t[2 * NLIMBS];
+  widelimb c;
+  int i;
+  int j;
+
+  for (i = 0; i < 2 * NLIMBS - 1; i++)
+    {
+      t[i] = in[i];
+    }
+  t[2 * NLIMBS - 1] = 0;
+
+  for (i = 0; i < 2 * NLIMBS - 1; i++)
+    {
+      c = t[i] >> 48;
+      t[i] &= bottom48bits;
+      t[i + 1] += c;
+    }
+
+  for (i = 2 * NLIMBS - 1; i >= NLIMBS; i--)
+    {
+      c = t[i];
+      t[i - NLIMBS] += c - c * two32;
+      t[i - NLIMBS + 2] += c + c * two32;
+    }
+
+  for (j = 0; j < 2; j++)
+    {
+      c = 0;
+      for (i = 0; i < NLIMBS; i++)
+        {
+          t[i] += c;
+          c = t[i] >> 48;
+          t[i] &= bottom48bits;
+        }
+      t[0] += c - c * two32;
+      t[2] += c + c * two32;
+    }
+
+  for (i = 0; i < NLIMBS; i++)
+    {
+      out[i] = (limb)t[i];
+    }
+}
+
+/* out = a * b */
+static void
+felem_mul(felem out, const felem a, const felem b)
+{
+  widefelem t;
+  int i;
+  int j;
+
+  memset(t, 0, sizeof(widefelem));
+  for (i = 0; i < NLIMBS; i++)
+    {
+      for (j = 0; j < NLIMBS; j++)
+        {
+          t[i + j] += ((widelimb)a[i]) * b[j];
+        }
+    }
+  felem_reduce(out, t);
+}
+
+/* out = a^2 */
+static void
+felem_square(felem out, const felem a)
+{
+  widefelem t;
+  limb a2;
+  int i;
+  int j;
+
+  memset(t, 0, sizeof(widefelem));
+  for (i = 0; i < NLIMBS; i++)
+    {
+      t[2 * i] += ((widelimb)a[i]) * a[i];
+      a2 = 2 * a[i];
+      for (j = i + 1; j < NLIMBS; j++)
+        {
+          t[i + j] += ((widelimb)a2) * a[j];
+        }
+    }
+  felem_reduce(out, t);
+}
+
+/*
+ * Converts a reduced felem to its unique representative in [0, p)
+ * with limbs in [0, 2^48).
+ */
+static void
+felem_contract(felem out, const felem in)
+{
+  limb c;
+  int i;
+
+  felem_assign(out, in);
+
+  /* Carry until no carry leaves the top limb, at which point the
+     value lies in [0, 2^384). */
+  do
+    {
+      c = 0;
+      for (i = 0; i < NLIMBS; i++)
+        {
+          out[i] += c;
+          c = out[i] >> 48;
+          out[i] &= bottom48bits;
+        }
+      out[0] += c - c * two32;
+      out[2] += c + c * two32;
+    }
+  while (c != 0);
+
+  /* Since 2^384 < 2p, at most one subtraction of p is needed. */
+  for (i = NLIMBS - 1; i >= 0 && out[i] == kPrime[i]; i--);
+
+  if (i < 0 || out[i] > kPrime[i])
+    {
+      c = 0;
+      for (i = 0; i < NLIMBS; i++)
+        {
+          out[i] += c - kPrime[i];
+          c = out[i] >> 48;
+          out[i] &= bottom48bits;
+        }
+    }
+}
+
+static int
+felem_is_zero(const felem in)
+{
+  felem t;
+  limb z;
+  int i;
+
+  felem_contract(t, in);
+
+  z = 0;
+  for (i = 0; i < NLIMBS; i++)
+    {
+      z |= t[i];
+    }
+  return z == 0;
+}
+
+/*
+ * Group operations.
+ *
+ * Points are represented in Jacobian projective coordinates and the
+ * point at infinity is represented by Z = 0, or by all coordinates
+ * being zero as produced by point_unit. All routines may be called
+ * with outputs that alias their inputs.
+ */
+
+static void
+point_unit(felem x3, felem y3, felem z3)
+{
+  memset(x3, 0, sizeof(felem));
+  memset(y3, 0, sizeof(felem));
+  memset(z3, 0, sizeof(felem));
+}
+
+/*
+ * Doubling of a point, using that a = -3 for P-384, i.e.,
+ * M = 3*(X1-Z1^2)*(X1+Z1^2).
+ */
+static void
+point_double(felem x3, felem y3, felem z3,
+             const felem x1, const felem y1, const felem z1)
+{
+  felem S;
+  felem M;
+  felem T;
+  felem t1;
+  felem t2;
+  felem t3;
+
+  /* (X1, Y1, Z1) is point at infinity or point which is its own
+     inverse. */
+  if (felem_is_zero(z1) || felem_is_zero(y1))
+    {
+      point_unit(x3, y3, z3);
+      return;
+    }
+
+  /* S = 4*X1*Y1^2 */
+  felem_square(t1, y1);
+  felem_mul(S, t1, x1);
+  felem_scalar(S, S, 4);
+  felem_reduce_small(S, S);
+
+  /* M = 3*(X1-Z1^2)*(X1+Z1^2) */
+  felem_square(t2, z1);
+  felem_sub(t3, x1, t2);
+  felem_add(t2, x1, t2);
+  felem_mul(M, t3, t2);
+  felem_scalar(M, M, 3);
+  felem_reduce_small(M, M);
+
+  /* T = M^2-2*S */
+  felem_square(T, M);
+  felem_sub(T, T, S);
+  felem_sub(T, T, S);
+  felem_reduce_small(T, T);
+
+  /* Z3 = 2*Y1*Z1, computed before Y1 may be overwritten. */
+  felem_mul(t2, y1, z1);
+  felem_add(t2, t2, t2);
+  felem_reduce_small(z3, t2);
+
+  /* Y3 = M*(S-T)-8*Y1^4, where t1 = Y1^2 */
+  felem_square(t1, t1);
+  felem_scalar(t1, t1, 8);
+
+  felem_sub(S, S, T);
+  felem_mul(S, S, M);
+  felem_sub(S, S, t1);
+  felem_reduce_small(y3, S);
+
+  /* X3 = T */
+  felem_assign(x3, T);
+}
+
+/* 1998 Cohen/Miyaji/Ono Jacobi coordinates, i.e., the same formulas
+   as in jadd_generic_inner.c. If mixed is non-zero, then Z2 must be
+   one or zero, which saves the powers of Z2. */
+static void
+point_add(felem x3, felem y3, felem z3,
+          const felem x1, const felem y1, const felem z1,
+          const int mixed,
+          const felem x2, const felem y2, const felem z2)
+{
+  felem U1;
+  felem S1;
+  felem S2;
+  felem H;
+  felem r;
+  felem t1;
+  felem t2;
+  felem t3;
+
+  /* P1 is point at infinity. */
+  if (felem_is_zero(z1))
+    {
+
+      /* P2 is also point at infinity. */
+      if (felem_is_zero(z2))
+        {
+          point_unit(x3, y3, z3);
+        }
+
+      /* P1 is point at infinity and P2 is not. */
+      else
+        {
+          felem_assign(x3, x2);
+          felem_assign(y3, y2);
+          felem_assign(z3, z2);
+        }
+      return;
+    }
+
+  /* P2 is point at infinity and P1 is not. */
+  else if (felem_is_zero(z2))
+    {
+      felem_assign(x3, x1);
+      felem_assign(y3, y1);
+      felem_assign(z3, z1);
+      return;
+    }
+
+  /* Compute powers of Z1. */
+  felem_square(t2, z1);         /* t2 = Z1^2 */
+  felem_mul(t3, t2, z1);        /* t3 = Z1^3 */
+
+  if (!mixed)
+    {
+
+      /* Compute powers of Z2. */
+      felem_square(t1, z2);     /* t1 = Z2^2 */
+      felem_mul(S2, t1, z2);    /* S2 = Z2^3 */
+
+      /* U1:=X1*Z2^2 */
+      felem_mul(U1, x1, t1);
+
+      /* S1:=Y1*Z2^3 */
+      felem_mul(S1, y1, S2);
+    }
+  else
+    {
+      felem_assign(U1, x1);
+      felem_assign(S1, y1);
+    }
+
+  /* H:=U2-U1, where U2:=X2*Z1^2 */
+  felem_mul(H, x2, t2);
+  felem_sub(H, H, U1);
+
+  /* r:=S2-S1, where S2:=Y2*Z1^3 */
+  felem_mul(r, y2, t3);
+  felem_sub(r, r, S1);
+
+  if (felem_is_zero(H))
+    {
+      if (!felem_is_zero(r))
+        {
+          point_unit(x3, y3, z3);
+        }
+      else
+        {
+          point_double(x3, y3, z3, x1, y1, z1);
+        }
+      return;
+    }
+
+  /* Z3:=Z1*Z2*H, computed before Z1 may be overwritten. */
+  if (!mixed)
+    {
+      felem_mul(t1, z1, z2);
+      felem_mul(z3, t1, H);
+    }
+  else
+    {
+      felem_mul(z3, z1, H);
+    }
+
+  /* Compute powers of H. */
+  felem_square(t2, H);          /* t2 = H^2 */
+  felem_mul(t3, t2, H);         /* t3 = H^3 */
+
+  /* X3:=-H^3-2*U1*H^2+r^2 */
+  felem_mul(U1, U1, t2);        /* U1 = U1*H^2 */
+  felem_square(t1, r);
+  felem_sub(t1, t1, t3);
+  felem_sub(t1, t1, U1);
+  felem_sub(t1, t1, U1);
+  felem_reduce_small(x3, t1);
+
+  /* Y3:=-S1*H^3+r*(U1*H^2-X3) */
+  felem_sub(t1, U1, x3);
+  felem_mul(t1, r, t1);
+  felem_mul(t2, S1, t3);
+  felem_sub(t1, t1, t2);
+  felem_reduce_small(y3, t1);
+}
@@ -300,8 +300,6 @@ static void felem_scalar128(largefelem out, limb scalar)
     out[8] *= scalar;
 }
 
-#if 0 /* VERIFICATUM_NISTP521_OMITTED */
-
 /*-
  * felem_neg sets |out| to |-in|
  * On entry:
@@ -326,8 +324,6 @@ static void felem_neg(felem out, const felem in)
     out[8] = two62m2 - in[8];
 }
 
-#endif /* VERIFICATUM_NISTP521_OMITTED */
-
 /*-
  * felem_diff64 subtracts |in| from |out|
  * On entry:
@@ -689,8 +685,6 @@ static void felem_reduce(felem out, const largefelem in)
      */
 }
 
-#if 0 /* VERIFICATUM_NISTP521_OMITTED */
-
 static void felem_square_reduce(felem out, const felem in)
 {
     largefelem tmp;
@@ -705,6 +699,8 @@ static void felem_mul_reduce(felem out, const felem in1, const felem in2)
     felem_reduce(out, tmp);
 }
 
+#if 0 /* VERIFICATUM_NISTP521_OMITTED */
+
 /*-
  * felem_inv calculates |out| = |in|^{-1}
  *
@@ -1176,9 +1172,7 @@ static void copy_conditional(felem out, const felem in, limb mask)
  * ECDH or ECDSA signing. */
 static void point_add(felem x3, felem y3, felem z3,
                       const felem x1, const felem y1, const felem z1,
-#if 0 /* VERIFICATUM_NISTP521_OMITTED */
                       const int mixed,
-#endif /* VERIFICATUM_NISTP521_OMITTED */
                       const felem x2, const felem y2,
                       const felem z2)
 {
@@ -1193,9 +1187,7 @@ static void point_add(felem x3, felem y3, felem z3,
     felem_square(tmp, z1);
     felem_reduce(ftmp, tmp);
 
-#if 0 /* VERIFICATUM_NISTP521_OMITTED */
     if (!mixed) {
-#endif /* VERIFICATUM_NISTP521_OMITTED */
 
         /* ftmp2 = z2z2 = z2**2 */
         felem_square(tmp, z2);
@@ -1227,7 +1219,6 @@ static void point_add(felem x3, felem y3, felem z3,
         felem_mul(tmp, y1, ftmp2);
         felem_reduce(ftmp6, tmp);
 
-#if 0 /* VERIFICATUM_NISTP521_OMITTED */
     } else {
         /*
          * We'll assume z2 = 1 (special case z2 = 0 is handled later)
@@ -1242,7 +1233,6 @@ static void point_add(felem x3, felem y3, felem z3,
         /* s1 = ftmp6 = y1 * z2**3 */
         felem_assign(ftmp6, y1);
     }
-#endif /* VERIFICATUM_NISTP521_OMITTED */
 
     /* u2 = x2*z1z1 */
     felem_mul(tmp, x2, ftmp);
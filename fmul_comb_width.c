@@ -0,0 +1,81 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <gmp.h>
+#include "vec.h"
+
+/*
+ * Computes a "theoretical" optimal width and number of tables of a
+ * comb for a given scalar length, given that the tables may use at
+ * most max_bytes bytes. A table of width w holds 2^(w - 1) entries,
+ * each of entry_bytes bytes. The smallest comb is returned if no
+ * comb fits within the bound.
+ */
+void
+vec_fmul_comb_width(int *width, int *tabs,
+                    int bit_length, int len,
+                    size_t entry_bytes, size_t max_bytes) {
+
+  int w;
+  int t;
+  int teeth;
+  int cols;
+  double cost;
+  double min_cost;
+  double entries;
+
+  *width = 2;
+  *tabs = 1;
+  min_cost = -1.0;
+
+  for (w = 2; w <= VEC_COMB_MAX_WIDTH; w++) {
+
+    for (t = 1; t * w <= bit_length || t == 1; t++) {
+
+      entries = (double)t * (1 << (w - 1));
+
+      /* The bound only grows with the number of tables. */
+      if (entries * entry_bytes > (double)max_bytes) {
+        break;
+      }
+
+      teeth = w * t;
+      cols = (bit_length + teeth - 1) / teeth;
+
+      /* Doublings and additions, and amortized cost for tables,
+         i.e., one addition per entry and doublings of the bases. */
+      cost = (cols - 1) + ((double)cols) * t
+        + (entries + ((double)teeth) * cols) / len;
+
+      if (min_cost < 0 || cost < min_cost) {
+        min_cost = cost;
+        *width = w;
+        *tabs = t;
+      }
+    }
+  }
+}
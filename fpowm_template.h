@@ -0,0 +1,121 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef FPOWM_ELEMENT
+
+#include <stdlib.h>
+#include "templates.h"
+
+/*
+ * Exponentiation of field elements in the native representation of
+ * the curve. The exponent is the same for all elements, e.g., the
+ * exponent used to compute square roots, so it is split into windows
+ * of fixed width once and the same sequence of squarings and
+ * multiplications is applied to every element. The macros FPOWM_*
+ * give the representation, which need not be initialized, and its
+ * arithmetic.
+ */
+
+#ifndef VEC_FPOWM_WIDTH
+#define VEC_FPOWM_WIDTH 4
+#endif
+
+void
+FUNCTION_NAME(vec_fpowm, POSTFIX)(mpz_t *rops,
+                                  mpz_t *bases,
+                                  mpz_t exponent,
+                                  size_t len,
+                                  CURVE *curve)
+{
+  size_t i;
+  size_t j;
+  size_t k;
+  size_t windows;
+  unsigned char *digits;
+  FPOWM_ELEMENT tab[1 << VEC_FPOWM_WIDTH];
+  FPOWM_ELEMENT acc;
+
+  VEC_UNUSED(curve);
+
+  if (mpz_sgn(exponent) == 0)
+    {
+      for (i = 0; i < len; i++)
+        {
+          mpz_set_ui(rops[i], 1);
+        }
+      return;
+    }
+
+  /* Digits of the exponent, least significant first. The most
+     significant digit is never zero. */
+  windows = (mpz_sizeinbase(exponent, 2) + VEC_FPOWM_WIDTH - 1)
+    / VEC_FPOWM_WIDTH;
+  digits = (unsigned char *)malloc(windows);
+  VEC_STATS_ALLOC(curve, 1, windows);
+
+  for (j = 0; j < windows; j++)
+    {
+      digits[j] = 0;
+      for (k = 0; k < VEC_FPOWM_WIDTH; k++)
+        {
+          digits[j] |= mpz_tstbit(exponent, j * VEC_FPOWM_WIDTH + k) << k;
+        }
+    }
+
+  for (i = 0; i < len; i++)
+    {
+
+      /* The first entry is one, since multiplying by one is the only
+         assignment available in the native representation. */
+      mpz_set_ui(rops[i], 1);
+      FPOWM_FROM_MPZ(tab[0], rops[i], curve);
+      FPOWM_FROM_MPZ(tab[1], bases[i], curve);
+      for (k = 2; k < (1 << VEC_FPOWM_WIDTH); k++)
+        {
+          FPOWM_MUL(tab[k], tab[k - 1], tab[1], curve);
+        }
+
+      FPOWM_MUL(acc, tab[digits[windows - 1]], tab[0], curve);
+
+      for (j = windows - 1; j-- > 0;)
+        {
+          for (k = 0; k < VEC_FPOWM_WIDTH; k++)
+            {
+              FPOWM_SQR(acc, acc, curve);
+            }
+          if (digits[j] != 0)
+            {
+              FPOWM_MUL(acc, acc, tab[digits[j]], curve);
+            }
+        }
+
+      FPOWM_TO_MPZ(rops[i], acc, curve);
+    }
+
+  free(digits);
+}
+
+#endif
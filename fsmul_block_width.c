@@ -0,0 +1,72 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <gmp.h>
+#include "vec.h"
+
+/*
+ * Computes a "theoretical" optimal block width of a table for
+ * simultaneous multiplication of a fixed list of bases_len bases,
+ * given that the table may use at most max_bytes bytes. A block of
+ * width w holds 2^w entries, each of entry_bytes bytes. The width one
+ * is returned if no table fits within the bound.
+ */
+int
+vec_fsmul_block_width(int bit_length, size_t bases_len, size_t len,
+                      size_t entry_bytes, size_t max_bytes) {
+
+  int w;
+  int width;
+  double tabs;
+  double cost;
+  double min_cost;
+
+  width = 1;
+  min_cost = -1.0;
+
+  for (w = 1; w <= VEC_TRANSPOSE_MAX_WIDTH && (size_t)w <= bases_len; w++) {
+
+    tabs = (double)((bases_len + w - 1) / w);
+
+    if (tabs * (1 << w) * entry_bytes > (double)max_bytes) {
+      continue;
+    }
+
+    /* Additions, and amortized cost for the tables, i.e., one
+       addition per entry. The doublings do not depend on the
+       width. */
+    cost = tabs * bit_length + tabs * (1 << w) / len;
+
+    if (min_cost < 0 || cost < min_cost) {
+      min_cost = cost;
+      width = w;
+    }
+  }
+
+  return width;
+}
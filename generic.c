@@ -31,12 +31,30 @@
 #include <gmp.h>
 #include "vec.h"
 
+/* Mixed addition used with tables in affine coordinates. */
+void
+vec_jadd_mixed_generic_inner(vec_scratch_mpz_t scratch,
+                             mpz_t X3, mpz_t Y3, mpz_t Z3,
+                             vec_curve *curve,
+                             mpz_t X1, mpz_t Y1, mpz_t Z1,
+                             mpz_t X2, mpz_t Y2, mpz_t Z2);
+
 #include "generic_macros.h"
 
 #include "jmul_template.h"
 #include "jmulsw_template.h"
+#include "jmulwnaf_template.h"
+#include "jaff_batch_template.h"
+#include "jsmul_bucket_template.h"
 #include "jsmul_template.h"
 #include "jfmul_template.h"
+#include "jsmul_file_template.h"
+#include "jfmul_file_template.h"
+#include "jdmul_template.h"
+#include "jfcomb_template.h"
+#include "jfsmul_template.h"
+#include "jtune_template.h"
+#include "point_array_template.h"
 
 void
 vec_jdbl_generic_inner(vec_scratch_mpz_t scratch,
@@ -71,6 +89,42 @@ vec_jmulsw_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
   vec_jmulsw_generic_inner(RX, RY, RZ, curve, X, Y, Z, scalar);
 }
 
+void
+vec_jmulwnaf_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                     vec_curve *curve,
+                     mpz_t X, mpz_t Y, mpz_t Z,
+                     mpz_t scalar)
+{
+  vec_jmulwnaf_generic_inner(RX, RY, RZ, curve, X, Y, Z, scalar);
+}
+
+void
+vec_jdmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                  vec_curve *curve,
+                  mpz_t X1, mpz_t Y1, mpz_t Z1,
+                  mpz_t scalar1,
+                  mpz_t X2, mpz_t Y2, mpz_t Z2,
+                  mpz_t scalar2)
+{
+  vec_jdmul_generic_inner(RX, RY, RZ,
+                          curve,
+                          X1, Y1, Z1, scalar1,
+                          X2, Y2, Z2, scalar2);
+}
+
+void
+vec_jfdmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   vec_jfmul_tab_ptr ptr,
+                   mpz_t scalar1,
+                   mpz_t X2, mpz_t Y2, mpz_t Z2,
+                   mpz_t scalar2)
+{
+  vec_jfdmul_generic_inner(RX, RY, RZ,
+                           curve, ptr.generic, scalar1,
+                           X2, Y2, Z2, scalar2);
+}
+
 void
 vec_jsmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
                   vec_curve *curve,
@@ -81,10 +135,21 @@ vec_jsmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
   vec_jsmul_generic_inner(RX, RY, RZ, curve, X, Y, Z, scalars, len);
 }
 
+void
+vec_jsmul_bucket_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                         vec_curve *curve,
+                         mpz_t *X, mpz_t *Y, mpz_t *Z,
+                         mpz_t *scalars,
+                         size_t len)
+{
+  vec_jsmul_bucket_generic_inner(RX, RY, RZ, curve, X, Y, Z, scalars, len);
+}
+
 vec_jfmul_tab_ptr
-vec_jfmul_precomp_generic(vec_curve *curve,
-                          mpz_t X, mpz_t Y, mpz_t Z,
-                          size_t len)
+vec_jfmul_precomp_par_generic(vec_curve *curve,
+                              mpz_t X, mpz_t Y, mpz_t Z,
+                              size_t len,
+                              size_t threads)
 {
   vec_jfmul_tab_ptr ptr;
 
@@ -93,11 +158,19 @@ vec_jfmul_precomp_generic(vec_curve *curve,
     malloc(sizeof(vec_jfmul_tab_generic_inner));
 
   vec_jfmul_init_generic_inner(ptr.generic, curve, len);
-  vec_jfmul_prcmp_generic_inner(curve, ptr.generic, X, Y, Z);
+  vec_jfmul_prcmp_par_generic_inner(curve, ptr.generic, X, Y, Z, threads);
 
   return ptr;
 }
 
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_generic(vec_curve *curve,
+                          mpz_t X, mpz_t Y, mpz_t Z,
+                          size_t len)
+{
+  return vec_jfmul_precomp_par_generic(curve, X, Y, Z, len, 1);
+}
+
 void
 vec_jfmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
                   vec_curve *curve,
@@ -107,12 +180,224 @@ vec_jfmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
   vec_jfmul_cmp_generic_inner(RX, RY, RZ, curve, ptr.generic, scalar);
 }
 
+void
+vec_jfmul_batch_generic(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                        vec_curve *curve,
+                        vec_jfmul_tab_ptr ptr,
+                        mpz_t *scalars,
+                        size_t len)
+{
+  vec_jfmul_cmp_batch_generic_inner(RX, RY, RZ,
+                                    curve, ptr.generic,
+                                    scalars,
+                                    len);
+}
+
+int
+vec_jfmul_save_generic(vec_curve *curve,
+                       vec_jfmul_tab_ptr ptr,
+                       const char *path)
+{
+  return vec_jfmul_save_generic_inner(curve, ptr.generic, path);
+}
+
+int
+vec_jfmul_load_generic(vec_jfmul_tab_ptr *ptr,
+                       vec_curve *curve,
+                       const char *path)
+{
+  vec_jfmul_tab_generic_inner *table;
+
+  table = vec_jfmul_load_generic_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->generic = table;
+  return 0;
+}
+
 void
 vec_jfmul_free_generic(vec_jfmul_tab_ptr ptr)
 {
   vec_jfmul_clear_free_generic_inner(ptr.generic);
 }
 
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_generic(vec_curve *curve,
+                           mpz_t X, mpz_t Y, mpz_t Z,
+                           size_t len,
+                           size_t max_bytes)
+{
+  vec_jfcomb_tab_ptr ptr;
+
+  ptr.generic =
+    (vec_jfcomb_tab_generic_inner*)
+    malloc(sizeof(vec_jfcomb_tab_generic_inner));
+
+  vec_jfcomb_init_generic_inner(ptr.generic, curve, len, max_bytes);
+  vec_jfcomb_prcmp_generic_inner(curve, ptr.generic, X, Y, Z);
+
+  return ptr;
+}
+
+void
+vec_jfcomb_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   vec_jfcomb_tab_ptr ptr,
+                   mpz_t scalar)
+{
+  vec_jfcomb_cmp_generic_inner(RX, RY, RZ, curve, ptr.generic, scalar);
+}
+
+void
+vec_jfcomb_free_generic(vec_jfcomb_tab_ptr ptr)
+{
+  vec_jfcomb_clear_free_generic_inner(ptr.generic);
+}
+
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_generic(vec_curve *curve,
+                           mpz_t *X, mpz_t *Y, mpz_t *Z,
+                           size_t bases_len,
+                           size_t len,
+                           size_t max_bytes)
+{
+  vec_jfsmul_tab_ptr ptr;
+
+  ptr.generic =
+    (vec_jfsmul_tab_generic_inner*)
+    malloc(sizeof(vec_jfsmul_tab_generic_inner));
+
+  vec_jfsmul_init_generic_inner(ptr.generic, curve, bases_len, len, max_bytes);
+  vec_jfsmul_prcmp_generic_inner(curve, ptr.generic, X, Y, Z);
+
+  return ptr;
+}
+
+void
+vec_jfsmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   vec_jfsmul_tab_ptr ptr,
+                   mpz_t *scalars)
+{
+  vec_jfsmul_cmp_generic_inner(RX, RY, RZ, curve, ptr.generic, scalars);
+}
+
+int
+vec_jfsmul_save_generic(vec_curve *curve,
+                        vec_jfsmul_tab_ptr ptr,
+                        const char *path)
+{
+  return vec_jfsmul_save_generic_inner(curve, ptr.generic, path);
+}
+
+int
+vec_jfsmul_load_generic(vec_jfsmul_tab_ptr *ptr,
+                        vec_curve *curve,
+                        const char *path)
+{
+  vec_jfsmul_tab_generic_inner *table;
+
+  table = vec_jfsmul_load_generic_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->generic = table;
+  return 0;
+}
+
+void
+vec_jfsmul_free_generic(vec_jfsmul_tab_ptr ptr)
+{
+  vec_jfsmul_clear_free_generic_inner(ptr.generic);
+}
+
+void
+vec_jtune_generic(vec_tuning_costs *costs,
+                  vec_curve *curve,
+                  long millisecs)
+{
+  vec_jtune_generic_inner(costs, curve, millisecs);
+}
+
+void
+vec_jaff_batch_generic(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       size_t len,
+                       vec_curve *curve)
+{
+  vec_jaff_batch_generic_inner(X, Y, Z, len, curve);
+}
+
+/* GMP uses Montgomery arithmetic with windows for exponentiation,
+   which is faster than exponentiation built from multiplications
+   followed by divisions. */
+void
+vec_fpowm_generic(mpz_t *rops,
+                  mpz_t *bases,
+                  mpz_t exponent,
+                  size_t len,
+                  vec_curve *curve)
+{
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    {
+      mpz_powm(rops[i], bases[i], exponent, curve->modulus);
+    }
+}
+
+/* The generic implementations compute with mpz_t, so there is
+   nothing to gain from converting in the native representation. */
+void
+vec_jmul_aff_generic(mpz_t rx, mpz_t ry,
+                     vec_curve *curve,
+                     mpz_t X, mpz_t Y, mpz_t Z,
+                     mpz_t scalar)
+{
+  mpz_t RZ;
+
+  mpz_init(RZ);
+
+  curve->jmul(rx, ry, RZ, curve, X, Y, Z, scalar);
+  vec_jaff(rx, ry, RZ, curve);
+
+  mpz_clear(RZ);
+}
+
+void
+vec_jsmul_aff_generic(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t *X, mpz_t *Y, mpz_t *Z,
+                      mpz_t *scalars,
+                      size_t len)
+{
+  mpz_t RZ;
+
+  mpz_init(RZ);
+
+  curve->jsmul(rx, ry, RZ, curve, X, Y, Z, scalars, len);
+  vec_jaff(rx, ry, RZ, curve);
+
+  mpz_clear(RZ);
+}
+
+void
+vec_jfmul_aff_generic(mpz_t rx, mpz_t ry,
+                      vec_curve *curve, vec_jfmul_tab_ptr ptr,
+                      mpz_t scalar)
+{
+  mpz_t RZ;
+
+  mpz_init(RZ);
+
+  curve->jfmul(rx, ry, RZ, curve, ptr, scalar);
+  vec_jaff(rx, ry, RZ, curve);
+
+  mpz_clear(RZ);
+}
+
 void
 vec_jdbl_generic(vec_scratch_mpz_t scratch,
                  mpz_t X3, mpz_t Y3, mpz_t Z3,
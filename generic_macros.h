@@ -55,11 +55,35 @@
   mpz_set(ry, y);                                  \
   mpz_set(rz, z)
 
+#define FIELD_ELEMENT_VAR_IMPORT(x, y, z, X, Y, Z, curve) \
+  mpz_set(x, X);                                        \
+  mpz_set(y, Y);                                        \
+  mpz_set(z, Z)
+#define FIELD_ELEMENT_VAR_EXPORT(X, Y, Z, x, y, z, curve) \
+  mpz_set(X, x);                                        \
+  mpz_set(Y, y);                                        \
+  mpz_set(Z, z)
+
+#define FIELD_ELEMENT_VAR_FROM_MPZ(x, X, curve) mpz_set(x, X)
+#define FIELD_ELEMENT_VAR_TO_MPZ(X, x, curve) mpz_set(X, x)
+#define FIELD_ELEMENT_VAR_MUL(r, x, y, curve) \
+  mpz_mul(r, x, y);                            \
+  mpz_mod(r, r, curve->modulus)
+#define FIELD_ELEMENT_VAR_IS_ZERO(x, curve) (mpz_sgn(x) == 0)
+#define FIELD_ELEMENT_VAR_NEG(r, x, curve) \
+  mpz_neg(r, x);                             \
+  mpz_mod(r, r, curve->modulus)
+
 #define FIELD_ELEMENT_CONTRACT(rx, ry, rz, x, y, z) \
   mpz_set(rx, x);                                   \
   mpz_set(ry, y);                                   \
   mpz_set(rz, z)                                    \
 
+#define FIELD_ELEMENT_VAR_BYTES(curve) \
+  (mpz_size(curve->modulus) * sizeof(mp_limb_t))
+#define FIELD_ELEMENT_VAR_WRITE(dst, x, curve) \
+  vec_limbs_write(dst, mpz_size(curve->modulus), x, curve->modulus)
+
 #define SCRATCH_INIT(scratch) vec_scratch_init_mpz_t(scratch)
 #define SCRATCH_CLEAR(scratch) vec_scratch_clear_mpz_t(scratch)
 
@@ -67,30 +91,46 @@
 
 #define ARRAY_CLEAR_FREE(array, len) vec_array_clear_free(array, len)
 
+#define ARRAY_MAP(src, len, curve) \
+  vec_array_map(src, len, mpz_size(curve->modulus))
+#define ARRAY_UNMAP(array) free(array)
+
 #define JDBL(scratch, rx, ry, rz, curve, x, y, z) \
-  curve->jdbl(scratch,                            \
-              rx, ry, rz,                         \
-              curve,                              \
-              x, y, z)
+  (VEC_STATS_INC(curve, dbl),                     \
+   curve->jdbl(scratch,                           \
+               rx, ry, rz,                        \
+               curve,                             \
+               x, y, z))
 
-#define JDBL_VAR(scratch, rx, ry, rz, curve, x, y, z)  \
-  curve->jdbl(scratch,                                 \
-              rx, ry, rz,                              \
-              curve,                                   \
-              x, y, z)
+#define JDBL_VAR(scratch, rx, ry, rz, curve, x, y, z) \
+  (VEC_STATS_INC(curve, dbl),                         \
+   curve->jdbl(scratch,                               \
+               rx, ry, rz,                            \
+               curve,                                 \
+               x, y, z))
 
 #define JADD(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
-  curve->jadd(scratch,                                           \
-              rx, ry, rz,                                        \
-              curve,                                             \
-              x1, y1, z1,                                        \
-              x2, y2, z2)
-
-#define JADD_VAR(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2)  \
-  curve->jadd(scratch,                                                \
-              rx, ry, rz,                                             \
-              curve,                                                  \
-              x1, y1, z1,                                             \
-              x2, y2, z2)
+  (VEC_STATS_INC(curve, add),                                    \
+   curve->jadd(scratch,                                          \
+               rx, ry, rz,                                       \
+               curve,                                            \
+               x1, y1, z1,                                       \
+               x2, y2, z2))
+
+#define JADD_VAR(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, add),                                        \
+   curve->jadd(scratch,                                              \
+               rx, ry, rz,                                           \
+               curve,                                                \
+               x1, y1, z1,                                           \
+               x2, y2, z2))
+
+#define JADD_MIXED(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, madd),                                         \
+   vec_jadd_mixed_generic_inner(scratch,                               \
+                                rx, ry, rz,                            \
+                                curve,                                 \
+                                x1, y1, z1,                            \
+                                x2, y2, z2))
 
 #define CURVE vec_curve
@@ -0,0 +1,192 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <gmp.h>
+
+#include "vec.h"
+
+/*
+ * Sets rop to a primitive cube root of unity modulo the prime
+ * modulus, or returns zero if the modulus is not one modulo three.
+ */
+static int
+glv_cube_root(mpz_t rop, mpz_t modulus)
+{
+  mpz_t e;
+  unsigned long g;
+
+  if (mpz_fdiv_ui(modulus, 3) != 1)
+    {
+      return 0;
+    }
+
+  mpz_init(e);
+  mpz_sub_ui(e, modulus, 1);
+  mpz_divexact_ui(e, e, 3);
+
+  /* Half of all elements give a primitive root, so this terminates
+     quickly. */
+  g = 2;
+  do
+    {
+      mpz_set_ui(rop, g);
+      mpz_powm(rop, rop, e, modulus);
+      g++;
+    }
+  while (mpz_cmp_ui(rop, 1) == 0);
+
+  mpz_clear(e);
+
+  return 1;
+}
+
+vec_glv_ctx *
+vec_glv_ctx_alloc(vec_curve *curve)
+{
+  vec_glv_ctx *ctx;
+  int found;
+  mpz_t X;
+  mpz_t Y;
+  mpz_t Z;
+  mpz_t r0;
+  mpz_t r1;
+  mpz_t t0;
+  mpz_t t1;
+  mpz_t q;
+  mpz_t sqrt_n;
+
+  /* The endomorphism (x, y) -> (beta * x, y) only exists for a = 0. */
+  if (mpz_sgn(curve->a) != 0)
+    {
+      return NULL;
+    }
+
+  ctx = (vec_glv_ctx *)malloc(sizeof(vec_glv_ctx));
+
+  mpz_init(ctx->beta);
+  mpz_init(ctx->lambda);
+  mpz_init(ctx->a1);
+  mpz_init(ctx->b1);
+  mpz_init(ctx->a2);
+  mpz_init(ctx->b2);
+
+  if (!glv_cube_root(ctx->beta, curve->modulus)
+      || !glv_cube_root(ctx->lambda, curve->n))
+    {
+      vec_glv_ctx_free(ctx);
+      return NULL;
+    }
+
+  mpz_init(X);
+  mpz_init(Y);
+  mpz_init(Z);
+
+  /* The endomorphism is multiplication by either lambda or
+     lambda^2. We pick the matching beta by applying it to the
+     generator. */
+  mpz_set_ui(Z, 1);
+  curve->jmul(X, Y, Z, curve, curve->gx, curve->gy, Z, ctx->lambda);
+  vec_jaff(X, Y, Z, curve);
+
+  mpz_mul(Z, ctx->beta, curve->gx);
+  mpz_mod(Z, Z, curve->modulus);
+  if (mpz_cmp(X, Z) != 0)
+    {
+      mpz_mul(ctx->beta, ctx->beta, ctx->beta);
+      mpz_mod(ctx->beta, ctx->beta, curve->modulus);
+
+      mpz_mul(Z, ctx->beta, curve->gx);
+      mpz_mod(Z, Z, curve->modulus);
+    }
+  found = mpz_cmp(X, Z) == 0;
+
+  mpz_clear(Z);
+  mpz_clear(Y);
+  mpz_clear(X);
+
+  if (!found)
+    {
+      vec_glv_ctx_free(ctx);
+      return NULL;
+    }
+
+  /* Short basis of the lattice {(i, j) : i + j * lambda = 0 mod n}
+     using the extended Euclidean algorithm as in Gallant, Lambert,
+     and Vanstone. Every remainder r satisfies r = t * lambda mod n
+     for the corresponding t, so (r, -t) is in the lattice. */
+  mpz_init_set(r0, curve->n);
+  mpz_init_set(r1, ctx->lambda);
+  mpz_init_set_ui(t0, 0);
+  mpz_init_set_ui(t1, 1);
+  mpz_init(q);
+  mpz_init(sqrt_n);
+
+  mpz_sqrt(sqrt_n, curve->n);
+
+  while (mpz_cmp(r1, sqrt_n) >= 0)
+    {
+      mpz_fdiv_q(q, r0, r1);
+
+      mpz_submul(r0, q, r1);
+      mpz_swap(r0, r1);
+
+      mpz_submul(t0, q, t1);
+      mpz_swap(t0, t1);
+    }
+
+  /* First vector is the first remainder smaller than sqrt(n). */
+  mpz_set(ctx->a1, r1);
+  mpz_neg(ctx->b1, t1);
+
+  /* Second vector is the shorter of its two neighbours. */
+  mpz_set(ctx->a2, r0);
+  mpz_neg(ctx->b2, t0);
+
+  mpz_fdiv_q(q, r0, r1);
+  mpz_submul(r0, q, r1);
+  mpz_submul(t0, q, t1);
+
+  mpz_mul(q, ctx->a2, ctx->a2);
+  mpz_addmul(q, ctx->b2, ctx->b2);
+  mpz_mul(sqrt_n, r0, r0);
+  mpz_addmul(sqrt_n, t0, t0);
+
+  if (mpz_cmp(sqrt_n, q) < 0)
+    {
+      mpz_set(ctx->a2, r0);
+      mpz_neg(ctx->b2, t0);
+    }
+
+  mpz_clear(sqrt_n);
+  mpz_clear(q);
+  mpz_clear(t1);
+  mpz_clear(t0);
+  mpz_clear(r1);
+  mpz_clear(r0);
+
+  return ctx;
+}
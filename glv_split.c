@@ -0,0 +1,84 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gmp.h>
+
+#include "vec.h"
+
+/*
+ * Sets rop to op / n rounded to the nearest integer.
+ */
+static void
+glv_round_div(mpz_t rop, mpz_t op, mpz_t n)
+{
+  mpz_t d;
+
+  mpz_init(d);
+  mpz_mul_2exp(d, n, 1);
+
+  mpz_mul_2exp(rop, op, 1);
+  mpz_add(rop, rop, n);
+  mpz_fdiv_q(rop, rop, d);
+
+  mpz_clear(d);
+}
+
+void
+vec_glv_split(mpz_t k1, mpz_t k2, vec_curve *curve, mpz_t scalar)
+{
+  vec_glv_ctx *ctx = curve->glv;
+  mpz_t k;
+  mpz_t c1;
+  mpz_t c2;
+
+  mpz_init(k);
+  mpz_init(c1);
+  mpz_init(c2);
+
+  mpz_mod(k, scalar, curve->n);
+
+  /* c1 = round(b2 * k / n) and c2 = round(-b1 * k / n). */
+  mpz_mul(c1, ctx->b2, k);
+  glv_round_div(c1, c1, curve->n);
+
+  mpz_mul(c2, ctx->b1, k);
+  mpz_neg(c2, c2);
+  glv_round_div(c2, c2, curve->n);
+
+  /* k1 = k - c1 * a1 - c2 * a2 */
+  mpz_set(k1, k);
+  mpz_submul(k1, c1, ctx->a1);
+  mpz_submul(k1, c2, ctx->a2);
+
+  /* k2 = -c1 * b1 - c2 * b2 */
+  mpz_mul(k2, c1, ctx->b1);
+  mpz_addmul(k2, c2, ctx->b2);
+  mpz_neg(k2, k2);
+
+  mpz_clear(c2);
+  mpz_clear(c1);
+  mpz_clear(k);
+}
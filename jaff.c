@@ -26,6 +26,7 @@
 
 #include <gmp.h>
 #include "vec.h"
+#include "stats.h"
 
 void
 vec_jaff(mpz_t X, mpz_t Y, mpz_t Z, vec_curve *curve) {
@@ -43,6 +44,7 @@ vec_jaff(mpz_t X, mpz_t Y, mpz_t Z, vec_curve *curve) {
       mpz_init(ZZ);
 
       mpz_invert(Z, Z, curve->modulus);
+      VEC_STATS_INC(curve, inversions);
 
       mpz_mul(ZZ, Z, Z);
       mpz_mod(ZZ, ZZ, curve->modulus);
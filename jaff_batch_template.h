@@ -0,0 +1,263 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef FIELD_ELEMENT
+
+#include <stdlib.h>
+#include "templates.h"
+
+/*
+ * Conversion of many points from Jacobi to affine coordinates using
+ * Montgomery's simultaneous inversion, i.e., a single inversion and
+ * 3(n - 1) multiplications to invert n z-coordinates. The
+ * multiplications are computed in the native representation. The
+ * single inversion is computed using mpz_invert, since it does not
+ * matter for the running time.
+ */
+
+/* Maps (x, y, z) to (x * zi^2, y * zi^3, one), where zi is the
+   inverse of z. */
+static void
+FUNCTION_NAME(jaff_batch_point, POSTFIX)(FIELD_ELEMENT_VAR x,
+                                         FIELD_ELEMENT_VAR y,
+                                         FIELD_ELEMENT_VAR z,
+                                         CURVE *curve,
+                                         FIELD_ELEMENT_VAR zi,
+                                         FIELD_ELEMENT_VAR one)
+{
+  FIELD_ELEMENT_VAR t;
+
+  VEC_UNUSED(curve);
+
+  FIELD_ELEMENT_VAR_INIT(t);
+
+  FIELD_ELEMENT_VAR_MUL(t, zi, zi, curve);
+  FIELD_ELEMENT_VAR_MUL(x, x, t, curve);
+  FIELD_ELEMENT_VAR_MUL(t, t, zi, curve);
+  FIELD_ELEMENT_VAR_MUL(y, y, t, curve);
+
+  /* Multiplying by one is the only assignment available for
+     individual coordinates in the native representation. */
+  FIELD_ELEMENT_VAR_MUL(z, one, one, curve);
+
+  FIELD_ELEMENT_VAR_CLEAR(t);
+}
+
+/* Writes the affine coordinates of the point to X and Y, or (-1, -1)
+   if it is the point at infinity, without exporting the point in
+   Jacobi coordinates first. This lets multiplications return affine
+   results directly. The point is overwritten. */
+void
+FUNCTION_NAME(vec_jaff_point, POSTFIX)(mpz_t X, mpz_t Y,
+                                       FIELD_ELEMENT_VAR x,
+                                       FIELD_ELEMENT_VAR y,
+                                       FIELD_ELEMENT_VAR z,
+                                       CURVE *curve)
+{
+  FIELD_ELEMENT_VAR zi;
+  FIELD_ELEMENT_VAR t;
+
+  if (FIELD_ELEMENT_VAR_IS_ZERO(z, curve))
+    {
+      mpz_set_si(X, -1);
+      mpz_set_si(Y, -1);
+      return;
+    }
+
+  FIELD_ELEMENT_VAR_INIT(zi);
+  FIELD_ELEMENT_VAR_INIT(t);
+
+  /* The inversion is computed using mpz_invert, since it is several
+     times faster than exponentiation in the native representation. */
+  FIELD_ELEMENT_VAR_TO_MPZ(X, z, curve);
+  mpz_invert(X, X, curve->modulus);
+  VEC_STATS_INC(curve, inversions);
+  FIELD_ELEMENT_VAR_FROM_MPZ(zi, X, curve);
+
+  FIELD_ELEMENT_VAR_MUL(t, zi, zi, curve);
+  FIELD_ELEMENT_VAR_MUL(x, x, t, curve);
+  FIELD_ELEMENT_VAR_MUL(t, t, zi, curve);
+  FIELD_ELEMENT_VAR_MUL(y, y, t, curve);
+
+  FIELD_ELEMENT_VAR_TO_MPZ(X, x, curve);
+  FIELD_ELEMENT_VAR_TO_MPZ(Y, y, curve);
+
+  FIELD_ELEMENT_VAR_CLEAR(t);
+  FIELD_ELEMENT_VAR_CLEAR(zi);
+}
+
+/* Same as vec_jaff_batch_var, except that the caller provides room
+   for len products and indices, and a temporary integer, which lets
+   tables kept in a workspace be converted without allocating. */
+void
+FUNCTION_NAME(vec_jaff_batch_buf, POSTFIX)(FIELD_ELEMENT_VAR *x,
+                                           FIELD_ELEMENT_VAR *y,
+                                           FIELD_ELEMENT_VAR *z,
+                                           size_t len,
+                                           CURVE *curve,
+                                           FIELD_ELEMENT_VAR *acc,
+                                           size_t *index,
+                                           mpz_t tmp)
+{
+  size_t i;
+  size_t j;
+  size_t m;
+
+  FIELD_ELEMENT_VAR inv;
+  FIELD_ELEMENT_VAR zi;
+  FIELD_ELEMENT_VAR one;
+
+  FIELD_ELEMENT_VAR_INIT(inv);
+  FIELD_ELEMENT_VAR_INIT(zi);
+  FIELD_ELEMENT_VAR_INIT(one);
+  mpz_set_ui(tmp, 1);
+
+  FIELD_ELEMENT_VAR_FROM_MPZ(one, tmp, curve);
+
+  /* Accumulate the products of the z-coordinates. Points at infinity
+     have no inverse and are left untouched. */
+  m = 0;
+  for (i = 0; i < len; i++)
+    {
+      if (!FIELD_ELEMENT_VAR_IS_ZERO(z[i], curve))
+        {
+          if (m == 0)
+            {
+              FIELD_ELEMENT_VAR_MUL(acc[0], z[i], one, curve);
+            }
+          else
+            {
+              FIELD_ELEMENT_VAR_MUL(acc[m], acc[m - 1], z[i], curve);
+            }
+          index[m] = i;
+          m++;
+        }
+    }
+
+  if (m > 0)
+    {
+
+      /* Invert the product of all z-coordinates. */
+      FIELD_ELEMENT_VAR_TO_MPZ(tmp, acc[m - 1], curve);
+      mpz_invert(tmp, tmp, curve->modulus);
+      VEC_STATS_INC(curve, inversions);
+      FIELD_ELEMENT_VAR_FROM_MPZ(inv, tmp, curve);
+
+      /* Peel off one inverse at a time, i.e., inv is the inverse of
+         the product of the first j + 1 z-coordinates at the start of
+         each step. */
+      for (j = m - 1; j > 0; j--)
+        {
+          i = index[j];
+
+          FIELD_ELEMENT_VAR_MUL(zi, inv, acc[j - 1], curve);
+          FIELD_ELEMENT_VAR_MUL(inv, inv, z[i], curve);
+
+          FUNCTION_NAME(jaff_batch_point, POSTFIX)(x[i], y[i], z[i],
+                                                   curve,
+                                                   zi, one);
+        }
+
+      i = index[0];
+      FUNCTION_NAME(jaff_batch_point, POSTFIX)(x[i], y[i], z[i],
+                                               curve,
+                                               inv, one);
+    }
+
+  FIELD_ELEMENT_VAR_CLEAR(one);
+  FIELD_ELEMENT_VAR_CLEAR(zi);
+  FIELD_ELEMENT_VAR_CLEAR(inv);
+}
+
+void
+FUNCTION_NAME(vec_jaff_batch_var, POSTFIX)(FIELD_ELEMENT_VAR *x,
+                                           FIELD_ELEMENT_VAR *y,
+                                           FIELD_ELEMENT_VAR *z,
+                                           size_t len,
+                                           CURVE *curve)
+{
+  size_t *index;
+  FIELD_ELEMENT_VAR *acc;
+  mpz_t tmp;
+
+  index = (size_t *)malloc(len * sizeof(size_t));
+  acc = ARRAY_MALLOC_INIT(len);
+  VEC_STATS_ALLOC(curve, 2,
+                  len * (sizeof(size_t) + sizeof(FIELD_ELEMENT_VAR)));
+  mpz_init(tmp);
+
+  FUNCTION_NAME(vec_jaff_batch_buf, POSTFIX)(x, y, z, len, curve,
+                                             acc, index, tmp);
+
+  mpz_clear(tmp);
+  ARRAY_CLEAR_FREE(acc, len);
+  free(index);
+}
+
+void
+FUNCTION_NAME(vec_jaff_batch, POSTFIX)(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                                       size_t len,
+                                       CURVE *curve)
+{
+  size_t i;
+
+  FIELD_ELEMENT_VAR *x;
+  FIELD_ELEMENT_VAR *y;
+  FIELD_ELEMENT_VAR *z;
+
+  x = ARRAY_MALLOC_INIT(len);
+  y = ARRAY_MALLOC_INIT(len);
+  z = ARRAY_MALLOC_INIT(len);
+
+  for (i = 0; i < len; i++)
+    {
+      FIELD_ELEMENT_VAR_IMPORT(x[i], y[i], z[i], X[i], Y[i], Z[i], curve);
+    }
+
+  FUNCTION_NAME(vec_jaff_batch_var, POSTFIX)(x, y, z, len, curve);
+
+  /* Points at infinity are mapped to the affine unit (-1, -1). */
+  for (i = 0; i < len; i++)
+    {
+      if (mpz_sgn(Z[i]) == 0)
+        {
+          mpz_set_si(X[i], -1);
+          mpz_set_si(Y[i], -1);
+        }
+      else
+        {
+          FIELD_ELEMENT_VAR_TO_MPZ(X[i], x[i], curve);
+          FIELD_ELEMENT_VAR_TO_MPZ(Y[i], y[i], curve);
+          mpz_set_ui(Z[i], 1);
+        }
+    }
+
+  ARRAY_CLEAR_FREE(z, len);
+  ARRAY_CLEAR_FREE(y, len);
+  ARRAY_CLEAR_FREE(x, len);
+}
+
+#endif
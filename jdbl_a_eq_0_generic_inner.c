@@ -0,0 +1,100 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <gmp.h>
+#include "vec.h"
+
+#define t1 scratch->t1
+#define t2 scratch->t2
+#define alpha scratch->t3
+#define beta scratch->t4
+#define gamma scratch->t5
+#define delta scratch->t6
+
+#define modulus curve->modulus
+
+
+/* 2009 Lange Jacobi coordinates. Special case a = 0. */
+
+void
+vec_jdbl_a_eq_0_generic_inner(vec_scratch_mpz_t scratch,
+                              mpz_t X3, mpz_t Y3, mpz_t Z3,
+                              vec_curve *curve,
+                              mpz_t X1, mpz_t Y1, mpz_t Z1)
+{
+
+  /* (X1, Y1, Z1) is point at infinity or point which is its own
+     inverse. */
+  if (mpz_cmp_ui(Z1, 0) == 0 || mpz_cmp_ui(Y1, 0) == 0)
+    {
+      mpz_set_ui(X3, 0);
+      mpz_set_ui(Y3, 1);
+      mpz_set_ui(Z3, 0);
+      return;
+    }
+
+  /* alpha = X1^2 */
+  mpz_mul(alpha, X1, X1);
+  mpz_mod(alpha, alpha, modulus);
+
+  /* beta = Y1^2 */
+  mpz_mul(beta, Y1, Y1);
+  mpz_mod(beta, beta, modulus);
+
+  /* gamma = beta^2 */
+  mpz_mul(gamma, beta, beta);
+  mpz_mod(gamma, gamma, modulus);
+
+  /* delta = 2*((X1+beta)^2-alpha-gamma) */
+  mpz_add(t1, X1, beta);
+  mpz_mul(t1, t1, t1);
+  mpz_sub(t1, t1, alpha);
+  mpz_sub(t1, t1, gamma);
+  mpz_mul_2exp(t1, t1, 1);
+  mpz_mod(delta, t1, modulus);
+
+  /* alpha = 3*alpha */
+  mpz_mul_ui(alpha, alpha, 3);
+
+  /* Z3 = 2*Y1*Z1, computed before Y1 may be overwritten. */
+  mpz_mul(t1, Y1, Z1);
+  mpz_mul_2exp(t1, t1, 1);
+  mpz_mod(Z3, t1, modulus);
+
+  /* X3 = alpha^2-2*delta */
+  mpz_mul(t1, alpha, alpha);
+  mpz_mul_2exp(t2, delta, 1);
+  mpz_sub(X3, t1, t2);
+  mpz_mod(X3, X3, modulus);
+
+  /* Y3 = alpha*(delta-X3)-8*gamma */
+  mpz_sub(t1, delta, X3);
+  mpz_mul(t1, t1, alpha);
+  mpz_mul_2exp(t2, gamma, 3);
+  mpz_sub(Y3, t1, t2);
+  mpz_mod(Y3, Y3, modulus);
+}
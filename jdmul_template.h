@@ -0,0 +1,468 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef FIELD_ELEMENT
+
+#include <stdlib.h>
+#include "templates.h"
+
+#include "jfmul_h_template.h"
+
+#ifndef JDMUL_TEMPLATE_H
+#define JDMUL_TEMPLATE_H
+
+/* Maximal width of the wNAFs, which bounds the size of the tables
+   kept on the stack. */
+#define VEC_JDMUL_MAX_WIDTH 6
+#define VEC_JDMUL_TAB_LEN (1 << (VEC_JDMUL_MAX_WIDTH - 2))
+
+/* The digits of scalars of at most this bit length are kept on the
+   stack. */
+#define VEC_JDMUL_STACK_BITS 1024
+
+#endif /* JDMUL_TEMPLATE_H */
+
+/*
+ * Computes the odd multiples P, 3P, ..., (2 * size - 1)P of a point
+ * and the negatives of their y-coordinates.
+ */
+static void
+FUNCTION_NAME(jdmul_precomp, POSTFIX)(FIELD_ELEMENT_VAR *xtab,
+                                      FIELD_ELEMENT_VAR *ytab,
+                                      FIELD_ELEMENT_VAR *ztab,
+                                      FIELD_ELEMENT_VAR *nytab,
+                                      int size,
+                                      CURVE *curve,
+                                      FIELD_ELEMENT_VAR X,
+                                      FIELD_ELEMENT_VAR Y,
+                                      FIELD_ELEMENT_VAR Z)
+{
+  int i;
+
+  FIELD_ELEMENT_VAR dx;
+  FIELD_ELEMENT_VAR dy;
+  FIELD_ELEMENT_VAR dz;
+
+  SCRATCH(scratch);
+
+  VEC_UNUSED(curve);
+
+  SCRATCH_INIT(scratch);
+
+  FIELD_ELEMENT_VAR_INIT(dx);
+  FIELD_ELEMENT_VAR_INIT(dy);
+  FIELD_ELEMENT_VAR_INIT(dz);
+
+  JDBL_VAR(scratch, dx, dy, dz, curve, X, Y, Z);
+
+  FIELD_ELEMENT_VAR_SET(xtab[0], ytab[0], ztab[0], X, Y, Z);
+
+  for (i = 1; i < size; i++)
+    {
+      JADD_VAR(scratch,
+               xtab[i], ytab[i], ztab[i],
+               curve,
+               xtab[i - 1], ytab[i - 1], ztab[i - 1],
+               dx, dy, dz);
+    }
+
+  for (i = 0; i < size; i++)
+    {
+      FIELD_ELEMENT_VAR_NEG(nytab[i], ytab[i], curve);
+    }
+
+  FIELD_ELEMENT_VAR_CLEAR(dz);
+  FIELD_ELEMENT_VAR_CLEAR(dy);
+  FIELD_ELEMENT_VAR_CLEAR(dx);
+
+  SCRATCH_CLEAR(scratch);
+}
+
+/* Returns the width used for the wNAF of a scalar of the given bit
+   length. */
+static int
+FUNCTION_NAME(jdmul_width, POSTFIX)(int bit_length)
+{
+  int width = vec_mul_window_width(bit_length, 1);
+
+  if (width > VEC_JDMUL_MAX_WIDTH)
+    {
+      width = VEC_JDMUL_MAX_WIDTH;
+    }
+  return width;
+}
+
+/*
+ * Double multiplication scalar1 * P1 + scalar2 * P2 with interleaved
+ * wNAFs, i.e., Straus' algorithm with signed windows, where all
+ * doublings are shared. The tables are kept on the stack, and so are
+ * the digits unless a scalar is longer than VEC_JDMUL_STACK_BITS
+ * bits. The scalars must be non-negative.
+ */
+void
+FUNCTION_NAME(vec_jdmul, POSTFIX)
+     (FIELD_ELEMENT RX, FIELD_ELEMENT RY, FIELD_ELEMENT RZ,
+      CURVE *curve,
+      FIELD_ELEMENT_VAR X1, FIELD_ELEMENT_VAR Y1, FIELD_ELEMENT_VAR Z1,
+      mpz_t scalar1,
+      FIELD_ELEMENT_VAR X2, FIELD_ELEMENT_VAR Y2, FIELD_ELEMENT_VAR Z2,
+      mpz_t scalar2)
+{
+  int i;
+  int j;
+  int size;
+  int width;
+  int bit_length;
+  int len1;
+  int len2;
+
+  signed char stack_digits[2 * (VEC_JDMUL_STACK_BITS + 1)];
+  signed char *digits1;
+  signed char *digits2;
+
+  FIELD_ELEMENT_VAR xtab1[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR ytab1[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR ztab1[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR nytab1[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR xtab2[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR ytab2[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR ztab2[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR nytab2[VEC_JDMUL_TAB_LEN];
+
+  SCRATCH(scratch);
+  VEC_STATS_TIMER(timer);
+
+  VEC_UNUSED(curve);
+
+  SCRATCH_INIT(scratch);
+
+  /* Determine bit length. */
+  bit_length = (int)mpz_sizeinbase(scalar1, 2);
+  if ((int)mpz_sizeinbase(scalar2, 2) > bit_length)
+    {
+      bit_length = (int)mpz_sizeinbase(scalar2, 2);
+    }
+
+  /* Two tables and twice as many additions give the same optimal
+     width as for a single scalar. */
+  width = FUNCTION_NAME(jdmul_width, POSTFIX)(bit_length);
+  size = 1 << (width - 2);
+
+  /* Recode scalars. */
+  if (bit_length <= VEC_JDMUL_STACK_BITS)
+    {
+      digits1 = stack_digits;
+    }
+  else
+    {
+      digits1 = (signed char *)malloc(2 * (bit_length + 1));
+    }
+  digits2 = digits1 + bit_length + 1;
+
+  len1 = (int)vec_wnaf(digits1, scalar1, width);
+  len2 = (int)vec_wnaf(digits2, scalar2, width);
+
+  /* Precompute tables. */
+  VEC_STATS_START(timer);
+
+  for (j = 0; j < size; j++)
+    {
+      FIELD_ELEMENT_VAR_INIT(xtab1[j]);
+      FIELD_ELEMENT_VAR_INIT(ytab1[j]);
+      FIELD_ELEMENT_VAR_INIT(ztab1[j]);
+      FIELD_ELEMENT_VAR_INIT(nytab1[j]);
+      FIELD_ELEMENT_VAR_INIT(xtab2[j]);
+      FIELD_ELEMENT_VAR_INIT(ytab2[j]);
+      FIELD_ELEMENT_VAR_INIT(ztab2[j]);
+      FIELD_ELEMENT_VAR_INIT(nytab2[j]);
+    }
+
+  FUNCTION_NAME(jdmul_precomp, POSTFIX)(xtab1, ytab1, ztab1, nytab1, size,
+                                        curve,
+                                        X1, Y1, Z1);
+  FUNCTION_NAME(jdmul_precomp, POSTFIX)(xtab2, ytab2, ztab2, nytab2, size,
+                                        curve,
+                                        X2, Y2, Z2);
+
+  VEC_STATS_ADD(curve, table_entries, 2 * size);
+  VEC_STATS_STOP(curve, precomp_cycles, timer);
+  VEC_STATS_START(timer);
+
+  /* Initialize with unit element. */
+  FIELD_ELEMENT_UNIT(RX, RY, RZ);
+
+  /* Compute output. */
+  for (i = (len1 > len2 ? len1 : len2) - 1; i >= 0; i--)
+    {
+
+      JDBL(scratch,
+           RX, RY, RZ,
+           curve,
+           RX, RY, RZ);
+
+      j = i < len1 ? digits1[i] : 0;
+      if (j > 0)
+        {
+          JADD(scratch,
+               RX, RY, RZ,
+               curve,
+               RX, RY, RZ,
+               xtab1[j >> 1], ytab1[j >> 1], ztab1[j >> 1]);
+        }
+      else if (j < 0)
+        {
+          JADD(scratch,
+               RX, RY, RZ,
+               curve,
+               RX, RY, RZ,
+               xtab1[-j >> 1], nytab1[-j >> 1], ztab1[-j >> 1]);
+        }
+
+      j = i < len2 ? digits2[i] : 0;
+      if (j > 0)
+        {
+          JADD(scratch,
+               RX, RY, RZ,
+               curve,
+               RX, RY, RZ,
+               xtab2[j >> 1], ytab2[j >> 1], ztab2[j >> 1]);
+        }
+      else if (j < 0)
+        {
+          JADD(scratch,
+               RX, RY, RZ,
+               curve,
+               RX, RY, RZ,
+               xtab2[-j >> 1], nytab2[-j >> 1], ztab2[-j >> 1]);
+        }
+    }
+
+  VEC_STATS_STOP(curve, main_cycles, timer);
+
+  for (j = 0; j < size; j++)
+    {
+      FIELD_ELEMENT_VAR_CLEAR(nytab2[j]);
+      FIELD_ELEMENT_VAR_CLEAR(ztab2[j]);
+      FIELD_ELEMENT_VAR_CLEAR(ytab2[j]);
+      FIELD_ELEMENT_VAR_CLEAR(xtab2[j]);
+      FIELD_ELEMENT_VAR_CLEAR(nytab1[j]);
+      FIELD_ELEMENT_VAR_CLEAR(ztab1[j]);
+      FIELD_ELEMENT_VAR_CLEAR(ytab1[j]);
+      FIELD_ELEMENT_VAR_CLEAR(xtab1[j]);
+    }
+
+  if (digits1 != stack_digits)
+    {
+      free(digits1);
+    }
+
+  SCRATCH_CLEAR(scratch);
+}
+
+/*
+ * Double multiplication scalar1 * P1 + scalar2 * P2, where P1 is a
+ * fixed basis given by a table for fixed basis multiplication. The
+ * additions from the table are interleaved with the wNAF of the
+ * second scalar, so the doublings for the table come for free. The
+ * table only covers scalars of the bit length of the order of the
+ * curve, so scalars that are negative or longer than the order are
+ * reduced first. Nothing is allocated on the heap unless a scalar is
+ * reduced or the second scalar is longer than VEC_JDMUL_STACK_BITS
+ * bits.
+ */
+void
+FUNCTION_NAME(vec_jfdmul, POSTFIX)
+     (FIELD_ELEMENT RX, FIELD_ELEMENT RY, FIELD_ELEMENT RZ,
+      CURVE *curve,
+      FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+      mpz_t scalar1,
+      FIELD_ELEMENT_VAR X2, FIELD_ELEMENT_VAR Y2, FIELD_ELEMENT_VAR Z2,
+      mpz_t scalar2)
+{
+  int i;
+  int j;
+  int k;
+  int size;
+  int width;
+  int bit_length;
+  int len2;
+  int mask;
+
+  size_t bw = table->tab->block_width;
+  size_t slice_bit_len = table->slice_bit_len;
+  int affine = table->tab->affine;
+
+  FIELD_ELEMENT_VAR *tabx = table->tab->tabsx[0];
+  FIELD_ELEMENT_VAR *taby = table->tab->tabsy[0];
+  FIELD_ELEMENT_VAR *tabz = table->tab->tabsz[0];
+
+  signed char stack_digits[VEC_JDMUL_STACK_BITS + 1];
+  signed char *digits2;
+
+  FIELD_ELEMENT_VAR xtab2[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR ytab2[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR ztab2[VEC_JDMUL_TAB_LEN];
+  FIELD_ELEMENT_VAR nytab2[VEC_JDMUL_TAB_LEN];
+
+  size_t order_bit_length = mpz_sizeinbase(curve->n, 2);
+  mpz_t reduced1;
+  mpz_t reduced2;
+  mpz_ptr s1 = scalar1;
+  mpz_ptr s2 = scalar2;
+
+  SCRATCH(scratch);
+
+  SCRATCH_INIT(scratch);
+
+  if (mpz_sgn(scalar1) < 0
+      || mpz_sizeinbase(scalar1, 2) > order_bit_length)
+    {
+      mpz_init(reduced1);
+      mpz_mod(reduced1, scalar1, curve->n);
+      s1 = reduced1;
+    }
+  if (mpz_sgn(scalar2) < 0
+      || mpz_sizeinbase(scalar2, 2) > order_bit_length)
+    {
+      mpz_init(reduced2);
+      mpz_mod(reduced2, scalar2, curve->n);
+      s2 = reduced2;
+    }
+
+  bit_length = (int)mpz_sizeinbase(s2, 2);
+
+  width = FUNCTION_NAME(jdmul_width, POSTFIX)(bit_length);
+  size = 1 << (width - 2);
+
+  /* Recode the second scalar. */
+  if (bit_length <= VEC_JDMUL_STACK_BITS)
+    {
+      digits2 = stack_digits;
+    }
+  else
+    {
+      digits2 = (signed char *)malloc(bit_length + 1);
+    }
+  len2 = (int)vec_wnaf(digits2, s2, width);
+
+  /* Precompute table for the second basis. */
+  for (j = 0; j < size; j++)
+    {
+      FIELD_ELEMENT_VAR_INIT(xtab2[j]);
+      FIELD_ELEMENT_VAR_INIT(ytab2[j]);
+      FIELD_ELEMENT_VAR_INIT(ztab2[j]);
+      FIELD_ELEMENT_VAR_INIT(nytab2[j]);
+    }
+
+  FUNCTION_NAME(jdmul_precomp, POSTFIX)(xtab2, ytab2, ztab2, nytab2, size,
+                                        curve,
+                                        X2, Y2, Z2);
+
+  /* Initialize with unit element. */
+  FIELD_ELEMENT_UNIT(RX, RY, RZ);
+
+  /* Compute output. */
+  i = len2 > (int)slice_bit_len ? len2 : (int)slice_bit_len;
+  for (i = i - 1; i >= 0; i--)
+    {
+
+      JDBL(scratch,
+           RX, RY, RZ,
+           curve,
+           RX, RY, RZ);
+
+      /* Add the entry of the fixed basis table given by the bits at
+         index i of the slices of the first scalar. */
+      if (i < (int)slice_bit_len)
+        {
+          mask = 0;
+          for (k = (int)bw - 1; k >= 0; k--)
+            {
+              mask = (mask << 1) | mpz_tstbit(s1, k * slice_bit_len + i);
+            }
+
+          if (mask != 0 && affine)
+            {
+              JADD_MIXED(scratch,
+                         RX, RY, RZ,
+                         curve,
+                         RX, RY, RZ,
+                         tabx[mask], taby[mask], tabz[mask]);
+            }
+          else if (mask != 0)
+            {
+              JADD(scratch,
+                   RX, RY, RZ,
+                   curve,
+                   RX, RY, RZ,
+                   tabx[mask], taby[mask], tabz[mask]);
+            }
+        }
+
+      j = i < len2 ? digits2[i] : 0;
+      if (j > 0)
+        {
+          JADD(scratch,
+               RX, RY, RZ,
+               curve,
+               RX, RY, RZ,
+               xtab2[j >> 1], ytab2[j >> 1], ztab2[j >> 1]);
+        }
+      else if (j < 0)
+        {
+          JADD(scratch,
+               RX, RY, RZ,
+               curve,
+               RX, RY, RZ,
+               xtab2[-j >> 1], nytab2[-j >> 1], ztab2[-j >> 1]);
+        }
+    }
+
+  for (j = 0; j < size; j++)
+    {
+      FIELD_ELEMENT_VAR_CLEAR(nytab2[j]);
+      FIELD_ELEMENT_VAR_CLEAR(ztab2[j]);
+      FIELD_ELEMENT_VAR_CLEAR(ytab2[j]);
+      FIELD_ELEMENT_VAR_CLEAR(xtab2[j]);
+    }
+
+  if (digits2 != stack_digits)
+    {
+      free(digits2);
+    }
+  if (s2 != scalar2)
+    {
+      mpz_clear(reduced2);
+    }
+  if (s1 != scalar1)
+    {
+      mpz_clear(reduced1);
+    }
+
+  SCRATCH_CLEAR(scratch);
+}
+
+#endif
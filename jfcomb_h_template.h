@@ -0,0 +1,86 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef JFCOMB_H_TEMPLATE_H
+#define JFCOMB_H_TEMPLATE_H
+
+#include <gmp.h>
+#include "vec.h"
+#include "templates.h"
+
+/*
+ * Comb for fixed basis multiplication with several tables and signed
+ * digits. The scalar is recoded such that each of its width * tabs *
+ * cols bits represents a digit which is plus or minus one. The
+ * entries of a table are the sums of the width teeth of the comb
+ * with the most significant digit positive, so the table holds only
+ * 2^(width - 1) entries. A negative most significant digit is
+ * handled by negating an entry.
+ */
+struct FUNCTION_NAME(_vec_jfcomb_tab, TAB_POSTFIX)
+{
+  size_t width;                /**< Number of teeth of each table. */
+  size_t tabs;                 /**< Number of tables. */
+  size_t cols;                 /**< Number of columns, i.e., bits of
+                                  each tooth. */
+  size_t tab_len;              /**< Number of entries of each table. */
+  FIELD_ELEMENT_VAR *tabx;     /**< x-coordinates of all tables. */
+  FIELD_ELEMENT_VAR *taby;     /**< y-coordinates of all tables. */
+  FIELD_ELEMENT_VAR *tabz;     /**< z-coordinates of all tables. */
+  FIELD_ELEMENT_VAR *tabny;    /**< Negated y-coordinates of all
+                                  tables. */
+  int affine;                  /**< Indicates that all entries have
+                                  z-coordinate one. */
+  mpz_t half;                  /**< Inverse of two modulo the order. */
+  mpz_t offset;                /**< Offset of the recoding. */
+};
+typedef struct FUNCTION_NAME(_vec_jfcomb_tab, TAB_POSTFIX)
+FUNCTION_NAME(vec_jfcomb_tab, TAB_POSTFIX); /* Magic references. */
+
+void
+FUNCTION_NAME(vec_jfcomb_init, POSTFIX)
+     (FUNCTION_NAME(vec_jfcomb_tab, TAB_POSTFIX) *table,
+      CURVE *curve,
+      size_t len,
+      size_t max_bytes);
+
+void
+FUNCTION_NAME(vec_jfcomb_clear_free, POSTFIX)
+     (FUNCTION_NAME(vec_jfcomb_tab, TAB_POSTFIX) *table);
+
+void
+FUNCTION_NAME(vec_jfcomb_prcmp, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfcomb_tab, TAB_POSTFIX) *table,
+      FIELD_ELEMENT_VAR x, FIELD_ELEMENT_VAR y, FIELD_ELEMENT_VAR z);
+
+void
+FUNCTION_NAME(vec_jfcomb_cmp, POSTFIX)
+     (FIELD_ELEMENT_VAR ropx, FIELD_ELEMENT_VAR ropy, FIELD_ELEMENT_VAR ropz,
+      CURVE *curve, FUNCTION_NAME(vec_jfcomb_tab, TAB_POSTFIX) *table,
+      mpz_t scalar);
+
+#endif /* JFCOMB_H_TEMPLATE_H */
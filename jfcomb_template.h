@@ -0,0 +1,364 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "templates.h"
+
+#include "jfcomb_h_template.h"
+
+void
+FUNCTION_NAME(vec_jfcomb_init, POSTFIX)
+     (FUNCTION_NAME(vec_jfcomb_tab, TAB_POSTFIX) *table,
+      CURVE *curve,
+      size_t len,
+      size_t max_bytes)
+{
+  int width;
+  int tabs;
+  size_t entries;
+  size_t bit_length = mpz_sizeinbase(curve->n, 2);
+
+  /* Each entry stores the coordinates and the negated y-coordinate. */
+  vec_fmul_comb_width(&width, &tabs,
+                      (int)bit_length, len > 0 ? (int)len : 1,
+                      4 * FIELD_ELEMENT_VAR_BYTES(curve), max_bytes);
+
+  table->width = width;
+  table->tabs = tabs;
+  table->cols = (bit_length + width * tabs - 1) / (width * tabs);
+  table->tab_len = ((size_t)1) << (width - 1);
+
+  entries = table->tabs * table->tab_len;
+  table->tabx = ARRAY_MALLOC_INIT(entries);
+  table->taby = ARRAY_MALLOC_INIT(entries);
+  table->tabz = ARRAY_MALLOC_INIT(entries);
+  table->tabny = ARRAY_MALLOC_INIT(entries);
+  VEC_STATS_ALLOC(curve, 4, 4 * entries * sizeof(FIELD_ELEMENT_VAR));
+  table->affine = 0;
+
+  /* A scalar k is recoded as (k + 2^l - 1) / 2 modulo the order,
+     where l is the total number of bits of the comb. */
+  mpz_init(table->half);
+  mpz_add_ui(table->half, curve->n, 1);
+  mpz_tdiv_q_2exp(table->half, table->half, 1);
+
+  mpz_init_set_ui(table->offset, 1);
+  mpz_mul_2exp(table->offset, table->offset,
+               table->width * table->tabs * table->cols);
+  mpz_sub_ui(table->offset, table->offset, 1);
+  mpz_mul(table->offset, table->offset, table->half);
+  mpz_mod(table->offset, table->offset, curve->n);
+}
+
+void
+FUNCTION_NAME(vec_jfcomb_clear_free, POSTFIX)
+     (FUNCTION_NAME(vec_jfcomb_tab, TAB_POSTFIX) *table)
+{
+  size_t entries = table->tabs * table->tab_len;
+
+  VEC_UNUSED(entries);
+
+  ARRAY_CLEAR_FREE(table->tabx, entries);
+  ARRAY_CLEAR_FREE(table->taby, entries);
+  ARRAY_CLEAR_FREE(table->tabz, entries);
+  ARRAY_CLEAR_FREE(table->tabny, entries);
+
+  mpz_clear(table->offset);
+  mpz_clear(table->half);
+
+  free(table);
+}
+
+void
+FUNCTION_NAME(vec_jfcomb_prcmp, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfcomb_tab, TAB_POSTFIX) *table,
+      FIELD_ELEMENT_VAR x, FIELD_ELEMENT_VAR y, FIELD_ELEMENT_VAR z)
+{
+  size_t i;
+  size_t j;
+  size_t k;
+  size_t m;
+  size_t h;
+  size_t b;
+  size_t width = table->width;
+  size_t teeth = table->width * table->tabs;
+  size_t entries = table->tabs * table->tab_len;
+
+  FIELD_ELEMENT_VAR *tabx = table->tabx;
+  FIELD_ELEMENT_VAR *taby = table->taby;
+  FIELD_ELEMENT_VAR *tabz = table->tabz;
+
+  FIELD_ELEMENT_VAR *basesx;
+  FIELD_ELEMENT_VAR *basesy;
+  FIELD_ELEMENT_VAR *basesz;
+
+  FIELD_ELEMENT_VAR ny;
+
+  SCRATCH(scratch);
+  VEC_STATS_TIMER(timer);
+
+  SCRATCH_INIT(scratch);
+
+  VEC_STATS_START(timer);
+
+  FIELD_ELEMENT_VAR_INIT(ny);
+
+  basesx = ARRAY_MALLOC_INIT(teeth);
+  basesy = ARRAY_MALLOC_INIT(teeth);
+  basesz = ARRAY_MALLOC_INIT(teeth);
+  VEC_STATS_ALLOC(curve, 3, 3 * teeth * sizeof(FIELD_ELEMENT_VAR));
+
+  /* The ith tooth is 2^(i * cols) times the basis. */
+  FIELD_ELEMENT_VAR_SET(basesx[0], basesy[0], basesz[0], x, y, z);
+
+  for (i = 1; i < teeth; i++)
+    {
+
+      FIELD_ELEMENT_VAR_SET(basesx[i], basesy[i], basesz[i],
+                            basesx[i - 1], basesy[i - 1], basesz[i - 1]);
+
+      for (j = 0; j < table->cols; j++)
+        {
+          JDBL_VAR(scratch,
+                   basesx[i], basesy[i], basesz[i],
+                   curve,
+                   basesx[i], basesy[i], basesz[i]);
+        }
+    }
+
+  for (j = 0; j < table->tabs; j++)
+    {
+
+      k = j * table->tab_len;
+      b = j * width;
+
+      /* The first entry has all digits negative except the most
+         significant digit. */
+      FIELD_ELEMENT_VAR_SET(tabx[k], taby[k], tabz[k],
+                            basesx[b + width - 1],
+                            basesy[b + width - 1],
+                            basesz[b + width - 1]);
+
+      for (i = 0; i < width - 1; i++)
+        {
+          FIELD_ELEMENT_VAR_NEG(ny, basesy[b + i], curve);
+
+          JADD_VAR(scratch,
+                   tabx[k], taby[k], tabz[k],
+                   curve,
+                   tabx[k], taby[k], tabz[k],
+                   basesx[b + i], ny, basesz[b + i]);
+        }
+
+      /* Changing the ith digit from minus one to one adds twice the
+         ith tooth, so each entry costs a single addition. */
+      for (i = 0; i < width - 1; i++)
+        {
+          JDBL_VAR(scratch,
+                   basesx[b + i], basesy[b + i], basesz[b + i],
+                   curve,
+                   basesx[b + i], basesy[b + i], basesz[b + i]);
+
+          h = ((size_t)1) << i;
+          for (m = 0; m < h; m++)
+            {
+              JADD_VAR(scratch,
+                       tabx[k + h + m], taby[k + h + m], tabz[k + h + m],
+                       curve,
+                       tabx[k + m], taby[k + m], tabz[k + m],
+                       basesx[b + i], basesy[b + i], basesz[b + i]);
+            }
+        }
+    }
+
+  /* The table is used for many multiplications, so the conversion to
+     affine coordinates is always worthwhile. Entries at infinity are
+     left as they are, in which case general additions are used. */
+  FUNCTION_NAME(vec_jaff_batch_var, POSTFIX)(tabx, taby, tabz,
+                                             entries,
+                                             curve);
+  table->affine = 1;
+  for (k = 0; k < entries; k++)
+    {
+      if (FIELD_ELEMENT_VAR_IS_ZERO(tabz[k], curve))
+        {
+          table->affine = 0;
+        }
+      FIELD_ELEMENT_VAR_NEG(table->tabny[k], taby[k], curve);
+    }
+
+  ARRAY_CLEAR_FREE(basesx, teeth);
+  ARRAY_CLEAR_FREE(basesy, teeth);
+  ARRAY_CLEAR_FREE(basesz, teeth);
+
+  FIELD_ELEMENT_VAR_CLEAR(ny);
+
+  VEC_STATS_ADD(curve, table_entries, entries);
+  VEC_STATS_STOP(curve, precomp_cycles, timer);
+
+  SCRATCH_CLEAR(scratch);
+}
+
+/* Returns the bit at the given index of a number given by its
+   limbs. */
+static int
+FUNCTION_NAME(jfcomb_bit, POSTFIX)(const mp_limb_t *limbs, size_t size,
+                                   size_t index)
+{
+  size_t limb = index / GMP_NUMB_BITS;
+
+  if (limb < size)
+    {
+      return (int)((limbs[limb] >> (index % GMP_NUMB_BITS)) & 1);
+    }
+  else
+    {
+      return 0;
+    }
+}
+
+void
+FUNCTION_NAME(vec_jfcomb_cmp, POSTFIX)
+     (FIELD_ELEMENT_VAR ropx, FIELD_ELEMENT_VAR ropy, FIELD_ELEMENT_VAR ropz,
+      CURVE *curve, FUNCTION_NAME(vec_jfcomb_tab, TAB_POSTFIX) *table,
+      mpz_t scalar)
+{
+  size_t i;
+  size_t j;
+  size_t k;
+  size_t pos;
+  size_t size;
+  int col;
+  size_t mask;
+  const mp_limb_t *limbs;
+  mpz_t recoded;
+
+  FIELD_ELEMENT tmpx;
+  FIELD_ELEMENT tmpy;
+  FIELD_ELEMENT tmpz;
+
+  size_t width = table->width;
+  size_t tabs = table->tabs;
+  size_t cols = table->cols;
+  size_t tab_len = table->tab_len;
+  int affine = table->affine;
+
+  FIELD_ELEMENT_VAR *tabx = table->tabx;
+  FIELD_ELEMENT_VAR *tabz = table->tabz;
+  FIELD_ELEMENT_VAR *ys;
+
+  SCRATCH(scratch);
+  VEC_STATS_TIMER(timer);
+
+  SCRATCH_INIT(scratch);
+
+  VEC_STATS_START(timer);
+
+  FIELD_ELEMENT_INIT(tmpx);
+  FIELD_ELEMENT_INIT(tmpy);
+  FIELD_ELEMENT_INIT(tmpz);
+
+  /* Recode the scalar such that each bit represents a digit which is
+     plus or minus one. */
+  mpz_init(recoded);
+  mpz_mul(recoded, scalar, table->half);
+  mpz_add(recoded, recoded, table->offset);
+  mpz_mod(recoded, recoded, curve->n);
+
+  limbs = mpz_limbs_read(recoded);
+  size = mpz_size(recoded);
+
+  /* Initialize result variable. */
+  FIELD_ELEMENT_UNIT(tmpx, tmpy, tmpz);
+
+  for (col = (int)cols - 1; col >= 0; col--)
+    {
+
+      JDBL(scratch,
+           tmpx, tmpy, tmpz,
+           curve,
+           tmpx, tmpy, tmpz);
+
+      for (j = 0; j < tabs; j++)
+        {
+
+          /* Collect the bits of the teeth of the jth table. */
+          mask = 0;
+          pos = j * width * cols + col;
+          for (i = 0; i < width; i++)
+            {
+              if (FUNCTION_NAME(jfcomb_bit, POSTFIX)(limbs, size, pos))
+                {
+                  mask |= ((size_t)1) << i;
+                }
+              pos += cols;
+            }
+
+          /* If the most significant digit is negative, then the
+             entry with all digits negated is negated. */
+          if (mask & tab_len)
+            {
+              k = mask ^ tab_len;
+              ys = table->taby;
+            }
+          else
+            {
+              k = ~mask & (tab_len - 1);
+              ys = table->tabny;
+            }
+          k += j * tab_len;
+
+          if (affine)
+            {
+              JADD_MIXED(scratch,
+                         tmpx, tmpy, tmpz,
+                         curve,
+                         tmpx, tmpy, tmpz,
+                         tabx[k], ys[k], tabz[k]);
+            }
+          else
+            {
+              JADD(scratch,
+                   tmpx, tmpy, tmpz,
+                   curve,
+                   tmpx, tmpy, tmpz,
+                   tabx[k], ys[k], tabz[k]);
+            }
+        }
+    }
+
+  mpz_clear(recoded);
+
+  VEC_STATS_STOP(curve, main_cycles, timer);
+
+  SCRATCH_CLEAR(scratch);
+
+  FIELD_ELEMENT_CONTRACT(ropx, ropy, ropz, tmpx, tmpy, tmpz);
+  FIELD_ELEMENT_CLEAR(tmpx);
+  FIELD_ELEMENT_CLEAR(tmpy);
+  FIELD_ELEMENT_CLEAR(tmpz);
+}
@@ -34,16 +34,7 @@ vec_jfmul_aff(mpz_t rx, mpz_t ry,
                 vec_jfmul_tab_ptr table_ptr,
                 mpz_t scalar)
 {
-
-  mpz_t RZ;
-
-  mpz_init(RZ);
-
-  curve->jfmul(rx, ry, RZ,
-               curve, table_ptr,
-               scalar);
-
-  vec_jaff(rx, ry, RZ, curve);
-
-  mpz_clear(RZ);
+  curve->jfmul_aff(rx, ry,
+                   curve, table_ptr,
+                   scalar);
 }
@@ -0,0 +1,121 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <gmp.h>
+#include "vec.h"
+
+/* Smallest number of scalars worth handing to a thread of its own. */
+#define VEC_JFMUL_BATCH_MIN_LEN 16
+
+/*
+ * Work order of a single thread. Each thread computes the fixed
+ * basis multiplications of a contiguous range of the scalars using
+ * the batched fixed basis multiplication function of the curve.
+ */
+typedef struct
+{
+  vec_curve *curve;
+  vec_jfmul_tab_ptr table;
+  mpz_t *ropsx;
+  mpz_t *ropsy;
+  mpz_t *ropsz;
+  mpz_t *scalars;
+  size_t len;
+} vec_jfmul_batch_job;
+
+static void *
+vec_jfmul_batch_worker(void *arg)
+{
+  vec_jfmul_batch_job *job = (vec_jfmul_batch_job *)arg;
+
+  job->curve->jfmul_batch(job->ropsx, job->ropsy, job->ropsz,
+                          job->curve,
+                          job->table,
+                          job->scalars,
+                          job->len);
+  return NULL;
+}
+
+void
+vec_jfmul_batch(mpz_t *ropsx, mpz_t *ropsy, mpz_t *ropsz,
+                vec_curve *curve,
+                vec_jfmul_tab_ptr table,
+                mpz_t *scalars,
+                size_t len,
+                size_t threads)
+{
+  size_t i;
+  size_t offset;
+  size_t len_per_job;
+  size_t jobs_len;
+  vec_jfmul_batch_job *jobs;
+
+  /* Never give a thread less than a minimal number of scalars. */
+  threads = vec_threads(threads);
+  if (threads > len / VEC_JFMUL_BATCH_MIN_LEN)
+    {
+      threads = len / VEC_JFMUL_BATCH_MIN_LEN;
+    }
+
+  if (threads <= 1)
+    {
+      curve->jfmul_batch(ropsx, ropsy, ropsz,
+                         curve,
+                         table,
+                         scalars,
+                         len);
+      return;
+    }
+
+  /* Give each thread a contiguous range of scalars. */
+  len_per_job = (len + threads - 1) / threads;
+  jobs_len = (len + len_per_job - 1) / len_per_job;
+
+  jobs = (vec_jfmul_batch_job *)malloc(jobs_len * sizeof(vec_jfmul_batch_job));
+
+  offset = 0;
+  for (i = 0; i < jobs_len; i++)
+    {
+      jobs[i].curve = curve;
+      jobs[i].table = table;
+      jobs[i].ropsx = ropsx + offset;
+      jobs[i].ropsy = ropsy + offset;
+      jobs[i].ropsz = ropsz + offset;
+      jobs[i].scalars = scalars + offset;
+      jobs[i].len = len_per_job;
+      if (offset + jobs[i].len > len)
+        {
+          jobs[i].len = len - offset;
+        }
+      offset += jobs[i].len;
+    }
+
+  vec_par_run(jobs, jobs_len, sizeof(vec_jfmul_batch_job),
+              vec_jfmul_batch_worker);
+
+  free(jobs);
+}
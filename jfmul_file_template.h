@@ -0,0 +1,101 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "templates.h"
+
+#include "jfmul_h_template.h"
+
+int
+FUNCTION_NAME(vec_jfmul_save, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+      const char *path)
+{
+  vec_jfmul_file_header header;
+
+  memset(&header, 0, sizeof(vec_jfmul_file_header));
+  FUNCTION_NAME(vec_jsmul_file_prefix_init, POSTFIX)
+    (&header.prefix, curve, VEC_JFMUL_FILE_MAGIC, VEC_JFMUL_FILE_VERSION);
+  header.block_width = table->tab->block_width;
+  header.slice_bit_len = table->slice_bit_len;
+  header.tab_len = ((uint64_t)1) << table->tab->block_width;
+  header.affine = table->tab->affine;
+
+  return FUNCTION_NAME(vec_jsmul_file_save, POSTFIX)
+    (curve, table->tab, &header, sizeof(vec_jfmul_file_header), path);
+}
+
+FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *
+FUNCTION_NAME(vec_jfmul_load, POSTFIX)
+     (CURVE *curve,
+      const char *path)
+{
+  void *map;
+  size_t map_len;
+  vec_jfmul_file_header header;
+  FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table;
+
+  if (FUNCTION_NAME(vec_jsmul_file_map, POSTFIX)
+      (&map, &map_len, &header, sizeof(vec_jfmul_file_header), curve,
+       VEC_JFMUL_FILE_MAGIC, VEC_JFMUL_FILE_VERSION, path) != 0)
+    {
+      return NULL;
+    }
+
+  table = (FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *)
+    malloc(sizeof(FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX)));
+
+  /* The table has a single subtable, and its slices must cover all
+     scalars. */
+  if (header.block_width > VEC_TRANSPOSE_MAX_WIDTH
+      || header.tab_len != ((uint64_t)1) << header.block_width
+      || header.slice_bit_len == 0
+      || header.slice_bit_len > mpz_sizeinbase(curve->n, 2)
+      || header.block_width * header.slice_bit_len
+         < mpz_sizeinbase(curve->n, 2)
+      || FUNCTION_NAME(vec_jsmul_file_attach, POSTFIX)
+         (table->tab, curve, map, map_len, sizeof(vec_jfmul_file_header),
+          header.block_width, header.block_width, header.affine) != 0)
+    {
+      free(table);
+      munmap(map, map_len);
+      return NULL;
+    }
+
+  table->slice_bit_len = header.slice_bit_len;
+  table->map = map;
+  table->map_len = map_len;
+  table->lanes = NULL;
+
+#ifdef JFMUL_LANES_MIN_WIDTH
+  FUNCTION_NAME(vec_jfmul_lanes, POSTFIX)(table, curve);
+#endif
+
+  return table;
+}
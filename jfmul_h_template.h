@@ -27,10 +27,29 @@
 #ifndef JFMUL_H_TEMPLATE_H
 #define JFMUL_H_TEMPLATE_H
 
+#include <stdint.h>
 #include <gmp.h>
 #include "vec.h"
 #include "templates.h"
 #include "jsmul_h_template.h"
+#include "jsmul_file_h_template.h"
+
+/*
+ * File format of a fixed basis multiplication table, i.e., a file of
+ * a simultaneous multiplication table with a single subtable whose
+ * header also records the length of the slices of the scalars.
+ */
+#define VEC_JFMUL_FILE_MAGIC "VECJFMUL"
+#define VEC_JFMUL_FILE_VERSION 2
+
+typedef struct
+{
+  vec_jsmul_file_prefix prefix; /**< Common prefix of table files. */
+  uint64_t block_width;       /**< Width of the table. */
+  uint64_t slice_bit_len;     /**< Bit length of each slice. */
+  uint64_t tab_len;           /**< Number of entries in the table. */
+  uint64_t affine;            /**< Entries are in affine coordinates. */
+} vec_jfmul_file_header;
 
 struct FUNCTION_NAME(_vec_jfmul_tab, TAB_POSTFIX)
 {
@@ -38,6 +57,12 @@ struct FUNCTION_NAME(_vec_jfmul_tab, TAB_POSTFIX)
   FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) tab; /**< Underlying simultaneous
                                                 multiplication table. */
   size_t slice_bit_len;                      /**< Bit length of each slice. */
+  void *map;                                 /**< Mapped file holding the
+                                                table, or NULL. */
+  size_t map_len;                            /**< Length of mapped file. */
+  vec_lanes_tab *lanes;                      /**< Copy of the table for
+                                                the multi-lane arithmetic,
+                                                or NULL. */
 
 };
 typedef struct FUNCTION_NAME(_vec_jfmul_tab, TAB_POSTFIX)
@@ -59,11 +84,36 @@ FUNCTION_NAME(vec_jfmul_prcmp, POSTFIX)
       FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
       FIELD_ELEMENT_VAR x, FIELD_ELEMENT_VAR y, FIELD_ELEMENT_VAR z);
 
+void
+FUNCTION_NAME(vec_jfmul_prcmp_par, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+      FIELD_ELEMENT_VAR x, FIELD_ELEMENT_VAR y, FIELD_ELEMENT_VAR z,
+      size_t threads);
+
 void
 FUNCTION_NAME(vec_jfmul_cmp, POSTFIX)
      (FIELD_ELEMENT_VAR ropx, FIELD_ELEMENT_VAR ropy, FIELD_ELEMENT_VAR ropz,
       CURVE *curve, FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
       mpz_t scalar);
 
+void
+FUNCTION_NAME(vec_jfmul_cmp_batch, POSTFIX)
+     (FIELD_ELEMENT_VAR *ropsx, FIELD_ELEMENT_VAR *ropsy,
+      FIELD_ELEMENT_VAR *ropsz,
+      CURVE *curve, FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+      mpz_t *scalars,
+      size_t len);
+
+int
+FUNCTION_NAME(vec_jfmul_save, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+      const char *path);
+
+FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *
+FUNCTION_NAME(vec_jfmul_load, POSTFIX)
+     (CURVE *curve,
+      const char *path);
 
 #endif /* JFMUL_H_TEMPLATE_H */
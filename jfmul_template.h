@@ -38,7 +38,14 @@ FUNCTION_NAME(vec_jfmul_init, POSTFIX)
 {
   size_t bit_length = mpz_sizeinbase(curve->n, 2);
 
-  int block_width = vec_fmul_block_width(bit_length, len);
+  int block_width = vec_tuning_fmul(curve->tuning,
+                                    curve->name, STRING_NAME(POSTFIX),
+                                    bit_length, len);
+
+  if (block_width == 0)
+    {
+      block_width = vec_fmul_block_width(bit_length, len);
+    }
 
   FUNCTION_NAME(vec_jsmul_init, POSTFIX)(table->tab,
                                            curve,
@@ -46,21 +53,104 @@ FUNCTION_NAME(vec_jfmul_init, POSTFIX)
                                            block_width);
   table->slice_bit_len =
     (((int)bit_length) + (block_width - 1)) / block_width;
+  table->map = NULL;
+  table->map_len = 0;
+  table->lanes = NULL;
 }
 
 void
 FUNCTION_NAME(vec_jfmul_clear_free, POSTFIX)
      (FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table)
 {
-  FUNCTION_NAME(vec_jsmul_clear, POSTFIX)(table->tab);
+  if (table->lanes != NULL)
+    {
+      vec_lanes_tab_free(table->lanes);
+    }
+  if (table->map == NULL)
+    {
+      FUNCTION_NAME(vec_jsmul_clear, POSTFIX)(table->tab);
+    }
+  else
+    {
+      FUNCTION_NAME(vec_jsmul_file_unmap, POSTFIX)(table->tab, table->map,
+                                                   table->map_len);
+    }
   free(table);
 }
 
+#ifdef JFMUL_LANES_MIN_WIDTH
+
+/* Copies the table to the representation of the multi-lane
+   arithmetic, if the processor supports enough lanes for this to pay
+   off. Backends without a minimal number of lanes, e.g., the special
+   reduction of P-521, are faster on their own. This requires a single
+   affine table, which is what fixed basis multiplication uses. */
+static void
+FUNCTION_NAME(vec_jfmul_lanes, POSTFIX)
+     (FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+      CURVE *curve)
+{
+  size_t i;
+  size_t tab_len = ((size_t)1) << table->tab->block_width;
+  mpz_t x;
+  mpz_t y;
+  mpz_t z;
+
+  table->lanes = NULL;
+
+  if (!table->tab->affine || table->tab->tabs_len != 1
+      || vec_lanes_width() < JFMUL_LANES_MIN_WIDTH)
+    {
+      return;
+    }
+
+  table->lanes = vec_lanes_tab_alloc(curve, tab_len);
+  if (table->lanes == NULL)
+    {
+      return;
+    }
+  VEC_STATS_ALLOC(curve, 1, table->lanes->entries_bytes);
+
+  mpz_init(x);
+  mpz_init(y);
+  mpz_init(z);
+
+  /* The first entry is the point at infinity and is never read. */
+  for (i = 1; i < tab_len; i++)
+    {
+      FIELD_ELEMENT_VAR_EXPORT(x, y, z,
+                               table->tab->tabsx[0][i],
+                               table->tab->tabsy[0][i],
+                               table->tab->tabsz[0][i],
+                               curve);
+
+      /* The lanes can only add finite entries. */
+      if (mpz_sgn(z) == 0)
+        {
+          vec_lanes_tab_free(table->lanes);
+          table->lanes = NULL;
+          break;
+        }
+      vec_lanes_tab_set(table->lanes, i, x, y);
+    }
+
+  mpz_clear(z);
+  mpz_clear(y);
+  mpz_clear(x);
+}
+
+#endif
+
+/* The doubling chain giving the bases is only as long as the bit
+   length of the order, so it is computed sequentially. The entries of
+   the table are computed and converted to affine coordinates in
+   parallel. */
 void
-FUNCTION_NAME(vec_jfmul_prcmp, POSTFIX)
+FUNCTION_NAME(vec_jfmul_prcmp_par, POSTFIX)
      (CURVE *curve,
       FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
-      FIELD_ELEMENT_VAR x, FIELD_ELEMENT_VAR y, FIELD_ELEMENT_VAR z)
+      FIELD_ELEMENT_VAR x, FIELD_ELEMENT_VAR y, FIELD_ELEMENT_VAR z,
+      size_t threads)
 {
   size_t i;
   size_t j;
@@ -77,6 +167,7 @@ FUNCTION_NAME(vec_jfmul_prcmp, POSTFIX)
   basesx = ARRAY_MALLOC_INIT(bw);
   basesy = ARRAY_MALLOC_INIT(bw);
   basesz = ARRAY_MALLOC_INIT(bw);
+  VEC_STATS_ALLOC(curve, 3, 3 * bw * sizeof(FIELD_ELEMENT_VAR));
 
   FIELD_ELEMENT_VAR_SET(basesx[0], basesy[0], basesz[0], x, y, z);
 
@@ -95,9 +186,19 @@ FUNCTION_NAME(vec_jfmul_prcmp, POSTFIX)
         }
     }
 
-  FUNCTION_NAME(vec_jsmul_precomp, POSTFIX)(table->tab,
-                                              curve,
-                                              basesx, basesy, basesz);
+  FUNCTION_NAME(vec_jsmul_precomp_par, POSTFIX)(table->tab,
+                                                curve,
+                                                basesx, basesy, basesz,
+                                                threads);
+
+  /* The table is used for many multiplications, so the conversion to
+     affine coordinates is always worthwhile. */
+  FUNCTION_NAME(vec_jsmul_normalize_par, POSTFIX)(table->tab, curve,
+                                                  threads);
+
+#ifdef JFMUL_LANES_MIN_WIDTH
+  FUNCTION_NAME(vec_jfmul_lanes, POSTFIX)(table, curve);
+#endif
 
   ARRAY_CLEAR_FREE(basesx, bw);
   ARRAY_CLEAR_FREE(basesy, bw);
@@ -107,34 +208,163 @@ FUNCTION_NAME(vec_jfmul_prcmp, POSTFIX)
 }
 
 void
-FUNCTION_NAME(vec_jfmul_cmp, POSTFIX)
-     (FIELD_ELEMENT_VAR ropx, FIELD_ELEMENT_VAR ropy, FIELD_ELEMENT_VAR ropz,
-      CURVE *curve, FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+FUNCTION_NAME(vec_jfmul_prcmp, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+      FIELD_ELEMENT_VAR x, FIELD_ELEMENT_VAR y, FIELD_ELEMENT_VAR z)
+{
+  FUNCTION_NAME(vec_jfmul_prcmp_par, POSTFIX)(curve, table, x, y, z, 1);
+}
+
+/* Splits the scalar into slices of the bit length used by the
+   table. Both the slices and the temporary variable are allocated by
+   the caller, so that they can be reused for many scalars. */
+static void
+FUNCTION_NAME(vec_jfmul_slice, POSTFIX)
+     (mpz_t *slices, mpz_t tmp,
+      FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
       mpz_t scalar)
 {
   size_t i;
   size_t bw = table->tab->block_width;
-  mpz_t *scalars;
-  mpz_t tmp;
-
-  mpz_init(tmp);
-
-  scalars = vec_array_alloc_init(bw);
 
   mpz_set(tmp, scalar);
 
   for (i = 0; i < bw; i++)
     {
-      mpz_tdiv_r_2exp(scalars[i], tmp, table->slice_bit_len);
+      mpz_tdiv_r_2exp(slices[i], tmp, table->slice_bit_len);
       mpz_tdiv_q_2exp(tmp, tmp, table->slice_bit_len);
     }
+}
+
+void
+FUNCTION_NAME(vec_jfmul_cmp, POSTFIX)
+     (FIELD_ELEMENT_VAR ropx, FIELD_ELEMENT_VAR ropy, FIELD_ELEMENT_VAR ropz,
+      CURVE *curve, FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+      mpz_t scalar)
+{
+  size_t bw = table->tab->block_width;
+  mpz_t *slices;
+  uint16_t *masks;
+  vec_workspace *ws = vec_workspace_get();
+
+  /* The slices and masks are kept in the workspace, so that they can
+     be reused by later calls. */
+  slices = vec_workspace_slices(ws, bw, table->slice_bit_len);
+  masks = vec_workspace_masks(ws, table->slice_bit_len);
+
+  FUNCTION_NAME(vec_jfmul_slice, POSTFIX)(slices, ws->tmp, table, scalar);
+  vec_scalars_transpose(masks, slices, bw, bw, table->slice_bit_len);
 
   FUNCTION_NAME(vec_jsmul_table, POSTFIX)(ropx, ropy, ropz,
                                             curve,
                                             table->tab,
-                                            scalars,
+                                            masks,
                                             table->slice_bit_len);
-  vec_array_clear_free(scalars, bw);
+}
+
+void
+FUNCTION_NAME(vec_jfmul_cmp_batch, POSTFIX)
+     (FIELD_ELEMENT_VAR *ropsx, FIELD_ELEMENT_VAR *ropsy,
+      FIELD_ELEMENT_VAR *ropsz,
+      CURVE *curve, FUNCTION_NAME(vec_jfmul_tab, TAB_POSTFIX) *table,
+      mpz_t *scalars,
+      size_t len)
+{
+  size_t i;
+  size_t l;
+  size_t bw = table->tab->block_width;
+  size_t bitlen = table->slice_bit_len;
+  size_t width = table->lanes == NULL ? 0 : table->lanes->width;
+  int ok;
+  mpz_t *slices;
+  uint16_t *masks;
+  mpz_t X[VEC_LANES_MAX_WIDTH];
+  mpz_t Y[VEC_LANES_MAX_WIDTH];
+  mpz_t Z[VEC_LANES_MAX_WIDTH];
+  vec_workspace *ws = vec_workspace_get();
+  VEC_STATS_TIMER(timer);
+
+  /* The slices and masks of the workspace are used for the whole
+     batch, with room for the masks of one scalar in each lane. */
+  slices = vec_workspace_slices(ws, bw, bitlen);
+  masks = vec_workspace_masks(ws, (width == 0 ? 1 : width) * bitlen);
+
+  i = 0;
+
+  /* Compute as many multiplications as possible using all lanes at
+     once. If the addition formulas of the lanes do not apply to a
+     group of scalars, then the group is computed one by one. */
+  if (width > 0)
+    {
+      for (l = 0; l < width; l++)
+        {
+          mpz_init(X[l]);
+          mpz_init(Y[l]);
+          mpz_init(Z[l]);
+        }
+
+      for (; i + width <= len; i += width)
+        {
+          for (l = 0; l < width; l++)
+            {
+              FUNCTION_NAME(vec_jfmul_slice, POSTFIX)(slices, ws->tmp, table,
+                                                      scalars[i + l]);
+              vec_scalars_transpose(masks + l * bitlen, slices, bw, bw,
+                                    bitlen);
+            }
 
-  mpz_clear(tmp);
+          VEC_STATS_START(timer);
+          ok = table->lanes->jfmul(X, Y, Z, table->lanes, masks, bitlen);
+          VEC_STATS_STOP(curve, main_cycles, timer);
+          VEC_STATS_ADD(curve, dbl, width * bitlen);
+          VEC_STATS_ADD(curve, madd, width * bitlen);
+
+          for (l = 0; l < width; l++)
+            {
+              if (!ok)
+                {
+                  FUNCTION_NAME(vec_jsmul_table, POSTFIX)(ropsx[i + l],
+                                                          ropsy[i + l],
+                                                          ropsz[i + l],
+                                                          curve,
+                                                          table->tab,
+                                                          masks + l * bitlen,
+                                                          bitlen);
+                }
+              else if (mpz_sgn(Z[l]) == 0)
+                {
+                  FIELD_ELEMENT_VAR_UNIT(ropsx[i + l], ropsy[i + l],
+                                         ropsz[i + l]);
+                }
+              else
+                {
+                  FIELD_ELEMENT_VAR_IMPORT(ropsx[i + l], ropsy[i + l],
+                                           ropsz[i + l],
+                                           X[l], Y[l], Z[l],
+                                           curve);
+                }
+            }
+        }
+
+      for (l = 0; l < width; l++)
+        {
+          mpz_clear(Z[l]);
+          mpz_clear(Y[l]);
+          mpz_clear(X[l]);
+        }
+    }
+
+  for (; i < len; i++)
+    {
+      FUNCTION_NAME(vec_jfmul_slice, POSTFIX)(slices, ws->tmp, table,
+                                              scalars[i]);
+      vec_scalars_transpose(masks, slices, bw, bw, bitlen);
+
+      FUNCTION_NAME(vec_jsmul_table, POSTFIX)(ropsx[i], ropsy[i], ropsz[i],
+                                                curve,
+                                                table->tab,
+                                                masks,
+                                                bitlen);
+    }
 }
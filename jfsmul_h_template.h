@@ -0,0 +1,113 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef JFSMUL_H_TEMPLATE_H
+#define JFSMUL_H_TEMPLATE_H
+
+#include <stdint.h>
+#include <gmp.h>
+#include "vec.h"
+#include "templates.h"
+#include "jsmul_h_template.h"
+#include "jsmul_file_h_template.h"
+
+/*
+ * File format of a fixed bases simultaneous multiplication table,
+ * i.e., a file of a simultaneous multiplication table whose header
+ * records the number of bases and the width and number of the
+ * subtables.
+ */
+#define VEC_JFSMUL_FILE_MAGIC "VECJFSML"
+#define VEC_JFSMUL_FILE_VERSION 1
+
+typedef struct
+{
+  vec_jsmul_file_prefix prefix; /**< Common prefix of table files. */
+  uint64_t len;               /**< Number of bases. */
+  uint64_t block_width;       /**< Width of each subtable. */
+  uint64_t tabs_len;          /**< Number of subtables. */
+  uint64_t affine;            /**< Entries are in affine coordinates. */
+} vec_jfsmul_file_header;
+
+/*
+ * Simultaneous multiplication table for a fixed list of bases. This is
+ * the table built by vec_jsmul_precomp for all the bases at once, so
+ * each multiplication only transposes the scalars and runs the main
+ * loop.
+ */
+struct FUNCTION_NAME(_vec_jfsmul_tab, TAB_POSTFIX)
+{
+
+  FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) tab; /**< Underlying simultaneous
+                                                multiplication table. */
+  size_t bit_len;                            /**< Bit length of the
+                                                order. */
+  void *map;                                 /**< Mapped file holding the
+                                                table, or NULL. */
+  size_t map_len;                            /**< Length of mapped file. */
+
+};
+typedef struct FUNCTION_NAME(_vec_jfsmul_tab, TAB_POSTFIX)
+FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX); /* Magic references. */
+
+void
+FUNCTION_NAME(vec_jfsmul_init, POSTFIX)
+     (FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table,
+      CURVE *curve,
+      size_t bases_len,
+      size_t len,
+      size_t max_bytes);
+
+void
+FUNCTION_NAME(vec_jfsmul_clear_free, POSTFIX)
+     (FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table);
+
+void
+FUNCTION_NAME(vec_jfsmul_prcmp, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table,
+      FIELD_ELEMENT_VAR *basesx, FIELD_ELEMENT_VAR *basesy,
+      FIELD_ELEMENT_VAR *basesz);
+
+void
+FUNCTION_NAME(vec_jfsmul_cmp, POSTFIX)
+     (FIELD_ELEMENT_VAR ropx, FIELD_ELEMENT_VAR ropy, FIELD_ELEMENT_VAR ropz,
+      CURVE *curve, FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table,
+      mpz_t *scalars);
+
+int
+FUNCTION_NAME(vec_jfsmul_save, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table,
+      const char *path);
+
+FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *
+FUNCTION_NAME(vec_jfsmul_load, POSTFIX)
+     (CURVE *curve,
+      const char *path);
+
+#endif /* JFSMUL_H_TEMPLATE_H */
@@ -0,0 +1,54 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <gmp.h>
+#include "vec.h"
+
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_aff(vec_curve *curve,
+                       mpz_t *basesx, mpz_t *basesy,
+                       size_t bases_len,
+                       size_t len,
+                       size_t max_bytes)
+{
+  size_t i;
+  vec_jfsmul_tab_ptr ptr;
+
+  mpz_t *basesz = vec_array_alloc_init(bases_len);
+
+  for (i = 0; i < bases_len; i++) {
+    vec_affj(basesx[i], basesy[i], basesz[i]);
+  }
+
+  ptr = curve->jfsmul_precomp(curve,
+                              basesx, basesy, basesz,
+                              bases_len, len, max_bytes);
+
+  vec_array_clear_free(basesz, bases_len);
+
+  return ptr;
+}
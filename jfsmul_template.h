@@ -0,0 +1,209 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "templates.h"
+
+#include "jfsmul_h_template.h"
+#include "jsmul_h_template.h"
+
+void
+FUNCTION_NAME(vec_jfsmul_init, POSTFIX)
+     (FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table,
+      CURVE *curve,
+      size_t bases_len,
+      size_t len,
+      size_t max_bytes)
+{
+  size_t block_width;
+
+  table->bit_len = mpz_sizeinbase(curve->n, 2);
+
+  block_width = vec_fsmul_block_width((int)table->bit_len, bases_len,
+                                      len > 0 ? len : 1,
+                                      3 * FIELD_ELEMENT_VAR_BYTES(curve),
+                                      max_bytes);
+
+  FUNCTION_NAME(vec_jsmul_init, POSTFIX)(table->tab,
+                                           curve,
+                                           bases_len,
+                                           block_width);
+  table->map = NULL;
+  table->map_len = 0;
+}
+
+void
+FUNCTION_NAME(vec_jfsmul_clear_free, POSTFIX)
+     (FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table)
+{
+  if (table->map == NULL)
+    {
+      FUNCTION_NAME(vec_jsmul_clear, POSTFIX)(table->tab);
+    }
+  else
+    {
+      FUNCTION_NAME(vec_jsmul_file_unmap, POSTFIX)(table->tab, table->map,
+                                                   table->map_len);
+    }
+  free(table);
+}
+
+void
+FUNCTION_NAME(vec_jfsmul_prcmp, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table,
+      FIELD_ELEMENT_VAR *basesx, FIELD_ELEMENT_VAR *basesy,
+      FIELD_ELEMENT_VAR *basesz)
+{
+  FUNCTION_NAME(vec_jsmul_precomp, POSTFIX)(table->tab,
+                                              curve,
+                                              basesx, basesy, basesz);
+
+  /* The table is used for many multiplications, so the conversion to
+     affine coordinates is always worthwhile. */
+  FUNCTION_NAME(vec_jsmul_normalize, POSTFIX)(table->tab, curve);
+}
+
+void
+FUNCTION_NAME(vec_jfsmul_cmp, POSTFIX)
+     (FIELD_ELEMENT_VAR ropx, FIELD_ELEMENT_VAR ropy, FIELD_ELEMENT_VAR ropz,
+      CURVE *curve, FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table,
+      mpz_t *scalars)
+{
+  size_t i;
+  size_t bitlen;
+  size_t max_scalar_bitlen;
+  size_t len = table->tab->len;
+  mpz_t *reduced;
+  uint16_t *masks;
+  vec_workspace *ws = vec_workspace_get();
+
+  /* Scalars that are negative or longer than the order are reduced
+     into integers of the workspace. */
+  for (i = 0; i < len; i++)
+    {
+      if (mpz_sgn(scalars[i]) < 0
+          || mpz_sizeinbase(scalars[i], 2) > table->bit_len)
+        {
+          break;
+        }
+    }
+  if (i < len)
+    {
+      reduced = vec_workspace_slices(ws, len, table->bit_len);
+      for (i = 0; i < len; i++)
+        {
+          mpz_mod(reduced[i], scalars[i], curve->n);
+        }
+      scalars = reduced;
+    }
+
+  /* Short scalars, e.g., challenges of proofs, need fewer
+     doublings. */
+  max_scalar_bitlen = 0;
+  for (i = 0; i < len; i++)
+    {
+      bitlen = mpz_sizeinbase(scalars[i], 2);
+      if (bitlen > max_scalar_bitlen)
+        {
+          max_scalar_bitlen = bitlen;
+        }
+    }
+
+  masks = vec_workspace_masks(ws, max_scalar_bitlen * table->tab->tabs_len
+                              + 1);
+  vec_scalars_transpose(masks, scalars, len, table->tab->block_width,
+                        max_scalar_bitlen);
+
+  FUNCTION_NAME(vec_jsmul_table, POSTFIX)(ropx, ropy, ropz,
+                                            curve,
+                                            table->tab,
+                                            masks,
+                                            max_scalar_bitlen);
+}
+
+int
+FUNCTION_NAME(vec_jfsmul_save, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table,
+      const char *path)
+{
+  vec_jfsmul_file_header header;
+
+  memset(&header, 0, sizeof(vec_jfsmul_file_header));
+  FUNCTION_NAME(vec_jsmul_file_prefix_init, POSTFIX)
+    (&header.prefix, curve, VEC_JFSMUL_FILE_MAGIC, VEC_JFSMUL_FILE_VERSION);
+  header.len = table->tab->len;
+  header.block_width = table->tab->block_width;
+  header.tabs_len = table->tab->tabs_len;
+  header.affine = table->tab->affine;
+
+  return FUNCTION_NAME(vec_jsmul_file_save, POSTFIX)
+    (curve, table->tab, &header, sizeof(vec_jfsmul_file_header), path);
+}
+
+FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *
+FUNCTION_NAME(vec_jfsmul_load, POSTFIX)
+     (CURVE *curve,
+      const char *path)
+{
+  void *map;
+  size_t map_len;
+  vec_jfsmul_file_header header;
+  FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *table;
+
+  if (FUNCTION_NAME(vec_jsmul_file_map, POSTFIX)
+      (&map, &map_len, &header, sizeof(vec_jfsmul_file_header), curve,
+       VEC_JFSMUL_FILE_MAGIC, VEC_JFSMUL_FILE_VERSION, path) != 0)
+    {
+      return NULL;
+    }
+
+  table = (FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX) *)
+    malloc(sizeof(FUNCTION_NAME(vec_jfsmul_tab, TAB_POSTFIX)));
+
+  /* The number of subtables must match the number of bases. */
+  if (header.block_width == 0
+      || header.tabs_len != (header.len + header.block_width - 1)
+                            / header.block_width
+      || FUNCTION_NAME(vec_jsmul_file_attach, POSTFIX)
+         (table->tab, curve, map, map_len, sizeof(vec_jfsmul_file_header),
+          header.len, header.block_width, header.affine) != 0)
+    {
+      free(table);
+      munmap(map, map_len);
+      return NULL;
+    }
+
+  table->bit_len = mpz_sizeinbase(curve->n, 2);
+  table->map = map;
+  table->map_len = map_len;
+
+  return table;
+}
@@ -34,14 +34,10 @@ vec_jmul_aff(mpz_t rx, mpz_t ry,
              mpz_t x, mpz_t y,
              mpz_t scalar) {
 
-  mpz_t RZ;
-
   mpz_t X;
   mpz_t Y;
   mpz_t Z;
 
-  mpz_init(RZ);
-
   mpz_init(X);
   mpz_init(Y);
   mpz_init(Z);
@@ -51,17 +47,13 @@ vec_jmul_aff(mpz_t rx, mpz_t ry,
 
   vec_affj(X, Y, Z);
 
-  curve->jmul(rx, ry, RZ,
-              curve,
-              X, Y, Z,
-              scalar);
-
-  vec_jaff(rx, ry, RZ, curve);
+  curve->jmul_aff(rx, ry,
+                  curve,
+                  X, Y, Z,
+                  scalar);
 
   mpz_clear(Z);
   mpz_clear(Y);
   mpz_clear(X);
 
-  mpz_clear(RZ);
-
 }
@@ -29,9 +29,8 @@
 #include "templates.h"
 
 /*
- * Multiplication with sliding window. In theory this could be
- * slightly faster using wNAFs, but the difference would be very
- * small.
+ * Multiplication with sliding window. See vec_jmulwnaf for a variant
+ * with signed digits.
  */
 void
 FUNCTION_NAME(vec_jmulsw, POSTFIX)
@@ -46,8 +45,6 @@ FUNCTION_NAME(vec_jmulsw, POSTFIX)
   int b;
   int size;
   int width;
-  float cost;
-  float new_cost;
   int bit_length;
   int block;
 
@@ -65,19 +62,7 @@ FUNCTION_NAME(vec_jmulsw, POSTFIX)
   bit_length = (int)mpz_sizeinbase(scalar, 2);
 
   /* Determine optimal width of table. */
-  width = 1;
-  new_cost = bit_length / 2;
-
-  do {
-
-    width++;
-    cost = new_cost;
-    new_cost = (1 << (width - 1)) +
-      ((float)((1 << width) - 1) * bit_length) / ((1 << width) * width);
-
-  } while (new_cost < cost);
-
-  width--;
+  width = vec_mul_window_width(bit_length, 0);
 
   size = (1 << (width - 1));
 
@@ -0,0 +1,167 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef FIELD_ELEMENT
+
+#include <stdlib.h>
+#include "templates.h"
+
+/*
+ * Multiplication with a width-w non-adjacent form of the scalar. The
+ * negative of a point is given by negating its y-coordinate, so the
+ * table only holds the odd multiples P, 3P, ..., (2^(w - 1) - 1)P,
+ * i.e., half as many as for sliding window with the same width, and
+ * a point is added for about one in w + 1 bits.
+ */
+void
+FUNCTION_NAME(vec_jmulwnaf, POSTFIX)
+     (FIELD_ELEMENT RX, FIELD_ELEMENT RY, FIELD_ELEMENT RZ,
+      CURVE *curve,
+      FIELD_ELEMENT_VAR X, FIELD_ELEMENT_VAR Y, FIELD_ELEMENT_VAR Z,
+      mpz_t scalar)
+{
+  int i;
+  int size;
+  int tab_len;
+  int width;
+  int digit;
+  int bit_length;
+  signed char *digits;
+
+  FIELD_ELEMENT_VAR *xtab;
+  FIELD_ELEMENT_VAR *ytab;
+  FIELD_ELEMENT_VAR *ztab;
+  FIELD_ELEMENT_VAR *nytab;
+
+  SCRATCH(scratch);
+  VEC_STATS_TIMER(timer);
+
+  VEC_UNUSED(curve);
+
+  SCRATCH_INIT(scratch);
+
+  /* Determine bit length. */
+  bit_length = (int)mpz_sizeinbase(scalar, 2);
+
+  /* Determine optimal width of table. */
+  width = vec_mul_window_width(bit_length, 1);
+
+  size = (1 << (width - 2));
+
+  /* The last entry of the table is only used during precomputation. */
+  tab_len = size + 1;
+
+  /* Recode scalar. */
+  digits = (signed char *)malloc(bit_length + 1);
+  i = (int)vec_wnaf(digits, scalar, width) - 1;
+
+  /* Precompute table. */
+  VEC_STATS_START(timer);
+
+  xtab = ARRAY_MALLOC_INIT(tab_len);
+  ytab = ARRAY_MALLOC_INIT(tab_len);
+  ztab = ARRAY_MALLOC_INIT(tab_len);
+  nytab = ARRAY_MALLOC_INIT(size);
+  VEC_STATS_ALLOC(curve, 4, (3 * tab_len + size) * sizeof(FIELD_ELEMENT_VAR));
+  VEC_STATS_ADD(curve, table_entries, size);
+
+  /* Double (X, Y, Z) to compute table. */
+  JDBL_VAR(scratch,
+           xtab[size], ytab[size], ztab[size],
+           curve,
+           X, Y, Z);
+
+  /* Initialize with basis. */
+  FIELD_ELEMENT_VAR_SET(xtab[0], ytab[0], ztab[0], X, Y, Z);
+
+  /* Build table */
+  for (digit = 1; digit < size; digit++) {
+
+    JADD_VAR(scratch,
+             xtab[digit], ytab[digit], ztab[digit],
+             curve,
+             xtab[digit - 1], ytab[digit - 1], ztab[digit - 1],
+             xtab[size], ytab[size], ztab[size]);
+  }
+
+  /* Negate the y-coordinates once instead of for every negative
+     digit. */
+  for (digit = 0; digit < size; digit++)
+    {
+      FIELD_ELEMENT_VAR_NEG(nytab[digit], ytab[digit], curve);
+    }
+
+  VEC_STATS_STOP(curve, precomp_cycles, timer);
+  VEC_STATS_START(timer);
+
+  /* Initialize with unit. */
+  FIELD_ELEMENT_UNIT(RX, RY, RZ);
+
+  /* Compute output. */
+  for (; i >= 0; i--)
+    {
+      JDBL(scratch,
+           RX, RY, RZ,
+           curve,
+           RX, RY, RZ);
+
+      digit = digits[i];
+
+      if (digit > 0)
+        {
+          digit >>= 1;
+
+          JADD(scratch,
+               RX, RY, RZ,
+               curve,
+               RX, RY, RZ,
+               xtab[digit], ytab[digit], ztab[digit]);
+        }
+      else if (digit < 0)
+        {
+          digit = (-digit) >> 1;
+
+          JADD(scratch,
+               RX, RY, RZ,
+               curve,
+               RX, RY, RZ,
+               xtab[digit], nytab[digit], ztab[digit]);
+        }
+    }
+
+  VEC_STATS_STOP(curve, main_cycles, timer);
+
+  ARRAY_CLEAR_FREE(nytab, size);
+  ARRAY_CLEAR_FREE(ztab, tab_len);
+  ARRAY_CLEAR_FREE(ytab, tab_len);
+  ARRAY_CLEAR_FREE(xtab, tab_len);
+
+  free(digits);
+
+  SCRATCH_CLEAR(scratch);
+}
+
+#endif
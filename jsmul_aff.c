@@ -37,24 +37,17 @@ vec_jsmul_aff(mpz_t ropx, mpz_t ropy,
 {
   size_t i;
 
-  mpz_t ropz;
   mpz_t *basesz = vec_array_alloc_init(len);
 
-  mpz_init(ropz);
-
   for (i = 0; i < len; i++) {
     vec_affj(basesx[i], basesy[i], basesz[i]);
   }
 
-  curve->jsmul(ropx, ropy, ropz,
-               curve,
-               basesx, basesy, basesz,
-               exponents,
-               len);
-
-  vec_jaff(ropx, ropy, ropz, curve);
-
-  mpz_clear(ropz);
+  curve->jsmul_aff(ropx, ropy,
+                   curve,
+                   basesx, basesy, basesz,
+                   exponents,
+                   len);
 
   vec_array_clear_free(basesz, len);
 }
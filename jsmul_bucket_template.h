@@ -0,0 +1,242 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "templates.h"
+
+/*
+ * Multi-scalar multiplication with buckets, also known as
+ * Pippenger's method. The scalars are cut into windows of the given
+ * width. For each window, every base is added to the bucket indexed
+ * by its digit, and the buckets are then summed with a running sum,
+ * which weighs the ith bucket by i. Thus, the cost per base is
+ * roughly one addition per window, and the cost of summing the
+ * buckets is amortized over all bases. This beats the block-wise
+ * tables of vec_jsmul for large numbers of bases.
+ */
+
+/*
+ * Returns the digit of the given width starting at the given bit
+ * index of a non-negative integer.
+ */
+static size_t
+bucket_digit(mpz_t op, size_t index, size_t width)
+{
+  size_t size = mpz_size(op);
+  size_t limb_index = index / GMP_NUMB_BITS;
+  size_t shift = index % GMP_NUMB_BITS;
+  mp_limb_t digit;
+
+  if (limb_index >= size)
+    {
+      return 0;
+    }
+
+  digit = mpz_getlimbn(op, limb_index) >> shift;
+
+  /* The digit may straddle two limbs. */
+  if (shift + width > GMP_NUMB_BITS && limb_index + 1 < size)
+    {
+      digit |= mpz_getlimbn(op, limb_index + 1) << (GMP_NUMB_BITS - shift);
+    }
+
+  return (size_t)(digit & ((((mp_limb_t)1) << width) - 1));
+}
+
+void
+FUNCTION_NAME(vec_jsmul_bucket_windows, POSTFIX)
+     (FIELD_ELEMENT ropx, FIELD_ELEMENT ropy, FIELD_ELEMENT ropz,
+      CURVE *curve,
+      FIELD_ELEMENT_VAR *basesx, FIELD_ELEMENT_VAR *basesy,
+      FIELD_ELEMENT_VAR *basesz,
+      mpz_t *scalars,
+      size_t len,
+      size_t width,
+      size_t max_scalar_bitlen)
+{
+  size_t i;
+  size_t j;
+  size_t digit;
+  size_t index;
+  size_t buckets_len = (((size_t)1) << width) - 1;
+
+  FIELD_ELEMENT_VAR *bucketsx;
+  FIELD_ELEMENT_VAR *bucketsy;
+  FIELD_ELEMENT_VAR *bucketsz;
+
+  FIELD_ELEMENT_VAR sumx;
+  FIELD_ELEMENT_VAR sumy;
+  FIELD_ELEMENT_VAR sumz;
+
+  FIELD_ELEMENT_VAR accx;
+  FIELD_ELEMENT_VAR accy;
+  FIELD_ELEMENT_VAR accz;
+
+  SCRATCH(scratch);
+  VEC_STATS_TIMER(timer);
+
+  VEC_UNUSED(curve);
+
+  SCRATCH_INIT(scratch);
+
+  FIELD_ELEMENT_VAR_INIT(sumx);
+  FIELD_ELEMENT_VAR_INIT(sumy);
+  FIELD_ELEMENT_VAR_INIT(sumz);
+
+  FIELD_ELEMENT_VAR_INIT(accx);
+  FIELD_ELEMENT_VAR_INIT(accy);
+  FIELD_ELEMENT_VAR_INIT(accz);
+
+  /* Bucket i holds the sum of the bases with digit i + 1. */
+  bucketsx = ARRAY_MALLOC_INIT(buckets_len);
+  bucketsy = ARRAY_MALLOC_INIT(buckets_len);
+  bucketsz = ARRAY_MALLOC_INIT(buckets_len);
+  VEC_STATS_ALLOC(curve, 3, 3 * buckets_len * sizeof(FIELD_ELEMENT_VAR));
+
+  /* There is no table, so all the work is done in the main loop. */
+  VEC_STATS_START(timer);
+
+  /* Initialize result to unit element. */
+  FIELD_ELEMENT_UNIT(ropx, ropy, ropz);
+
+  /* Process the windows starting with the most significant. */
+  index = ((max_scalar_bitlen + width - 1) / width) * width;
+
+  while (index > 0)
+    {
+      index -= width;
+
+      /* Shift the result so far by the width of a window. */
+      for (i = 0; i < width; i++)
+        {
+          JDBL(scratch,
+               ropx, ropy, ropz,
+               curve,
+               ropx, ropy, ropz);
+        }
+
+      /* Empty all buckets. */
+      for (j = 0; j < buckets_len; j++)
+        {
+          FIELD_ELEMENT_VAR_UNIT(bucketsx[j], bucketsy[j], bucketsz[j]);
+        }
+
+      /* Sort the bases into buckets. */
+      for (i = 0; i < len; i++)
+        {
+          digit = bucket_digit(scalars[i], index, width);
+
+          if (digit > 0)
+            {
+              digit--;
+              JADD_VAR(scratch,
+                       bucketsx[digit], bucketsy[digit], bucketsz[digit],
+                       curve,
+                       bucketsx[digit], bucketsy[digit], bucketsz[digit],
+                       basesx[i], basesy[i], basesz[i]);
+            }
+        }
+
+      /* Sum the buckets weighted by their digits using a running
+         sum, i.e., acc = sum_j (j + 1) * bucket_j. */
+      FIELD_ELEMENT_VAR_UNIT(sumx, sumy, sumz);
+      FIELD_ELEMENT_VAR_UNIT(accx, accy, accz);
+
+      j = buckets_len;
+      while (j > 0)
+        {
+          j--;
+
+          JADD_VAR(scratch,
+                   sumx, sumy, sumz,
+                   curve,
+                   sumx, sumy, sumz,
+                   bucketsx[j], bucketsy[j], bucketsz[j]);
+          JADD_VAR(scratch,
+                   accx, accy, accz,
+                   curve,
+                   accx, accy, accz,
+                   sumx, sumy, sumz);
+        }
+
+      /* Add with result so far. */
+      JADD(scratch,
+           ropx, ropy, ropz,
+           curve,
+           ropx, ropy, ropz,
+           accx, accy, accz);
+    }
+
+  VEC_STATS_STOP(curve, main_cycles, timer);
+
+  ARRAY_CLEAR_FREE(bucketsz, buckets_len);
+  ARRAY_CLEAR_FREE(bucketsy, buckets_len);
+  ARRAY_CLEAR_FREE(bucketsx, buckets_len);
+
+  FIELD_ELEMENT_VAR_CLEAR(accz);
+  FIELD_ELEMENT_VAR_CLEAR(accy);
+  FIELD_ELEMENT_VAR_CLEAR(accx);
+
+  FIELD_ELEMENT_VAR_CLEAR(sumz);
+  FIELD_ELEMENT_VAR_CLEAR(sumy);
+  FIELD_ELEMENT_VAR_CLEAR(sumx);
+
+  SCRATCH_CLEAR(scratch);
+}
+
+void
+FUNCTION_NAME(vec_jsmul_bucket, POSTFIX)
+     (FIELD_ELEMENT ropx, FIELD_ELEMENT ropy, FIELD_ELEMENT ropz,
+      vec_curve *curve,
+      FIELD_ELEMENT_VAR *basesx, FIELD_ELEMENT_VAR *basesy,
+      FIELD_ELEMENT_VAR *basesz,
+      mpz_t *scalars,
+      size_t len)
+{
+  size_t i;
+  size_t bitlen;
+  size_t max_scalar_bitlen;
+
+  /* Compute the maximal bit length among the scalars. */
+  max_scalar_bitlen = 0;
+  for (i = 0; i < len; i++)
+    {
+      bitlen = mpz_sizeinbase(scalars[i], 2);
+      if (bitlen > max_scalar_bitlen)
+        {
+          max_scalar_bitlen = bitlen;
+        }
+    }
+
+  FUNCTION_NAME(vec_jsmul_bucket_windows, POSTFIX)
+    (ropx, ropy, ropz,
+     curve,
+     basesx, basesy, basesz,
+     scalars,
+     len,
+     vec_bucket_width(max_scalar_bitlen, len),
+     max_scalar_bitlen);
+}
@@ -0,0 +1,101 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef JSMUL_FILE_H_TEMPLATE_H
+#define JSMUL_FILE_H_TEMPLATE_H
+
+#include <stdint.h>
+#include <gmp.h>
+#include "vec.h"
+#include "templates.h"
+#include "jsmul_h_template.h"
+
+/*
+ * Files holding simultaneous multiplication tables, which are used by
+ * both fixed basis multiplication and simultaneous multiplication
+ * with fixed bases. A header that starts with the common prefix below
+ * is followed by the x-, y-, and z-coordinates of the entries of each
+ * subtable in turn, each stored as a contiguous array of elements in
+ * the native representation of the backend. The header and each
+ * array start at a multiple of VEC_JSMUL_FILE_ALIGN bytes and every
+ * array is padded to the size of an array of a full subtable, so
+ * that the arrays can be used directly from a read-only memory
+ * mapping of the file.
+ */
+#define VEC_JSMUL_FILE_BYTE_ORDER 0x01020304
+#define VEC_JSMUL_FILE_ALIGN 64
+
+/* Rounds up to the alignment of arrays in the file. */
+#define VEC_JSMUL_FILE_ROUND(x) \
+  ((((x) + VEC_JSMUL_FILE_ALIGN - 1) / VEC_JSMUL_FILE_ALIGN) \
+   * VEC_JSMUL_FILE_ALIGN)
+
+typedef struct
+{
+  char magic[8];              /**< Identifies the file format. */
+  uint32_t version;           /**< Version of the file format. */
+  uint32_t byte_order;        /**< Detects files of other platforms. */
+  char backend[24];           /**< Native representation of elements. */
+  char curve[32];             /**< Name of the curve. */
+  uint64_t element_bytes;     /**< Size of a stored element. */
+} vec_jsmul_file_prefix;
+
+void
+FUNCTION_NAME(vec_jsmul_file_prefix_init, POSTFIX)
+     (vec_jsmul_file_prefix *prefix,
+      CURVE *curve,
+      const char *magic,
+      uint32_t version);
+
+int
+FUNCTION_NAME(vec_jsmul_file_save, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) tab,
+      const void *header, size_t header_size,
+      const char *path);
+
+int
+FUNCTION_NAME(vec_jsmul_file_map, POSTFIX)
+     (void **map, size_t *map_len,
+      void *header, size_t header_size,
+      CURVE *curve,
+      const char *magic,
+      uint32_t version,
+      const char *path);
+
+int
+FUNCTION_NAME(vec_jsmul_file_attach, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) tab,
+      CURVE *curve,
+      void *map, size_t map_len, size_t header_size,
+      size_t len, size_t block_width, uint64_t affine);
+
+void
+FUNCTION_NAME(vec_jsmul_file_unmap, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) tab,
+      void *map, size_t map_len);
+
+#endif /* JSMUL_FILE_H_TEMPLATE_H */
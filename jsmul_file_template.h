@@ -0,0 +1,314 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "templates.h"
+
+#include "jsmul_file_h_template.h"
+
+void
+FUNCTION_NAME(vec_jsmul_file_prefix_init, POSTFIX)
+     (vec_jsmul_file_prefix *prefix,
+      CURVE *curve,
+      const char *magic,
+      uint32_t version)
+{
+  memset(prefix, 0, sizeof(vec_jsmul_file_prefix));
+  memcpy(prefix->magic, magic, sizeof(prefix->magic));
+  prefix->version = version;
+  prefix->byte_order = VEC_JSMUL_FILE_BYTE_ORDER;
+  strncpy(prefix->backend, STRING_NAME(TAB_POSTFIX),
+          sizeof(prefix->backend) - 1);
+  strncpy(prefix->curve, curve->name, sizeof(prefix->curve) - 1);
+  prefix->element_bytes = FIELD_ELEMENT_VAR_BYTES(curve);
+}
+
+/* Writes an array of elements followed by zeros up to the given
+   length in bytes. */
+static int
+FUNCTION_NAME(vec_jsmul_file_write, POSTFIX)
+     (FILE *fp, CURVE *curve, FIELD_ELEMENT_VAR *array, size_t len,
+      size_t element_bytes, size_t array_len, unsigned char *buf)
+{
+  size_t i;
+  size_t padding;
+
+  /* Not every backend needs the curve to write an element. */
+  VEC_UNUSED(curve);
+
+  for (i = 0; i < len; i++)
+    {
+      FIELD_ELEMENT_VAR_WRITE(buf, array[i], curve);
+      if (fwrite(buf, element_bytes, 1, fp) != 1)
+        {
+          return -1;
+        }
+    }
+
+  memset(buf, 0, element_bytes);
+  for (padding = array_len - len * element_bytes; padding > 0;
+       padding -= element_bytes < padding ? element_bytes : padding)
+    {
+      if (fwrite(buf, element_bytes < padding ? element_bytes : padding,
+                 1, fp) != 1)
+        {
+          return -1;
+        }
+    }
+  return 0;
+}
+
+/* Writes the header, which starts with a prefix, followed by the
+   subtables of the table. Returns 0 on success and -1 on failure. */
+int
+FUNCTION_NAME(vec_jsmul_file_save, POSTFIX)
+     (CURVE *curve,
+      FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) tab,
+      const void *header, size_t header_size,
+      const char *path)
+{
+  FILE *fp;
+  int res;
+  size_t i;
+  size_t block_width;
+  size_t element_bytes;
+  size_t header_len;
+  size_t array_len;
+  unsigned char *buf;
+
+  element_bytes = FIELD_ELEMENT_VAR_BYTES(curve);
+  header_len = VEC_JSMUL_FILE_ROUND(header_size);
+  array_len = VEC_JSMUL_FILE_ROUND((((size_t)1) << tab->block_width)
+                                   * element_bytes);
+
+  fp = fopen(path, "wb");
+  if (fp == NULL)
+    {
+      return -1;
+    }
+
+  /* The buffer holds the header or an element. */
+  buf = (unsigned char *)calloc(element_bytes > header_len
+                                ? element_bytes : header_len, 1);
+
+  memcpy(buf, header, header_size);
+  res = fwrite(buf, header_len, 1, fp) == 1 ? 0 : -1;
+
+  block_width = tab->block_width;
+  for (i = 0; res == 0 && i < tab->tabs_len; i++)
+    {
+
+      /* Last block may have smaller width, but it is never zero. */
+      if (i == tab->tabs_len - 1)
+        {
+          block_width = tab->len - i * tab->block_width;
+        }
+
+      res = FUNCTION_NAME(vec_jsmul_file_write, POSTFIX)
+        (fp, curve, tab->tabsx[i], ((size_t)1) << block_width,
+         element_bytes, array_len, buf);
+      if (res == 0)
+        {
+          res = FUNCTION_NAME(vec_jsmul_file_write, POSTFIX)
+            (fp, curve, tab->tabsy[i], ((size_t)1) << block_width,
+             element_bytes, array_len, buf);
+        }
+      if (res == 0)
+        {
+          res = FUNCTION_NAME(vec_jsmul_file_write, POSTFIX)
+            (fp, curve, tab->tabsz[i], ((size_t)1) << block_width,
+             element_bytes, array_len, buf);
+        }
+    }
+
+  free(buf);
+
+  if (fclose(fp) != 0)
+    {
+      res = -1;
+    }
+  return res;
+}
+
+/* Maps the file and copies its header. Returns 0 if the prefix of the
+   header was written by the same backend on the same platform for the
+   curve with the given magic and version, and -1 otherwise, in which
+   case nothing is mapped. */
+int
+FUNCTION_NAME(vec_jsmul_file_map, POSTFIX)
+     (void **map, size_t *map_len,
+      void *header, size_t header_size,
+      CURVE *curve,
+      const char *magic,
+      uint32_t version,
+      const char *path)
+{
+  int fd;
+  struct stat st;
+  vec_jsmul_file_prefix expected;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    {
+      return -1;
+    }
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < header_size)
+    {
+      close(fd);
+      return -1;
+    }
+  *map_len = (size_t)st.st_size;
+
+  /* Pages are shared by all processes mapping the same file. */
+  *map = mmap(NULL, *map_len, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (*map == MAP_FAILED)
+    {
+      return -1;
+    }
+
+  memcpy(header, *map, header_size);
+
+  FUNCTION_NAME(vec_jsmul_file_prefix_init, POSTFIX)(&expected, curve,
+                                                     magic, version);
+
+  if (memcmp(header, &expected, sizeof(vec_jsmul_file_prefix)) != 0)
+    {
+      munmap(*map, *map_len);
+      return -1;
+    }
+  return 0;
+}
+
+/* Lets the table refer to the arrays of a mapped file with a header
+   of the given size. Returns 0 on success and -1 if the table does not
+   fit the transposed scalars or the file is too short to hold it, in
+   which case the table is left untouched. */
+int
+FUNCTION_NAME(vec_jsmul_file_attach, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) tab,
+      CURVE *curve,
+      void *map, size_t map_len, size_t header_size,
+      size_t len, size_t block_width, uint64_t affine)
+{
+  size_t i;
+  size_t tabs_len;
+  size_t header_len;
+  size_t array_len;
+  size_t width;
+  size_t tab_len;
+  unsigned char *arrays;
+
+  /* The masks of the main loop limit the width. */
+  if (block_width == 0
+      || block_width > VEC_TRANSPOSE_MAX_WIDTH
+      || len < block_width
+      || affine > 1)
+    {
+      return -1;
+    }
+
+  tabs_len = (len + block_width - 1) / block_width;
+  header_len = VEC_JSMUL_FILE_ROUND(header_size);
+  array_len = VEC_JSMUL_FILE_ROUND((((size_t)1) << block_width)
+                                   * FIELD_ELEMENT_VAR_BYTES(curve));
+
+  if (map_len < header_len
+      || tabs_len > (map_len - header_len) / (3 * array_len))
+    {
+      return -1;
+    }
+
+  tab->curve = curve;
+  tab->len = len;
+  tab->block_width = block_width;
+  tab->tabs_len = tabs_len;
+  tab->affine = (int)affine;
+  tab->block = NULL;
+  tab->block_bytes = 0;
+
+  tab->tabsx =
+    (FIELD_ELEMENT_VAR **)malloc(tabs_len * sizeof(FIELD_ELEMENT_VAR *));
+  tab->tabsy =
+    (FIELD_ELEMENT_VAR **)malloc(tabs_len * sizeof(FIELD_ELEMENT_VAR *));
+  tab->tabsz =
+    (FIELD_ELEMENT_VAR **)malloc(tabs_len * sizeof(FIELD_ELEMENT_VAR *));
+
+  arrays = (unsigned char *)map + header_len;
+  width = block_width;
+
+  for (i = 0; i < tabs_len; i++)
+    {
+
+      /* Last block may have smaller width, but it is never zero. */
+      if (i == tabs_len - 1)
+        {
+          width = len - i * block_width;
+        }
+      tab_len = ((size_t)1) << width;
+
+      tab->tabsx[i] = ARRAY_MAP(arrays, tab_len, curve);
+      tab->tabsy[i] = ARRAY_MAP(arrays + array_len, tab_len, curve);
+      tab->tabsz[i] = ARRAY_MAP(arrays + 2 * array_len, tab_len, curve);
+
+      arrays += 3 * array_len;
+    }
+
+  /* Hack to avoid unused-variable warnings for the case where
+     ARRAY_MAP expands to an expression not involving tab_len. */
+  VEC_UNUSED(tab_len);
+
+  return 0;
+}
+
+/* Releases the arrays of a table attached to a mapped file and the
+   mapping itself. */
+void
+FUNCTION_NAME(vec_jsmul_file_unmap, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) tab,
+      void *map, size_t map_len)
+{
+  size_t i;
+
+  for (i = 0; i < tab->tabs_len; i++)
+    {
+      ARRAY_UNMAP(tab->tabsx[i]);
+      ARRAY_UNMAP(tab->tabsy[i]);
+      ARRAY_UNMAP(tab->tabsz[i]);
+    }
+
+  free(tab->tabsx);
+  free(tab->tabsy);
+  free(tab->tabsz);
+
+  munmap(map, map_len);
+}
@@ -27,6 +27,7 @@
 #ifndef JSMUL_H_TEMPLATE_H
 #define JSMUL_H_TEMPLATE_H
 
+#include <stdint.h>
 #include <gmp.h>
 #include "vec.h"
 #include "templates.h"
@@ -46,6 +47,11 @@ typedef struct
                                  block. */
   FIELD_ELEMENT_VAR **tabsz;  /**< Table of tables, one sub-table for each
                                  block. */
+  int affine;                 /**< Indicates that all finite entries have
+                                 z-coordinate one. */
+  void *block;                /**< Memory holding all sub-tables, or NULL
+                                 if they are allocated separately. */
+  size_t block_bytes;         /**< Size of the memory in bytes. */
 
 } FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX)[1]; /* Magic references. */
 
@@ -67,12 +73,35 @@ FUNCTION_NAME(vec_jsmul_precomp, POSTFIX)
       FIELD_ELEMENT_VAR *basesx, FIELD_ELEMENT_VAR *basesy,
       FIELD_ELEMENT_VAR *basesz);
 
+void
+FUNCTION_NAME(vec_jsmul_normalize, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      CURVE *curve);
+
+/* Same as vec_jsmul_precomp, except that the given number of threads
+   is used, or one thread per online core if it is zero. */
+void
+FUNCTION_NAME(vec_jsmul_precomp_par, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      CURVE *curve,
+      FIELD_ELEMENT_VAR *basesx, FIELD_ELEMENT_VAR *basesy,
+      FIELD_ELEMENT_VAR *basesz,
+      size_t threads);
+
+/* Same as vec_jsmul_normalize, except that the given number of
+   threads is used, or one thread per online core if it is zero. */
+void
+FUNCTION_NAME(vec_jsmul_normalize_par, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      CURVE *curve,
+      size_t threads);
+
 void
 FUNCTION_NAME(vec_jsmul_table, POSTFIX)
      (FIELD_ELEMENT_VAR ropx, FIELD_ELEMENT_VAR ropy, FIELD_ELEMENT_VAR ropz,
       CURVE *curve,
       FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
-      mpz_t *scalars,
+      uint16_t *masks,
       size_t max_scalar_bitlen);
 
 void
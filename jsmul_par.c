@@ -0,0 +1,164 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <gmp.h>
+#include "vec.h"
+
+/* Granularity of the partition of the input among threads. This
+   matches the batch length used by the simultaneous multiplication
+   routines, so that no thread processes a needlessly short batch. */
+#define VEC_JSMUL_PAR_BATCH_LEN 100
+
+/*
+ * Work order of a single thread. Each thread computes the
+ * simultaneous multiplication of a contiguous range of the input
+ * using the simultaneous multiplication function of the curve. The
+ * function only reads the curve and allocates its own scratch space
+ * and tables, so no synchronization is needed.
+ */
+typedef struct
+{
+  vec_curve *curve;
+  mpz_t *basesx;
+  mpz_t *basesy;
+  mpz_t *basesz;
+  mpz_t *scalars;
+  size_t len;
+  mpz_t ropx;
+  mpz_t ropy;
+  mpz_t ropz;
+} vec_jsmul_par_job;
+
+static void *
+vec_jsmul_par_worker(void *arg)
+{
+  vec_jsmul_par_job *job = (vec_jsmul_par_job *)arg;
+
+  job->curve->jsmul(job->ropx, job->ropy, job->ropz,
+                    job->curve,
+                    job->basesx, job->basesy, job->basesz,
+                    job->scalars,
+                    job->len);
+  return NULL;
+}
+
+void
+vec_jsmul_par(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+              vec_curve *curve,
+              mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+              mpz_t *scalars,
+              size_t len,
+              size_t threads)
+{
+  size_t i;
+  size_t step;
+  size_t batches;
+  size_t batches_per_job;
+  size_t offset;
+  size_t jobs_len;
+  vec_jsmul_par_job *jobs;
+  vec_scratch_mpz_t scratch;
+
+  /* Never use more threads than there are batches. */
+  threads = vec_threads(threads);
+  batches =
+    (len + VEC_JSMUL_PAR_BATCH_LEN - 1) / VEC_JSMUL_PAR_BATCH_LEN;
+  if (threads > batches)
+    {
+      threads = batches;
+    }
+
+  if (threads <= 1)
+    {
+      curve->jsmul(ropx, ropy, ropz,
+                   curve,
+                   basesx, basesy, basesz,
+                   scalars,
+                   len);
+      return;
+    }
+
+  /* Give each thread a contiguous range of whole batches. */
+  batches_per_job = (batches + threads - 1) / threads;
+  jobs_len = (batches + batches_per_job - 1) / batches_per_job;
+
+  jobs = (vec_jsmul_par_job *)malloc(jobs_len * sizeof(vec_jsmul_par_job));
+
+  offset = 0;
+  for (i = 0; i < jobs_len; i++)
+    {
+      jobs[i].curve = curve;
+      jobs[i].basesx = basesx + offset;
+      jobs[i].basesy = basesy + offset;
+      jobs[i].basesz = basesz + offset;
+      jobs[i].scalars = scalars + offset;
+      jobs[i].len = batches_per_job * VEC_JSMUL_PAR_BATCH_LEN;
+      if (offset + jobs[i].len > len)
+        {
+          jobs[i].len = len - offset;
+        }
+      offset += jobs[i].len;
+
+      mpz_init(jobs[i].ropx);
+      mpz_init(jobs[i].ropy);
+      mpz_init(jobs[i].ropz);
+    }
+
+  vec_par_run(jobs, jobs_len, sizeof(vec_jsmul_par_job),
+              vec_jsmul_par_worker);
+
+  /* Combine the partial results using a tree of additions. */
+  vec_scratch_init_mpz_t(scratch);
+
+  for (step = 1; step < jobs_len; step <<= 1)
+    {
+      for (i = 0; i + step < jobs_len; i += step << 1)
+        {
+          curve->jadd(scratch,
+                      jobs[i].ropx, jobs[i].ropy, jobs[i].ropz,
+                      curve,
+                      jobs[i].ropx, jobs[i].ropy, jobs[i].ropz,
+                      jobs[i + step].ropx,
+                      jobs[i + step].ropy,
+                      jobs[i + step].ropz);
+        }
+    }
+
+  vec_scratch_clear_mpz_t(scratch);
+
+  mpz_set(ropx, jobs[0].ropx);
+  mpz_set(ropy, jobs[0].ropy);
+  mpz_set(ropz, jobs[0].ropz);
+
+  for (i = 0; i < jobs_len; i++)
+    {
+      mpz_clear(jobs[i].ropz);
+      mpz_clear(jobs[i].ropy);
+      mpz_clear(jobs[i].ropx);
+    }
+  free(jobs);
+}
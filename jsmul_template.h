@@ -38,6 +38,10 @@ FUNCTION_NAME(vec_jsmul_init, POSTFIX)
 {
   size_t i;             /* Index parameters. */
   size_t tab_len;       /* Size of a subtable. */
+#ifdef ARRAY_CONTIGUOUS
+  size_t array_bytes;   /* Size of a coordinate array of a subtable. */
+  char *block;          /* Memory of all subtables. */
+#endif
 
   /* We need the curve parameter in other implementations of
    * multiplication, so to use function pointers we need to keep it here
@@ -52,6 +56,9 @@ FUNCTION_NAME(vec_jsmul_init, POSTFIX)
     table->block_width = len;
   }
   table->tabs_len = (len + block_width - 1) / block_width;
+  table->affine = 0;
+  table->block = NULL;
+  table->block_bytes = 0;
 
   /* Allocate and initialize space for pointers to tables. */
   table->tabsx =
@@ -61,6 +68,33 @@ FUNCTION_NAME(vec_jsmul_init, POSTFIX)
   table->tabsz =
     (FIELD_ELEMENT_VAR **)malloc(table->tabs_len * sizeof(FIELD_ELEMENT_VAR *));
 
+#ifdef ARRAY_CONTIGUOUS
+
+  /* Native elements need no initialization, so all subtables are
+     kept in a single block. Each coordinate array starts on a cache
+     line, and the three arrays of a subtable are adjacent, which
+     saves lines and pages touched by a lookup. The last subtable is
+     given the size of the others for simplicity. */
+  tab_len = ((size_t)1) << table->block_width;
+  array_bytes = tab_len * sizeof(FIELD_ELEMENT_VAR);
+  array_bytes =
+    (array_bytes + VEC_TABLE_ALIGN - 1) / VEC_TABLE_ALIGN * VEC_TABLE_ALIGN;
+
+  table->block_bytes = 3 * array_bytes * table->tabs_len;
+  table->block = vec_table_alloc(table->block_bytes);
+  VEC_STATS_ALLOC(curve, 1, table->block_bytes);
+
+  block = (char *)table->block;
+  for (i = 0; i < table->tabs_len; i++)
+    {
+      table->tabsx[i] = (FIELD_ELEMENT_VAR *)block;
+      table->tabsy[i] = (FIELD_ELEMENT_VAR *)(block + array_bytes);
+      table->tabsz[i] = (FIELD_ELEMENT_VAR *)(block + 2 * array_bytes);
+      block += 3 * array_bytes;
+    }
+
+#else
+
   tab_len = 1 << block_width;
   for (i = 0; i < table->tabs_len; i++)
     {
@@ -77,7 +111,10 @@ FUNCTION_NAME(vec_jsmul_init, POSTFIX)
       table->tabsx[i] = ARRAY_MALLOC_INIT(tab_len);
       table->tabsy[i] = ARRAY_MALLOC_INIT(tab_len);
       table->tabsz[i] = ARRAY_MALLOC_INIT(tab_len);
+      VEC_STATS_ALLOC(curve, 3, 3 * tab_len * sizeof(FIELD_ELEMENT_VAR));
     }
+
+#endif
 }
 
 int
@@ -90,6 +127,14 @@ FUNCTION_NAME(vec_jsmul_clear, POSTFIX)
   size_t tab_len;                          /* Size of each sub table. */
 
   tab_len = 1 << block_width;
+
+  /* All subtables may be kept in a single block. */
+  if (table->block != NULL)
+    {
+      vec_table_free(table->block, table->block_bytes);
+      tabs_len = 0;
+    }
+
   for (i = 0; i < tabs_len; i++)
     {
 
@@ -135,11 +180,14 @@ FUNCTION_NAME(vec_jsmul_precomp, POSTFIX)
   int one_mask;       /* Mask containing a single non-zero bit. */
 
   SCRATCH(scratch);
+  VEC_STATS_TIMER(timer);
 
   VEC_UNUSED(curve);
 
   SCRATCH_INIT(scratch);
 
+  VEC_STATS_START(timer);
+
   block_width = table->block_width;
   tab_len = 1 << block_width;
 
@@ -188,26 +236,448 @@ FUNCTION_NAME(vec_jsmul_precomp, POSTFIX)
       basesx += block_width;
       basesy += block_width;
       basesz += block_width;
+
+      VEC_STATS_ADD(curve, table_entries, tab_len);
     }
 
+  table->affine = 0;
+
+  VEC_STATS_STOP(curve, precomp_cycles, timer);
+
   SCRATCH_CLEAR(scratch);
 }
 
-static int
-getbits(mpz_t *op, int index, size_t block_width)
+/* Converts all entries of the table to affine coordinates using
+   buffers with room for the entries of a subtable. */
+static void
+FUNCTION_NAME(jsmul_normalize_buf, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      CURVE *curve,
+      FIELD_ELEMENT_VAR *acc, size_t *index, mpz_t tmp)
 {
-  int i;
-  int bits = 0;
+  size_t i;                                /* Index variable. */
+  size_t tabs_len = table->tabs_len;       /* Number of sub tables. */
+  size_t block_width = table->block_width; /* Width of current subtable. */
+  VEC_STATS_TIMER(timer);
 
-  for (i = block_width - 1; i >= 0; i--)
+  VEC_STATS_START(timer);
+
+  for (i = 0; i < tabs_len; i++)
     {
-      bits <<= 1;
-      if (mpz_tstbit(op[i], index))
+
+      /* Last block may have smaller width, but it is never zero. */
+      if (i == tabs_len - 1)
         {
-          bits |= 1;
+          block_width = table->len - (tabs_len - 1) * block_width;
         }
+
+      FUNCTION_NAME(vec_jaff_batch_buf, POSTFIX)(table->tabsx[i],
+                                                 table->tabsy[i],
+                                                 table->tabsz[i],
+                                                 ((size_t)1) << block_width,
+                                                 curve,
+                                                 acc, index, tmp);
     }
-  return bits;
+  table->affine = 1;
+
+  VEC_STATS_STOP(curve, precomp_cycles, timer);
+}
+
+/* Converts all entries of the table to affine coordinates, which
+   allows vec_jsmul_table to use mixed additions. */
+void
+FUNCTION_NAME(vec_jsmul_normalize, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      CURVE *curve)
+{
+  size_t tab_len = ((size_t)1) << table->block_width;
+  size_t *index;
+  FIELD_ELEMENT_VAR *acc;
+  mpz_t tmp;
+
+  index = (size_t *)malloc(tab_len * sizeof(size_t));
+  acc = ARRAY_MALLOC_INIT(tab_len);
+  VEC_STATS_ALLOC(curve, 2,
+                  tab_len * (sizeof(size_t) + sizeof(FIELD_ELEMENT_VAR)));
+  mpz_init(tmp);
+
+  FUNCTION_NAME(jsmul_normalize_buf, POSTFIX)(table, curve, acc, index, tmp);
+
+  mpz_clear(tmp);
+  ARRAY_CLEAR_FREE(acc, tab_len);
+  free(index);
+}
+
+/*
+ * Parallel precomputation. The recurrence only clears the least
+ * significant set bit of a mask, so an entry whose mask has a given
+ * prefix of high bits depends only on entries with the same prefix
+ * and on the entries of single low bits. Once the entries with zero
+ * low bits are computed, the groups of entries of distinct prefixes
+ * are computed independently by different threads. Conversion to
+ * affine coordinates is split in the same way, at the cost of one
+ * inversion per group.
+ */
+
+/* Work order of a single thread. A unit is a group of the entries of
+   a subtable with a given prefix, and each thread processes a
+   contiguous range of units. */
+typedef struct
+{
+  CURVE *curve;
+  FIELD_ELEMENT_VAR **tabsx;
+  FIELD_ELEMENT_VAR **tabsy;
+  FIELD_ELEMENT_VAR **tabsz;
+  size_t len;                 /* Total number of bases. */
+  size_t block_width;         /* Width of all but the last subtable. */
+  size_t tabs_len;            /* Number of subtables. */
+  size_t prefix_width;        /* Maximal width of prefixes. */
+  size_t first;               /* First unit of this thread. */
+  size_t last;                /* Unit following the last unit. */
+  int normalize;              /* Convert entries instead of computing. */
+} FUNCTION_NAME(jsmul_par_job, POSTFIX);
+
+/* Returns the width of the prefixes of a subtable of the given
+   width. At least one low bit is always left. */
+static size_t
+FUNCTION_NAME(jsmul_par_prefix, POSTFIX)(size_t prefix_width, size_t width)
+{
+  return prefix_width < width ? prefix_width : width - 1;
+}
+
+/* Returns the width of prefixes used to give each thread a few
+   units, so that the narrower last subtable does not leave threads
+   idle. */
+static size_t
+FUNCTION_NAME(jsmul_par_prefix_width, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      size_t threads)
+{
+  size_t prefix_width = 0;
+
+  while ((table->tabs_len << prefix_width) < 4 * threads
+         && prefix_width + 1 < table->block_width)
+    {
+      prefix_width++;
+    }
+  return prefix_width;
+}
+
+/* Sets the subtable, the width of the subtable, and the width of the
+   prefixes and the prefix of the unit with the given index. */
+static void
+FUNCTION_NAME(jsmul_par_unit, POSTFIX)
+     (size_t *i, size_t *width, size_t *prefix_width, size_t *prefix,
+      FUNCTION_NAME(jsmul_par_job, POSTFIX) *job,
+      size_t unit)
+{
+  *i = unit >> job->prefix_width;
+  if (*i >= job->tabs_len - 1)
+    {
+      *i = job->tabs_len - 1;
+      *width = job->len - (job->tabs_len - 1) * job->block_width;
+    }
+  else
+    {
+      *width = job->block_width;
+    }
+  *prefix_width = FUNCTION_NAME(jsmul_par_prefix, POSTFIX)(job->prefix_width,
+                                                           *width);
+  *prefix = unit - (*i << job->prefix_width);
+}
+
+static void *
+FUNCTION_NAME(jsmul_par_worker, POSTFIX)(void *arg)
+{
+  FUNCTION_NAME(jsmul_par_job, POSTFIX) *job =
+    (FUNCTION_NAME(jsmul_par_job, POSTFIX) *)arg;
+  CURVE *curve = job->curve;
+  size_t unit;
+  size_t i;
+  size_t width;
+  size_t prefix_width;
+  size_t prefix;
+  size_t low_len;             /* Number of entries of a unit. */
+  size_t max_low_len;         /* Maximal number of entries of a unit. */
+  size_t low;
+  size_t base;                /* First entry of the unit. */
+  FIELD_ELEMENT_VAR *tx;
+  FIELD_ELEMENT_VAR *ty;
+  FIELD_ELEMENT_VAR *tz;
+
+  int mask;           /* Mask used for dynamic programming */
+  int one_mask;       /* Mask containing a single non-zero bit. */
+
+  size_t *index = NULL;
+  FIELD_ELEMENT_VAR *acc = NULL;
+  mpz_t tmp;
+
+  SCRATCH(scratch);
+
+  VEC_UNUSED(curve);
+
+  SCRATCH_INIT(scratch);
+  mpz_init(tmp);
+
+  max_low_len = ((size_t)1) << (job->block_width - job->prefix_width);
+  if (job->normalize)
+    {
+      index = (size_t *)malloc(max_low_len * sizeof(size_t));
+      acc = ARRAY_MALLOC_INIT(max_low_len);
+      VEC_STATS_ALLOC(curve, 2,
+                      max_low_len
+                      * (sizeof(size_t) + sizeof(FIELD_ELEMENT_VAR)));
+    }
+
+  for (unit = job->first; unit < job->last; unit++)
+    {
+      FUNCTION_NAME(jsmul_par_unit, POSTFIX)(&i, &width,
+                                             &prefix_width, &prefix,
+                                             job, unit);
+
+      low_len = ((size_t)1) << (width - prefix_width);
+      base = prefix * low_len;
+
+      tx = job->tabsx[i];
+      ty = job->tabsy[i];
+      tz = job->tabsz[i];
+
+      if (job->normalize)
+        {
+          FUNCTION_NAME(vec_jaff_batch_buf, POSTFIX)(tx + base,
+                                                     ty + base,
+                                                     tz + base,
+                                                     low_len,
+                                                     curve,
+                                                     acc, index, tmp);
+          continue;
+        }
+
+      for (low = 1; low < low_len; low++)
+        {
+          mask = (int)(base | low);
+          one_mask = (int)(low & (-low));
+
+          /* The bases are already in place. */
+          if (mask == one_mask)
+            {
+              continue;
+            }
+
+          JADD_VAR(scratch,
+                   tx[mask], ty[mask], tz[mask],
+                   curve,
+                   tx[mask ^ one_mask],
+                   ty[mask ^ one_mask],
+                   tz[mask ^ one_mask],
+                   tx[one_mask],
+                   ty[one_mask],
+                   tz[one_mask]);
+        }
+    }
+
+  if (job->normalize)
+    {
+      ARRAY_CLEAR_FREE(acc, max_low_len);
+      free(index);
+    }
+
+  mpz_clear(tmp);
+  SCRATCH_CLEAR(scratch);
+
+  return NULL;
+}
+
+/* Processes all units of the table using the given number of
+   threads. */
+static void
+FUNCTION_NAME(jsmul_par_run, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      CURVE *curve,
+      size_t prefix_width,
+      size_t threads,
+      int normalize)
+{
+  size_t i;
+  size_t last_width;
+  size_t units;
+  size_t units_per_job;
+  size_t jobs_len;
+  FUNCTION_NAME(jsmul_par_job, POSTFIX) *jobs;
+
+  last_width = table->len - (table->tabs_len - 1) * table->block_width;
+  units = ((table->tabs_len - 1) << prefix_width)
+    + (((size_t)1)
+       << FUNCTION_NAME(jsmul_par_prefix, POSTFIX)(prefix_width,
+                                                   last_width));
+
+  units_per_job = (units + threads - 1) / threads;
+  jobs_len = (units + units_per_job - 1) / units_per_job;
+
+  jobs = (FUNCTION_NAME(jsmul_par_job, POSTFIX) *)
+    malloc(jobs_len * sizeof(FUNCTION_NAME(jsmul_par_job, POSTFIX)));
+
+  for (i = 0; i < jobs_len; i++)
+    {
+      jobs[i].curve = curve;
+      jobs[i].tabsx = table->tabsx;
+      jobs[i].tabsy = table->tabsy;
+      jobs[i].tabsz = table->tabsz;
+      jobs[i].len = table->len;
+      jobs[i].block_width = table->block_width;
+      jobs[i].tabs_len = table->tabs_len;
+      jobs[i].prefix_width = prefix_width;
+      jobs[i].first = i * units_per_job;
+      jobs[i].last = jobs[i].first + units_per_job;
+      if (jobs[i].last > units)
+        {
+          jobs[i].last = units;
+        }
+      jobs[i].normalize = normalize;
+    }
+
+  vec_par_run(jobs, jobs_len,
+              sizeof(FUNCTION_NAME(jsmul_par_job, POSTFIX)),
+              FUNCTION_NAME(jsmul_par_worker, POSTFIX));
+
+  free(jobs);
+}
+
+void
+FUNCTION_NAME(vec_jsmul_precomp_par, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      CURVE *curve,
+      FIELD_ELEMENT_VAR *basesx, FIELD_ELEMENT_VAR *basesy,
+      FIELD_ELEMENT_VAR *basesz,
+      size_t threads)
+{
+  size_t i, j;                    /* Index variables. */
+  size_t width;                   /* Width of current subtable. */
+  size_t prefix_width;            /* Width of prefixes of all subtables. */
+  size_t tab_prefix_width;        /* Width of prefixes of subtable. */
+  size_t prefix;
+  FIELD_ELEMENT_VAR *tx;          /* Temporary variable for subtable. */
+  FIELD_ELEMENT_VAR *ty;          /* Temporary variable for subtable. */
+  FIELD_ELEMENT_VAR *tz;          /* Temporary variable for subtable. */
+
+  int mask;           /* Mask used for dynamic programming */
+  int one_mask;       /* Mask containing a single non-zero bit. */
+
+  SCRATCH(scratch);
+  VEC_STATS_TIMER(timer);
+
+  threads = vec_threads(threads);
+  if (threads <= 1)
+    {
+      FUNCTION_NAME(vec_jsmul_precomp, POSTFIX)(table, curve,
+                                                basesx, basesy, basesz);
+      return;
+    }
+
+  VEC_UNUSED(curve);
+
+  SCRATCH_INIT(scratch);
+
+  VEC_STATS_START(timer);
+
+  prefix_width =
+    FUNCTION_NAME(jsmul_par_prefix_width, POSTFIX)(table, threads);
+
+  width = table->block_width;
+
+  /* Compute the bases and the entries with zero low bits of all
+     subtables sequentially. */
+  for (i = 0; i < table->tabs_len; i++)
+    {
+
+      /* Last block may have smaller width, but it is never zero. */
+      if (i == table->tabs_len - 1)
+        {
+          width = table->len - (table->tabs_len - 1) * width;
+        }
+      tab_prefix_width =
+        FUNCTION_NAME(jsmul_par_prefix, POSTFIX)(prefix_width, width);
+
+      tx = table->tabsx[i];
+      ty = table->tabsy[i];
+      tz = table->tabsz[i];
+
+      FIELD_ELEMENT_VAR_UNIT(tx[0], ty[0], tz[0]);
+
+      mask = 1;
+      for (j = 0; j < width; j++)
+        {
+          FIELD_ELEMENT_VAR_SET(tx[mask], ty[mask], tz[mask],
+                                basesx[j], basesy[j], basesz[j]);
+          mask <<= 1;
+        }
+
+      for (prefix = 1;
+           prefix < (((size_t)1) << tab_prefix_width);
+           prefix++)
+        {
+          mask = (int)(prefix << (width - tab_prefix_width));
+          one_mask = mask & (-mask);
+
+          if (mask == one_mask)
+            {
+              continue;
+            }
+
+          JADD_VAR(scratch,
+                   tx[mask], ty[mask], tz[mask],
+                   curve,
+                   tx[mask ^ one_mask],
+                   ty[mask ^ one_mask],
+                   tz[mask ^ one_mask],
+                   tx[one_mask],
+                   ty[one_mask],
+                   tz[one_mask]);
+        }
+
+      basesx += width;
+      basesy += width;
+      basesz += width;
+
+      VEC_STATS_ADD(curve, table_entries, ((size_t)1) << width);
+    }
+
+  /* Compute the remaining entries of each prefix in parallel. */
+  FUNCTION_NAME(jsmul_par_run, POSTFIX)(table, curve,
+                                        prefix_width, threads, 0);
+
+  table->affine = 0;
+
+  VEC_STATS_STOP(curve, precomp_cycles, timer);
+
+  SCRATCH_CLEAR(scratch);
+}
+
+void
+FUNCTION_NAME(vec_jsmul_normalize_par, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      CURVE *curve,
+      size_t threads)
+{
+  VEC_STATS_TIMER(timer);
+
+  threads = vec_threads(threads);
+  if (threads <= 1)
+    {
+      FUNCTION_NAME(vec_jsmul_normalize, POSTFIX)(table, curve);
+      return;
+    }
+
+  VEC_STATS_START(timer);
+
+  FUNCTION_NAME(jsmul_par_run, POSTFIX)
+    (table, curve,
+     FUNCTION_NAME(jsmul_par_prefix_width, POSTFIX)(table, threads),
+     threads, 1);
+
+  table->affine = 1;
+
+  VEC_STATS_STOP(curve, precomp_cycles, timer);
 }
 
 void
@@ -215,35 +685,36 @@ FUNCTION_NAME(vec_jsmul_table, POSTFIX)
      (FIELD_ELEMENT_VAR ropx, FIELD_ELEMENT_VAR ropy, FIELD_ELEMENT_VAR ropz,
       CURVE *curve,
       FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
-      mpz_t *scalars,
+      uint16_t *masks,
       size_t max_scalar_bitlen)
 {
 
   size_t i;
+  size_t next_i;
   int index;
   int mask;
-
-  mpz_t *scls;
+  int next_mask;
 
   FIELD_ELEMENT tmpx;
   FIELD_ELEMENT tmpy;
   FIELD_ELEMENT tmpz;
 
-  size_t len = table->len;
   size_t tabs_len = table->tabs_len;
-  size_t block_width = table->block_width;
-  size_t last_block_width = len - (tabs_len - 1) * block_width;
 
   FIELD_ELEMENT_VAR **tabsx = table->tabsx;
   FIELD_ELEMENT_VAR **tabsy = table->tabsy;
   FIELD_ELEMENT_VAR **tabsz = table->tabsz;
+  int affine = table->affine;
 
   SCRATCH(scratch);
+  VEC_STATS_TIMER(timer);
 
   VEC_UNUSED(curve);
 
   SCRATCH_INIT(scratch);
 
+  VEC_STATS_START(timer);
+
   FIELD_ELEMENT_INIT(tmpx);
   FIELD_ELEMENT_INIT(tmpy);
   FIELD_ELEMENT_INIT(tmpz);
@@ -262,30 +733,47 @@ FUNCTION_NAME(vec_jsmul_table, POSTFIX)
            tmpx, tmpy, tmpz);
 
       /* ... and multiply. */
-      i = 0;
-      scls = scalars;
-      while (i < tabs_len)
+      for (i = 0; i < tabs_len; i++)
         {
-          if (i == tabs_len - 1)
+          mask = masks[index * tabs_len + i];
+
+          /* Fetch the entry of the next block, or of the first block
+             for the next bit, while the current entry is added. */
+          if (i + 1 < tabs_len)
             {
-              mask = getbits(scls, index, last_block_width);
+              next_i = i + 1;
+              next_mask = masks[index * tabs_len + next_i];
             }
           else
             {
-              mask = getbits(scls, index, block_width);
+              next_i = 0;
+              next_mask = index > 0 ? masks[(index - 1) * tabs_len] : 0;
             }
+          VEC_PREFETCH(&tabsx[next_i][next_mask]);
+          VEC_PREFETCH(&tabsy[next_i][next_mask]);
+          VEC_PREFETCH(&tabsz[next_i][next_mask]);
 
-          JADD(scratch,
-               tmpx, tmpy, tmpz,
-               curve,
-               tmpx, tmpy, tmpz,
-               tabsx[i][mask], tabsy[i][mask], tabsz[i][mask]);
-
-          i++;
-          scls += block_width;
+          if (affine)
+            {
+              JADD_MIXED(scratch,
+                         tmpx, tmpy, tmpz,
+                         curve,
+                         tmpx, tmpy, tmpz,
+                         tabsx[i][mask], tabsy[i][mask], tabsz[i][mask]);
+            }
+          else
+            {
+              JADD(scratch,
+                   tmpx, tmpy, tmpz,
+                   curve,
+                   tmpx, tmpy, tmpz,
+                   tabsx[i][mask], tabsy[i][mask], tabsz[i][mask]);
+            }
         }
     }
 
+  VEC_STATS_STOP(curve, main_cycles, timer);
+
   SCRATCH_CLEAR(scratch);
 
   FIELD_ELEMENT_CONTRACT(ropx, ropy, ropz, tmpx, tmpy, tmpz);
@@ -294,6 +782,89 @@ FUNCTION_NAME(vec_jsmul_table, POSTFIX)
   FIELD_ELEMENT_CLEAR(tmpz);
 }
 
+/* Table cached by a workspace together with buffers for converting
+   a subtable to affine coordinates. */
+typedef struct
+{
+  FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) tab;
+  FIELD_ELEMENT_VAR *acc;
+  size_t *index;
+} FUNCTION_NAME(jsmul_workspace_entry, POSTFIX);
+
+/* Frees a table cached by a workspace. */
+static void
+FUNCTION_NAME(jsmul_workspace_free, POSTFIX)(void *table)
+{
+  FUNCTION_NAME(jsmul_workspace_entry, POSTFIX) *entry =
+    (FUNCTION_NAME(jsmul_workspace_entry, POSTFIX) *)table;
+  size_t tab_len = ((size_t)1) << entry->tab->block_width;
+
+  ARRAY_CLEAR_FREE(entry->acc, tab_len);
+  free(entry->index);
+  FUNCTION_NAME(vec_jsmul_clear, POSTFIX)(entry->tab);
+  free(entry);
+
+  /* Hack to avoid unused-variable warnings for the case where
+     ARRAY_CLEAR_FREE expands to an expression not involving
+     tab_len. */
+  VEC_UNUSED(tab_len);
+}
+
+/* Sets the table to a view of the table cached by the workspace with
+   room for len bases in blocks of the given width, and returns the
+   cached entry. The cached table is replaced if it belongs to another
+   implementation, has another block width, or is too small. A view
+   must never be cleared. */
+static FUNCTION_NAME(jsmul_workspace_entry, POSTFIX) *
+FUNCTION_NAME(jsmul_workspace_table, POSTFIX)
+     (FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table,
+      CURVE *curve,
+      vec_workspace *ws,
+      size_t len,
+      size_t block_width)
+{
+  size_t tab_len;
+  FUNCTION_NAME(jsmul_workspace_entry, POSTFIX) *cached =
+    (FUNCTION_NAME(jsmul_workspace_entry, POSTFIX) *)ws->table;
+
+  if (ws->table_free != FUNCTION_NAME(jsmul_workspace_free, POSTFIX)
+      || ws->table_block_width != block_width
+      || ws->table_len < len)
+    {
+      if (ws->table != NULL)
+        {
+          ws->table_free(ws->table);
+        }
+
+      cached = (FUNCTION_NAME(jsmul_workspace_entry, POSTFIX) *)
+        malloc(sizeof(FUNCTION_NAME(jsmul_workspace_entry, POSTFIX)));
+      FUNCTION_NAME(vec_jsmul_init, POSTFIX)(cached->tab, curve,
+                                             len, block_width);
+
+      tab_len = ((size_t)1) << cached->tab->block_width;
+      cached->acc = ARRAY_MALLOC_INIT(tab_len);
+      cached->index = (size_t *)malloc(tab_len * sizeof(size_t));
+      VEC_STATS_ALLOC(curve, 2,
+                      tab_len * (sizeof(size_t) + sizeof(FIELD_ELEMENT_VAR)));
+
+      ws->table = cached;
+      ws->table_free = FUNCTION_NAME(jsmul_workspace_free, POSTFIX);
+      ws->table_len = len;
+      ws->table_block_width = block_width;
+    }
+
+  /* The first blocks of a shorter view coincide with those of the
+     cached table, and the last block of the view is at most as wide
+     as the corresponding block of the cached table. */
+  table[0] = cached->tab[0];
+  table->len = len;
+  table->block_width = len < block_width ? len : block_width;
+  table->tabs_len = (len + block_width - 1) / block_width;
+  table->affine = 0;
+
+  return cached;
+}
+
 void
 FUNCTION_NAME(vec_jsmul_block_batch, POSTFIX)
      (FIELD_ELEMENT ropx, FIELD_ELEMENT ropy, FIELD_ELEMENT ropz,
@@ -306,7 +877,11 @@ FUNCTION_NAME(vec_jsmul_block_batch, POSTFIX)
       size_t max_scalar_bitlen)
 {
   size_t i;
+  size_t tabs_len;
   FUNCTION_NAME(vec_jsmul_tab, TAB_POSTFIX) table;
+  uint16_t *masks;
+  vec_workspace *ws = vec_workspace_get();
+  FUNCTION_NAME(jsmul_workspace_entry, POSTFIX) *entry;
 
   FIELD_ELEMENT_VAR tmpx;
   FIELD_ELEMENT_VAR tmpy;
@@ -324,8 +899,13 @@ FUNCTION_NAME(vec_jsmul_block_batch, POSTFIX)
     batch_len = len;
   }
 
-  FUNCTION_NAME(vec_jsmul_init, POSTFIX)(table, curve, batch_len,
-                                         block_width);
+  entry = FUNCTION_NAME(jsmul_workspace_table, POSTFIX)(table, curve, ws,
+                                                        batch_len,
+                                                        block_width);
+
+  /* Room for the transposed scalars of a batch. */
+  tabs_len = table->tabs_len;
+  masks = vec_workspace_masks(ws, max_scalar_bitlen * tabs_len + 1);
 
   /* Initialize result to unit element. */
   FIELD_ELEMENT_UNIT(ropx, ropy, ropz);
@@ -338,19 +918,32 @@ FUNCTION_NAME(vec_jsmul_block_batch, POSTFIX)
         {
           batch_len = len - i;
 
-          FUNCTION_NAME(vec_jsmul_clear, POSTFIX)(table);
-          FUNCTION_NAME(vec_jsmul_init, POSTFIX)(table, curve,
-                                                 batch_len, block_width);
+          entry =
+            FUNCTION_NAME(jsmul_workspace_table, POSTFIX)(table, curve, ws,
+                                                          batch_len,
+                                                          block_width);
         }
 
       /* Perform computation for batch */
       FUNCTION_NAME(vec_jsmul_precomp, POSTFIX)(table, curve,
                                                 basesx, basesy, basesz);
 
+      /* Mixed additions pay for the conversion of the table for long
+         scalars and narrow blocks. */
+      if (vec_smul_use_affine(max_scalar_bitlen, table->block_width))
+        {
+          FUNCTION_NAME(jsmul_normalize_buf, POSTFIX)(table, curve,
+                                                      entry->acc,
+                                                      entry->index,
+                                                      ws->tmp);
+        }
+
       /* Compute batch. */
+      vec_scalars_transpose(masks, scalars, batch_len,
+                            block_width, max_scalar_bitlen);
       FUNCTION_NAME(vec_jsmul_table, POSTFIX)(tmpx, tmpy, tmpz,
                                               curve, table,
-                                              scalars, max_scalar_bitlen);
+                                              masks, max_scalar_bitlen);
 
       /* Add with result so far. */
       JADD(scratch,
@@ -366,9 +959,11 @@ FUNCTION_NAME(vec_jsmul_block_batch, POSTFIX)
       scalars += batch_len;
     }
 
-  SCRATCH_CLEAR(scratch);
+  FIELD_ELEMENT_VAR_CLEAR(tmpz);
+  FIELD_ELEMENT_VAR_CLEAR(tmpy);
+  FIELD_ELEMENT_VAR_CLEAR(tmpx);
 
-  FUNCTION_NAME(vec_jsmul_clear, POSTFIX)(table);
+  SCRATCH_CLEAR(scratch);
 }
 
 void
@@ -400,8 +995,28 @@ FUNCTION_NAME(vec_jsmul, POSTFIX)
         }
     }
 
-  /* Determine a good block width. */
-  block_width = vec_smul_block_width(max_scalar_bitlen, batch_len);
+  /* Use buckets instead of tables if there are many bases. */
+  if (vec_smul_use_bucket(max_scalar_bitlen, len))
+    {
+      FUNCTION_NAME(vec_jsmul_bucket_windows, POSTFIX)
+        (ropx, ropy, ropz,
+         curve,
+         basesx, basesy, basesz,
+         scalars,
+         len,
+         vec_bucket_width(max_scalar_bitlen, len),
+         max_scalar_bitlen);
+      return;
+    }
+
+  /* Determine a good block width, and batch length if the curve is
+     tuned. */
+  if (!vec_tuning_smul(&block_width, &batch_len,
+                       curve->tuning, curve->name, STRING_NAME(POSTFIX),
+                       max_scalar_bitlen, len))
+    {
+      block_width = vec_smul_block_width(max_scalar_bitlen, batch_len);
+    }
 
   FUNCTION_NAME(vec_jsmul_block_batch, POSTFIX)(ropx, ropy, ropz,
                                                 curve,
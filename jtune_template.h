@@ -0,0 +1,294 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef FIELD_ELEMENT
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "templates.h"
+
+/*
+ * Measurement of the costs of the operations used in the main loops
+ * of the multiplication algorithms, i.e., doublings and additions of
+ * points in the native representation to an accumulator. Each
+ * operation is repeated in rounds of 16 between reading the clock
+ * until at least millisecs milliseconds have passed.
+ */
+
+/* Returns the number of nanoseconds per operation. */
+static double
+FUNCTION_NAME(jtune_ns, POSTFIX)(long start, long ops)
+{
+  return ((double)(clock() - start)) * 1e9 / ((double)CLOCKS_PER_SEC * ops);
+}
+
+/* Returns the number of nanoseconds per mixed addition of a table
+   entry chosen pseudo-randomly among the given number of entries to
+   the accumulator. A linear congruential generator keeps the
+   hardware from prefetching the entries. */
+static double
+FUNCTION_NAME(jtune_lookup, POSTFIX)(FIELD_ELEMENT ropx,
+                                     FIELD_ELEMENT ropy,
+                                     FIELD_ELEMENT ropz,
+                                     CURVE *curve,
+                                     FIELD_ELEMENT_VAR x,
+                                     FIELD_ELEMENT_VAR y,
+                                     FIELD_ELEMENT_VAR z,
+                                     size_t entries,
+                                     long millisecs)
+{
+  int j;
+  size_t i;
+  size_t state;
+  long ops;
+  long start;
+  FIELD_ELEMENT_VAR *tabx;
+  FIELD_ELEMENT_VAR *taby;
+  FIELD_ELEMENT_VAR *tabz;
+
+  SCRATCH(scratch);
+
+  VEC_UNUSED(curve);
+
+  SCRATCH_INIT(scratch);
+
+  tabx = ARRAY_MALLOC_INIT(entries);
+  taby = ARRAY_MALLOC_INIT(entries);
+  tabz = ARRAY_MALLOC_INIT(entries);
+
+  for (i = 0; i < entries; i++)
+    {
+      FIELD_ELEMENT_VAR_SET(tabx[i], taby[i], tabz[i], x, y, z);
+    }
+
+  state = 1;
+  ops = 0;
+  start = clock();
+  do
+    {
+      for (j = 0; j < 16; j++)
+        {
+          state = state * 1103515245 + 12345;
+          i = (state >> 8) % entries;
+
+          JADD_MIXED(scratch,
+                     ropx, ropy, ropz,
+                     curve,
+                     ropx, ropy, ropz,
+                     tabx[i], taby[i], tabz[i]);
+        }
+      ops += 16;
+    }
+  while (!vec_done(start, millisecs));
+
+  ARRAY_CLEAR_FREE(tabz, entries);
+  ARRAY_CLEAR_FREE(taby, entries);
+  ARRAY_CLEAR_FREE(tabx, entries);
+
+  SCRATCH_CLEAR(scratch);
+
+  return FUNCTION_NAME(jtune_ns, POSTFIX)(start, ops);
+}
+
+/* Returns the cost of a lookup in a table of the given size in bytes
+   relative to a lookup in a table of 16 entries. */
+static double
+FUNCTION_NAME(jtune_penalty, POSTFIX)(FIELD_ELEMENT ropx,
+                                      FIELD_ELEMENT ropy,
+                                      FIELD_ELEMENT ropz,
+                                      CURVE *curve,
+                                      FIELD_ELEMENT_VAR x,
+                                      FIELD_ELEMENT_VAR y,
+                                      FIELD_ELEMENT_VAR z,
+                                      size_t bytes,
+                                      size_t entry_bytes,
+                                      double small,
+                                      long millisecs)
+{
+  double cost;
+
+  if (bytes > VEC_TUNING_MAX_TABLE_BYTES)
+    {
+      bytes = VEC_TUNING_MAX_TABLE_BYTES;
+    }
+
+  cost = FUNCTION_NAME(jtune_lookup, POSTFIX)(ropx, ropy, ropz,
+                                              curve,
+                                              x, y, z,
+                                              bytes / entry_bytes,
+                                              millisecs);
+
+  return cost > small ? cost - small : 0.0;
+}
+
+void
+FUNCTION_NAME(vec_jtune, POSTFIX)(vec_tuning_costs *costs,
+                                  CURVE *curve,
+                                  long millisecs)
+{
+  int j;
+  long ops;
+  long start;
+  double small;
+
+  FIELD_ELEMENT ropx;
+  FIELD_ELEMENT ropy;
+  FIELD_ELEMENT ropz;
+
+  FIELD_ELEMENT_VAR x;
+  FIELD_ELEMENT_VAR y;
+  FIELD_ELEMENT_VAR z;
+  FIELD_ELEMENT_VAR dx;
+  FIELD_ELEMENT_VAR dy;
+  FIELD_ELEMENT_VAR dz;
+
+  mpz_t one;
+
+  SCRATCH(scratch);
+
+  SCRATCH_INIT(scratch);
+
+  FIELD_ELEMENT_INIT(ropx);
+  FIELD_ELEMENT_INIT(ropy);
+  FIELD_ELEMENT_INIT(ropz);
+
+  FIELD_ELEMENT_VAR_INIT(x);
+  FIELD_ELEMENT_VAR_INIT(y);
+  FIELD_ELEMENT_VAR_INIT(z);
+  FIELD_ELEMENT_VAR_INIT(dx);
+  FIELD_ELEMENT_VAR_INIT(dy);
+  FIELD_ELEMENT_VAR_INIT(dz);
+
+  mpz_init_set_ui(one, 1);
+
+  /* The generator in affine coordinates and its double in Jacobi
+     coordinates. */
+  FIELD_ELEMENT_VAR_IMPORT(x, y, z, curve->gx, curve->gy, one, curve);
+  JDBL_VAR(scratch, dx, dy, dz, curve, x, y, z);
+
+  /* Start from three times the generator to avoid the special cases
+     of the formulas. */
+  FIELD_ELEMENT_UNIT(ropx, ropy, ropz);
+  JADD_MIXED(scratch, ropx, ropy, ropz, curve, ropx, ropy, ropz, x, y, z);
+  JADD(scratch, ropx, ropy, ropz, curve, ropx, ropy, ropz, dx, dy, dz);
+
+  strncpy(costs->curve, curve->name, sizeof(costs->curve) - 1);
+  costs->curve[sizeof(costs->curve) - 1] = '\0';
+  strncpy(costs->backend, STRING_NAME(POSTFIX), sizeof(costs->backend) - 1);
+  costs->backend[sizeof(costs->backend) - 1] = '\0';
+  costs->entry_bytes = 3 * FIELD_ELEMENT_VAR_BYTES(curve);
+
+  ops = 0;
+  start = clock();
+  do
+    {
+      for (j = 0; j < 16; j++)
+        {
+          JDBL(scratch, ropx, ropy, ropz, curve, ropx, ropy, ropz);
+        }
+      ops += 16;
+    }
+  while (!vec_done(start, millisecs));
+  costs->dbl = FUNCTION_NAME(jtune_ns, POSTFIX)(start, ops);
+
+  ops = 0;
+  start = clock();
+  do
+    {
+      for (j = 0; j < 16; j++)
+        {
+          JADD(scratch,
+               ropx, ropy, ropz,
+               curve,
+               ropx, ropy, ropz,
+               dx, dy, dz);
+        }
+      ops += 16;
+    }
+  while (!vec_done(start, millisecs));
+  costs->add = FUNCTION_NAME(jtune_ns, POSTFIX)(start, ops);
+
+  ops = 0;
+  start = clock();
+  do
+    {
+      for (j = 0; j < 16; j++)
+        {
+          JADD_MIXED(scratch,
+                     ropx, ropy, ropz,
+                     curve,
+                     ropx, ropy, ropz,
+                     x, y, z);
+        }
+      ops += 16;
+    }
+  while (!vec_done(start, millisecs));
+  costs->madd = FUNCTION_NAME(jtune_ns, POSTFIX)(start, ops);
+
+  /* Lookups in tables of increasing size. The cache sizes are set by
+     the caller. */
+  small = FUNCTION_NAME(jtune_lookup, POSTFIX)(ropx, ropy, ropz,
+                                               curve,
+                                               x, y, z,
+                                               16,
+                                               millisecs);
+  costs->lookup = small > costs->madd ? small - costs->madd : 0.0;
+
+  costs->l2_penalty =
+    FUNCTION_NAME(jtune_penalty, POSTFIX)(ropx, ropy, ropz,
+                                          curve,
+                                          x, y, z,
+                                          2 * costs->l2_bytes,
+                                          costs->entry_bytes,
+                                          small,
+                                          millisecs);
+  costs->l3_penalty =
+    FUNCTION_NAME(jtune_penalty, POSTFIX)(ropx, ropy, ropz,
+                                          curve,
+                                          x, y, z,
+                                          2 * costs->l3_bytes,
+                                          costs->entry_bytes,
+                                          small,
+                                          millisecs);
+
+  mpz_clear(one);
+
+  FIELD_ELEMENT_VAR_CLEAR(dz);
+  FIELD_ELEMENT_VAR_CLEAR(dy);
+  FIELD_ELEMENT_VAR_CLEAR(dx);
+  FIELD_ELEMENT_VAR_CLEAR(z);
+  FIELD_ELEMENT_VAR_CLEAR(y);
+  FIELD_ELEMENT_VAR_CLEAR(x);
+
+  FIELD_ELEMENT_CLEAR(ropz);
+  FIELD_ELEMENT_CLEAR(ropy);
+  FIELD_ELEMENT_CLEAR(ropx);
+
+  SCRATCH_CLEAR(scratch);
+}
+
+#endif
@@ -0,0 +1,81 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef VEC_LANES_AVX2
+
+#include <immintrin.h>
+
+/* Four lanes of 64 bits. */
+#define LANES_POSTFIX _avx2
+#define LANES_WIDTH 4
+#define LANES_TARGET __attribute__((target("avx2")))
+#define LANES_VEC __m256i
+
+#define LANES_ADD(a, b) _mm256_add_epi64(a, b)
+#define LANES_SUB(a, b) _mm256_sub_epi64(a, b)
+#define LANES_MUL(a, b) _mm256_mul_epu32(a, b)
+#define LANES_AND(a, b) _mm256_and_si256(a, b)
+#define LANES_ANDNOT(a, b) _mm256_andnot_si256(a, b)
+#define LANES_OR(a, b) _mm256_or_si256(a, b)
+#define LANES_SRL(a, bits) _mm256_srli_epi64(a, bits)
+#define LANES_SET1(x) _mm256_set1_epi64x(x)
+#define LANES_LOAD(p) _mm256_loadu_si256((const __m256i *)(p))
+#define LANES_STORE(p, a) _mm256_storeu_si256((__m256i *)(p), a)
+#define LANES_GATHER(words, i) \
+  _mm256_set_epi64x(words[3][i], words[2][i], words[1][i], words[0][i])
+#define LANES_EQ_ZERO(a) _mm256_cmpeq_epi64(a, _mm256_setzero_si256())
+#define LANES_ANY(a) (!_mm256_testz_si256(a, a))
+
+#include "lanes_template.h"
+
+#else
+
+#include <gmp.h>
+#include "vec.h"
+#include "templates.h"
+
+/* Without compiler support the caller always falls back on the
+   scalar code. */
+int
+vec_lanes_jfmul_avx2(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                     vec_lanes_tab *lt,
+                     uint16_t *masks,
+                     size_t bitlen)
+{
+  VEC_UNUSED(X);
+  VEC_UNUSED(Y);
+  VEC_UNUSED(Z);
+  VEC_UNUSED(lt);
+  VEC_UNUSED(masks);
+  VEC_UNUSED(bitlen);
+  return 0;
+}
+
+#endif
@@ -0,0 +1,83 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef VEC_LANES_AVX512
+
+#include <immintrin.h>
+
+/* Eight lanes of 64 bits. */
+#define LANES_POSTFIX _avx512
+#define LANES_WIDTH 8
+#define LANES_TARGET __attribute__((target("avx512f")))
+#define LANES_VEC __m512i
+
+#define LANES_ADD(a, b) _mm512_add_epi64(a, b)
+#define LANES_SUB(a, b) _mm512_sub_epi64(a, b)
+#define LANES_MUL(a, b) _mm512_mul_epu32(a, b)
+#define LANES_AND(a, b) _mm512_and_si512(a, b)
+#define LANES_ANDNOT(a, b) _mm512_andnot_si512(a, b)
+#define LANES_OR(a, b) _mm512_or_si512(a, b)
+#define LANES_SRL(a, bits) _mm512_srli_epi64(a, bits)
+#define LANES_SET1(x) _mm512_set1_epi64(x)
+#define LANES_LOAD(p) _mm512_loadu_si512((const void *)(p))
+#define LANES_STORE(p, a) _mm512_storeu_si512((void *)(p), a)
+#define LANES_GATHER(words, i)                                       \
+  _mm512_set_epi64(words[7][i], words[6][i], words[5][i], words[4][i], \
+                   words[3][i], words[2][i], words[1][i], words[0][i])
+#define LANES_EQ_ZERO(a) \
+  _mm512_maskz_set1_epi64(_mm512_cmpeq_epi64_mask(a, _mm512_setzero_si512()), -1)
+#define LANES_ANY(a) (_mm512_test_epi64_mask(a, a) != 0)
+
+#include "lanes_template.h"
+
+#else
+
+#include <gmp.h>
+#include "vec.h"
+#include "templates.h"
+
+/* Without compiler support the caller always falls back on the
+   scalar code. */
+int
+vec_lanes_jfmul_avx512(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       vec_lanes_tab *lt,
+                       uint16_t *masks,
+                       size_t bitlen)
+{
+  VEC_UNUSED(X);
+  VEC_UNUSED(Y);
+  VEC_UNUSED(Z);
+  VEC_UNUSED(lt);
+  VEC_UNUSED(masks);
+  VEC_UNUSED(bitlen);
+  return 0;
+}
+
+#endif
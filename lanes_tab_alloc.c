@@ -0,0 +1,123 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <gmp.h>
+#include "vec.h"
+
+vec_lanes_tab *
+vec_lanes_tab_alloc(vec_curve *curve, size_t tab_len)
+{
+  size_t width = vec_lanes_width();
+  size_t limbs;
+  vec_lanes_tab *lt;
+  mpz_t tmp;
+
+  /* Elements must be smaller than a quarter of the Montgomery
+     radix, so that products of elements smaller than twice the
+     modulus are reduced to elements smaller than twice the
+     modulus. */
+  limbs = (mpz_sizeinbase(curve->modulus, 2) + 2 + VEC_LANES_RADIX - 1)
+    / VEC_LANES_RADIX;
+
+  if (width == 0 || limbs > VEC_LANES_MAX_LIMBS)
+    {
+      return NULL;
+    }
+
+  lt = (vec_lanes_tab *)malloc(sizeof(vec_lanes_tab));
+  lt->width = width;
+  lt->limbs = limbs;
+  lt->tab_len = tab_len;
+  lt->entries_bytes = 2 * tab_len * limbs * sizeof(uint32_t);
+  lt->entries = (uint32_t *)vec_table_alloc(lt->entries_bytes);
+
+  if (lt->entries == NULL)
+    {
+      free(lt);
+      return NULL;
+    }
+
+#ifdef VEC_LANES_AVX512
+  if (width == 8)
+    {
+      lt->jfmul = vec_lanes_jfmul_avx512;
+    }
+#endif
+#ifdef VEC_LANES_AVX2
+  if (width == 4)
+    {
+      lt->jfmul = vec_lanes_jfmul_avx2;
+    }
+#endif
+
+  mpz_init_set(lt->modulus, curve->modulus);
+  mpz_init(tmp);
+
+  vec_lanes_limbs(lt->p, limbs, curve->modulus);
+  mpz_mul_2exp(tmp, curve->modulus, 1);
+  vec_lanes_limbs(lt->p2, limbs, tmp);
+
+  /* Negated inverse of the modulus modulo two to the radix. */
+  mpz_set_ui(tmp, 1);
+  mpz_mul_2exp(tmp, tmp, VEC_LANES_RADIX);
+  mpz_invert(tmp, curve->modulus, tmp);
+  lt->n0 = (uint32_t)((1UL << VEC_LANES_RADIX) - mpz_get_ui(tmp));
+
+  /* Doubling is cheaper for the common x-coefficients. */
+  mpz_mod(tmp, curve->a, curve->modulus);
+  mpz_add_ui(tmp, tmp, 3);
+  if (mpz_cmp_ui(tmp, 3) == 0)
+    {
+      lt->a_type = 1;
+    }
+  else if (mpz_cmp(tmp, curve->modulus) == 0)
+    {
+      lt->a_type = 2;
+    }
+  else
+    {
+      lt->a_type = 0;
+    }
+
+  /* One and the x-coefficient in Montgomery form. */
+  mpz_set_ui(tmp, 1);
+  mpz_mul_2exp(tmp, tmp, VEC_LANES_RADIX * limbs);
+  mpz_mod(tmp, tmp, curve->modulus);
+  vec_lanes_limbs(lt->one, limbs, tmp);
+
+  mpz_mul(tmp, tmp, curve->a);
+  mpz_mod(tmp, tmp, curve->modulus);
+  vec_lanes_limbs(lt->a, limbs, tmp);
+
+  mpz_clear(tmp);
+
+  return lt;
+}
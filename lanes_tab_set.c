@@ -0,0 +1,48 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gmp.h>
+#include "vec.h"
+
+void
+vec_lanes_tab_set(vec_lanes_tab *lt, size_t index, mpz_t x, mpz_t y)
+{
+  uint32_t *entry = lt->entries + 2 * index * lt->limbs;
+  mpz_t tmp;
+
+  mpz_init(tmp);
+
+  /* Convert each coordinate to Montgomery form. */
+  mpz_mul_2exp(tmp, x, VEC_LANES_RADIX * lt->limbs);
+  mpz_mod(tmp, tmp, lt->modulus);
+  vec_lanes_limbs(entry, lt->limbs, tmp);
+
+  mpz_mul_2exp(tmp, y, VEC_LANES_RADIX * lt->limbs);
+  mpz_mod(tmp, tmp, lt->modulus);
+  vec_lanes_limbs(entry + lt->limbs, lt->limbs, tmp);
+
+  mpz_clear(tmp);
+}
@@ -0,0 +1,583 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef LANES_VEC
+
+#include <gmp.h>
+#include "vec.h"
+#include "templates.h"
+
+/*
+ * Multi-lane arithmetic for batches of fixed basis multiplications.
+ * The including file maps the macros below to the instructions of a
+ * given instruction set, where a vector holds one 64-bit word for
+ * each lane, and each lane computes an independent multiplication.
+ *
+ * Field elements are stored in Montgomery form with R = 2^(26 *
+ * limbs) as limbs of VEC_LANES_RADIX bits, one limb of all lanes in
+ * each vector. Thus products of limbs fit in 52 bits and the columns
+ * of a product can be accumulated without propagating carries. All
+ * elements are kept in [0, 2p), which is preserved by Montgomery
+ * multiplication since R > 4p.
+ *
+ * LANES_POSTFIX, LANES_WIDTH, LANES_TARGET, LANES_VEC,
+ * LANES_ADD(a, b), LANES_SUB(a, b), LANES_MUL(a, b) (product of the
+ * lower 32 bits), LANES_AND(a, b), LANES_ANDNOT(a, b) (~a & b),
+ * LANES_OR(a, b), LANES_SRL(a, bits), LANES_SET1(x), LANES_LOAD(p),
+ * LANES_STORE(p, a), LANES_GATHER(words, i) (the ith word of each
+ * lane), LANES_EQ_ZERO(a) (all ones in zero lanes), and LANES_ANY(a)
+ * (a has a non-zero lane) must be defined.
+ */
+
+#define LANES_FELEM FUNCTION_NAME(lanes_felem, LANES_POSTFIX)
+#define LANES_POINT FUNCTION_NAME(lanes_point, LANES_POSTFIX)
+#define LANES_CTX FUNCTION_NAME(lanes_ctx, LANES_POSTFIX)
+
+typedef struct
+{
+  LANES_VEC v[VEC_LANES_MAX_LIMBS];
+} LANES_FELEM;
+
+typedef struct
+{
+  LANES_FELEM x;
+  LANES_FELEM y;
+  LANES_FELEM z;
+} LANES_POINT;
+
+/* Constants of the curve broadcast to all lanes. */
+typedef struct
+{
+  size_t limbs;
+  int a_type;
+  LANES_VEC mask;
+  LANES_VEC n0;
+  LANES_FELEM p;
+  LANES_FELEM p2;
+  LANES_FELEM one;
+  LANES_FELEM a;
+} LANES_CTX;
+
+static LANES_TARGET void
+FUNCTION_NAME(lanes_ctx_init, LANES_POSTFIX)(LANES_CTX *c,
+                                             vec_lanes_tab *lt)
+{
+  size_t i;
+
+  c->limbs = lt->limbs;
+  c->a_type = lt->a_type;
+  c->mask = LANES_SET1((1 << VEC_LANES_RADIX) - 1);
+  c->n0 = LANES_SET1(lt->n0);
+
+  for (i = 0; i < lt->limbs; i++)
+    {
+      c->p.v[i] = LANES_SET1(lt->p[i]);
+      c->p2.v[i] = LANES_SET1(lt->p2[i]);
+      c->one.v[i] = LANES_SET1(lt->one[i]);
+      c->a.v[i] = LANES_SET1(lt->a[i]);
+    }
+}
+
+/* Sets r = a in lanes where m is all ones and r = b elsewhere. */
+static inline LANES_TARGET void
+FUNCTION_NAME(lanes_select, LANES_POSTFIX)(LANES_FELEM *r,
+                                           LANES_VEC m,
+                                           const LANES_FELEM *a,
+                                           const LANES_FELEM *b,
+                                           const LANES_CTX *c)
+{
+  size_t i;
+
+  for (i = 0; i < c->limbs; i++)
+    {
+      r->v[i] = LANES_OR(LANES_AND(m, a->v[i]), LANES_ANDNOT(m, b->v[i]));
+    }
+}
+
+/* Sets r = x - q if x >= q and r = x otherwise. */
+static inline LANES_TARGET void
+FUNCTION_NAME(lanes_cond_sub, LANES_POSTFIX)(LANES_FELEM *r,
+                                             const LANES_FELEM *x,
+                                             const LANES_FELEM *q,
+                                             const LANES_CTX *c)
+{
+  size_t i;
+  LANES_VEC s;
+  LANES_VEC borrow = LANES_SET1(0);
+  LANES_VEC bias = LANES_SET1(1 << VEC_LANES_RADIX);
+  LANES_VEC one = LANES_SET1(1);
+  LANES_FELEM d;
+
+  /* The bias keeps each limb non-negative, so the borrow, which is
+     zero or minus one, can be extracted with a logical shift. */
+  for (i = 0; i < c->limbs; i++)
+    {
+      s = LANES_ADD(LANES_SUB(LANES_ADD(x->v[i], bias), q->v[i]), borrow);
+      d.v[i] = LANES_AND(s, c->mask);
+      borrow = LANES_SUB(LANES_SRL(s, VEC_LANES_RADIX), one);
+    }
+
+  /* The final borrow is all ones in the lanes where x < q. */
+  FUNCTION_NAME(lanes_select, LANES_POSTFIX)(r, borrow, x, &d, c);
+}
+
+static inline LANES_TARGET void
+FUNCTION_NAME(lanes_add, LANES_POSTFIX)(LANES_FELEM *r,
+                                        const LANES_FELEM *a,
+                                        const LANES_FELEM *b,
+                                        const LANES_CTX *c)
+{
+  size_t i;
+  LANES_VEC s;
+  LANES_VEC carry = LANES_SET1(0);
+  LANES_FELEM t;
+
+  for (i = 0; i < c->limbs; i++)
+    {
+      s = LANES_ADD(LANES_ADD(a->v[i], b->v[i]), carry);
+      t.v[i] = LANES_AND(s, c->mask);
+      carry = LANES_SRL(s, VEC_LANES_RADIX);
+    }
+  FUNCTION_NAME(lanes_cond_sub, LANES_POSTFIX)(r, &t, &c->p2, c);
+}
+
+/* Sets r = a - b + 2p reduced to [0, 2p). */
+static inline LANES_TARGET void
+FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(LANES_FELEM *r,
+                                        const LANES_FELEM *a,
+                                        const LANES_FELEM *b,
+                                        const LANES_CTX *c)
+{
+  size_t i;
+  LANES_VEC s;
+  LANES_VEC carry = LANES_SET1(0);
+  LANES_VEC bias = LANES_SET1(2 << VEC_LANES_RADIX);
+  LANES_VEC two = LANES_SET1(2);
+  LANES_FELEM t;
+
+  for (i = 0; i < c->limbs; i++)
+    {
+      s = LANES_ADD(LANES_ADD(a->v[i], c->p2.v[i]),
+                    LANES_SUB(LANES_ADD(bias, carry), b->v[i]));
+      t.v[i] = LANES_AND(s, c->mask);
+      carry = LANES_SUB(LANES_SRL(s, VEC_LANES_RADIX), two);
+    }
+  FUNCTION_NAME(lanes_cond_sub, LANES_POSTFIX)(r, &t, &c->p2, c);
+}
+
+/* Montgomery multiplication, i.e., r = a * b / R, for a given number
+   of limbs. This is inlined with constant numbers of limbs below, so
+   that the compiler can unroll the loops. */
+static inline __attribute__((always_inline)) LANES_TARGET void
+FUNCTION_NAME(lanes_mul_limbs, LANES_POSTFIX)(LANES_FELEM *r,
+                                              const LANES_FELEM *a,
+                                              const LANES_FELEM *b,
+                                              const LANES_CTX *c,
+                                              size_t n)
+{
+  size_t i;
+  size_t j;
+  LANES_VEC m;
+  LANES_VEC carry;
+  LANES_VEC t[2 * VEC_LANES_MAX_LIMBS];
+
+  for (i = 0; i < 2 * n; i++)
+    {
+      t[i] = LANES_SET1(0);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      for (j = 0; j < n; j++)
+        {
+          t[i + j] = LANES_ADD(t[i + j], LANES_MUL(a->v[i], b->v[j]));
+        }
+    }
+
+  /* Clear the lower limbs one at a time. Each column is bounded by
+     2 * limbs products of 52 bits, so nothing overflows. */
+  for (i = 0; i < n; i++)
+    {
+      m = LANES_AND(LANES_MUL(t[i], c->n0), c->mask);
+      for (j = 0; j < n; j++)
+        {
+          t[i + j] = LANES_ADD(t[i + j], LANES_MUL(m, c->p.v[j]));
+        }
+      t[i + 1] = LANES_ADD(t[i + 1], LANES_SRL(t[i], VEC_LANES_RADIX));
+    }
+
+  carry = LANES_SET1(0);
+  for (i = 0; i < n; i++)
+    {
+      carry = LANES_ADD(t[n + i], carry);
+      r->v[i] = LANES_AND(carry, c->mask);
+      carry = LANES_SRL(carry, VEC_LANES_RADIX);
+    }
+}
+
+/* Montgomery multiplication specialized to the numbers of limbs of
+   the standard curves of 192, 224, 256, 384, and 512 or 521 bits. */
+static LANES_TARGET void
+FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(LANES_FELEM *r,
+                                        const LANES_FELEM *a,
+                                        const LANES_FELEM *b,
+                                        const LANES_CTX *c)
+{
+  switch (c->limbs)
+    {
+    case 8:
+      FUNCTION_NAME(lanes_mul_limbs, LANES_POSTFIX)(r, a, b, c, 8);
+      break;
+    case 9:
+      FUNCTION_NAME(lanes_mul_limbs, LANES_POSTFIX)(r, a, b, c, 9);
+      break;
+    case 10:
+      FUNCTION_NAME(lanes_mul_limbs, LANES_POSTFIX)(r, a, b, c, 10);
+      break;
+    case 15:
+      FUNCTION_NAME(lanes_mul_limbs, LANES_POSTFIX)(r, a, b, c, 15);
+      break;
+    case 20:
+      FUNCTION_NAME(lanes_mul_limbs, LANES_POSTFIX)(r, a, b, c, 20);
+      break;
+    case 21:
+      FUNCTION_NAME(lanes_mul_limbs, LANES_POSTFIX)(r, a, b, c, 21);
+      break;
+    default:
+      FUNCTION_NAME(lanes_mul_limbs, LANES_POSTFIX)(r, a, b, c, c->limbs);
+    }
+}
+
+/* Returns all ones in the lanes where a is zero modulo p. */
+static inline LANES_TARGET LANES_VEC
+FUNCTION_NAME(lanes_is_zero, LANES_POSTFIX)(const LANES_FELEM *a,
+                                            const LANES_CTX *c)
+{
+  size_t i;
+  LANES_VEC acc = LANES_SET1(0);
+  LANES_FELEM t;
+
+  FUNCTION_NAME(lanes_cond_sub, LANES_POSTFIX)(&t, a, &c->p, c);
+
+  for (i = 0; i < c->limbs; i++)
+    {
+      acc = LANES_OR(acc, t.v[i]);
+    }
+  return LANES_EQ_ZERO(acc);
+}
+
+/* Doubling in Jacobi coordinates, see dbl-2001-b and dbl-2007-bl
+   at https://www.hyperelliptic.org. */
+static LANES_TARGET void
+FUNCTION_NAME(lanes_dbl, LANES_POSTFIX)(LANES_POINT *p,
+                                        const LANES_CTX *c)
+{
+  LANES_FELEM xx;
+  LANES_FELEM yy;
+  LANES_FELEM zz;
+  LANES_FELEM s;
+  LANES_FELEM m;
+  LANES_FELEM t;
+
+  if (c->a_type == 2)
+    {
+      /* zz = delta, yy = gamma, s = beta, and m = alpha. */
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&zz, &p->z, &p->z, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&yy, &p->y, &p->y, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&s, &p->x, &yy, c);
+
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&t, &p->x, &zz, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&m, &p->x, &zz, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&t, &t, &m, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&m, &t, &t, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&m, &m, &t, c);
+
+      /* z3 = (y + z)^2 - gamma - delta. */
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &p->y, &p->z, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&t, &t, &t, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&t, &t, &yy, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&p->z, &t, &zz, c);
+
+      /* x3 = alpha^2 - 8 * beta. */
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&s, &s, &s, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&s, &s, &s, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &s, &s, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&p->x, &m, &m, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&p->x, &p->x, &t, c);
+
+      /* y3 = alpha * (4 * beta - x3) - 8 * gamma^2. */
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&s, &s, &p->x, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&s, &m, &s, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&t, &yy, &yy, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &t, &t, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &t, &t, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &t, &t, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&p->y, &s, &t, c);
+    }
+  else
+    {
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&xx, &p->x, &p->x, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&yy, &p->y, &p->y, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&zz, &p->z, &p->z, c);
+
+      /* s = 2 * ((x + yy)^2 - xx - yyyy), where t = yyyy. */
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&t, &yy, &yy, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&s, &p->x, &yy, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&s, &s, &s, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&s, &s, &xx, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&s, &s, &t, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&s, &s, &s, c);
+
+      /* m = 3 * xx + a * zz^2. */
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&m, &xx, &xx, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&m, &m, &xx, c);
+      if (c->a_type == 0)
+        {
+          FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&xx, &zz, &zz, c);
+          FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&xx, &xx, &c->a, c);
+          FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&m, &m, &xx, c);
+        }
+
+      /* z3 = (y + z)^2 - yy - zz. */
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&xx, &p->y, &p->z, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&xx, &xx, &xx, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&xx, &xx, &yy, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&p->z, &xx, &zz, c);
+
+      /* x3 = m^2 - 2 * s. */
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&xx, &m, &m, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&xx, &xx, &s, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&p->x, &xx, &s, c);
+
+      /* y3 = m * (s - x3) - 8 * yyyy. */
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&s, &s, &p->x, c);
+      FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&s, &m, &s, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &t, &t, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &t, &t, c);
+      FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &t, &t, c);
+      FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&p->y, &s, &t, c);
+    }
+}
+
+/* Mixed addition in Jacobi coordinates, see madd-2007-bl at
+   https://www.hyperelliptic.org. Only lanes where active is all ones
+   are changed. A lane where the point is at infinity, as indicated
+   by inf, is set to the affine point instead. Lanes where the points
+   are equal or opposite are flagged in exc, since the formula does
+   not handle them. */
+static LANES_TARGET void
+FUNCTION_NAME(lanes_madd, LANES_POSTFIX)(LANES_POINT *p,
+                                         const LANES_FELEM *x2,
+                                         const LANES_FELEM *y2,
+                                         LANES_VEC active,
+                                         LANES_VEC *inf,
+                                         LANES_VEC *exc,
+                                         const LANES_CTX *c)
+{
+  LANES_FELEM z1z1;
+  LANES_FELEM h;
+  LANES_FELEM hh;
+  LANES_FELEM i;
+  LANES_FELEM j;
+  LANES_FELEM r;
+  LANES_FELEM v;
+  LANES_FELEM t;
+  LANES_POINT q;
+
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&z1z1, &p->z, &p->z, c);
+
+  /* h = x2 * z1z1 - x1. */
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&h, x2, &z1z1, c);
+  FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&h, &h, &p->x, c);
+
+  /* r = 2 * (y2 * z1 * z1z1 - y1). */
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&r, y2, &p->z, c);
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&r, &r, &z1z1, c);
+  FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&r, &r, &p->y, c);
+  FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&r, &r, &r, c);
+
+  /* i = 4 * h^2, j = h * i, and v = x1 * i. */
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&hh, &h, &h, c);
+  FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&i, &hh, &hh, c);
+  FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&i, &i, &i, c);
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&j, &h, &i, c);
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&v, &p->x, &i, c);
+
+  /* x3 = r^2 - j - 2 * v. */
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&q.x, &r, &r, c);
+  FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&q.x, &q.x, &j, c);
+  FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&q.x, &q.x, &v, c);
+  FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&q.x, &q.x, &v, c);
+
+  /* y3 = r * (v - x3) - 2 * y1 * j. */
+  FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&v, &v, &q.x, c);
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&v, &r, &v, c);
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&t, &p->y, &j, c);
+  FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &t, &t, c);
+  FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&q.y, &v, &t, c);
+
+  /* z3 = (z1 + h)^2 - z1z1 - hh. */
+  FUNCTION_NAME(lanes_add, LANES_POSTFIX)(&t, &p->z, &h, c);
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&t, &t, &t, c);
+  FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&t, &t, &z1z1, c);
+  FUNCTION_NAME(lanes_sub, LANES_POSTFIX)(&q.z, &t, &hh, c);
+
+  *exc = LANES_OR(*exc,
+                  LANES_ANDNOT(*inf,
+                               LANES_AND(active,
+                                         FUNCTION_NAME(lanes_is_zero,
+                                                       LANES_POSTFIX)(&h, c))));
+
+  FUNCTION_NAME(lanes_select, LANES_POSTFIX)(&q.x, *inf, x2, &q.x, c);
+  FUNCTION_NAME(lanes_select, LANES_POSTFIX)(&q.y, *inf, y2, &q.y, c);
+  FUNCTION_NAME(lanes_select, LANES_POSTFIX)(&q.z, *inf, &c->one, &q.z, c);
+
+  FUNCTION_NAME(lanes_select, LANES_POSTFIX)(&p->x, active, &q.x, &p->x, c);
+  FUNCTION_NAME(lanes_select, LANES_POSTFIX)(&p->y, active, &q.y, &p->y, c);
+  FUNCTION_NAME(lanes_select, LANES_POSTFIX)(&p->z, active, &q.z, &p->z, c);
+
+  *inf = LANES_ANDNOT(active, *inf);
+}
+
+/* Converts an element out of Montgomery form and writes the value
+   of each lane to an integer. */
+static LANES_TARGET void
+FUNCTION_NAME(lanes_export, LANES_POSTFIX)(mpz_t *R,
+                                           const LANES_FELEM *a,
+                                           const LANES_CTX *c)
+{
+  size_t i;
+  size_t l;
+  uint64_t words[VEC_LANES_MAX_LIMBS][LANES_WIDTH];
+  LANES_FELEM unit;
+  LANES_FELEM t;
+
+  unit.v[0] = LANES_SET1(1);
+  for (i = 1; i < c->limbs; i++)
+    {
+      unit.v[i] = LANES_SET1(0);
+    }
+
+  FUNCTION_NAME(lanes_mul, LANES_POSTFIX)(&t, a, &unit, c);
+  FUNCTION_NAME(lanes_cond_sub, LANES_POSTFIX)(&t, &t, &c->p, c);
+
+  for (i = 0; i < c->limbs; i++)
+    {
+      LANES_STORE(words[i], t.v[i]);
+    }
+
+  for (l = 0; l < LANES_WIDTH; l++)
+    {
+      mpz_set_ui(R[l], 0);
+      for (i = c->limbs; i > 0; i--)
+        {
+          mpz_mul_2exp(R[l], R[l], VEC_LANES_RADIX);
+          mpz_add_ui(R[l], R[l], (unsigned long)words[i - 1][l]);
+        }
+    }
+}
+
+LANES_TARGET int
+FUNCTION_NAME(vec_lanes_jfmul, LANES_POSTFIX)(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                                              vec_lanes_tab *lt,
+                                              uint16_t *masks,
+                                              size_t bitlen)
+{
+  size_t i;
+  size_t l;
+  int index;
+  uint16_t mask;
+  uint64_t words[LANES_WIDTH];
+  const uint32_t *entries[LANES_WIDTH];
+  LANES_CTX c;
+  LANES_POINT acc;
+  LANES_FELEM x2;
+  LANES_FELEM y2;
+  LANES_VEC active;
+  LANES_VEC inf;
+  LANES_VEC exc;
+
+  FUNCTION_NAME(lanes_ctx_init, LANES_POSTFIX)(&c, lt);
+
+  for (i = 0; i < c.limbs; i++)
+    {
+      acc.x.v[i] = c.one.v[i];
+      acc.y.v[i] = c.one.v[i];
+      acc.z.v[i] = LANES_SET1(0);
+    }
+  inf = LANES_SET1(-1);
+  exc = LANES_SET1(0);
+
+  /* Execute square-and-multiply in all lanes, each lane with the
+     masks of its own scalar. */
+  for (index = bitlen - 1; index >= 0; index--)
+    {
+      FUNCTION_NAME(lanes_dbl, LANES_POSTFIX)(&acc, &c);
+
+      for (l = 0; l < LANES_WIDTH; l++)
+        {
+          mask = masks[l * bitlen + index];
+          entries[l] = lt->entries + 2 * mask * c.limbs;
+          words[l] = mask == 0 ? 0 : ~((uint64_t)0);
+        }
+      active = LANES_LOAD(words);
+
+      for (i = 0; i < c.limbs; i++)
+        {
+          x2.v[i] = LANES_GATHER(entries, i);
+          y2.v[i] = LANES_GATHER(entries, c.limbs + i);
+        }
+
+      FUNCTION_NAME(lanes_madd, LANES_POSTFIX)(&acc, &x2, &y2,
+                                               active, &inf, &exc, &c);
+    }
+
+  if (LANES_ANY(exc))
+    {
+      return 0;
+    }
+
+  FUNCTION_NAME(lanes_export, LANES_POSTFIX)(X, &acc.x, &c);
+  FUNCTION_NAME(lanes_export, LANES_POSTFIX)(Y, &acc.y, &c);
+  FUNCTION_NAME(lanes_export, LANES_POSTFIX)(Z, &acc.z, &c);
+
+  LANES_STORE(words, inf);
+  for (l = 0; l < LANES_WIDTH; l++)
+    {
+      if (words[l] != 0)
+        {
+          mpz_set_ui(Z[l], 0);
+        }
+    }
+
+  return 1;
+}
+
+#undef LANES_CTX
+#undef LANES_POINT
+#undef LANES_FELEM
+
+#endif
@@ -0,0 +1,50 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "gmp.h"
+#include "vec.h"
+
+void
+vec_limbs_write(void *limbs, size_t size, mpz_t op, mpz_t modulus)
+{
+  mpz_t tmp;
+
+  memset(limbs, 0, size * sizeof(mp_limb_t));
+
+  /* Elements are normally reduced already, but we make sure. */
+  if (mpz_sgn(op) < 0 || mpz_size(op) > size)
+    {
+      mpz_init(tmp);
+      mpz_mod(tmp, op, modulus);
+      memcpy(limbs, mpz_limbs_read(tmp), mpz_size(tmp) * sizeof(mp_limb_t));
+      mpz_clear(tmp);
+    }
+  else
+    {
+      memcpy(limbs, mpz_limbs_read(op), mpz_size(op) * sizeof(mp_limb_t));
+    }
+}
@@ -0,0 +1,843 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <gmp.h>
+#include "vec.h"
+
+#include "mont_core.c"
+#include "mont_util.c"
+
+#include "mont_macros.h"
+
+#include "jmul_template.h"
+#include "jmulsw_template.h"
+#include "jmulwnaf_template.h"
+#include "jaff_batch_template.h"
+#include "jsmul_bucket_template.h"
+#include "jsmul_template.h"
+#include "jfmul_template.h"
+#include "jsmul_file_template.h"
+#include "jfmul_file_template.h"
+#include "jdmul_template.h"
+#include "jfcomb_template.h"
+#include "jfsmul_template.h"
+#include "jtune_template.h"
+#include "point_array_template.h"
+
+vec_mont_ctx *
+vec_mont_ctx_alloc(vec_curve *curve)
+{
+  int i;
+  mp_limb_t inv;
+  mpz_t tmp;
+  vec_mont_ctx *ctx;
+
+  /* Montgomery reduction requires an odd modulus. */
+  if (mpz_sizeinbase(curve->modulus, 2) > VEC_MONT_MAX_BITS
+      || mpz_even_p(curve->modulus))
+    {
+      return NULL;
+    }
+
+  ctx = (vec_mont_ctx *)calloc(1, sizeof(vec_mont_ctx));
+
+  ctx->n = mpz_size(curve->modulus);
+  vec_limbs_write(ctx->p, ctx->n, curve->modulus, curve->modulus);
+
+  /* Newton iteration doubles the number of correct low bits of the
+     inverse, starting with at least three since p is odd. */
+  inv = ctx->p[0];
+  for (i = 0; i < 6; i++)
+    {
+      inv *= 2 - ctx->p[0] * inv;
+    }
+  ctx->pinv = -inv;
+
+  mpz_init(tmp);
+
+  /* R mod p and R^2 mod p. */
+  mpz_set_ui(tmp, 1);
+  mpz_mul_2exp(tmp, tmp, ctx->n * GMP_NUMB_BITS);
+  vec_limbs_write(ctx->one, ctx->n, tmp, curve->modulus);
+
+  mpz_set_ui(tmp, 1);
+  mpz_mul_2exp(tmp, tmp, 2 * ctx->n * GMP_NUMB_BITS);
+  vec_limbs_write(ctx->r2, ctx->n, tmp, curve->modulus);
+
+  mpz_clear(tmp);
+
+  mpz_t_to_mont_felem(ctx->a, curve->a, ctx);
+
+  if (vec_curve_a_eq_neg3(curve))
+    {
+      ctx->a_kind = VEC_MONT_A_EQ_NEG3;
+    }
+  else if (mont_is_zero(ctx->a, ctx))
+    {
+      ctx->a_kind = VEC_MONT_A_EQ_0;
+    }
+  else
+    {
+      ctx->a_kind = VEC_MONT_A_GENERIC;
+    }
+
+  return ctx;
+}
+
+void
+vec_mont_ctx_free(vec_mont_ctx *ctx)
+{
+  free(ctx);
+}
+
+void
+vec_jmulsw_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_curve *curve,
+                mpz_t X, mpz_t Y, mpz_t Z,
+                mpz_t scalar)
+{
+  mont_felem x;
+  mont_felem y;
+  mont_felem z;
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  mpz_t_to_mont_felem(x, X, curve->mont);
+  mpz_t_to_mont_felem(y, Y, curve->mont);
+  mpz_t_to_mont_felem(z, Z, curve->mont);
+
+  vec_jmulsw_mont_inner(rx, ry, rz,
+                        curve,
+                        x, y, z,
+                        scalar);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+}
+
+void
+vec_jmulwnaf_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                  vec_curve *curve,
+                  mpz_t X, mpz_t Y, mpz_t Z,
+                  mpz_t scalar)
+{
+  mont_felem x;
+  mont_felem y;
+  mont_felem z;
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  mpz_t_to_mont_felem(x, X, curve->mont);
+  mpz_t_to_mont_felem(y, Y, curve->mont);
+  mpz_t_to_mont_felem(z, Z, curve->mont);
+
+  vec_jmulwnaf_mont_inner(rx, ry, rz,
+                          curve,
+                          x, y, z,
+                          scalar);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+}
+
+void
+vec_jdmul_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+               vec_curve *curve,
+               mpz_t X1, mpz_t Y1, mpz_t Z1,
+               mpz_t scalar1,
+               mpz_t X2, mpz_t Y2, mpz_t Z2,
+               mpz_t scalar2)
+{
+  mont_felem x1;
+  mont_felem y1;
+  mont_felem z1;
+  mont_felem x2;
+  mont_felem y2;
+  mont_felem z2;
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  mpz_t_to_mont_felem(x1, X1, curve->mont);
+  mpz_t_to_mont_felem(y1, Y1, curve->mont);
+  mpz_t_to_mont_felem(z1, Z1, curve->mont);
+  mpz_t_to_mont_felem(x2, X2, curve->mont);
+  mpz_t_to_mont_felem(y2, Y2, curve->mont);
+  mpz_t_to_mont_felem(z2, Z2, curve->mont);
+
+  vec_jdmul_mont_inner(rx, ry, rz,
+                       curve,
+                       x1, y1, z1, scalar1,
+                       x2, y2, z2, scalar2);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+}
+
+void
+vec_jfdmul_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_curve *curve,
+                vec_jfmul_tab_ptr ptr,
+                mpz_t scalar1,
+                mpz_t X2, mpz_t Y2, mpz_t Z2,
+                mpz_t scalar2)
+{
+  mont_felem x2;
+  mont_felem y2;
+  mont_felem z2;
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  mpz_t_to_mont_felem(x2, X2, curve->mont);
+  mpz_t_to_mont_felem(y2, Y2, curve->mont);
+  mpz_t_to_mont_felem(z2, Z2, curve->mont);
+
+  vec_jfdmul_mont_inner(rx, ry, rz,
+                        curve, ptr.mont, scalar1,
+                        x2, y2, z2, scalar2);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+}
+
+void
+vec_jsmul_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+               vec_curve *curve,
+               mpz_t *X, mpz_t *Y, mpz_t *Z,
+               mpz_t *scalars,
+               size_t len)
+{
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  mont_felem *x = mpz_t_s_to_mont_felems(X, len, curve->mont);
+  mont_felem *y = mpz_t_s_to_mont_felems(Y, len, curve->mont);
+  mont_felem *z = mpz_t_s_to_mont_felems(Z, len, curve->mont);
+
+  vec_jsmul_mont_inner(rx, ry, rz,
+                       curve,
+                       x, y, z,
+                       scalars,
+                       len);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
+void
+vec_jsmul_bucket_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                      vec_curve *curve,
+                      mpz_t *X, mpz_t *Y, mpz_t *Z,
+                      mpz_t *scalars,
+                      size_t len)
+{
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  mont_felem *x = mpz_t_s_to_mont_felems(X, len, curve->mont);
+  mont_felem *y = mpz_t_s_to_mont_felems(Y, len, curve->mont);
+  mont_felem *z = mpz_t_s_to_mont_felems(Z, len, curve->mont);
+
+  vec_jsmul_bucket_mont_inner(rx, ry, rz,
+                              curve,
+                              x, y, z,
+                              scalars,
+                              len);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
+/*
+ * Replaces (x, y) by its image under the GLV endomorphism, i.e.,
+ * (beta * x, y), if endo is non-zero, and negates the result if neg
+ * is non-zero.
+ */
+static void
+glv_point_mont(mp_limb_t *x, mp_limb_t *y,
+               const mp_limb_t *beta, int endo, int neg,
+               const vec_mont_ctx *ctx)
+{
+  mont_felem zero;
+
+  if (endo)
+    {
+      mont_mul(x, x, beta, ctx);
+    }
+  if (neg)
+    {
+      memset(zero, 0, sizeof(mont_felem));
+      mont_sub(y, zero, y, ctx);
+    }
+}
+
+/* Computes the GLV multiplication in the native representation. */
+static void
+jmul_glv_mont(mp_limb_t *rx, mp_limb_t *ry, mp_limb_t *rz,
+              vec_curve *curve,
+              mpz_t X, mpz_t Y, mpz_t Z,
+              mpz_t scalar)
+{
+  mont_felem x1;
+  mont_felem y1;
+  mont_felem x2;
+  mont_felem y2;
+  mont_felem z;
+  mont_felem beta;
+  mpz_t k1;
+  mpz_t k2;
+
+  mpz_init(k1);
+  mpz_init(k2);
+
+  /* scalar = k1 + k2 * lambda mod n with k1 and k2 of half size. */
+  vec_glv_split(k1, k2, curve, scalar);
+
+  mpz_t_to_mont_felem(beta, curve->glv->beta, curve->mont);
+
+  mpz_t_to_mont_felem(x1, X, curve->mont);
+  mpz_t_to_mont_felem(y1, Y, curve->mont);
+  mpz_t_to_mont_felem(z, Z, curve->mont);
+
+  mont_assign(x2, x1);
+  mont_assign(y2, y1);
+
+  glv_point_mont(x1, y1, beta, 0, mpz_sgn(k1) < 0, curve->mont);
+  glv_point_mont(x2, y2, beta, 1, mpz_sgn(k2) < 0, curve->mont);
+
+  mpz_abs(k1, k1);
+  mpz_abs(k2, k2);
+
+  vec_jdmul_mont_inner(rx, ry, rz,
+                       curve,
+                       x1, y1, z, k1,
+                       x2, y2, z, k2);
+
+  mpz_clear(k2);
+  mpz_clear(k1);
+}
+
+void
+vec_jmul_glv_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                  vec_curve *curve,
+                  mpz_t X, mpz_t Y, mpz_t Z,
+                  mpz_t scalar)
+{
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  jmul_glv_mont(rx, ry, rz, curve, X, Y, Z, scalar);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+}
+
+void
+vec_jmul_aff_glv_mont(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar)
+{
+  mont_felem tx;
+  mont_felem ty;
+  mont_felem tz;
+
+  jmul_glv_mont(tx, ty, tz, curve, X, Y, Z, scalar);
+
+  vec_jaff_point_mont_inner(rx, ry, tx, ty, tz, curve);
+}
+
+/* Computes the GLV simultaneous multiplication in the native
+   representation. */
+static void
+jsmul_glv_mont(mp_limb_t *rx, mp_limb_t *ry, mp_limb_t *rz,
+               vec_curve *curve,
+               mpz_t *X, mpz_t *Y, mpz_t *Z,
+               mpz_t *scalars,
+               size_t len)
+{
+  size_t i;
+  mont_felem beta;
+
+  mont_felem *x = (mont_felem *)malloc(2 * len * sizeof(mont_felem));
+  mont_felem *y = (mont_felem *)malloc(2 * len * sizeof(mont_felem));
+  mont_felem *z = (mont_felem *)malloc(2 * len * sizeof(mont_felem));
+  mpz_t *ks = vec_array_alloc_init(2 * len);
+
+  mpz_t_to_mont_felem(beta, curve->glv->beta, curve->mont);
+
+  /* Each base P with scalar k gives the two bases P and beta(P) with
+     scalars k1 and k2 of half size, where the bases are negated when
+     the scalars are negative. */
+  for (i = 0; i < len; i++)
+    {
+      vec_glv_split(ks[i], ks[len + i], curve, scalars[i]);
+
+      mpz_t_to_mont_felem(x[i], X[i], curve->mont);
+      mpz_t_to_mont_felem(y[i], Y[i], curve->mont);
+      mpz_t_to_mont_felem(z[i], Z[i], curve->mont);
+
+      mont_assign(x[len + i], x[i]);
+      mont_assign(y[len + i], y[i]);
+      mont_assign(z[len + i], z[i]);
+
+      glv_point_mont(x[i], y[i], beta,
+                     0, mpz_sgn(ks[i]) < 0, curve->mont);
+      glv_point_mont(x[len + i], y[len + i], beta,
+                     1, mpz_sgn(ks[len + i]) < 0, curve->mont);
+
+      mpz_abs(ks[i], ks[i]);
+      mpz_abs(ks[len + i], ks[len + i]);
+    }
+
+  vec_jsmul_mont_inner(rx, ry, rz,
+                       curve,
+                       x, y, z,
+                       ks,
+                       2 * len);
+
+  vec_array_clear_free(ks, 2 * len);
+  free(x);
+  free(y);
+  free(z);
+}
+
+void
+vec_jsmul_glv_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   mpz_t *X, mpz_t *Y, mpz_t *Z,
+                   mpz_t *scalars,
+                   size_t len)
+{
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  jsmul_glv_mont(rx, ry, rz, curve, X, Y, Z, scalars, len);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+}
+
+void
+vec_jsmul_aff_glv_mont(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       mpz_t *scalars,
+                       size_t len)
+{
+  mont_felem tx;
+  mont_felem ty;
+  mont_felem tz;
+
+  jsmul_glv_mont(tx, ty, tz, curve, X, Y, Z, scalars, len);
+
+  vec_jaff_point_mont_inner(rx, ry, tx, ty, tz, curve);
+}
+
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_mont(vec_curve *curve,
+                           mpz_t X, mpz_t Y, mpz_t Z,
+                           size_t len,
+                           size_t threads)
+{
+  mont_felem x;
+  mont_felem y;
+  mont_felem z;
+  vec_jfmul_tab_ptr ptr;
+
+  ptr.mont =
+    (vec_jfmul_tab_mont_inner*)
+    malloc(sizeof(vec_jfmul_tab_mont_inner));
+
+  mpz_t_to_mont_felem(x, X, curve->mont);
+  mpz_t_to_mont_felem(y, Y, curve->mont);
+  mpz_t_to_mont_felem(z, Z, curve->mont);
+
+  vec_jfmul_init_mont_inner(ptr.mont, curve, len);
+
+  vec_jfmul_prcmp_par_mont_inner(curve, ptr.mont, x, y, z, threads);
+
+  return ptr;
+}
+
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_mont(vec_curve *curve,
+                       mpz_t X, mpz_t Y, mpz_t Z,
+                       size_t len)
+{
+  return vec_jfmul_precomp_par_mont(curve, X, Y, Z, len, 1);
+}
+
+void
+vec_jfmul_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+               vec_curve *curve,
+               vec_jfmul_tab_ptr ptr,
+               mpz_t scalar)
+{
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  vec_jfmul_cmp_mont_inner(rx, ry, rz,
+                           curve, ptr.mont,
+                           scalar);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+}
+
+void
+vec_jfmul_batch_mont(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                     vec_curve *curve, vec_jfmul_tab_ptr ptr,
+                     mpz_t *scalars,
+                     size_t len)
+{
+  size_t i;
+
+  mont_felem *rx = (mont_felem *)malloc(len * sizeof(mont_felem));
+  mont_felem *ry = (mont_felem *)malloc(len * sizeof(mont_felem));
+  mont_felem *rz = (mont_felem *)malloc(len * sizeof(mont_felem));
+
+  vec_jfmul_cmp_batch_mont_inner(rx, ry, rz,
+                                 curve, ptr.mont,
+                                 scalars,
+                                 len);
+
+  for (i = 0; i < len; i++)
+    {
+      mont_point_to_mpz_t(RX[i], RY[i], RZ[i],
+                          rx[i], ry[i], rz[i],
+                          curve->mont);
+    }
+
+  free(rx);
+  free(ry);
+  free(rz);
+}
+
+int
+vec_jfmul_save_mont(vec_curve *curve,
+                    vec_jfmul_tab_ptr ptr,
+                    const char *path)
+{
+  return vec_jfmul_save_mont_inner(curve, ptr.mont, path);
+}
+
+int
+vec_jfmul_load_mont(vec_jfmul_tab_ptr *ptr,
+                    vec_curve *curve,
+                    const char *path)
+{
+  vec_jfmul_tab_mont_inner *table;
+
+  table = vec_jfmul_load_mont_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->mont = table;
+  return 0;
+}
+
+void
+vec_jfmul_free_mont(vec_jfmul_tab_ptr ptr)
+{
+  vec_jfmul_clear_free_mont_inner(ptr.mont);
+}
+
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_mont(vec_curve *curve,
+                        mpz_t X, mpz_t Y, mpz_t Z,
+                        size_t len,
+                        size_t max_bytes)
+{
+  mont_felem x;
+  mont_felem y;
+  mont_felem z;
+  vec_jfcomb_tab_ptr ptr;
+
+  ptr.mont =
+    (vec_jfcomb_tab_mont_inner*)
+    malloc(sizeof(vec_jfcomb_tab_mont_inner));
+
+  mpz_t_to_mont_felem(x, X, curve->mont);
+  mpz_t_to_mont_felem(y, Y, curve->mont);
+  mpz_t_to_mont_felem(z, Z, curve->mont);
+
+  vec_jfcomb_init_mont_inner(ptr.mont, curve, len, max_bytes);
+
+  vec_jfcomb_prcmp_mont_inner(curve, ptr.mont, x, y, z);
+
+  return ptr;
+}
+
+void
+vec_jfcomb_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_curve *curve,
+                vec_jfcomb_tab_ptr ptr,
+                mpz_t scalar)
+{
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  vec_jfcomb_cmp_mont_inner(rx, ry, rz,
+                            curve, ptr.mont,
+                            scalar);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+}
+
+void
+vec_jfcomb_free_mont(vec_jfcomb_tab_ptr ptr)
+{
+  vec_jfcomb_clear_free_mont_inner(ptr.mont);
+}
+
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_mont(vec_curve *curve,
+                        mpz_t *X, mpz_t *Y, mpz_t *Z,
+                        size_t bases_len,
+                        size_t len,
+                        size_t max_bytes)
+{
+  vec_jfsmul_tab_ptr ptr;
+
+  mont_felem *x = mpz_t_s_to_mont_felems(X, bases_len, curve->mont);
+  mont_felem *y = mpz_t_s_to_mont_felems(Y, bases_len, curve->mont);
+  mont_felem *z = mpz_t_s_to_mont_felems(Z, bases_len, curve->mont);
+
+  ptr.mont =
+    (vec_jfsmul_tab_mont_inner*)
+    malloc(sizeof(vec_jfsmul_tab_mont_inner));
+
+  vec_jfsmul_init_mont_inner(ptr.mont, curve, bases_len, len, max_bytes);
+  vec_jfsmul_prcmp_mont_inner(curve, ptr.mont, x, y, z);
+
+  free(x);
+  free(y);
+  free(z);
+
+  return ptr;
+}
+
+void
+vec_jfsmul_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_curve *curve,
+                vec_jfsmul_tab_ptr ptr,
+                mpz_t *scalars)
+{
+  mont_felem rx;
+  mont_felem ry;
+  mont_felem rz;
+
+  vec_jfsmul_cmp_mont_inner(rx, ry, rz,
+                            curve, ptr.mont,
+                            scalars);
+
+  mont_point_to_mpz_t(RX, RY, RZ, rx, ry, rz, curve->mont);
+}
+
+int
+vec_jfsmul_save_mont(vec_curve *curve,
+                     vec_jfsmul_tab_ptr ptr,
+                     const char *path)
+{
+  return vec_jfsmul_save_mont_inner(curve, ptr.mont, path);
+}
+
+int
+vec_jfsmul_load_mont(vec_jfsmul_tab_ptr *ptr,
+                     vec_curve *curve,
+                     const char *path)
+{
+  vec_jfsmul_tab_mont_inner *table;
+
+  table = vec_jfsmul_load_mont_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->mont = table;
+  return 0;
+}
+
+void
+vec_jfsmul_free_mont(vec_jfsmul_tab_ptr ptr)
+{
+  vec_jfsmul_clear_free_mont_inner(ptr.mont);
+}
+
+void
+vec_jtune_mont(vec_tuning_costs *costs,
+               vec_curve *curve,
+               long millisecs)
+{
+  vec_jtune_mont_inner(costs, curve, millisecs);
+}
+
+void
+vec_jaff_batch_mont(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                    size_t len,
+                    vec_curve *curve)
+{
+  vec_jaff_batch_mont_inner(X, Y, Z, len, curve);
+}
+
+void
+vec_jmul_aff_mont(mpz_t rx, mpz_t ry,
+                  vec_curve *curve,
+                  mpz_t X, mpz_t Y, mpz_t Z,
+                  mpz_t scalar)
+{
+  mont_felem x;
+  mont_felem y;
+  mont_felem z;
+  mont_felem tx;
+  mont_felem ty;
+  mont_felem tz;
+
+  mpz_t_to_mont_felem(x, X, curve->mont);
+  mpz_t_to_mont_felem(y, Y, curve->mont);
+  mpz_t_to_mont_felem(z, Z, curve->mont);
+
+  vec_jmulwnaf_mont_inner(tx, ty, tz,
+                          curve,
+                          x, y, z,
+                          scalar);
+
+  vec_jaff_point_mont_inner(rx, ry, tx, ty, tz, curve);
+}
+
+void
+vec_jsmul_aff_mont(mpz_t rx, mpz_t ry,
+                   vec_curve *curve,
+                   mpz_t *X, mpz_t *Y, mpz_t *Z,
+                   mpz_t *scalars,
+                   size_t len)
+{
+  mont_felem tx;
+  mont_felem ty;
+  mont_felem tz;
+
+  mont_felem *x = mpz_t_s_to_mont_felems(X, len, curve->mont);
+  mont_felem *y = mpz_t_s_to_mont_felems(Y, len, curve->mont);
+  mont_felem *z = mpz_t_s_to_mont_felems(Z, len, curve->mont);
+
+  vec_jsmul_mont_inner(tx, ty, tz,
+                       curve,
+                       x, y, z,
+                       scalars,
+                       len);
+
+  vec_jaff_point_mont_inner(rx, ry, tx, ty, tz, curve);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
+void
+vec_jfmul_aff_mont(mpz_t rx, mpz_t ry,
+                   vec_curve *curve,
+                   vec_jfmul_tab_ptr ptr,
+                   mpz_t scalar)
+{
+  mont_felem tx;
+  mont_felem ty;
+  mont_felem tz;
+
+  vec_jfmul_cmp_mont_inner(tx, ty, tz,
+                           curve, ptr.mont,
+                           scalar);
+
+  vec_jaff_point_mont_inner(rx, ry, tx, ty, tz, curve);
+}
+
+void
+vec_jdbl_mont(vec_scratch_mpz_t scratch,
+              mpz_t X3, mpz_t Y3, mpz_t Z3,
+              vec_curve *curve,
+              mpz_t X1, mpz_t Y1, mpz_t Z1)
+{
+  mont_felem x_in;
+  mont_felem y_in;
+  mont_felem z_in;
+  mont_felem x_out;
+  mont_felem y_out;
+  mont_felem z_out;
+
+  VEC_UNUSED(scratch);
+
+  mpz_t_to_mont_felem(x_in, X1, curve->mont);
+  mpz_t_to_mont_felem(y_in, Y1, curve->mont);
+  mpz_t_to_mont_felem(z_in, Z1, curve->mont);
+
+  mont_point_double(x_out, y_out, z_out, x_in, y_in, z_in, curve->mont);
+
+  mont_point_to_mpz_t(X3, Y3, Z3, x_out, y_out, z_out, curve->mont);
+}
+
+void
+vec_jadd_mont(vec_scratch_mpz_t scratch,
+              mpz_t X3, mpz_t Y3, mpz_t Z3,
+              vec_curve *curve,
+              mpz_t X1, mpz_t Y1, mpz_t Z1,
+              mpz_t X2, mpz_t Y2, mpz_t Z2)
+{
+  mont_felem x1;
+  mont_felem y1;
+  mont_felem z1;
+  mont_felem x2;
+  mont_felem y2;
+  mont_felem z2;
+  mont_felem x3;
+  mont_felem y3;
+  mont_felem z3;
+
+  VEC_UNUSED(scratch);
+
+  mpz_t_to_mont_felem(x1, X1, curve->mont);
+  mpz_t_to_mont_felem(y1, Y1, curve->mont);
+  mpz_t_to_mont_felem(z1, Z1, curve->mont);
+  mpz_t_to_mont_felem(x2, X2, curve->mont);
+  mpz_t_to_mont_felem(y2, Y2, curve->mont);
+  mpz_t_to_mont_felem(z2, Z2, curve->mont);
+
+  mont_point_add(x3, y3, z3, x1, y1, z1, 0, x2, y2, z2, curve->mont);
+
+  mont_point_to_mpz_t(X3, Y3, Z3, x3, y3, z3, curve->mont);
+}
@@ -0,0 +1,371 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Montgomery arithmetic for curves over arbitrary prime fields of at
+ * most VEC_MONT_MAX_BITS bits. Field elements are stored as
+ * fixed-length limb arrays in Montgomery form, i.e., x is represented
+ * by xR mod p, where R = 2^(n * GMP_NUMB_BITS) and n is the number of
+ * limbs of the modulus. Elements are always fully reduced.
+ *
+ * This file is included by mont.c. All functions operate on the
+ * first n limbs of their arguments and allow outputs to alias
+ * inputs.
+ */
+
+#if GMP_NAIL_BITS != 0
+#error "Montgomery arithmetic requires GMP without nail bits."
+#endif
+
+#define VEC_MONT_MAX_BITS 521
+#define VEC_MONT_MAX_LIMBS \
+  ((VEC_MONT_MAX_BITS + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS)
+
+/* Kinds of x-coefficients with faster doubling formulas. */
+#define VEC_MONT_A_GENERIC 0
+#define VEC_MONT_A_EQ_NEG3 1
+#define VEC_MONT_A_EQ_0 2
+
+typedef mp_limb_t mont_felem[VEC_MONT_MAX_LIMBS];
+
+struct vec_mont_ctx
+{
+  mp_size_t n;            /**< Number of limbs of the modulus. */
+  mont_felem p;           /**< Modulus. */
+  mp_limb_t pinv;         /**< -p^(-1) mod 2^GMP_NUMB_BITS. */
+  mont_felem r2;          /**< R^2 mod p. */
+  mont_felem one;         /**< R mod p, i.e., one in Montgomery form. */
+  mont_felem a;           /**< x-coefficient in Montgomery form. */
+  int a_kind;             /**< Kind of x-coefficient. */
+};
+
+typedef struct vec_mont_ctx vec_mont_ctx;
+
+/* Montgomery reduction of the 2n-limb input t, which is destroyed,
+   using the method of mpn_redc_1 in GMP. The result is smaller than
+   2p and an outgoing carry is returned. */
+static mp_limb_t
+mont_redc(mp_limb_t *r, mp_limb_t *t, const vec_mont_ctx *ctx)
+{
+  mp_size_t i;
+  mp_size_t n = ctx->n;
+  mp_limb_t *tp = t;
+
+  for (i = 0; i < n; i++)
+    {
+      tp[0] = mpn_addmul_1(tp, ctx->p, n, tp[0] * ctx->pinv);
+      tp++;
+    }
+  return mpn_add_n(r, tp, t, n);
+}
+
+/* Subtracts the modulus if there is a carry or r >= p. */
+static void
+mont_reduce_once(mp_limb_t *r, mp_limb_t carry, const vec_mont_ctx *ctx)
+{
+  if (carry != 0 || mpn_cmp(r, ctx->p, ctx->n) >= 0)
+    {
+      mpn_sub_n(r, r, ctx->p, ctx->n);
+    }
+}
+
+static void
+mont_mul(mp_limb_t *r, const mp_limb_t *x, const mp_limb_t *y,
+         const vec_mont_ctx *ctx)
+{
+  mp_limb_t t[2 * VEC_MONT_MAX_LIMBS];
+
+  mpn_mul_n(t, x, y, ctx->n);
+  mont_reduce_once(r, mont_redc(r, t, ctx), ctx);
+}
+
+static void
+mont_sqr(mp_limb_t *r, const mp_limb_t *x, const vec_mont_ctx *ctx)
+{
+  mp_limb_t t[2 * VEC_MONT_MAX_LIMBS];
+
+  mpn_sqr(t, x, ctx->n);
+  mont_reduce_once(r, mont_redc(r, t, ctx), ctx);
+}
+
+static void
+mont_add(mp_limb_t *r, const mp_limb_t *x, const mp_limb_t *y,
+         const vec_mont_ctx *ctx)
+{
+  mont_reduce_once(r, mpn_add_n(r, x, y, ctx->n), ctx);
+}
+
+static void
+mont_sub(mp_limb_t *r, const mp_limb_t *x, const mp_limb_t *y,
+         const vec_mont_ctx *ctx)
+{
+  if (mpn_sub_n(r, x, y, ctx->n) != 0)
+    {
+      mpn_add_n(r, r, ctx->p, ctx->n);
+    }
+}
+
+static void
+mont_neg(mp_limb_t *r, const mp_limb_t *x, const vec_mont_ctx *ctx)
+{
+  if (mpn_zero_p(x, ctx->n))
+    {
+      mpn_zero(r, ctx->n);
+    }
+  else
+    {
+      mpn_sub_n(r, ctx->p, x, ctx->n);
+    }
+}
+
+static int
+mont_is_zero(const mp_limb_t *x, const vec_mont_ctx *ctx)
+{
+  return mpn_zero_p(x, ctx->n);
+}
+
+static void
+mont_assign(mp_limb_t *r, const mp_limb_t *x)
+{
+  memcpy(r, x, sizeof(mont_felem));
+}
+
+/* Sets the point to the point at infinity. */
+static void
+mont_point_unit(mp_limb_t *x, mp_limb_t *y, mp_limb_t *z)
+{
+  memset(x, 0, sizeof(mont_felem));
+  memset(y, 0, sizeof(mont_felem));
+  memset(z, 0, sizeof(mont_felem));
+}
+
+/* 1998 Cohen/Miyaji/Ono Jacobi coordinates, i.e., the same formulas
+   as in jdbl_generic_inner.c and jdbl_a_eq_neg3_generic_inner.c. */
+static void
+mont_point_double(mp_limb_t *x3, mp_limb_t *y3, mp_limb_t *z3,
+                  const mp_limb_t *x1, const mp_limb_t *y1,
+                  const mp_limb_t *z1,
+                  const vec_mont_ctx *ctx)
+{
+  mont_felem S;
+  mont_felem M;
+  mont_felem T;
+  mont_felem t1;
+  mont_felem t2;
+
+  /* (X1, Y1, Z1) is point at infinity or point which is its own
+     inverse. */
+  if (mont_is_zero(z1, ctx) || mont_is_zero(y1, ctx))
+    {
+      mont_point_unit(x3, y3, z3);
+      return;
+    }
+
+  /* S = 4*X1*Y1^2 */
+  mont_sqr(t1, y1, ctx);
+  mont_mul(S, t1, x1, ctx);
+  mont_add(S, S, S, ctx);
+  mont_add(S, S, S, ctx);
+
+  /* M = 3*X1^2+a*Z1^4 */
+  switch (ctx->a_kind)
+    {
+    case VEC_MONT_A_EQ_NEG3:
+
+      /* M = 3*(X1-Z1^2)*(X1+Z1^2) */
+      mont_sqr(t2, z1, ctx);
+      mont_sub(M, x1, t2, ctx);
+      mont_add(t2, x1, t2, ctx);
+      mont_mul(M, M, t2, ctx);
+      mont_add(t2, M, M, ctx);
+      mont_add(M, M, t2, ctx);
+      break;
+
+    case VEC_MONT_A_EQ_0:
+
+      /* M = 3*X1^2 */
+      mont_sqr(M, x1, ctx);
+      mont_add(t2, M, M, ctx);
+      mont_add(M, M, t2, ctx);
+      break;
+
+    default:
+
+      mont_sqr(M, x1, ctx);
+      mont_add(t2, M, M, ctx);
+      mont_add(M, M, t2, ctx);
+
+      mont_sqr(t2, z1, ctx);
+      mont_sqr(t2, t2, ctx);
+      mont_mul(t2, t2, ctx->a, ctx);
+      mont_add(M, M, t2, ctx);
+    }
+
+  /* T = M^2-2*S */
+  mont_sqr(T, M, ctx);
+  mont_sub(T, T, S, ctx);
+  mont_sub(T, T, S, ctx);
+
+  /* Z3 = 2*Y1*Z1, computed before Y1 may be overwritten. */
+  mont_mul(t2, y1, z1, ctx);
+  mont_add(z3, t2, t2, ctx);
+
+  /* Y3 = M*(S-T)-8*Y1^4, where t1 = Y1^2 */
+  mont_sqr(t1, t1, ctx);
+  mont_add(t1, t1, t1, ctx);
+  mont_add(t1, t1, t1, ctx);
+  mont_add(t1, t1, t1, ctx);
+
+  mont_sub(S, S, T, ctx);
+  mont_mul(S, S, M, ctx);
+  mont_sub(y3, S, t1, ctx);
+
+  /* X3 = T */
+  mont_assign(x3, T);
+}
+
+/* 1998 Cohen/Miyaji/Ono Jacobi coordinates, i.e., the same formulas
+   as in jadd_generic_inner.c. If mixed is non-zero, then Z2 must be
+   one or zero, which saves the powers of Z2. */
+static void
+mont_point_add(mp_limb_t *x3, mp_limb_t *y3, mp_limb_t *z3,
+               const mp_limb_t *x1, const mp_limb_t *y1,
+               const mp_limb_t *z1,
+               const int mixed,
+               const mp_limb_t *x2, const mp_limb_t *y2,
+               const mp_limb_t *z2,
+               const vec_mont_ctx *ctx)
+{
+  mont_felem U1;
+  mont_felem S1;
+  mont_felem S2;
+  mont_felem H;
+  mont_felem r;
+  mont_felem t1;
+  mont_felem t2;
+  mont_felem t3;
+
+  /* P1 is point at infinity. */
+  if (mont_is_zero(z1, ctx))
+    {
+
+      /* P2 is also point at infinity. */
+      if (mont_is_zero(z2, ctx))
+        {
+          mont_point_unit(x3, y3, z3);
+        }
+
+      /* P1 is point at infinity and P2 is not. */
+      else
+        {
+          mont_assign(x3, x2);
+          mont_assign(y3, y2);
+          mont_assign(z3, z2);
+        }
+      return;
+    }
+
+  /* P2 is point at infinity and P1 is not. */
+  else if (mont_is_zero(z2, ctx))
+    {
+      mont_assign(x3, x1);
+      mont_assign(y3, y1);
+      mont_assign(z3, z1);
+      return;
+    }
+
+  /* Compute powers of Z1. */
+  mont_sqr(t2, z1, ctx);         /* t2 = Z1^2 */
+  mont_mul(t3, t2, z1, ctx);     /* t3 = Z1^3 */
+
+  if (!mixed)
+    {
+
+      /* Compute powers of Z2. */
+      mont_sqr(t1, z2, ctx);     /* t1 = Z2^2 */
+      mont_mul(S2, t1, z2, ctx); /* S2 = Z2^3 */
+
+      /* U1:=X1*Z2^2 */
+      mont_mul(U1, x1, t1, ctx);
+
+      /* S1:=Y1*Z2^3 */
+      mont_mul(S1, y1, S2, ctx);
+    }
+  else
+    {
+      mont_assign(U1, x1);
+      mont_assign(S1, y1);
+    }
+
+  /* H:=U2-U1, where U2:=X2*Z1^2 */
+  mont_mul(H, x2, t2, ctx);
+  mont_sub(H, H, U1, ctx);
+
+  /* r:=S2-S1, where S2:=Y2*Z1^3 */
+  mont_mul(r, y2, t3, ctx);
+  mont_sub(r, r, S1, ctx);
+
+  if (mont_is_zero(H, ctx))
+    {
+      if (!mont_is_zero(r, ctx))
+        {
+          mont_point_unit(x3, y3, z3);
+        }
+      else
+        {
+          mont_point_double(x3, y3, z3, x1, y1, z1, ctx);
+        }
+      return;
+    }
+
+  /* Z3:=Z1*Z2*H, computed before Z1 may be overwritten. */
+  if (!mixed)
+    {
+      mont_mul(t1, z1, z2, ctx);
+      mont_mul(z3, t1, H, ctx);
+    }
+  else
+    {
+      mont_mul(z3, z1, H, ctx);
+    }
+
+  /* Compute powers of H. */
+  mont_sqr(t2, H, ctx);          /* t2 = H^2 */
+  mont_mul(t3, t2, H, ctx);      /* t3 = H^3 */
+
+  /* X3:=-H^3-2*U1*H^2+r^2 */
+  mont_mul(U1, U1, t2, ctx);     /* U1 = U1*H^2 */
+  mont_sqr(t1, r, ctx);
+  mont_sub(t1, t1, t3, ctx);
+  mont_sub(t1, t1, U1, ctx);
+  mont_sub(x3, t1, U1, ctx);
+
+  /* Y3:=-S1*H^3+r*(U1*H^2-X3) */
+  mont_sub(t1, U1, x3, ctx);
+  mont_mul(t1, r, t1, ctx);
+  mont_mul(t2, S1, t3, ctx);
+  mont_sub(y3, t1, t2, ctx);
+}
@@ -0,0 +1,112 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "undefine_macros.h"
+
+#define POSTFIX _mont_inner
+#define TAB_POSTFIX _mont_inner
+
+#define FIELD_ELEMENT mont_felem
+#define FIELD_ELEMENT_INIT(x)
+#define FIELD_ELEMENT_CLEAR(x)
+#define FIELD_ELEMENT_UNIT(x, y, z) \
+  mont_point_unit(x, y, z)
+#define FIELD_ELEMENT_SET(rx, ry, rz, x, y, z) \
+  mont_assign(rx, x);                          \
+  mont_assign(ry, y);                          \
+  mont_assign(rz, z)
+
+#define FIELD_ELEMENT_VAR mont_felem
+#define FIELD_ELEMENT_VAR_INIT(x)
+#define FIELD_ELEMENT_VAR_CLEAR(x)
+#define FIELD_ELEMENT_VAR_UNIT(x, y, z) \
+  mont_point_unit(x, y, z)
+#define FIELD_ELEMENT_VAR_SET(rx, ry, rz, x, y, z) \
+  mont_assign(rx, x);                              \
+  mont_assign(ry, y);                              \
+  mont_assign(rz, z)
+
+#define FIELD_ELEMENT_VAR_BYTES(curve) sizeof(mont_felem)
+#define FIELD_ELEMENT_VAR_WRITE(dst, x, curve) \
+  memcpy(dst, x, sizeof(mont_felem))
+
+#define FIELD_ELEMENT_VAR_IMPORT(x, y, z, X, Y, Z, curve) \
+  mpz_t_to_mont_felem(x, X, curve->mont);               \
+  mpz_t_to_mont_felem(y, Y, curve->mont);               \
+  mpz_t_to_mont_felem(z, Z, curve->mont)
+#define FIELD_ELEMENT_VAR_EXPORT(X, Y, Z, x, y, z, curve) \
+  mont_point_to_mpz_t(X, Y, Z, x, y, z, curve->mont)
+
+#define FIELD_ELEMENT_VAR_FROM_MPZ(x, X, curve) \
+  mpz_t_to_mont_felem(x, X, curve->mont)
+#define FIELD_ELEMENT_VAR_TO_MPZ(X, x, curve) \
+  mont_felem_to_mpz_t(X, x, curve->mont)
+#define FIELD_ELEMENT_VAR_MUL(r, x, y, curve) \
+  mont_mul(r, x, y, curve->mont)
+#define FIELD_ELEMENT_VAR_IS_ZERO(x, curve) mont_is_zero(x, curve->mont)
+#define FIELD_ELEMENT_VAR_NEG(r, x, curve) mont_neg(r, x, curve->mont)
+
+#define FIELD_ELEMENT_CONTRACT(rx, ry, rz, x, y, z) \
+  mont_assign(rx, x);                               \
+  mont_assign(ry, y);                               \
+  mont_assign(rz, z)
+
+#define SCRATCH(scratch)
+#define SCRATCH_INIT(scratch)
+#define SCRATCH_CLEAR(scratch)
+
+#define ARRAY_MALLOC_INIT(len) \
+  (FIELD_ELEMENT *)calloc(len, sizeof(FIELD_ELEMENT))
+
+#define ARRAY_CLEAR_FREE(array, len) free(array)
+#define ARRAY_CONTIGUOUS
+
+#define ARRAY_MAP(src, len, curve) ((mont_felem *)(src))
+#define ARRAY_UNMAP(array) VEC_UNUSED(array)
+
+#define JFMUL_LANES_MIN_WIDTH 4
+
+#define JDBL(scratch, rx, ry, rz, curve, x, y, z) \
+  (VEC_STATS_INC(curve, dbl),                     \
+   mont_point_double(rx, ry, rz, x, y, z, curve->mont))
+
+#define JDBL_VAR(scratch, rx, ry, rz, curve, x, y, z) \
+  (VEC_STATS_INC(curve, dbl),                         \
+   mont_point_double(rx, ry, rz, x, y, z, curve->mont))
+
+#define JADD(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, add),                                    \
+   mont_point_add(rx, ry, rz, x1, y1, z1, 0, x2, y2, z2, curve->mont))
+
+#define JADD_VAR(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, add),                                        \
+   mont_point_add(rx, ry, rz, x1, y1, z1, 0, x2, y2, z2, curve->mont))
+
+#define JADD_MIXED(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, madd),                                         \
+   mont_point_add(rx, ry, rz, x1, y1, z1, 1, x2, y2, z2, curve->mont))
+
+#define CURVE vec_curve
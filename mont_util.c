@@ -0,0 +1,105 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Conversions between mpz_t and Montgomery form. This file is
+ * included by mont.c.
+ */
+
+static void
+mpz_t_to_mont_felem(mp_limb_t *rop, const mpz_t op, const vec_mont_ctx *ctx)
+{
+  mpz_t tmp;
+  mont_felem t;
+
+  mpz_init(tmp);
+  mpz_set(tmp, op);
+
+  /* Inputs are normally reduced already, but we make sure. */
+  if (mpz_sgn(tmp) < 0 || mpz_size(tmp) > (size_t)ctx->n)
+    {
+      mpz_t p;
+      mpz_mod(tmp, tmp, mpz_roinit_n(p, ctx->p, ctx->n));
+    }
+
+  memset(t, 0, sizeof(mont_felem));
+  memcpy(t, mpz_limbs_read(tmp), mpz_size(tmp) * sizeof(mp_limb_t));
+
+  memset(rop, 0, sizeof(mont_felem));
+  mont_mul(rop, t, ctx->r2, ctx);
+
+  mpz_clear(tmp);
+}
+
+static void
+mont_felem_to_mpz_t(mpz_t rop, const mp_limb_t *op, const vec_mont_ctx *ctx)
+{
+  mpz_t tmp;
+  mont_felem t;
+  mont_felem one;
+
+  memset(one, 0, sizeof(mont_felem));
+  one[0] = 1;
+
+  mont_mul(t, op, one, ctx);
+  mpz_set(rop, mpz_roinit_n(tmp, t, ctx->n));
+}
+
+/* Points at infinity are represented by a zero z-coordinate in
+   Montgomery form, but we use the canonical representation (0, 1,
+   0) for mpz_t. */
+static void
+mont_point_to_mpz_t(mpz_t X, mpz_t Y, mpz_t Z,
+                    const mp_limb_t *x, const mp_limb_t *y,
+                    const mp_limb_t *z,
+                    const vec_mont_ctx *ctx)
+{
+  if (mont_is_zero(z, ctx))
+    {
+      mpz_set_ui(X, 0);
+      mpz_set_ui(Y, 1);
+      mpz_set_ui(Z, 0);
+    }
+  else
+    {
+      mont_felem_to_mpz_t(X, x, ctx);
+      mont_felem_to_mpz_t(Y, y, ctx);
+      mont_felem_to_mpz_t(Z, z, ctx);
+    }
+}
+
+static mont_felem *
+mpz_t_s_to_mont_felems(mpz_t *ops, size_t len, const vec_mont_ctx *ctx)
+{
+  size_t i;
+  mont_felem *rops = (mont_felem *)malloc(len * sizeof(mont_felem));
+
+  for (i = 0; i < len; i++)
+    {
+      mpz_t_to_mont_felem(rops[i], ops[i], ctx);
+    }
+  return rops;
+}
@@ -0,0 +1,78 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gmp.h>
+#include "vec.h"
+
+/*
+ * Computes a "theoretical" optimal window width for multiplication of
+ * a single point, counted in additions. With unsigned digits, the
+ * table holds the odd multiples 1, 3, ..., 2^w - 1 and a window is
+ * added for roughly every w + 1 bits. With signed digits, negation is
+ * free, so the table only holds 1, 3, ..., 2^(w - 1) - 1 and the
+ * non-zero digits of the wNAF have density 1 / (w + 1).
+ */
+int
+vec_mul_window_width(int bit_length, int signed_digits) {
+
+  int width;
+  double cost;
+  double new_cost;
+
+  if (signed_digits)
+    {
+
+      /* Width two corresponds to NAF, i.e., a table holding only the
+         basis itself. */
+      width = 2;
+      new_cost = 1 + ((double)bit_length) / 3;
+
+      do {
+
+        width++;
+        cost = new_cost;
+        new_cost = (1 << (width - 2)) + ((double)bit_length) / (width + 1);
+
+      } while (new_cost < cost && width <= VEC_WNAF_MAX_WIDTH);
+    }
+  else
+    {
+      width = 1;
+      new_cost = bit_length / 2;
+
+      do {
+
+        width++;
+        cost = new_cost;
+        new_cost = (1 << (width - 1)) +
+          ((double)((1 << width) - 1) * bit_length) / ((1 << width) * width);
+
+      } while (new_cost < cost);
+    }
+
+  width--;
+
+  return width;
+}
@@ -34,12 +34,29 @@
 #include "ecp_nistp224_core.c"
 #include "ecp_nistp224_util.c"
 
+const char *
+vec_arithmetic_nistp224(void)
+{
+  return "portable";
+}
+
 #include "nistp224_macros.h"
 
 #include "jmul_template.h"
 #include "jmulsw_template.h"
+#include "jmulwnaf_template.h"
+#include "jaff_batch_template.h"
+#include "fpowm_template.h"
+#include "jsmul_bucket_template.h"
 #include "jsmul_template.h"
 #include "jfmul_template.h"
+#include "jsmul_file_template.h"
+#include "jfmul_file_template.h"
+#include "jdmul_template.h"
+#include "jfcomb_template.h"
+#include "jfsmul_template.h"
+#include "jtune_template.h"
+#include "point_array_template.h"
 
 /* Naive version of multiplication. Only used during development.
 void
@@ -95,6 +112,95 @@ vec_jmulsw_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
   felem_to_mpz_t(RZ, rz);
 }
 
+void
+vec_jmulwnaf_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar)
+{
+  felem x;
+  felem y;
+  felem z;
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+  mpz_t_to_felem(z, Z);
+
+  vec_jmulwnaf_nistp224_inner(rx, ry, rz,
+                              curve,
+                              x, y, z,
+                              scalar);
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jdmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   mpz_t X1, mpz_t Y1, mpz_t Z1,
+                   mpz_t scalar1,
+                   mpz_t X2, mpz_t Y2, mpz_t Z2,
+                   mpz_t scalar2)
+{
+  felem x1;
+  felem y1;
+  felem z1;
+  felem x2;
+  felem y2;
+  felem z2;
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_felem(x1, X1);
+  mpz_t_to_felem(y1, Y1);
+  mpz_t_to_felem(z1, Z1);
+  mpz_t_to_felem(x2, X2);
+  mpz_t_to_felem(y2, Y2);
+  mpz_t_to_felem(z2, Z2);
+
+  vec_jdmul_nistp224_inner(rx, ry, rz,
+                           curve,
+                           x1, y1, z1, scalar1,
+                           x2, y2, z2, scalar2);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jfdmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    vec_jfmul_tab_ptr ptr,
+                    mpz_t scalar1,
+                    mpz_t X2, mpz_t Y2, mpz_t Z2,
+                    mpz_t scalar2)
+{
+  felem x2;
+  felem y2;
+  felem z2;
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_felem(x2, X2);
+  mpz_t_to_felem(y2, Y2);
+  mpz_t_to_felem(z2, Z2);
+
+  vec_jfdmul_nistp224_inner(rx, ry, rz,
+                            curve, ptr.nistp224, scalar1,
+                            x2, y2, z2, scalar2);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
 void
 vec_jsmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
                    vec_curve *curve,
@@ -124,10 +230,40 @@ vec_jsmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
   free(z);
 }
 
+void
+vec_jsmul_bucket_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                          vec_curve *curve,
+                          mpz_t *X, mpz_t *Y, mpz_t *Z,
+                          mpz_t *scalars,
+                          size_t len)
+{
+  felem rx;
+  felem ry;
+  felem rz;
+
+  felem *x = mpz_t_s_to_felems(X, len);
+  felem *y = mpz_t_s_to_felems(Y, len);
+  felem *z = mpz_t_s_to_felems(Z, len);
+
+  vec_jsmul_bucket_nistp224_inner(rx, ry, rz,
+                                  curve,
+                                  x, y, z,
+                                  scalars,
+                                  len);
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
 vec_jfmul_tab_ptr
-vec_jfmul_precomp_nistp224(vec_curve *curve,
-                           mpz_t X, mpz_t Y, mpz_t Z,
-                           size_t len)
+vec_jfmul_precomp_par_nistp224(vec_curve *curve,
+                               mpz_t X, mpz_t Y, mpz_t Z,
+                               size_t len,
+                               size_t threads)
 {
   felem x;
   felem y;
@@ -144,11 +280,19 @@ vec_jfmul_precomp_nistp224(vec_curve *curve,
 
   vec_jfmul_init_nistp224_inner(ptr.nistp224, curve, len);
 
-  vec_jfmul_prcmp_nistp224_inner(curve, ptr.nistp224, x, y, z);
+  vec_jfmul_prcmp_par_nistp224_inner(curve, ptr.nistp224, x, y, z, threads);
 
   return ptr;
 }
 
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_nistp224(vec_curve *curve,
+                           mpz_t X, mpz_t Y, mpz_t Z,
+                           size_t len)
+{
+  return vec_jfmul_precomp_par_nistp224(curve, X, Y, Z, len, 1);
+}
+
 void
 vec_jfmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
                    vec_curve *curve,
@@ -168,12 +312,290 @@ vec_jfmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
   felem_to_mpz_t(RZ, rz);
 }
 
+void
+vec_jfmul_batch_nistp224(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                         vec_curve *curve, vec_jfmul_tab_ptr ptr,
+                         mpz_t *scalars,
+                         size_t len)
+{
+  size_t i;
+
+  felem *rx = (felem *)malloc(len * sizeof(felem));
+  felem *ry = (felem *)malloc(len * sizeof(felem));
+  felem *rz = (felem *)malloc(len * sizeof(felem));
+
+  vec_jfmul_cmp_batch_nistp224_inner(rx, ry, rz,
+                                     curve, ptr.nistp224,
+                                     scalars,
+                                     len);
+
+  for (i = 0; i < len; i++)
+    {
+      felem_to_mpz_t(RX[i], rx[i]);
+      felem_to_mpz_t(RY[i], ry[i]);
+      felem_to_mpz_t(RZ[i], rz[i]);
+    }
+
+  free(rx);
+  free(ry);
+  free(rz);
+}
+
+int
+vec_jfmul_save_nistp224(vec_curve *curve,
+                        vec_jfmul_tab_ptr ptr,
+                        const char *path)
+{
+  return vec_jfmul_save_nistp224_inner(curve, ptr.nistp224, path);
+}
+
+int
+vec_jfmul_load_nistp224(vec_jfmul_tab_ptr *ptr,
+                        vec_curve *curve,
+                        const char *path)
+{
+  vec_jfmul_tab_nistp224_inner *table;
+
+  table = vec_jfmul_load_nistp224_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->nistp224 = table;
+  return 0;
+}
+
 void
 vec_jfmul_free_nistp224(vec_jfmul_tab_ptr ptr)
 {
   vec_jfmul_clear_free_nistp224_inner(ptr.nistp224);
 }
 
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_nistp224(vec_curve *curve,
+                            mpz_t X, mpz_t Y, mpz_t Z,
+                            size_t len,
+                            size_t max_bytes)
+{
+  felem x;
+  felem y;
+  felem z;
+  vec_jfcomb_tab_ptr ptr;
+
+  ptr.nistp224 =
+    (vec_jfcomb_tab_nistp224_inner*)
+    malloc(sizeof(vec_jfcomb_tab_nistp224_inner));
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+  mpz_t_to_felem(z, Z);
+
+  vec_jfcomb_init_nistp224_inner(ptr.nistp224, curve, len, max_bytes);
+
+  vec_jfcomb_prcmp_nistp224_inner(curve, ptr.nistp224, x, y, z);
+
+  return ptr;
+}
+
+void
+vec_jfcomb_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    vec_jfcomb_tab_ptr ptr,
+                    mpz_t scalar)
+{
+  felem rx;
+  felem ry;
+  felem rz;
+
+  vec_jfcomb_cmp_nistp224_inner(rx, ry, rz,
+                                curve, ptr.nistp224,
+                                scalar);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jfcomb_free_nistp224(vec_jfcomb_tab_ptr ptr)
+{
+  vec_jfcomb_clear_free_nistp224_inner(ptr.nistp224);
+}
+
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_nistp224(vec_curve *curve,
+                            mpz_t *X, mpz_t *Y, mpz_t *Z,
+                            size_t bases_len,
+                            size_t len,
+                            size_t max_bytes)
+{
+  vec_jfsmul_tab_ptr ptr;
+
+  felem *x = mpz_t_s_to_felems(X, bases_len);
+  felem *y = mpz_t_s_to_felems(Y, bases_len);
+  felem *z = mpz_t_s_to_felems(Z, bases_len);
+
+  ptr.nistp224 =
+    (vec_jfsmul_tab_nistp224_inner*)
+    malloc(sizeof(vec_jfsmul_tab_nistp224_inner));
+
+  vec_jfsmul_init_nistp224_inner(ptr.nistp224, curve,
+                                 bases_len, len, max_bytes);
+  vec_jfsmul_prcmp_nistp224_inner(curve, ptr.nistp224, x, y, z);
+
+  free(x);
+  free(y);
+  free(z);
+
+  return ptr;
+}
+
+void
+vec_jfsmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    vec_jfsmul_tab_ptr ptr,
+                    mpz_t *scalars)
+{
+  felem rx;
+  felem ry;
+  felem rz;
+
+  vec_jfsmul_cmp_nistp224_inner(rx, ry, rz,
+                                curve, ptr.nistp224,
+                                scalars);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+int
+vec_jfsmul_save_nistp224(vec_curve *curve,
+                         vec_jfsmul_tab_ptr ptr,
+                         const char *path)
+{
+  return vec_jfsmul_save_nistp224_inner(curve, ptr.nistp224, path);
+}
+
+int
+vec_jfsmul_load_nistp224(vec_jfsmul_tab_ptr *ptr,
+                         vec_curve *curve,
+                         const char *path)
+{
+  vec_jfsmul_tab_nistp224_inner *table;
+
+  table = vec_jfsmul_load_nistp224_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->nistp224 = table;
+  return 0;
+}
+
+void
+vec_jfsmul_free_nistp224(vec_jfsmul_tab_ptr ptr)
+{
+  vec_jfsmul_clear_free_nistp224_inner(ptr.nistp224);
+}
+
+void
+vec_jtune_nistp224(vec_tuning_costs *costs,
+                   vec_curve *curve,
+                   long millisecs)
+{
+  vec_jtune_nistp224_inner(costs, curve, millisecs);
+}
+
+void
+vec_jaff_batch_nistp224(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                        size_t len,
+                        vec_curve *curve)
+{
+  vec_jaff_batch_nistp224_inner(X, Y, Z, len, curve);
+}
+
+void
+vec_fpowm_nistp224(mpz_t *rops,
+                   mpz_t *bases,
+                   mpz_t exponent,
+                   size_t len,
+                   vec_curve *curve)
+{
+  vec_fpowm_nistp224_inner(rops, bases, exponent, len, curve);
+}
+
+void
+vec_jmul_aff_nistp224(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar)
+{
+  felem x;
+  felem y;
+  felem z;
+
+  felem tx;
+  felem ty;
+  felem tz;
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+  mpz_t_to_felem(z, Z);
+
+  vec_jmulwnaf_nistp224_inner(tx, ty, tz,
+                              curve,
+                              x, y, z,
+                              scalar);
+
+  vec_jaff_point_nistp224_inner(rx, ry, tx, ty, tz, curve);
+}
+
+void
+vec_jsmul_aff_nistp224(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       mpz_t *scalars,
+                       size_t len)
+{
+  felem tx;
+  felem ty;
+  felem tz;
+
+  felem *x = mpz_t_s_to_felems(X, len);
+  felem *y = mpz_t_s_to_felems(Y, len);
+  felem *z = mpz_t_s_to_felems(Z, len);
+
+  vec_jsmul_nistp224_inner(tx, ty, tz,
+                           curve,
+                           x, y, z,
+                           scalars,
+                           len);
+
+  vec_jaff_point_nistp224_inner(rx, ry, tx, ty, tz, curve);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
+void
+vec_jfmul_aff_nistp224(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       vec_jfmul_tab_ptr ptr,
+                       mpz_t scalar)
+{
+  felem tx;
+  felem ty;
+  felem tz;
+
+  vec_jfmul_cmp_nistp224_inner(tx, ty, tz,
+                               curve, ptr.nistp224,
+                               scalar);
+
+  vec_jaff_point_nistp224_inner(rx, ry, tx, ty, tz, curve);
+}
+
 void
 vec_jdbl_nistp224(vec_scratch_mpz_t scratch,
                   mpz_t X3, mpz_t Y3, mpz_t Z3,
@@ -228,7 +650,7 @@ vec_jadd_nistp224(vec_scratch_mpz_t scratch,
   mpz_t_to_felem(y2, Y2);
   mpz_t_to_felem(z2, Z2);
 
-  point_add(x3, y3, z3, x1, y1, z1, x2, y2, z2);
+  point_add(x3, y3, z3, x1, y1, z1, 0, x2, y2, z2);
 
   felem_to_mpz_t(X3, x3);
   felem_to_mpz_t(Y3, y3);
@@ -301,7 +723,7 @@ time_jadd_nistp224(int test_time, mpz_t X, mpz_t Y)
   i = 0;
   do
     {
-      point_add(rx, ry, rz, rx, ry, rz, x, y, z);
+      point_add(rx, ry, rz, rx, ry, rz, 0, x, y, z);
       i++;
     }
   while (!vec_done(t, test_time));
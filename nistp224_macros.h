@@ -53,11 +53,38 @@
   felem_assign(ry, y);                             \
   felem_assign(rz, z)
 
+#define FIELD_ELEMENT_VAR_BYTES(curve) sizeof(felem)
+#define FIELD_ELEMENT_VAR_WRITE(dst, x, curve) \
+  memcpy(dst, x, sizeof(felem))
+
+#define FIELD_ELEMENT_VAR_IMPORT(x, y, z, X, Y, Z, curve) \
+  mpz_t_to_felem(x, X);                                 \
+  mpz_t_to_felem(y, Y);                                 \
+  mpz_t_to_felem(z, Z)
+#define FIELD_ELEMENT_VAR_EXPORT(X, Y, Z, x, y, z, curve) \
+  felem_to_mpz_t(X, x);                                 \
+  felem_to_mpz_t(Y, y);                                 \
+  felem_to_mpz_t(Z, z)
+
+#define FIELD_ELEMENT_VAR_FROM_MPZ(x, X, curve) mpz_t_to_felem(x, X)
+#define FIELD_ELEMENT_VAR_TO_MPZ(X, x, curve) \
+  felem_contract(x, x);                        \
+  felem_to_mpz_t(X, x)
+#define FIELD_ELEMENT_VAR_MUL(r, x, y, curve) felem_mul_reduce(r, x, y)
+#define FIELD_ELEMENT_VAR_IS_ZERO(x, curve) (felem_is_zero(x) != 0)
+#define FIELD_ELEMENT_VAR_NEG(r, x, curve) felem_neg(r, x)
+
 #define FIELD_ELEMENT_CONTRACT(rx, ry, rz, x, y, z) \
   felem_assign(rx, x);                              \
   felem_assign(ry, y);                              \
   felem_assign(rz, z)
 
+#define FPOWM_ELEMENT felem
+#define FPOWM_FROM_MPZ(x, X, curve) mpz_t_to_felem(x, X)
+#define FPOWM_TO_MPZ(X, x, curve) felem_to_mpz_t(X, x)
+#define FPOWM_MUL(r, x, y, curve) felem_mul_reduce(r, x, y)
+#define FPOWM_SQR(r, x, curve) felem_square_reduce(r, x)
+
 #define SCRATCH(scratch)
 #define SCRATCH_INIT(scratch)
 #define SCRATCH_CLEAR(scratch)
@@ -66,17 +93,29 @@
   (FIELD_ELEMENT *)malloc(len * sizeof(FIELD_ELEMENT))
 
 #define ARRAY_CLEAR_FREE(array, len) free(array)
+#define ARRAY_CONTIGUOUS
+
+#define ARRAY_MAP(src, len, curve) ((felem *)(src))
+#define ARRAY_UNMAP(array) VEC_UNUSED(array)
 
 #define JDBL(scratch, rx, ry, rz, curve, x, y, z) \
-  point_double(rx, ry, rz, x, y, z)
+  (VEC_STATS_INC(curve, dbl),                     \
+   point_double(rx, ry, rz, x, y, z))
 
 #define JDBL_VAR(scratch, rx, ry, rz, curve, x, y, z) \
-  point_double(rx, ry, rz, x, y, z)
+  (VEC_STATS_INC(curve, dbl),                         \
+   point_double(rx, ry, rz, x, y, z))
 
 #define JADD(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
-  point_add(rx, ry, rz, x1, y1, z1, x2, y2, z2)
+  (VEC_STATS_INC(curve, add),                                    \
+   point_add(rx, ry, rz, x1, y1, z1, 0, x2, y2, z2))
 
 #define JADD_VAR(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
-  point_add(rx, ry, rz, x1, y1, z1, x2, y2, z2)
+  (VEC_STATS_INC(curve, add),                                        \
+   point_add(rx, ry, rz, x1, y1, z1, 0, x2, y2, z2))
+
+#define JADD_MIXED(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, madd),                                         \
+   point_add(rx, ry, rz, x1, y1, z1, 1, x2, y2, z2))
 
 #define CURVE vec_curve
@@ -24,6 +24,10 @@
  * SOFTWARE.
  */
 
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -34,12 +38,84 @@
 #include "ecp_nistp256_core.c"
 #include "ecp_nistp256_util.c"
 
+#ifdef VEC_MULX
+
+/* The point operations of nistp256_mulx.c, where the field
+   multiplication and squaring use the MULX and ADX instructions. */
+void
+vec_nistp256_point_double_mulx(felem x3, felem y3, felem z3,
+                               const felem x1, const felem y1,
+                               const felem z1);
+void
+vec_nistp256_point_double_small_mulx(smallfelem x3, smallfelem y3,
+                                     smallfelem z3,
+                                     const smallfelem x1, const smallfelem y1,
+                                     const smallfelem z1);
+void
+vec_nistp256_point_add_mulx(felem x3, felem y3, felem z3,
+                            const felem x1, const felem y1, const felem z1,
+                            const int mixed,
+                            const smallfelem x2, const smallfelem y2,
+                            const smallfelem z2);
+void
+vec_nistp256_point_add_small_mulx(smallfelem x3, smallfelem y3, smallfelem z3,
+                                  smallfelem x1, smallfelem y1, smallfelem z1,
+                                  smallfelem x2, smallfelem y2, smallfelem z2);
+
+#endif
+
+/* The point operations used by all functions below. They are
+   selected for the processor when the library is loaded. */
+static void (*nistp256_point_double)(felem, felem, felem,
+                                     const felem, const felem, const felem) = point_double;
+static void (*nistp256_point_double_small)(smallfelem, smallfelem, smallfelem,
+                                           const smallfelem, const smallfelem,
+                                           const smallfelem) = point_double_small;
+static void (*nistp256_point_add)(felem, felem, felem,
+                                  const felem, const felem, const felem,
+                                  const int,
+                                  const smallfelem, const smallfelem, const smallfelem) = point_add;
+static void (*nistp256_point_add_small)(smallfelem, smallfelem, smallfelem,
+                                        smallfelem, smallfelem, smallfelem,
+                                        smallfelem, smallfelem, smallfelem) = point_add_small;
+
+static void __attribute__((constructor))
+nistp256_dispatch(void)
+{
+#ifdef VEC_MULX
+  if (vec_mulx_supported())
+    {
+      nistp256_point_double = vec_nistp256_point_double_mulx;
+      nistp256_point_double_small = vec_nistp256_point_double_small_mulx;
+      nistp256_point_add = vec_nistp256_point_add_mulx;
+      nistp256_point_add_small = vec_nistp256_point_add_small_mulx;
+    }
+#endif
+}
+
+const char *
+vec_arithmetic_nistp256(void)
+{
+  return nistp256_point_double == point_double ? "portable" : "mulx";
+}
+
 #include "nistp256_macros.h"
 
 #include "jmul_template.h"
 #include "jmulsw_template.h"
+#include "jmulwnaf_template.h"
+#include "jaff_batch_template.h"
+#include "fpowm_template.h"
+#include "jsmul_bucket_template.h"
 #include "jsmul_template.h"
 #include "jfmul_template.h"
+#include "jsmul_file_template.h"
+#include "jfmul_file_template.h"
+#include "jdmul_template.h"
+#include "jfcomb_template.h"
+#include "jfsmul_template.h"
+#include "jtune_template.h"
+#include "point_array_template.h"
 
 /* Naive version of multiplication. Only used during development.
 void
@@ -97,6 +173,96 @@ vec_jmulsw_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
   felem_to_mpz_t(RZ, rz);
 }
 
+void
+vec_jmulwnaf_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar)
+{
+  smallfelem x;
+  smallfelem y;
+  smallfelem z;
+
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_smallfelem(x, X);
+  mpz_t_to_smallfelem(y, Y);
+  mpz_t_to_smallfelem(z, Z);
+
+  vec_jmulwnaf_nistp256_inner(rx, ry, rz,
+                              curve,
+                              x, y, z,
+                              scalar);
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jdmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   mpz_t X1, mpz_t Y1, mpz_t Z1,
+                   mpz_t scalar1,
+                   mpz_t X2, mpz_t Y2, mpz_t Z2,
+                   mpz_t scalar2)
+{
+  smallfelem x1;
+  smallfelem y1;
+  smallfelem z1;
+  smallfelem x2;
+  smallfelem y2;
+  smallfelem z2;
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_smallfelem(x1, X1);
+  mpz_t_to_smallfelem(y1, Y1);
+  mpz_t_to_smallfelem(z1, Z1);
+  mpz_t_to_smallfelem(x2, X2);
+  mpz_t_to_smallfelem(y2, Y2);
+  mpz_t_to_smallfelem(z2, Z2);
+
+  vec_jdmul_nistp256_inner(rx, ry, rz,
+                           curve,
+                           x1, y1, z1, scalar1,
+                           x2, y2, z2, scalar2);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jfdmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    vec_jfmul_tab_ptr ptr,
+                    mpz_t scalar1,
+                    mpz_t X2, mpz_t Y2, mpz_t Z2,
+                    mpz_t scalar2)
+{
+  smallfelem x2;
+  smallfelem y2;
+  smallfelem z2;
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_smallfelem(x2, X2);
+  mpz_t_to_smallfelem(y2, Y2);
+  mpz_t_to_smallfelem(z2, Z2);
+
+  vec_jfdmul_nistp256_inner(rx, ry, rz,
+                            curve, ptr.nistp256, scalar1,
+                            x2, y2, z2, scalar2);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
 void
 vec_jsmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
                    vec_curve *curve,
@@ -126,10 +292,40 @@ vec_jsmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
   free(z);
 }
 
+void
+vec_jsmul_bucket_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                          vec_curve *curve,
+                          mpz_t *X, mpz_t *Y, mpz_t *Z,
+                          mpz_t *scalars,
+                          size_t len)
+{
+  felem rx;
+  felem ry;
+  felem rz;
+
+  smallfelem *x = mpz_t_s_to_smallfelems(X, len);
+  smallfelem *y = mpz_t_s_to_smallfelems(Y, len);
+  smallfelem *z = mpz_t_s_to_smallfelems(Z, len);
+
+  vec_jsmul_bucket_nistp256_inner(rx, ry, rz,
+                                  curve,
+                                  x, y, z,
+                                  scalars,
+                                  len);
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
 vec_jfmul_tab_ptr
-vec_jfmul_precomp_nistp256(vec_curve *curve,
-                           mpz_t X, mpz_t Y, mpz_t Z,
-                           size_t len)
+vec_jfmul_precomp_par_nistp256(vec_curve *curve,
+                               mpz_t X, mpz_t Y, mpz_t Z,
+                               size_t len,
+                               size_t threads)
 {
   smallfelem x;
   smallfelem y;
@@ -146,11 +342,19 @@ vec_jfmul_precomp_nistp256(vec_curve *curve,
 
   vec_jfmul_init_nistp256_inner(ptr.nistp256, curve, len);
 
-  vec_jfmul_prcmp_nistp256_inner(curve, ptr.nistp256, x, y, z);
+  vec_jfmul_prcmp_par_nistp256_inner(curve, ptr.nistp256, x, y, z, threads);
 
   return ptr;
 }
 
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_nistp256(vec_curve *curve,
+                           mpz_t X, mpz_t Y, mpz_t Z,
+                           size_t len)
+{
+  return vec_jfmul_precomp_par_nistp256(curve, X, Y, Z, len, 1);
+}
+
 void
 vec_jfmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
                    vec_curve *curve, vec_jfmul_tab_ptr ptr,
@@ -169,12 +373,301 @@ vec_jfmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
   smallfelem_to_mpz_t(RZ, rz);
 }
 
+void
+vec_jfmul_batch_nistp256(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                         vec_curve *curve, vec_jfmul_tab_ptr ptr,
+                         mpz_t *scalars,
+                         size_t len)
+{
+  size_t i;
+
+  smallfelem *rx = (smallfelem *)malloc(len * sizeof(smallfelem));
+  smallfelem *ry = (smallfelem *)malloc(len * sizeof(smallfelem));
+  smallfelem *rz = (smallfelem *)malloc(len * sizeof(smallfelem));
+
+  vec_jfmul_cmp_batch_nistp256_inner(rx, ry, rz,
+                                     curve, ptr.nistp256,
+                                     scalars,
+                                     len);
+
+  for (i = 0; i < len; i++)
+    {
+      smallfelem_to_mpz_t(RX[i], rx[i]);
+      smallfelem_to_mpz_t(RY[i], ry[i]);
+      smallfelem_to_mpz_t(RZ[i], rz[i]);
+    }
+
+  free(rx);
+  free(ry);
+  free(rz);
+}
+
+int
+vec_jfmul_save_nistp256(vec_curve *curve,
+                        vec_jfmul_tab_ptr ptr,
+                        const char *path)
+{
+  return vec_jfmul_save_nistp256_inner(curve, ptr.nistp256, path);
+}
+
+int
+vec_jfmul_load_nistp256(vec_jfmul_tab_ptr *ptr,
+                        vec_curve *curve,
+                        const char *path)
+{
+  vec_jfmul_tab_nistp256_inner *table;
+
+  table = vec_jfmul_load_nistp256_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->nistp256 = table;
+  return 0;
+}
+
 void
 vec_jfmul_free_nistp256(vec_jfmul_tab_ptr ptr)
 {
   vec_jfmul_clear_free_nistp256_inner(ptr.nistp256);
 }
 
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_nistp256(vec_curve *curve,
+                            mpz_t X, mpz_t Y, mpz_t Z,
+                            size_t len,
+                            size_t max_bytes)
+{
+  smallfelem x;
+  smallfelem y;
+  smallfelem z;
+  vec_jfcomb_tab_ptr ptr;
+
+  ptr.nistp256 =
+    (vec_jfcomb_tab_nistp256_inner*)
+    malloc(sizeof(vec_jfcomb_tab_nistp256_inner));
+
+  mpz_t_to_smallfelem(x, X);
+  mpz_t_to_smallfelem(y, Y);
+  mpz_t_to_smallfelem(z, Z);
+
+  vec_jfcomb_init_nistp256_inner(ptr.nistp256, curve, len, max_bytes);
+
+  vec_jfcomb_prcmp_nistp256_inner(curve, ptr.nistp256, x, y, z);
+
+  return ptr;
+}
+
+void
+vec_jfcomb_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfcomb_tab_ptr ptr,
+                    mpz_t scalar)
+{
+  smallfelem rx;
+  smallfelem ry;
+  smallfelem rz;
+
+  vec_jfcomb_cmp_nistp256_inner(rx, ry, rz,
+                                curve, ptr.nistp256,
+                                scalar);
+
+  smallfelem_to_mpz_t(RX, rx);
+  smallfelem_to_mpz_t(RY, ry);
+  smallfelem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jfcomb_free_nistp256(vec_jfcomb_tab_ptr ptr)
+{
+  vec_jfcomb_clear_free_nistp256_inner(ptr.nistp256);
+}
+
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_nistp256(vec_curve *curve,
+                            mpz_t *X, mpz_t *Y, mpz_t *Z,
+                            size_t bases_len,
+                            size_t len,
+                            size_t max_bytes)
+{
+  vec_jfsmul_tab_ptr ptr;
+
+  smallfelem *x = mpz_t_s_to_smallfelems(X, bases_len);
+  smallfelem *y = mpz_t_s_to_smallfelems(Y, bases_len);
+  smallfelem *z = mpz_t_s_to_smallfelems(Z, bases_len);
+
+  ptr.nistp256 =
+    (vec_jfsmul_tab_nistp256_inner*)
+    malloc(sizeof(vec_jfsmul_tab_nistp256_inner));
+
+  vec_jfsmul_init_nistp256_inner(ptr.nistp256, curve,
+                                 bases_len, len, max_bytes);
+  vec_jfsmul_prcmp_nistp256_inner(curve, ptr.nistp256, x, y, z);
+
+  free(x);
+  free(y);
+  free(z);
+
+  return ptr;
+}
+
+void
+vec_jfsmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    vec_jfsmul_tab_ptr ptr,
+                    mpz_t *scalars)
+{
+  smallfelem rx;
+  smallfelem ry;
+  smallfelem rz;
+
+  vec_jfsmul_cmp_nistp256_inner(rx, ry, rz,
+                                curve, ptr.nistp256,
+                                scalars);
+
+  smallfelem_to_mpz_t(RX, rx);
+  smallfelem_to_mpz_t(RY, ry);
+  smallfelem_to_mpz_t(RZ, rz);
+}
+
+int
+vec_jfsmul_save_nistp256(vec_curve *curve,
+                         vec_jfsmul_tab_ptr ptr,
+                         const char *path)
+{
+  return vec_jfsmul_save_nistp256_inner(curve, ptr.nistp256, path);
+}
+
+int
+vec_jfsmul_load_nistp256(vec_jfsmul_tab_ptr *ptr,
+                         vec_curve *curve,
+                         const char *path)
+{
+  vec_jfsmul_tab_nistp256_inner *table;
+
+  table = vec_jfsmul_load_nistp256_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->nistp256 = table;
+  return 0;
+}
+
+void
+vec_jfsmul_free_nistp256(vec_jfsmul_tab_ptr ptr)
+{
+  vec_jfsmul_clear_free_nistp256_inner(ptr.nistp256);
+}
+
+void
+vec_jtune_nistp256(vec_tuning_costs *costs,
+                   vec_curve *curve,
+                   long millisecs)
+{
+  vec_jtune_nistp256_inner(costs, curve, millisecs);
+}
+
+void
+vec_jaff_batch_nistp256(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                        size_t len,
+                        vec_curve *curve)
+{
+  vec_jaff_batch_nistp256_inner(X, Y, Z, len, curve);
+}
+
+void
+vec_fpowm_nistp256(mpz_t *rops,
+                   mpz_t *bases,
+                   mpz_t exponent,
+                   size_t len,
+                   vec_curve *curve)
+{
+  vec_fpowm_nistp256_inner(rops, bases, exponent, len, curve);
+}
+
+void
+vec_jmul_aff_nistp256(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar)
+{
+  smallfelem x;
+  smallfelem y;
+  smallfelem z;
+
+  felem tx;
+  felem ty;
+  felem tz;
+
+  mpz_t_to_smallfelem(x, X);
+  mpz_t_to_smallfelem(y, Y);
+  mpz_t_to_smallfelem(z, Z);
+
+  vec_jmulwnaf_nistp256_inner(tx, ty, tz,
+                              curve,
+                              x, y, z,
+                              scalar);
+
+  felem_contract(x, tx);
+  felem_contract(y, ty);
+  felem_contract(z, tz);
+
+  vec_jaff_point_nistp256_inner(rx, ry, x, y, z, curve);
+}
+
+void
+vec_jsmul_aff_nistp256(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       mpz_t *scalars,
+                       size_t len)
+{
+  felem tx;
+  felem ty;
+  felem tz;
+
+  smallfelem sx;
+  smallfelem sy;
+  smallfelem sz;
+
+  smallfelem *x = mpz_t_s_to_smallfelems(X, len);
+  smallfelem *y = mpz_t_s_to_smallfelems(Y, len);
+  smallfelem *z = mpz_t_s_to_smallfelems(Z, len);
+
+  vec_jsmul_nistp256_inner(tx, ty, tz,
+                           curve,
+                           x, y, z,
+                           scalars,
+                           len);
+
+  felem_contract(sx, tx);
+  felem_contract(sy, ty);
+  felem_contract(sz, tz);
+
+  vec_jaff_point_nistp256_inner(rx, ry, sx, sy, sz, curve);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
+void
+vec_jfmul_aff_nistp256(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       vec_jfmul_tab_ptr ptr,
+                       mpz_t scalar)
+{
+  smallfelem x;
+  smallfelem y;
+  smallfelem z;
+
+  vec_jfmul_cmp_nistp256_inner(x, y, z,
+                               curve, ptr.nistp256,
+                               scalar);
+
+  vec_jaff_point_nistp256_inner(rx, ry, x, y, z, curve);
+}
+
 void
 vec_jdbl_nistp256(vec_scratch_mpz_t scratch,
                   mpz_t X3, mpz_t Y3, mpz_t Z3,
@@ -195,7 +688,7 @@ vec_jdbl_nistp256(vec_scratch_mpz_t scratch,
   mpz_t_to_felem(y_in, Y1);
   mpz_t_to_felem(z_in, Z1);
 
-  point_double(x_out, y_out, z_out, x_in, y_in, z_in);
+  nistp256_point_double(x_out, y_out, z_out, x_in, y_in, z_in);
 
   felem_to_mpz_t(X3, x_out);
   felem_to_mpz_t(Y3, y_out);
@@ -231,7 +724,7 @@ vec_jadd_nistp256(vec_scratch_mpz_t scratch,
   mpz_t_to_smallfelem(y2, Y2);
   mpz_t_to_smallfelem(z2, Z2);
 
-  point_add(x3, y3, z3, x1, y1, z1, x2, y2, z2);
+  nistp256_point_add(x3, y3, z3, x1, y1, z1, 0, x2, y2, z2);
 
   felem_to_mpz_t(X3, x3);
   felem_to_mpz_t(Y3, y3);
@@ -266,7 +759,7 @@ time_jdbl_nistp256(int test_time, mpz_t X, mpz_t Y)
   i = 0;
   do
     {
-      point_double(x, y, z, x, y, z);
+      nistp256_point_double(x, y, z, x, y, z);
       i++;
     }
   while (!vec_done(t, test_time));
@@ -307,7 +800,7 @@ time_jadd_nistp256(int test_time, mpz_t X, mpz_t Y)
   i = 0;
   do
     {
-      point_add(rx, ry, rz, rx, ry, rz, x, y, z);
+      nistp256_point_add(rx, ry, rz, rx, ry, rz, 0, x, y, z);
       i++;
     }
   while (!vec_done(t, test_time));
@@ -53,12 +53,40 @@
   smallfelem_assign(ry, y);                        \
   smallfelem_assign(rz, z)
 
+#define FIELD_ELEMENT_VAR_BYTES(curve) sizeof(smallfelem)
+#define FIELD_ELEMENT_VAR_WRITE(dst, x, curve) \
+  memcpy(dst, x, sizeof(smallfelem))
+
+#define FIELD_ELEMENT_VAR_IMPORT(x, y, z, X, Y, Z, curve) \
+  mpz_t_to_smallfelem(x, X);                            \
+  mpz_t_to_smallfelem(y, Y);                            \
+  mpz_t_to_smallfelem(z, Z)
+#define FIELD_ELEMENT_VAR_EXPORT(X, Y, Z, x, y, z, curve) \
+  smallfelem_to_mpz_t(X, x);                            \
+  smallfelem_to_mpz_t(Y, y);                            \
+  smallfelem_to_mpz_t(Z, z)
+
+#define FIELD_ELEMENT_VAR_FROM_MPZ(x, X, curve) mpz_t_to_smallfelem(x, X)
+#define FIELD_ELEMENT_VAR_TO_MPZ(X, x, curve) smallfelem_to_mpz_t(X, x)
+#define FIELD_ELEMENT_VAR_MUL(r, x, y, curve) \
+  smallfelem_mul_contract(r, x, y)
+#define FIELD_ELEMENT_VAR_IS_ZERO(x, curve) (smallfelem_is_zero(x) != 0)
+#define FIELD_ELEMENT_VAR_NEG(r, x, curve) smallfelem_neg_contract(r, x)
+
 #define FIELD_ELEMENT_CONTRACT(rx, ry, rz, x, y, z) \
   felem_contract(rx, x);                            \
   felem_contract(ry, y);                            \
   felem_contract(rz, z);
 
 
+/* Exponentiation uses unreduced elements, which are not contracted
+   after each multiplication. */
+#define FPOWM_ELEMENT felem
+#define FPOWM_FROM_MPZ(x, X, curve) mpz_t_to_felem(x, X)
+#define FPOWM_TO_MPZ(X, x, curve) felem_to_mpz_t(X, x)
+#define FPOWM_MUL(r, x, y, curve) felem_mul_reduce(r, x, y)
+#define FPOWM_SQR(r, x, curve) felem_square_reduce(r, x)
+
 #define SCRATCH(scratch)
 #define SCRATCH_INIT(scratch)
 #define SCRATCH_CLEAR(scratch)
@@ -67,17 +95,32 @@
   (FIELD_ELEMENT_VAR *)malloc(len * sizeof(FIELD_ELEMENT_VAR))
 
 #define ARRAY_CLEAR_FREE(array, len) free(array)
+#define ARRAY_CONTIGUOUS
+
+#define ARRAY_MAP(src, len, curve) ((smallfelem *)(src))
+#define ARRAY_UNMAP(array) VEC_UNUSED(array)
+
+/* Four lanes are on par with this code, but eight lanes are faster. */
+#define JFMUL_LANES_MIN_WIDTH 8
 
 #define JDBL(scratch, rx, ry, rz, curve, x, y, z) \
-  point_double(rx, ry, rz, x, y, z)
+  (VEC_STATS_INC(curve, dbl),                     \
+   nistp256_point_double(rx, ry, rz, x, y, z))
 
 #define JDBL_VAR(scratch, rx, ry, rz, curve, x, y, z) \
-  point_double_small(rx, ry, rz, x, y, z)             \
+  (VEC_STATS_INC(curve, dbl),                         \
+   nistp256_point_double_small(rx, ry, rz, x, y, z))
 
 #define JADD(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
-  point_add(rx, ry, rz, x1, y1, z1, x2, y2, z2);
+  (VEC_STATS_INC(curve, add),                                    \
+   nistp256_point_add(rx, ry, rz, x1, y1, z1, 0, x2, y2, z2))
+
+#define JADD_VAR(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, add),                                        \
+   nistp256_point_add_small(rx, ry, rz, x1, y1, z1, x2, y2, z2))
 
-#define JADD_VAR(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2)  \
-  point_add_small(rx, ry, rz, x1, y1, z1, x2, y2, z2)
+#define JADD_MIXED(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, madd),                                         \
+   nistp256_point_add(rx, ry, rz, x1, y1, z1, 1, x2, y2, z2))
 
 #define CURVE vec_curve
@@ -0,0 +1,95 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef VEC_MULX
+
+/* The core of P-256 compiled for processors with the MULX and ADX
+   instructions. The field multiplication and squaring of the core
+   are then written in assembly using these instructions, and all
+   field operations are inlined into the point operations exported
+   below. The point operations are only used if the processor
+   supports the instructions, which is decided in nistp256.c when the
+   library is loaded. */
+#pragma GCC target("bmi2,adx")
+
+/* Only the point operations of the core are used here. */
+#pragma GCC diagnostic ignored "-Wunused-function"
+
+#define VEC_NISTP256_MULX
+
+#include <stdlib.h>
+#include <string.h>
+#include <gmp.h>
+#include "vec.h"
+
+#include "ecp_nistp256_core.c"
+
+__attribute__((flatten)) void
+vec_nistp256_point_double_mulx(felem x3, felem y3, felem z3,
+                               const felem x1, const felem y1,
+                               const felem z1)
+{
+  point_double(x3, y3, z3, x1, y1, z1);
+}
+
+__attribute__((flatten)) void
+vec_nistp256_point_double_small_mulx(smallfelem x3, smallfelem y3,
+                                     smallfelem z3,
+                                     const smallfelem x1, const smallfelem y1,
+                                     const smallfelem z1)
+{
+  point_double_small(x3, y3, z3, x1, y1, z1);
+}
+
+__attribute__((flatten)) void
+vec_nistp256_point_add_mulx(felem x3, felem y3, felem z3,
+                            const felem x1, const felem y1, const felem z1,
+                            const int mixed,
+                            const smallfelem x2, const smallfelem y2,
+                            const smallfelem z2)
+{
+  point_add(x3, y3, z3, x1, y1, z1, mixed, x2, y2, z2);
+}
+
+__attribute__((flatten)) void
+vec_nistp256_point_add_small_mulx(smallfelem x3, smallfelem y3, smallfelem z3,
+                                  smallfelem x1, smallfelem y1, smallfelem z1,
+                                  smallfelem x2, smallfelem y2, smallfelem z2)
+{
+  point_add_small(x3, y3, z3, x1, y1, z1, x2, y2, z2);
+}
+
+#else
+
+/* Without assembler support for the instructions nistp256.c only uses
+   the portable point operations. */
+typedef int vec_nistp256_mulx_unused;
+
+#endif
@@ -0,0 +1,727 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <gmp.h>
+#include "vec.h"
+
+#include "ecp_nistp384_core.c"
+#include "ecp_nistp384_util.c"
+
+const char *
+vec_arithmetic_nistp384(void)
+{
+  return "portable";
+}
+
+#include "nistp384_macros.h"
+
+#include "jmul_template.h"
+#include "jmulsw_template.h"
+#include "jmulwnaf_template.h"
+#include "jaff_batch_template.h"
+#include "jsmul_bucket_template.h"
+#include "jsmul_template.h"
+#include "jfmul_template.h"
+#include "jsmul_file_template.h"
+#include "jfmul_file_template.h"
+#include "jdmul_template.h"
+#include "jfcomb_template.h"
+#include "jfsmul_template.h"
+#include "jtune_template.h"
+#include "point_array_template.h"
+
+/* Naive version of multiplication. Only used during development.
+void
+vec_jmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                  vec_curve *curve,
+                  mpz_t X, mpz_t Y, mpz_t Z,
+                  mpz_t scalar)
+{
+  felem x;
+  felem y;
+  felem z;
+
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+  mpz_t_to_felem(z, Z);
+
+  vec_jmul_nistp384_inner(rx, ry, rz,
+                          curve,
+                          x, y, z,
+                          scalar);
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+*/
+
+void
+vec_jmulsw_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    mpz_t X, mpz_t Y, mpz_t Z,
+                    mpz_t scalar)
+{
+  felem x;
+  felem y;
+  felem z;
+
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+  mpz_t_to_felem(z, Z);
+
+  vec_jmulsw_nistp384_inner(rx, ry, rz,
+                            curve,
+                            x, y, z,
+                            scalar);
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jmulwnaf_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar)
+{
+  felem x;
+  felem y;
+  felem z;
+
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+  mpz_t_to_felem(z, Z);
+
+  vec_jmulwnaf_nistp384_inner(rx, ry, rz,
+                              curve,
+                              x, y, z,
+                              scalar);
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jdmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   mpz_t X1, mpz_t Y1, mpz_t Z1,
+                   mpz_t scalar1,
+                   mpz_t X2, mpz_t Y2, mpz_t Z2,
+                   mpz_t scalar2)
+{
+  felem x1;
+  felem y1;
+  felem z1;
+  felem x2;
+  felem y2;
+  felem z2;
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_felem(x1, X1);
+  mpz_t_to_felem(y1, Y1);
+  mpz_t_to_felem(z1, Z1);
+  mpz_t_to_felem(x2, X2);
+  mpz_t_to_felem(y2, Y2);
+  mpz_t_to_felem(z2, Z2);
+
+  vec_jdmul_nistp384_inner(rx, ry, rz,
+                           curve,
+                           x1, y1, z1, scalar1,
+                           x2, y2, z2, scalar2);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jfdmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    vec_jfmul_tab_ptr ptr,
+                    mpz_t scalar1,
+                    mpz_t X2, mpz_t Y2, mpz_t Z2,
+                    mpz_t scalar2)
+{
+  felem x2;
+  felem y2;
+  felem z2;
+  felem rx;
+  felem ry;
+  felem rz;
+
+  mpz_t_to_felem(x2, X2);
+  mpz_t_to_felem(y2, Y2);
+  mpz_t_to_felem(z2, Z2);
+
+  vec_jfdmul_nistp384_inner(rx, ry, rz,
+                            curve, ptr.nistp384, scalar1,
+                            x2, y2, z2, scalar2);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jsmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   mpz_t *X, mpz_t *Y, mpz_t *Z,
+                   mpz_t *scalars,
+                   size_t len)
+{
+  felem rx;
+  felem ry;
+  felem rz;
+
+  felem *x = mpz_t_s_to_felems(X, len);
+  felem *y = mpz_t_s_to_felems(Y, len);
+  felem *z = mpz_t_s_to_felems(Z, len);
+
+  vec_jsmul_nistp384_inner(rx, ry, rz,
+                           curve,
+                           x, y, z,
+                           scalars,
+                           len);
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
+void
+vec_jsmul_bucket_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                          vec_curve *curve,
+                          mpz_t *X, mpz_t *Y, mpz_t *Z,
+                          mpz_t *scalars,
+                          size_t len)
+{
+  felem rx;
+  felem ry;
+  felem rz;
+
+  felem *x = mpz_t_s_to_felems(X, len);
+  felem *y = mpz_t_s_to_felems(Y, len);
+  felem *z = mpz_t_s_to_felems(Z, len);
+
+  vec_jsmul_bucket_nistp384_inner(rx, ry, rz,
+                                  curve,
+                                  x, y, z,
+                                  scalars,
+                                  len);
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_nistp384(vec_curve *curve,
+                               mpz_t X, mpz_t Y, mpz_t Z,
+                               size_t len,
+                               size_t threads)
+{
+  felem x;
+  felem y;
+  felem z;
+  vec_jfmul_tab_ptr ptr;
+
+  ptr.nistp384 =
+    (vec_jfmul_tab_nistp384_inner*)
+    malloc(sizeof(vec_jfmul_tab_nistp384_inner));
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+  mpz_t_to_felem(z, Z);
+
+  vec_jfmul_init_nistp384_inner(ptr.nistp384, curve, len);
+
+  vec_jfmul_prcmp_par_nistp384_inner(curve, ptr.nistp384, x, y, z, threads);
+
+  return ptr;
+}
+
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_nistp384(vec_curve *curve,
+                           mpz_t X, mpz_t Y, mpz_t Z,
+                           size_t len)
+{
+  return vec_jfmul_precomp_par_nistp384(curve, X, Y, Z, len, 1);
+}
+
+void
+vec_jfmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve, vec_jfmul_tab_ptr ptr,
+                   mpz_t scalar)
+{
+  felem rx;
+  felem ry;
+  felem rz;
+
+  vec_jfmul_cmp_nistp384_inner(rx, ry, rz,
+                               curve, ptr.nistp384,
+                               scalar);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jfmul_batch_nistp384(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                         vec_curve *curve, vec_jfmul_tab_ptr ptr,
+                         mpz_t *scalars,
+                         size_t len)
+{
+  size_t i;
+
+  felem *rx = (felem *)malloc(len * sizeof(felem));
+  felem *ry = (felem *)malloc(len * sizeof(felem));
+  felem *rz = (felem *)malloc(len * sizeof(felem));
+
+  vec_jfmul_cmp_batch_nistp384_inner(rx, ry, rz,
+                                     curve, ptr.nistp384,
+                                     scalars,
+                                     len);
+
+  for (i = 0; i < len; i++)
+    {
+      felem_to_mpz_t(RX[i], rx[i]);
+      felem_to_mpz_t(RY[i], ry[i]);
+      felem_to_mpz_t(RZ[i], rz[i]);
+    }
+
+  free(rx);
+  free(ry);
+  free(rz);
+}
+
+int
+vec_jfmul_save_nistp384(vec_curve *curve,
+                        vec_jfmul_tab_ptr ptr,
+                        const char *path)
+{
+  return vec_jfmul_save_nistp384_inner(curve, ptr.nistp384, path);
+}
+
+int
+vec_jfmul_load_nistp384(vec_jfmul_tab_ptr *ptr,
+                        vec_curve *curve,
+                        const char *path)
+{
+  vec_jfmul_tab_nistp384_inner *table;
+
+  table = vec_jfmul_load_nistp384_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->nistp384 = table;
+  return 0;
+}
+
+void
+vec_jfmul_free_nistp384(vec_jfmul_tab_ptr ptr)
+{
+  vec_jfmul_clear_free_nistp384_inner(ptr.nistp384);
+}
+
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_nistp384(vec_curve *curve,
+                            mpz_t X, mpz_t Y, mpz_t Z,
+                            size_t len,
+                            size_t max_bytes)
+{
+  felem x;
+  felem y;
+  felem z;
+  vec_jfcomb_tab_ptr ptr;
+
+  ptr.nistp384 =
+    (vec_jfcomb_tab_nistp384_inner*)
+    malloc(sizeof(vec_jfcomb_tab_nistp384_inner));
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+  mpz_t_to_felem(z, Z);
+
+  vec_jfcomb_init_nistp384_inner(ptr.nistp384, curve, len, max_bytes);
+
+  vec_jfcomb_prcmp_nistp384_inner(curve, ptr.nistp384, x, y, z);
+
+  return ptr;
+}
+
+void
+vec_jfcomb_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfcomb_tab_ptr ptr,
+                    mpz_t scalar)
+{
+  felem rx;
+  felem ry;
+  felem rz;
+
+  vec_jfcomb_cmp_nistp384_inner(rx, ry, rz,
+                                curve, ptr.nistp384,
+                                scalar);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+void
+vec_jfcomb_free_nistp384(vec_jfcomb_tab_ptr ptr)
+{
+  vec_jfcomb_clear_free_nistp384_inner(ptr.nistp384);
+}
+
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_nistp384(vec_curve *curve,
+                            mpz_t *X, mpz_t *Y, mpz_t *Z,
+                            size_t bases_len,
+                            size_t len,
+                            size_t max_bytes)
+{
+  vec_jfsmul_tab_ptr ptr;
+
+  felem *x = mpz_t_s_to_felems(X, bases_len);
+  felem *y = mpz_t_s_to_felems(Y, bases_len);
+  felem *z = mpz_t_s_to_felems(Z, bases_len);
+
+  ptr.nistp384 =
+    (vec_jfsmul_tab_nistp384_inner*)
+    malloc(sizeof(vec_jfsmul_tab_nistp384_inner));
+
+  vec_jfsmul_init_nistp384_inner(ptr.nistp384, curve,
+                                 bases_len, len, max_bytes);
+  vec_jfsmul_prcmp_nistp384_inner(curve, ptr.nistp384, x, y, z);
+
+  free(x);
+  free(y);
+  free(z);
+
+  return ptr;
+}
+
+void
+vec_jfsmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    vec_jfsmul_tab_ptr ptr,
+                    mpz_t *scalars)
+{
+  felem rx;
+  felem ry;
+  felem rz;
+
+  vec_jfsmul_cmp_nistp384_inner(rx, ry, rz,
+                                curve, ptr.nistp384,
+                                scalars);
+
+  felem_to_mpz_t(RX, rx);
+  felem_to_mpz_t(RY, ry);
+  felem_to_mpz_t(RZ, rz);
+}
+
+int
+vec_jfsmul_save_nistp384(vec_curve *curve,
+                         vec_jfsmul_tab_ptr ptr,
+                         const char *path)
+{
+  return vec_jfsmul_save_nistp384_inner(curve, ptr.nistp384, path);
+}
+
+int
+vec_jfsmul_load_nistp384(vec_jfsmul_tab_ptr *ptr,
+                         vec_curve *curve,
+                         const char *path)
+{
+  vec_jfsmul_tab_nistp384_inner *table;
+
+  table = vec_jfsmul_load_nistp384_inner(curve, path);
+  if (table == NULL)
+    {
+      return -1;
+    }
+  ptr->nistp384 = table;
+  return 0;
+}
+
+void
+vec_jfsmul_free_nistp384(vec_jfsmul_tab_ptr ptr)
+{
+  vec_jfsmul_clear_free_nistp384_inner(ptr.nistp384);
+}
+
+void
+vec_jtune_nistp384(vec_tuning_costs *costs,
+                   vec_curve *curve,
+                   long millisecs)
+{
+  vec_jtune_nistp384_inner(costs, curve, millisecs);
+}
+
+void
+vec_jaff_batch_nistp384(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                        size_t len,
+                        vec_curve *curve)
+{
+  vec_jaff_batch_nistp384_inner(X, Y, Z, len, curve);
+}
+
+void
+vec_jmul_aff_nistp384(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar)
+{
+  felem x;
+  felem y;
+  felem z;
+
+  felem tx;
+  felem ty;
+  felem tz;
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+  mpz_t_to_felem(z, Z);
+
+  vec_jmulwnaf_nistp384_inner(tx, ty, tz,
+                              curve,
+                              x, y, z,
+                              scalar);
+
+  vec_jaff_point_nistp384_inner(rx, ry, tx, ty, tz, curve);
+}
+
+void
+vec_jsmul_aff_nistp384(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       mpz_t *scalars,
+                       size_t len)
+{
+  felem tx;
+  felem ty;
+  felem tz;
+
+  felem *x = mpz_t_s_to_felems(X, len);
+  felem *y = mpz_t_s_to_felems(Y, len);
+  felem *z = mpz_t_s_to_felems(Z, len);
+
+  vec_jsmul_nistp384_inner(tx, ty, tz,
+                           curve,
+                           x, y, z,
+                           scalars,
+                           len);
+
+  vec_jaff_point_nistp384_inner(rx, ry, tx, ty, tz, curve);
+
+  free(x);
+  free(y);
+  free(z);
+}
+
+void
+vec_jfmul_aff_nistp384(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       vec_jfmul_tab_ptr ptr,
+                       mpz_t scalar)
+{
+  felem tx;
+  felem ty;
+  felem tz;
+
+  vec_jfmul_cmp_nistp384_inner(tx, ty, tz,
+                               curve, ptr.nistp384,
+                               scalar);
+
+  vec_jaff_point_nistp384_inner(rx, ry, tx, ty, tz, curve);
+}
+
+void
+vec_jdbl_nistp384(vec_scratch_mpz_t scratch,
+                  mpz_t X3, mpz_t Y3, mpz_t Z3,
+                  vec_curve *curve,
+                  mpz_t X1, mpz_t Y1, mpz_t Z1)
+{
+  felem x_in;
+  felem y_in;
+  felem z_in;
+  felem x_out;
+  felem y_out;
+  felem z_out;
+
+  VEC_UNUSED(scratch);
+  VEC_UNUSED(curve);
+
+  mpz_t_to_felem(x_in, X1);
+  mpz_t_to_felem(y_in, Y1);
+  mpz_t_to_felem(z_in, Z1);
+
+  point_double(x_out, y_out, z_out, x_in, y_in, z_in);
+
+  felem_to_mpz_t(X3, x_out);
+  felem_to_mpz_t(Y3, y_out);
+  felem_to_mpz_t(Z3, z_out);
+}
+
+void
+vec_jadd_nistp384(vec_scratch_mpz_t scratch,
+                  mpz_t X3, mpz_t Y3, mpz_t Z3,
+                  vec_curve *curve,
+                  mpz_t X1, mpz_t Y1, mpz_t Z1,
+                  mpz_t X2, mpz_t Y2, mpz_t Z2)
+{
+  felem x1;
+  felem y1;
+  felem z1;
+  felem x2;
+  felem y2;
+  felem z2;
+
+  felem x3;
+  felem y3;
+  felem z3;
+
+  VEC_UNUSED(scratch);
+  VEC_UNUSED(curve);
+
+  mpz_t_to_felem(x1, X1);
+  mpz_t_to_felem(y1, Y1);
+  mpz_t_to_felem(z1, Z1);
+
+  mpz_t_to_felem(x2, X2);
+  mpz_t_to_felem(y2, Y2);
+  mpz_t_to_felem(z2, Z2);
+
+  point_add(x3, y3, z3, x1, y1, z1, 0, x2, y2, z2);
+
+  felem_to_mpz_t(X3, x3);
+  felem_to_mpz_t(Y3, y3);
+  felem_to_mpz_t(Z3, z3);
+}
+
+/* These are timing routines and not tested beyond using them. */
+/* LCOV_EXCL_START */
+
+long
+time_jdbl_nistp384(int test_time, mpz_t X, mpz_t Y)
+{
+  long i;
+  int t;
+  felem x;
+  felem y;
+  felem z;
+
+  mpz_t Z;
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+
+  mpz_init(Z);
+  mpz_set_ui(Z, 1);
+  mpz_t_to_felem(z, Z);
+  mpz_clear(Z);
+
+  t = clock();
+
+  i = 0;
+  do
+    {
+      point_double(x, y, z, x, y, z);
+      i++;
+    }
+  while (!vec_done(t, test_time));
+
+  return i;
+}
+
+long
+time_jadd_nistp384(int test_time, mpz_t X, mpz_t Y)
+{
+  long i;
+  int t;
+
+  felem rx;
+  felem ry;
+  felem rz;
+
+  felem x;
+  felem y;
+  felem z;
+
+  mpz_t Z;
+
+  mpz_t_to_felem(x, X);
+  mpz_t_to_felem(y, Y);
+
+  mpz_init(Z);
+  mpz_set_ui(Z, 1);
+  mpz_t_to_felem(z, Z);
+  mpz_clear(Z);
+
+  memset(rx, 0, sizeof(felem));
+  memset(ry, 0, sizeof(felem));
+  memset(rz, 0, sizeof(felem));
+
+  t = clock();
+
+  i = 0;
+  do
+    {
+      point_add(rx, ry, rz, rx, ry, rz, 0, x, y, z);
+      i++;
+    }
+  while (!vec_done(t, test_time));
+
+  return i;
+}
+/* LCOV_EXCL_STOP */
@@ -0,0 +1,115 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "undefine_macros.h"
+
+#define POSTFIX _nistp384_inner
+#define TAB_POSTFIX _nistp384_inner
+
+#define FIELD_ELEMENT felem
+#define FIELD_ELEMENT_INIT(x)
+#define FIELD_ELEMENT_CLEAR(x)
+#define FIELD_ELEMENT_UNIT(x, y, z) \
+  memset(x, 0, sizeof(felem));      \
+  memset(y, 0, sizeof(felem));      \
+  memset(z, 0, sizeof(felem))
+#define FIELD_ELEMENT_SET(rx, ry, rz, x, y, z) \
+  felem_assign(rx, x);                         \
+  felem_assign(ry, y);                         \
+  felem_assign(rz, z)
+
+#define FIELD_ELEMENT_VAR felem
+#define FIELD_ELEMENT_VAR_INIT(x)
+#define FIELD_ELEMENT_VAR_CLEAR(x)
+#define FIELD_ELEMENT_VAR_UNIT(x, y, z) \
+  memset(x, 0, sizeof(felem));          \
+  memset(y, 0, sizeof(felem));          \
+  memset(z, 0, sizeof(felem))
+#define FIELD_ELEMENT_VAR_SET(rx, ry, rz, x, y, z) \
+  felem_assign(rx, x);                             \
+  felem_assign(ry, y);                             \
+  felem_assign(rz, z)
+
+#define FIELD_ELEMENT_VAR_BYTES(curve) sizeof(felem)
+#define FIELD_ELEMENT_VAR_WRITE(dst, x, curve) \
+  memcpy(dst, x, sizeof(felem))
+
+#define FIELD_ELEMENT_VAR_IMPORT(x, y, z, X, Y, Z, curve) \
+  mpz_t_to_felem(x, X);                                 \
+  mpz_t_to_felem(y, Y);                                 \
+  mpz_t_to_felem(z, Z)
+#define FIELD_ELEMENT_VAR_EXPORT(X, Y, Z, x, y, z, curve) \
+  felem_to_mpz_t(X, x);                                 \
+  felem_to_mpz_t(Y, y);                                 \
+  felem_to_mpz_t(Z, z)
+
+#define FIELD_ELEMENT_VAR_FROM_MPZ(x, X, curve) mpz_t_to_felem(x, X)
+#define FIELD_ELEMENT_VAR_TO_MPZ(X, x, curve) felem_to_mpz_t(X, x)
+#define FIELD_ELEMENT_VAR_MUL(r, x, y, curve) felem_mul(r, x, y)
+#define FIELD_ELEMENT_VAR_IS_ZERO(x, curve) (felem_is_zero(x) != 0)
+#define FIELD_ELEMENT_VAR_NEG(r, x, curve) felem_neg(r, x)
+
+#define FIELD_ELEMENT_CONTRACT(rx, ry, rz, x, y, z) \
+  felem_contract(rx, x);                            \
+  felem_contract(ry, y);                            \
+  felem_contract(rz, z)
+
+#define SCRATCH(scratch)
+#define SCRATCH_INIT(scratch)
+#define SCRATCH_CLEAR(scratch)
+
+#define ARRAY_MALLOC_INIT(len) \
+  (FIELD_ELEMENT *)malloc(len * sizeof(FIELD_ELEMENT))
+
+#define ARRAY_CLEAR_FREE(array, len) free(array)
+#define ARRAY_CONTIGUOUS
+
+#define ARRAY_MAP(src, len, curve) ((felem *)(src))
+#define ARRAY_UNMAP(array) VEC_UNUSED(array)
+
+#define JFMUL_LANES_MIN_WIDTH 4
+
+#define JDBL(scratch, rx, ry, rz, curve, x, y, z) \
+  (VEC_STATS_INC(curve, dbl),                     \
+   point_double(rx, ry, rz, x, y, z))
+
+#define JDBL_VAR(scratch, rx, ry, rz, curve, x, y, z) \
+  (VEC_STATS_INC(curve, dbl),                         \
+   point_double(rx, ry, rz, x, y, z))
+
+#define JADD(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, add),                                    \
+   point_add(rx, ry, rz, x1, y1, z1, 0, x2, y2, z2))
+
+#define JADD_VAR(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, add),                                        \
+   point_add(rx, ry, rz, x1, y1, z1, 0, x2, y2, z2))
+
+#define JADD_MIXED(scratch, rx, ry, rz, curve, x1, y1, z1, x2, y2, z2) \
+  (VEC_STATS_INC(curve, madd),                                         \
+   point_add(rx, ry, rz, x1, y1, z1, 1, x2, y2, z2))
+
+#define CURVE vec_curve
@@ -0,0 +1,70 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <gmp.h>
+#include "vec.h"
+
+void
+vec_par_run(void *jobs, size_t jobs_len, size_t size,
+            void *(*worker)(void *))
+{
+  size_t i;
+  char *job;
+  pthread_t *thread;
+  int *threaded;
+
+  thread = (pthread_t *)malloc(jobs_len * sizeof(pthread_t));
+  threaded = (int *)malloc(jobs_len * sizeof(int));
+
+  /* The calling thread processes the first job itself. If a thread
+     can not be created, then its job is processed in the calling
+     thread as well. */
+  job = (char *)jobs;
+  for (i = 1; i < jobs_len; i++)
+    {
+      threaded[i] =
+        pthread_create(&thread[i], NULL, worker, job + i * size) == 0;
+    }
+  for (i = 0; i < jobs_len; i++)
+    {
+      if (i == 0 || !threaded[i])
+        {
+          worker(job + i * size);
+        }
+    }
+  for (i = 1; i < jobs_len; i++)
+    {
+      if (threaded[i])
+        {
+          pthread_join(thread[i], NULL);
+        }
+    }
+
+  free(threaded);
+  free(thread);
+}
@@ -0,0 +1,118 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <gmp.h>
+
+#include "vec.h"
+
+/* Returns non-zero if the affine point is on the curve, i.e., if
+   y^2 = x^3 + a * x + b modulo the modulus. */
+static int
+point_array_on_curve(vec_curve *curve, mpz_t x, mpz_t y, mpz_t l, mpz_t r)
+{
+  mpz_mul(l, y, y);
+  mpz_mod(l, l, curve->modulus);
+
+  mpz_mul(r, x, x);
+  mpz_add(r, r, curve->a);
+  mpz_mul(r, r, x);
+  mpz_add(r, r, curve->b);
+  mpz_mod(r, r, curve->modulus);
+
+  return mpz_cmp(l, r) == 0;
+}
+
+int
+vec_point_array_import_bytes(vec_point_array *array,
+                             size_t offset,
+                             const unsigned char *bytes,
+                             size_t len)
+{
+  int res;
+  size_t i;
+  size_t n;
+  mpz_t *X;
+  mpz_t *Y;
+  mpz_t *Z;
+  mpz_t l;
+  mpz_t r;
+  vec_curve *curve = array->curve;
+
+  if (offset > array->len || len > array->len - offset)
+    {
+      return -1;
+    }
+
+  n = (mpz_sizeinbase(curve->modulus, 2) + 7) / 8;
+
+  X = vec_array_alloc_init(len);
+  Y = vec_array_alloc_init(len);
+  Z = vec_array_alloc_init(len);
+  mpz_init(l);
+  mpz_init(r);
+
+  /* Nothing is imported unless all points are valid, since the
+     native representations assume reduced coordinates. */
+  res = 0;
+  for (i = 0; i < len && res == 0; i++)
+    {
+      mpz_import(X[i], n, 1, 1, 1, 0, bytes);
+      bytes += n;
+      mpz_import(Y[i], n, 1, 1, 1, 0, bytes);
+      bytes += n;
+
+      /* All zeros encodes the point at infinity. */
+      if (mpz_sgn(X[i]) == 0 && mpz_sgn(Y[i]) == 0)
+        {
+          mpz_set_ui(Y[i], 1);
+          mpz_set_ui(Z[i], 0);
+        }
+      else if (mpz_cmp(X[i], curve->modulus) >= 0
+               || mpz_cmp(Y[i], curve->modulus) >= 0
+               || !point_array_on_curve(curve, X[i], Y[i], l, r))
+        {
+          res = -1;
+        }
+      else
+        {
+          mpz_set_ui(Z[i], 1);
+        }
+    }
+
+  if (res == 0)
+    {
+      vec_point_array_import(array, offset, X, Y, Z, len);
+    }
+
+  mpz_clear(r);
+  mpz_clear(l);
+  vec_array_clear_free(Z, len);
+  vec_array_clear_free(Y, len);
+  vec_array_clear_free(X, len);
+
+  return res;
+}
@@ -0,0 +1,220 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef FIELD_ELEMENT
+
+#include <stdlib.h>
+#include "templates.h"
+
+/*
+ * Arrays of points kept in the native representation of the backend
+ * between calls. The coordinate arrays of a vec_point_array are
+ * arrays of FIELD_ELEMENT_VAR, i.e., the type used for the bases of
+ * simultaneous multiplication.
+ */
+
+static void
+FUNCTION_NAME(vec_point_array_init, POSTFIX)(vec_point_array *array)
+{
+  array->x = ARRAY_MALLOC_INIT(array->len);
+  array->y = ARRAY_MALLOC_INIT(array->len);
+  array->z = ARRAY_MALLOC_INIT(array->len);
+}
+
+static void
+FUNCTION_NAME(vec_point_array_clear, POSTFIX)(vec_point_array *array)
+{
+  ARRAY_CLEAR_FREE((FIELD_ELEMENT_VAR *)array->z, array->len);
+  ARRAY_CLEAR_FREE((FIELD_ELEMENT_VAR *)array->y, array->len);
+  ARRAY_CLEAR_FREE((FIELD_ELEMENT_VAR *)array->x, array->len);
+}
+
+static void
+FUNCTION_NAME(vec_point_array_from_mpz, POSTFIX)
+     (vec_point_array *array,
+      size_t offset,
+      mpz_t *X, mpz_t *Y, mpz_t *Z,
+      size_t len)
+{
+  size_t i;
+  CURVE *curve = array->curve;
+  FIELD_ELEMENT_VAR *x = (FIELD_ELEMENT_VAR *)array->x + offset;
+  FIELD_ELEMENT_VAR *y = (FIELD_ELEMENT_VAR *)array->y + offset;
+  FIELD_ELEMENT_VAR *z = (FIELD_ELEMENT_VAR *)array->z + offset;
+
+  VEC_UNUSED(curve);
+
+  for (i = 0; i < len; i++)
+    {
+      FIELD_ELEMENT_VAR_IMPORT(x[i], y[i], z[i], X[i], Y[i], Z[i], curve);
+    }
+}
+
+static void
+FUNCTION_NAME(vec_point_array_to_mpz, POSTFIX)
+     (mpz_t *X, mpz_t *Y, mpz_t *Z,
+      vec_point_array *array)
+{
+  size_t i;
+  CURVE *curve = array->curve;
+  FIELD_ELEMENT_VAR *x = (FIELD_ELEMENT_VAR *)array->x;
+  FIELD_ELEMENT_VAR *y = (FIELD_ELEMENT_VAR *)array->y;
+  FIELD_ELEMENT_VAR *z = (FIELD_ELEMENT_VAR *)array->z;
+
+  VEC_UNUSED(curve);
+
+  for (i = 0; i < array->len; i++)
+    {
+      FIELD_ELEMENT_VAR_EXPORT(X[i], Y[i], Z[i], x[i], y[i], z[i], curve);
+    }
+}
+
+static void
+FUNCTION_NAME(vec_jmul_array, POSTFIX)
+     (vec_point_array *rop,
+      vec_point_array *array,
+      mpz_t *scalars)
+{
+  size_t i;
+  CURVE *curve = array->curve;
+  FIELD_ELEMENT_VAR *rx = (FIELD_ELEMENT_VAR *)rop->x;
+  FIELD_ELEMENT_VAR *ry = (FIELD_ELEMENT_VAR *)rop->y;
+  FIELD_ELEMENT_VAR *rz = (FIELD_ELEMENT_VAR *)rop->z;
+  FIELD_ELEMENT_VAR *x = (FIELD_ELEMENT_VAR *)array->x;
+  FIELD_ELEMENT_VAR *y = (FIELD_ELEMENT_VAR *)array->y;
+  FIELD_ELEMENT_VAR *z = (FIELD_ELEMENT_VAR *)array->z;
+
+  FIELD_ELEMENT tx;
+  FIELD_ELEMENT ty;
+  FIELD_ELEMENT tz;
+
+  FIELD_ELEMENT_INIT(tx);
+  FIELD_ELEMENT_INIT(ty);
+  FIELD_ELEMENT_INIT(tz);
+
+  for (i = 0; i < array->len; i++)
+    {
+      FUNCTION_NAME(vec_jmulsw, POSTFIX)(tx, ty, tz,
+                                         curve,
+                                         x[i], y[i], z[i],
+                                         scalars[i]);
+
+      FIELD_ELEMENT_CONTRACT(rx[i], ry[i], rz[i], tx, ty, tz);
+    }
+
+  FIELD_ELEMENT_CLEAR(tz);
+  FIELD_ELEMENT_CLEAR(ty);
+  FIELD_ELEMENT_CLEAR(tx);
+}
+
+static void
+FUNCTION_NAME(vec_jadd_array, POSTFIX)
+     (vec_point_array *rop,
+      vec_point_array *array1,
+      vec_point_array *array2)
+{
+  size_t i;
+  CURVE *curve = array1->curve;
+  FIELD_ELEMENT_VAR *rx = (FIELD_ELEMENT_VAR *)rop->x;
+  FIELD_ELEMENT_VAR *ry = (FIELD_ELEMENT_VAR *)rop->y;
+  FIELD_ELEMENT_VAR *rz = (FIELD_ELEMENT_VAR *)rop->z;
+  FIELD_ELEMENT_VAR *x1 = (FIELD_ELEMENT_VAR *)array1->x;
+  FIELD_ELEMENT_VAR *y1 = (FIELD_ELEMENT_VAR *)array1->y;
+  FIELD_ELEMENT_VAR *z1 = (FIELD_ELEMENT_VAR *)array1->z;
+  FIELD_ELEMENT_VAR *x2 = (FIELD_ELEMENT_VAR *)array2->x;
+  FIELD_ELEMENT_VAR *y2 = (FIELD_ELEMENT_VAR *)array2->y;
+  FIELD_ELEMENT_VAR *z2 = (FIELD_ELEMENT_VAR *)array2->z;
+
+  SCRATCH(scratch);
+
+  VEC_UNUSED(curve);
+
+  SCRATCH_INIT(scratch);
+
+  for (i = 0; i < array1->len; i++)
+    {
+      JADD_VAR(scratch,
+               rx[i], ry[i], rz[i],
+               curve,
+               x1[i], y1[i], z1[i],
+               x2[i], y2[i], z2[i]);
+    }
+
+  SCRATCH_CLEAR(scratch);
+}
+
+static void
+FUNCTION_NAME(vec_jsmul_array, POSTFIX)
+     (mpz_t RX, mpz_t RY, mpz_t RZ,
+      vec_point_array *array,
+      mpz_t *scalars)
+{
+  CURVE *curve = array->curve;
+
+  FIELD_ELEMENT tx;
+  FIELD_ELEMENT ty;
+  FIELD_ELEMENT tz;
+  FIELD_ELEMENT_VAR rx;
+  FIELD_ELEMENT_VAR ry;
+  FIELD_ELEMENT_VAR rz;
+
+  FIELD_ELEMENT_INIT(tx);
+  FIELD_ELEMENT_INIT(ty);
+  FIELD_ELEMENT_INIT(tz);
+  FIELD_ELEMENT_VAR_INIT(rx);
+  FIELD_ELEMENT_VAR_INIT(ry);
+  FIELD_ELEMENT_VAR_INIT(rz);
+
+  FUNCTION_NAME(vec_jsmul, POSTFIX)(tx, ty, tz,
+                                    curve,
+                                    (FIELD_ELEMENT_VAR *)array->x,
+                                    (FIELD_ELEMENT_VAR *)array->y,
+                                    (FIELD_ELEMENT_VAR *)array->z,
+                                    scalars,
+                                    array->len);
+
+  FIELD_ELEMENT_CONTRACT(rx, ry, rz, tx, ty, tz);
+  FIELD_ELEMENT_VAR_EXPORT(RX, RY, RZ, rx, ry, rz, curve);
+
+  FIELD_ELEMENT_VAR_CLEAR(rz);
+  FIELD_ELEMENT_VAR_CLEAR(ry);
+  FIELD_ELEMENT_VAR_CLEAR(rx);
+  FIELD_ELEMENT_CLEAR(tz);
+  FIELD_ELEMENT_CLEAR(ty);
+  FIELD_ELEMENT_CLEAR(tx);
+}
+
+const vec_point_array_ops FUNCTION_NAME(vec_point_array_ops, POSTFIX) = {
+  FUNCTION_NAME(vec_point_array_init, POSTFIX),
+  FUNCTION_NAME(vec_point_array_clear, POSTFIX),
+  FUNCTION_NAME(vec_point_array_from_mpz, POSTFIX),
+  FUNCTION_NAME(vec_point_array_to_mpz, POSTFIX),
+  FUNCTION_NAME(vec_jmul_array, POSTFIX),
+  FUNCTION_NAME(vec_jadd_array, POSTFIX),
+  FUNCTION_NAME(vec_jsmul_array, POSTFIX)
+};
+
+#endif
@@ -0,0 +1,207 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <gmp.h>
+#include "vec.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Number of bytes of the scalars processed in each round. This bounds
+   the buffer kept on the stack. */
+#define CHUNK_BYTES 64
+
+/* Each block occupies VEC_TRANSPOSE_MAX_WIDTH lanes of a row and
+   with AVX2 two blocks are processed at a time. */
+#if defined(__AVX2__)
+#define BLOCKS_PER_ROW 2
+#else
+#define BLOCKS_PER_ROW 1
+#endif
+#define LANES (BLOCKS_PER_ROW * VEC_TRANSPOSE_MAX_WIDTH)
+
+/* Writes bytes offset, offset + 1, ..., offset + CHUNK_BYTES - 1 of
+   the scalar to dst with the given stride. */
+static void
+write_bytes(unsigned char *dst, size_t stride, mpz_t scalar, size_t offset)
+{
+  size_t i;
+  size_t j;
+  size_t size = mpz_size(scalar);
+  size_t limb_bytes = GMP_NUMB_BITS / 8;
+  size_t first = offset / limb_bytes;
+  size_t last = (offset + CHUNK_BYTES + limb_bytes - 1) / limb_bytes;
+  mp_limb_t limb;
+  size_t pos;
+
+  if (last > size)
+    {
+      last = size;
+    }
+
+  for (i = first; i < last; i++)
+    {
+      limb = mpz_getlimbn(scalar, i);
+      for (j = 0; j < limb_bytes; j++)
+        {
+          pos = i * limb_bytes + j;
+          if (offset <= pos && pos < offset + CHUNK_BYTES)
+            {
+              dst[(pos - offset) * stride] = (unsigned char)(limb >> (8 * j));
+            }
+        }
+    }
+}
+
+/* Extracts the masks of the eight bit indices of a row of bytes, one
+   byte from each scalar in each lane. The most significant bit is
+   extracted first by moving the sign bits of the bytes. */
+static void
+transpose_row(uint16_t *masks, size_t tabs_len, size_t tabs_in_row,
+              const unsigned char *row, size_t index, size_t bit_length)
+{
+  int bit;
+
+#if defined(__AVX2__)
+
+  uint32_t m;
+  __m256i v = _mm256_loadu_si256((const __m256i *)row);
+
+  for (bit = 7; bit >= 0; bit--)
+    {
+      if (index + bit < bit_length)
+        {
+          m = (uint32_t)_mm256_movemask_epi8(v);
+          masks[(index + bit) * tabs_len] = (uint16_t)m;
+          if (tabs_in_row > 1)
+            {
+              masks[(index + bit) * tabs_len + 1] = (uint16_t)(m >> 16);
+            }
+        }
+      v = _mm256_add_epi8(v, v);
+    }
+
+#elif defined(__SSE2__)
+
+  __m128i v = _mm_loadu_si128((const __m128i *)row);
+
+  for (bit = 7; bit >= 0; bit--)
+    {
+      if (index + bit < bit_length)
+        {
+          masks[(index + bit) * tabs_len] = (uint16_t)_mm_movemask_epi8(v);
+        }
+      v = _mm_add_epi8(v, v);
+    }
+  (void)tabs_in_row;
+
+#else
+
+  size_t k;
+  uint16_t m;
+
+  for (bit = 7; bit >= 0; bit--)
+    {
+      if (index + bit < bit_length)
+        {
+          m = 0;
+          for (k = 0; k < VEC_TRANSPOSE_MAX_WIDTH; k++)
+            {
+              m |= (uint16_t)(((row[k] >> bit) & 1) << k);
+            }
+          masks[(index + bit) * tabs_len] = m;
+        }
+    }
+  (void)tabs_in_row;
+
+#endif
+}
+
+void
+vec_scalars_transpose(uint16_t *masks,
+                      mpz_t *scalars, size_t len,
+                      size_t block_width,
+                      size_t bit_length)
+{
+  size_t i;
+  size_t j;
+  size_t k;
+  size_t p;
+  size_t width;
+  size_t offset;
+  size_t tabs_in_row;
+  size_t tabs_len = (len + block_width - 1) / block_width;
+  size_t nbytes = (bit_length + 7) / 8;
+
+  unsigned char rows[CHUNK_BYTES * LANES];
+
+  for (i = 0; i < tabs_len; i += BLOCKS_PER_ROW)
+    {
+
+      tabs_in_row = tabs_len - i < BLOCKS_PER_ROW ?
+        tabs_len - i : BLOCKS_PER_ROW;
+
+      for (offset = 0; offset < nbytes; offset += CHUNK_BYTES)
+        {
+
+          /* Gather the bytes of the scalars of the blocks such that
+             each row holds a given byte of all scalars. */
+          memset(rows, 0, sizeof(rows));
+
+          for (j = 0; j < tabs_in_row; j++)
+            {
+
+              /* Last block may have smaller width. */
+              width = block_width;
+              if (i + j == tabs_len - 1)
+                {
+                  width = len - (tabs_len - 1) * block_width;
+                }
+
+              for (k = 0; k < width; k++)
+                {
+                  write_bytes(rows + j * VEC_TRANSPOSE_MAX_WIDTH + k, LANES,
+                              scalars[(i + j) * block_width + k],
+                              offset);
+                }
+            }
+
+          /* Extract the masks from each row. */
+          for (p = 0; p < CHUNK_BYTES && offset + p < nbytes; p++)
+            {
+              transpose_row(masks + i, tabs_len, tabs_in_row,
+                            rows + p * LANES,
+                            8 * (offset + p),
+                            bit_length);
+            }
+        }
+    }
+}
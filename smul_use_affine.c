@@ -0,0 +1,53 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gmp.h>
+#include "vec.h"
+
+/*
+ * Cost, counted in field multiplications, of a single inversion
+ * computed using mpz_invert. This is a rough estimate for the sizes
+ * of moduli used in practice.
+ */
+#define INVERSION_COST 100
+
+/*
+ * Returns non-zero if converting a table of the given block width to
+ * affine coordinates is expected to be paid for by the mixed
+ * additions during simultaneous multiplication.
+ */
+int
+vec_smul_use_affine(int scalars_bitlen, int block_width) {
+
+  /* Simultaneous inversion of the z-coordinates and scaling of the
+     coordinates of each entry. */
+  double normalize = 8.0 * (1 << block_width) + INVERSION_COST;
+
+  /* Each addition with an entry of the table saves roughly five
+     multiplications when the entry has z-coordinate one. */
+  double saved = 5.0 * scalars_bitlen;
+
+  return normalize < saved;
+}
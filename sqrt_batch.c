@@ -0,0 +1,74 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <gmp.h>
+
+#include "vec.h"
+
+int
+vec_sqrt_batch(mpz_t *rops, mpz_t *ops, size_t len, vec_curve *curve)
+{
+  int res;
+  size_t i;
+  vec_sqrt_ctx *ctx;
+  mpz_t *as;
+
+  /* Curves created without a name have no cached constants. */
+  ctx = curve->sqrt_ctx;
+  if (ctx == NULL)
+    {
+      ctx = vec_sqrt_ctx_alloc(curve->modulus);
+    }
+
+  as = vec_array_alloc_init(len);
+  for (i = 0; i < len; i++)
+    {
+      mpz_mod(as[i], ops[i], ctx->modulus);
+    }
+
+  /* The exponent is the same for all elements. */
+  curve->fpowm(rops, as, ctx->e, len, curve);
+
+  res = 0;
+  for (i = 0; i < len; i++)
+    {
+      if (vec_sqrt_ctx_finish(rops[i], as[i], ctx) != 0)
+        {
+          res = -1;
+        }
+    }
+
+  vec_array_clear_free(as, len);
+
+  if (ctx != curve->sqrt_ctx)
+    {
+      vec_sqrt_ctx_free(ctx);
+    }
+
+  return res;
+}
@@ -0,0 +1,81 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <gmp.h>
+
+#include "vec.h"
+
+vec_sqrt_ctx *
+vec_sqrt_ctx_alloc(mpz_t modulus)
+{
+  vec_sqrt_ctx *ctx;
+  mpz_t q;
+
+  ctx = (vec_sqrt_ctx *)malloc(sizeof(vec_sqrt_ctx));
+
+  mpz_init(ctx->modulus);
+  mpz_init(ctx->e);
+  mpz_init(ctx->z);
+  mpz_init(ctx->c);
+
+  mpz_set(ctx->modulus, modulus);
+
+  /* Compute s such that p - 1 = 2^s * q, where q is odd. */
+  mpz_sub_ui(ctx->e, modulus, 1);
+  ctx->s = mpz_scan1(ctx->e, 0);
+
+  /* If p = 3 mod 4, then a^((p + 1)/4) is a square root of a. */
+  if (ctx->s == 1)
+    {
+      mpz_add_ui(ctx->e, modulus, 1);
+      mpz_tdiv_q_2exp(ctx->e, ctx->e, 2);
+      return ctx;
+    }
+
+  mpz_init(q);
+  mpz_tdiv_q_2exp(q, ctx->e, ctx->s);
+
+  /* Half of all elements are non-residues, so this terminates
+     quickly. */
+  mpz_set_ui(ctx->z, 2);
+  while (mpz_legendre(ctx->z, modulus) != -1)
+    {
+      mpz_add_ui(ctx->z, ctx->z, 1);
+    }
+
+  /* c = z^q generates the subgroup of order 2^s. */
+  mpz_powm(ctx->c, ctx->z, q, modulus);
+
+  /* e = (q - 1)/2 */
+  mpz_sub_ui(ctx->e, q, 1);
+  mpz_tdiv_q_2exp(ctx->e, ctx->e, 1);
+
+  mpz_clear(q);
+
+  return ctx;
+}
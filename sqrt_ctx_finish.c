@@ -0,0 +1,132 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <gmp.h>
+
+#include "vec.h"
+
+/*
+ * Completes the Tonelli-Shanks algorithm, where r = a^((q - 1)/2) on
+ * input and p - 1 = 2^s * q with q odd. Then n = a^q lies in the
+ * subgroup of order 2^s, and r * a is a square root of n * a. Each
+ * step multiplies r by a power of c = z^q which reduces the order of
+ * n. The order of n is 2^s only for non-residues.
+ */
+static int
+sqrt_tonelli_shanks(mpz_t r, mpz_t a, vec_sqrt_ctx *ctx)
+{
+  int m;
+  int i;
+  int j;
+  int res;
+  mpz_t n;
+  mpz_t c;
+  mpz_t t;
+
+  mpz_init(n);
+  mpz_init(c);
+  mpz_init(t);
+
+  mpz_mul(n, r, r);            /* n = r^2 * a = a^q */
+  mpz_mod(n, n, ctx->modulus);
+  mpz_mul(n, n, a);
+  mpz_mod(n, n, ctx->modulus);
+
+  mpz_mul(r, r, a);            /* r = a^((q + 1)/2) */
+  mpz_mod(r, r, ctx->modulus);
+
+  mpz_set(c, ctx->c);
+  m = ctx->s;
+  res = 0;
+
+  /* Zero is its own square root, i.e., then n is zero. */
+  while (mpz_cmp_ui(n, 1) > 0)
+    {
+
+      /* Find the least i such that n^(2^i) = 1. */
+      mpz_set(t, n);
+      i = 0;
+      while (mpz_cmp_ui(t, 1) != 0 && i < m)
+        {
+          mpz_mul(t, t, t);
+          mpz_mod(t, t, ctx->modulus);
+          i++;
+        }
+
+      if (i == m)
+        {
+          res = -1;
+          break;
+        }
+
+      /* c = c^(2^(m - i - 1)) */
+      for (j = 0; j < m - i - 1; j++)
+        {
+          mpz_mul(c, c, c);
+          mpz_mod(c, c, ctx->modulus);
+        }
+
+      mpz_mul(r, r, c);        /* r = r * c */
+      mpz_mod(r, r, ctx->modulus);
+      mpz_mul(c, c, c);        /* c = c^2 */
+      mpz_mod(c, c, ctx->modulus);
+      mpz_mul(n, n, c);        /* n = n * c */
+      mpz_mod(n, n, ctx->modulus);
+
+      m = i;
+    }
+
+  mpz_clear(t);
+  mpz_clear(c);
+  mpz_clear(n);
+
+  return res;
+}
+
+int
+vec_sqrt_ctx_finish(mpz_t r, mpz_t a, vec_sqrt_ctx *ctx)
+{
+  int res;
+  mpz_t t;
+
+  if (ctx->s > 1)
+    {
+      return sqrt_tonelli_shanks(r, a, ctx);
+    }
+
+  /* If p = 3 mod 4, then r = a^((p + 1)/4) is a square root of a if
+     and only if a is a quadratic residue. */
+  mpz_init(t);
+
+  mpz_mul(t, r, r);
+  mpz_mod(t, t, ctx->modulus);
+  res = mpz_cmp(t, a) == 0 ? 0 : -1;
+
+  mpz_clear(t);
+
+  return res;
+}
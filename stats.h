@@ -0,0 +1,97 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/*
+ * Counting of operations in the hot paths of the library. The
+ * counters are kept in the stats field of a curve, but they are only
+ * updated if the library is configured with --enable-stats. Otherwise
+ * the macros below expand to nothing, so the instrumentation has no
+ * cost at all. The counters are updated atomically since the parallel
+ * functions use the same curve in several threads.
+ */
+#ifdef VEC_STATS
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <x86intrin.h>
+
+#define VEC_STATS_CYCLES() ((uint64_t)__rdtsc())
+
+#else
+
+#include <time.h>
+
+/* Nanoseconds are used as cycles on platforms without a time stamp
+   counter. */
+static inline uint64_t
+vec_stats_cycles(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec) * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+#define VEC_STATS_CYCLES() vec_stats_cycles()
+
+#endif
+
+#define VEC_STATS_ADD(curve, field, n) \
+  ((void)__atomic_fetch_add(&(curve)->stats.field, (uint64_t)(n), \
+                            __ATOMIC_RELAXED))
+
+#define VEC_STATS_INC(curve, field) VEC_STATS_ADD(curve, field, 1)
+
+#define VEC_STATS_ALLOC(curve, k, n) \
+  (VEC_STATS_ADD(curve, mallocs, k), VEC_STATS_ADD(curve, bytes, n))
+
+#define VEC_STATS_TIMER(t) uint64_t t
+
+#define VEC_STATS_START(t) ((t) = VEC_STATS_CYCLES())
+
+#define VEC_STATS_STOP(curve, field, t) \
+  VEC_STATS_ADD(curve, field, VEC_STATS_CYCLES() - (t))
+
+#else
+
+#define VEC_STATS_ADD(curve, field, n) ((void)0)
+#define VEC_STATS_INC(curve, field) ((void)0)
+#define VEC_STATS_ALLOC(curve, k, n) ((void)0)
+#define VEC_STATS_TIMER(t)
+#define VEC_STATS_START(t) ((void)0)
+#define VEC_STATS_STOP(curve, field, t) ((void)0)
+
+#endif
+
+#endif /* STATS_H */
@@ -0,0 +1,49 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "vec.h"
+#include "stats.h"
+
+#ifdef VEC_STATS
+#define STATS_LOAD(curve, field) \
+  __atomic_load_n(&(curve)->stats.field, __ATOMIC_RELAXED)
+#else
+#define STATS_LOAD(curve, field) ((curve)->stats.field)
+#endif
+
+void
+vec_stats_snapshot(vec_stats *stats, vec_curve *curve)
+{
+  stats->dbl = STATS_LOAD(curve, dbl);
+  stats->add = STATS_LOAD(curve, add);
+  stats->madd = STATS_LOAD(curve, madd);
+  stats->inversions = STATS_LOAD(curve, inversions);
+  stats->table_entries = STATS_LOAD(curve, table_entries);
+  stats->mallocs = STATS_LOAD(curve, mallocs);
+  stats->bytes = STATS_LOAD(curve, bytes);
+  stats->precomp_cycles = STATS_LOAD(curve, precomp_cycles);
+  stats->main_cycles = STATS_LOAD(curve, main_cycles);
+}
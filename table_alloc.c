@@ -0,0 +1,63 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <gmp.h>
+#include "vec.h"
+
+void *
+vec_table_alloc(size_t bytes)
+{
+  void *table;
+
+#if defined(MAP_ANONYMOUS) && defined(MADV_HUGEPAGE)
+
+  /* Large tables are mapped directly, so that the kernel can back
+     them by huge pages and save misses in the TLB. Mapped memory is
+     already zeroed. */
+  if (bytes >= VEC_TABLE_HUGE_BYTES)
+    {
+      table = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (table != MAP_FAILED)
+        {
+          madvise(table, bytes, MADV_HUGEPAGE);
+          return table;
+        }
+      return NULL;
+    }
+#endif
+
+  if (posix_memalign(&table, VEC_TABLE_ALIGN, bytes) != 0)
+    {
+      return NULL;
+    }
+  memset(table, 0, bytes);
+
+  return table;
+}
@@ -27,9 +27,14 @@
 #ifndef TEMPLATES_H
 #define TEMPLATES_H
 
+#include "stats.h"
+
 #define CAT(X,Y) X##Y
 #define FUNCTION_NAME(X,Y) CAT(X,Y)
 
+#define STR(X) #X
+#define STRING_NAME(X) STR(X)
+
 /*
  * We use compiler flags that enforce that unused variables are
  * flagged as errors. We need this in some cases where we are forced
@@ -37,4 +42,14 @@
  */
 #define VEC_UNUSED(x) ((void)(x))
 
+/*
+ * Hints the processor to fetch the cache line holding the given
+ * address, e.g., an entry of a table needed by the next addition.
+ */
+#ifdef __GNUC__
+#define VEC_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define VEC_PREFETCH(addr) VEC_UNUSED(addr)
+#endif
+
 #endif /* TEMPLATES_H */
@@ -0,0 +1,81 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <gmp.h>
+
+#include "vec.h"
+
+/*
+ * Default cache sizes used if the sizes can not be read from the
+ * system.
+ */
+#define DEFAULT_L2_BYTES (256 * 1024)
+#define DEFAULT_L3_BYTES (8 * 1024 * 1024)
+
+/*
+ * Returns the size of the cache of the given level as reported by the
+ * system, or the default if it is not available.
+ */
+static size_t
+cache_bytes(int level, size_t def)
+{
+  long bytes = -1;
+
+#if defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+  bytes = sysconf(level == 2 ? _SC_LEVEL2_CACHE_SIZE : _SC_LEVEL3_CACHE_SIZE);
+#else
+  (void)level;
+#endif
+
+  return bytes > 0 ? (size_t)bytes : def;
+}
+
+vec_tuning_record *
+vec_tune(vec_tuning *tuning, vec_curve *curve, long millisecs)
+{
+  vec_tuning_record record;
+
+  memset(&record, 0, sizeof(vec_tuning_record));
+
+  record.costs.l2_bytes = cache_bytes(2, DEFAULT_L2_BYTES);
+  record.costs.l3_bytes = cache_bytes(3, DEFAULT_L3_BYTES);
+
+  /* Some platforms report no L3 cache. */
+  if (record.costs.l3_bytes < record.costs.l2_bytes)
+    {
+      record.costs.l3_bytes = record.costs.l2_bytes;
+    }
+
+  curve->jtune(&record.costs, curve, millisecs);
+
+  record.bit_length = mpz_sizeinbase(curve->n, 2);
+
+  vec_tuning_derive(&record);
+
+  return vec_tuning_insert(tuning, &record);
+}
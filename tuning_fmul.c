@@ -0,0 +1,63 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gmp.h>
+
+#include "vec.h"
+
+int
+vec_tuning_fmul(vec_tuning *tuning,
+                const char *curve, const char *backend,
+                int bit_length, size_t len)
+{
+  int i;
+  vec_tuning_record *record;
+
+  if (tuning == NULL || curve == NULL)
+    {
+      return 0;
+    }
+
+  record = vec_tuning_find(tuning, curve, backend);
+  if (record == NULL)
+    {
+      return 0;
+    }
+
+  if (bit_length != record->bit_length)
+    {
+      return vec_tuning_fmul_width(&record->costs, bit_length, len);
+    }
+
+  /* Largest derived length not exceeding the given length. */
+  i = 0;
+  while (i < VEC_TUNING_LENS - 1 && (len >> (i + 1)) > 0)
+    {
+      i++;
+    }
+
+  return record->fmul_block_width[i];
+}
@@ -0,0 +1,89 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gmp.h>
+
+#include "vec.h"
+
+/*
+ * Cost of a single inversion computed using mpz_invert, counted in
+ * additions. This is a rough estimate in the same way as in
+ * vec_smul_use_affine().
+ */
+#define INVERSION_ADDS 6.0
+
+int
+vec_tuning_fmul_width(vec_tuning_costs *costs, int bit_length, size_t len)
+{
+  int width;
+  int best_width = 2;
+  int slice_bit_len;
+  double entries;
+  double bytes;
+  double table;
+  double cost;
+  double min_cost = -1.0;
+
+  if (len == 0)
+    {
+      len = 1;
+    }
+
+  for (width = 2; width <= VEC_TRANSPOSE_MAX_WIDTH; width++)
+    {
+      entries = (double)(1 << width);
+      bytes = entries * costs->entry_bytes;
+
+      if (bytes > VEC_TUNING_MAX_TABLE_BYTES)
+        {
+          break;
+        }
+
+      slice_bit_len = (bit_length + width - 1) / width;
+
+      /* Doublings of the bases, one addition for each entry, and
+         conversion of the table to affine coordinates, amortized over
+         all multiplications. */
+      table = bit_length * costs->dbl
+        + entries * costs->add * 1.5
+        + INVERSION_ADDS * costs->add;
+
+      /* Each multiplication doubles once per bit of a slice and adds
+         an entry of the table unless all bits are zero. */
+      cost = table / len
+        + slice_bit_len * costs->dbl
+        + slice_bit_len * (1 - 1.0 / entries)
+        * (costs->madd + vec_tuning_lookup(costs, bytes));
+
+      if (min_cost < 0 || cost < min_cost)
+        {
+          min_cost = cost;
+          best_width = width;
+        }
+    }
+
+  return best_width;
+}
@@ -0,0 +1,53 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <gmp.h>
+
+#include "vec.h"
+
+vec_tuning_record *
+vec_tuning_insert(vec_tuning *tuning, vec_tuning_record *record)
+{
+  vec_tuning_record *old;
+
+  old = vec_tuning_find(tuning,
+                        record->costs.curve, record->costs.backend);
+
+  if (old == NULL)
+    {
+      tuning->records = (vec_tuning_record *)
+        realloc(tuning->records,
+                (tuning->len + 1) * sizeof(vec_tuning_record));
+      old = &tuning->records[tuning->len];
+      tuning->len++;
+    }
+
+  memcpy(old, record, sizeof(vec_tuning_record));
+
+  return old;
+}
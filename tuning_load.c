@@ -0,0 +1,168 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <gmp.h>
+
+#include "vec.h"
+
+/*
+ * Parses a line holding a record of the format written by
+ * vec_tuning_save(). Returns non-zero on success.
+ */
+static int
+parse_record(vec_tuning_record *record, const char *line)
+{
+  unsigned long entry_bytes;
+  unsigned long l2_bytes;
+  unsigned long l3_bytes;
+
+  memset(record, 0, sizeof(vec_tuning_record));
+
+  if (sscanf(line,
+             "record %31s %31s %d %lu %lu %lu %lf %lf %lf %lf %lf %lf",
+             record->costs.curve,
+             record->costs.backend,
+             &record->bit_length,
+             &entry_bytes,
+             &l2_bytes,
+             &l3_bytes,
+             &record->costs.dbl,
+             &record->costs.add,
+             &record->costs.madd,
+             &record->costs.lookup,
+             &record->costs.l2_penalty,
+             &record->costs.l3_penalty) != 12
+      || record->bit_length <= 0)
+    {
+      return 0;
+    }
+
+  record->costs.entry_bytes = entry_bytes;
+  record->costs.l2_bytes = l2_bytes;
+  record->costs.l3_bytes = l3_bytes;
+
+  return 1;
+}
+
+/*
+ * Parses a line holding the parameters of the given index of a
+ * record. Returns non-zero on success.
+ */
+static int
+parse_len(vec_tuning_record *record, int index, const char *line)
+{
+  int i;
+  unsigned long smul_block_width;
+  unsigned long smul_batch_len;
+  int fmul_block_width;
+
+  if (sscanf(line, "len %d %lu %lu %d",
+             &i,
+             &smul_block_width,
+             &smul_batch_len,
+             &fmul_block_width) != 4
+      || i != index
+      || smul_block_width < 1
+      || smul_block_width > VEC_TRANSPOSE_MAX_WIDTH
+      || smul_batch_len < 1
+      || fmul_block_width < 2
+      || fmul_block_width > VEC_TRANSPOSE_MAX_WIDTH)
+    {
+      return 0;
+    }
+
+  record->smul_block_width[index] = smul_block_width;
+  record->smul_batch_len[index] = smul_batch_len;
+  record->fmul_block_width[index] = fmul_block_width;
+
+  return 1;
+}
+
+int
+vec_tuning_load(vec_tuning *tuning, const char *path)
+{
+  FILE *fp;
+  char line[512];
+  int index;
+  int res;
+  vec_tuning_record record;
+
+  fp = fopen(path, "r");
+  if (fp == NULL)
+    {
+      return -1;
+    }
+
+  /* Index of the next derived length of the current record, or -1 if
+     a record is expected. */
+  index = -1;
+  res = 0;
+
+  while (res == 0 && fgets(line, sizeof(line), fp) != NULL)
+    {
+      if (line[0] == '#' || line[0] == '\n')
+        {
+          continue;
+        }
+
+      if (index < 0)
+        {
+          if (parse_record(&record, line))
+            {
+              index = 0;
+            }
+          else
+            {
+              res = -1;
+            }
+        }
+      else if (parse_len(&record, index, line))
+        {
+          index++;
+          if (index == VEC_TUNING_LENS)
+            {
+              vec_tuning_insert(tuning, &record);
+              index = -1;
+            }
+        }
+      else
+        {
+          res = -1;
+        }
+    }
+
+  /* A truncated record is an error. */
+  if (index >= 0 || ferror(fp))
+    {
+      res = -1;
+    }
+
+  fclose(fp);
+
+  return res;
+}
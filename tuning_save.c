@@ -0,0 +1,93 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <gmp.h>
+
+#include "vec.h"
+
+/*
+ * The file consists of one line for each record, followed by one line
+ * for each derived length of the record. Lines starting with '#' are
+ * comments.
+ */
+int
+vec_tuning_save(vec_tuning *tuning, const char *path)
+{
+  size_t i;
+  int j;
+  int res;
+  FILE *fp;
+  vec_tuning_record *record;
+
+  fp = fopen(path, "w");
+  if (fp == NULL)
+    {
+      return -1;
+    }
+
+  fprintf(fp, "# VEC tuning file, version 1\n");
+  fprintf(fp, "# record curve backend bit_length entry_bytes l2_bytes "
+          "l3_bytes dbl add madd lookup l2_penalty l3_penalty\n");
+  fprintf(fp, "# len index smul_block_width smul_batch_len "
+          "fmul_block_width\n");
+
+  for (i = 0; i < tuning->len; i++)
+    {
+      record = &tuning->records[i];
+
+      fprintf(fp, "record %s %s %d %lu %lu %lu %.6g %.6g %.6g %.6g %.6g %.6g\n",
+              record->costs.curve,
+              record->costs.backend,
+              record->bit_length,
+              (unsigned long)record->costs.entry_bytes,
+              (unsigned long)record->costs.l2_bytes,
+              (unsigned long)record->costs.l3_bytes,
+              record->costs.dbl,
+              record->costs.add,
+              record->costs.madd,
+              record->costs.lookup,
+              record->costs.l2_penalty,
+              record->costs.l3_penalty);
+
+      for (j = 0; j < VEC_TUNING_LENS; j++)
+        {
+          fprintf(fp, "len %d %lu %lu %d\n",
+                  j,
+                  (unsigned long)record->smul_block_width[j],
+                  (unsigned long)record->smul_batch_len[j],
+                  record->fmul_block_width[j]);
+        }
+    }
+
+  res = ferror(fp) ? -1 : 0;
+
+  if (fclose(fp) != 0)
+    {
+      res = -1;
+    }
+  return res;
+}
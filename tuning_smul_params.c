@@ -0,0 +1,124 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gmp.h>
+
+#include "vec.h"
+
+/*
+ * Cost of a single inversion computed using mpz_invert, counted in
+ * additions. This is a rough estimate in the same way as in
+ * vec_smul_use_affine().
+ */
+#define INVERSION_ADDS 6.0
+
+/*
+ * Amortized cost per base of simultaneous multiplication in batches
+ * of batch_len bases with tables of the given block width. This
+ * mirrors vec_smul_block_width(), except that the operations are
+ * weighted by their measured costs and lookups in tables that do not
+ * fit in the caches are penalized.
+ */
+static double
+smul_cost(vec_tuning_costs *costs,
+          int bit_length, size_t batch_len, int block_width)
+{
+  size_t tabs_len = (batch_len + block_width - 1) / block_width;
+  double entries = ((double)tabs_len) * (1 << block_width);
+  double bytes = entries * costs->entry_bytes;
+  double table;
+  double add;
+
+  /* One addition for each entry of the tables. */
+  table = entries * costs->add;
+  add = costs->add;
+
+  /* Conversion to affine coordinates costs about eight
+     multiplications for each entry, i.e., half an addition, and a
+     single inversion. */
+  if (vec_smul_use_affine(bit_length, block_width))
+    {
+      table += entries * costs->add / 2 + INVERSION_ADDS * costs->add;
+      add = costs->madd;
+    }
+
+  return (bit_length * costs->dbl
+          + table
+          + tabs_len * bit_length * (1 - 1.0 / (1 << block_width))
+          * (add + vec_tuning_lookup(costs, bytes))) / batch_len;
+}
+
+void
+vec_tuning_smul_params(size_t *block_width, size_t *batch_len,
+                       vec_tuning_costs *costs,
+                       int bit_length, size_t len)
+{
+  int width;
+  size_t batch;
+  double cost;
+  double min_cost = -1.0;
+
+  *block_width = 1;
+  *batch_len = 1;
+
+  if (len == 0)
+    {
+      return;
+    }
+
+  /* Batch lengths are powers of two and the full length. */
+  batch = 1;
+  for (;;)
+    {
+      for (width = 1;
+           width <= VEC_TRANSPOSE_MAX_WIDTH && (size_t)width <= batch;
+           width++)
+        {
+
+          /* The tables only grow with the width. */
+          if (((double)(batch + width - 1) / width) * (1 << width)
+              * costs->entry_bytes > VEC_TUNING_MAX_TABLE_BYTES)
+            {
+              break;
+            }
+
+          cost = smul_cost(costs, bit_length, batch, width);
+
+          if (min_cost < 0 || cost < min_cost)
+            {
+              min_cost = cost;
+              *block_width = width;
+              *batch_len = batch;
+            }
+        }
+
+      if (batch >= len)
+        {
+          break;
+        }
+      batch = 2 * batch < len ? 2 * batch : len;
+    }
+}
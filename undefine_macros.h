@@ -32,6 +32,11 @@
 
 #undef ARRAY_MALLOC_INIT
 #undef ARRAY_CLEAR_FREE
+#undef ARRAY_CONTIGUOUS
+#undef ARRAY_MAP
+#undef ARRAY_UNMAP
+
+#undef JFMUL_LANES_MIN_WIDTH
 
 #undef FIELD_ELEMENT
 #undef FIELD_ELEMENT_INIT
@@ -41,10 +46,27 @@
 
 #undef FIELD_ELEMENT_SET
 
+#undef FIELD_ELEMENT_VAR_BYTES
+#undef FIELD_ELEMENT_VAR_WRITE
+#undef FIELD_ELEMENT_VAR_IMPORT
+#undef FIELD_ELEMENT_VAR_EXPORT
+#undef FIELD_ELEMENT_VAR_FROM_MPZ
+#undef FIELD_ELEMENT_VAR_TO_MPZ
+#undef FIELD_ELEMENT_VAR_MUL
+#undef FIELD_ELEMENT_VAR_IS_ZERO
+#undef FIELD_ELEMENT_VAR_NEG
+
+#undef FPOWM_ELEMENT
+#undef FPOWM_FROM_MPZ
+#undef FPOWM_TO_MPZ
+#undef FPOWM_MUL
+#undef FPOWM_SQR
+
 #undef JDBL
 #undef JDBL_VAR
 #undef JADD
 #undef JADD_VAR
+#undef JADD_MIXED
 
 #undef CURVE
 
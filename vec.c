@@ -29,6 +29,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <unistd.h>
+#include <sys/resource.h>
 
 #include <gmp.h>
 
@@ -36,6 +38,7 @@
 
 #define DEFAULT_TEST_TIME 500
 #define DEFAULT_SPEED_TIME 2000
+#define DEFAULT_TUNE_TIME 100
 
 
 /*
@@ -683,6 +686,214 @@ test_jmul(vec_curve *curve)
   mpz_clear(rx1);
 }
 
+void
+test_jmulsw(vec_curve *curve)
+{
+  jmul_func jmul = curve->jmul;
+
+  curve->jmul = vec_jmulsw_generic;
+  test_jmul(curve);
+  curve->jmul = jmul;
+}
+
+void
+test_jdmul(vec_curve *curve)
+{
+  int t;
+
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rx2;
+  mpz_t ry2;
+  mpz_t rx3;
+  mpz_t ry3;
+
+  vec_scratch_mpz_t scratch;
+  vec_jfmul_tab_ptr table_ptr;
+
+  mpz_t Ox;
+  mpz_t Oy;
+
+  mpz_t bx;
+  mpz_t by;
+
+  mpz_t scalar1;
+  mpz_t scalar2;
+
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rx2);
+  mpz_init(ry2);
+  mpz_init(rx3);
+  mpz_init(ry3);
+
+  vec_scratch_init_mpz_t(scratch);
+
+  mpz_init(Ox);
+  mpz_init(Oy);
+
+  mpz_init(bx);
+  mpz_init(by);
+
+  mpz_init(scalar1);
+  mpz_init(scalar2);
+
+  t = clock();
+
+  table_ptr = vec_jfmul_precomp_aff(curve, curve->gx, curve->gy, 1000);
+
+  mpz_set_si(Ox, -1);
+  mpz_set_si(Oy, -1);
+
+  /* Test with zero scalars and with the unit element. */
+  mpz_set_ui(scalar1, 0);
+  mpz_set_ui(scalar2, 0);
+
+  vec_jdmul_aff(rx1, ry1,
+                curve,
+                curve->gx, curve->gy, scalar1,
+                curve->gx, curve->gy, scalar2);
+  assert(vec_eq(rx1, ry1, Ox, Oy));
+
+  vec_jfdmul_aff(rx1, ry1,
+                 curve,
+                 table_ptr, scalar1,
+                 curve->gx, curve->gy, scalar2);
+  assert(vec_eq(rx1, ry1, Ox, Oy));
+
+  mpz_set_ui(scalar2, 1);
+  mpz_mul_2exp(scalar2, scalar2, 100000);
+  mpz_mod(scalar2, scalar2, curve->n);
+
+  vec_mul(rx1, ry1,
+          curve,
+          curve->gx, curve->gy,
+          scalar2);
+
+  vec_jdmul_aff(rx2, ry2,
+                curve,
+                Ox, Oy, scalar2,
+                curve->gx, curve->gy, scalar2);
+  assert(vec_eq(rx1, ry1, rx2, ry2));
+
+  vec_jfdmul_aff(rx2, ry2,
+                 curve,
+                 table_ptr, scalar1,
+                 curve->gx, curve->gy, scalar2);
+  assert(vec_eq(rx1, ry1, rx2, ry2));
+
+  vec_jfdmul_aff(rx2, ry2,
+                 curve,
+                 table_ptr, scalar2,
+                 Ox, Oy, scalar2);
+  assert(vec_eq(rx1, ry1, rx2, ry2));
+
+  /* Test cancellation, i.e., s * P + (n - s) * P. */
+  mpz_sub(scalar1, curve->n, scalar2);
+
+  vec_jdmul_aff(rx2, ry2,
+                curve,
+                curve->gx, curve->gy, scalar1,
+                curve->gx, curve->gy, scalar2);
+  assert(vec_eq(rx2, ry2, Ox, Oy));
+
+  vec_jfdmul_aff(rx2, ry2,
+                 curve,
+                 table_ptr, scalar1,
+                 curve->gx, curve->gy, scalar2);
+  assert(vec_eq(rx2, ry2, Ox, Oy));
+
+  /* Test scalars longer than the order. */
+  mpz_set_ui(scalar1, 1);
+  mpz_mul_2exp(scalar1, scalar1, mpz_sizeinbase(curve->n, 2) + 5);
+  mpz_add_ui(scalar2, scalar1, 3);
+
+  mpz_add(bx, scalar1, scalar2);
+  mpz_mod(bx, bx, curve->n);
+  vec_mul(rx1, ry1,
+          curve,
+          curve->gx, curve->gy,
+          bx);
+
+  vec_jfdmul_aff(rx2, ry2,
+                 curve,
+                 table_ptr, scalar1,
+                 curve->gx, curve->gy, scalar2);
+  assert(vec_eq(rx1, ry1, rx2, ry2));
+
+  mpz_set_ui(scalar2, 1);
+  mpz_mul_2exp(scalar2, scalar2, 100000);
+  mpz_mod(scalar2, scalar2, curve->n);
+
+  mpz_set(bx, curve->gx);
+  mpz_set(by, curve->gy);
+
+  mpz_mul(scalar1, scalar2, scalar2);
+  mpz_add_ui(scalar1, scalar1, 1);
+  mpz_mod(scalar1, scalar1, curve->n);
+
+  /* Test general double-scalar multiplication. */
+  do
+    {
+
+      vec_mul(rx1, ry1,
+              curve,
+              curve->gx, curve->gy,
+              scalar1);
+      vec_mul(rx2, ry2,
+              curve,
+              bx, by,
+              scalar2);
+      vec_add(scratch,
+              rx1, ry1,
+              curve,
+              rx1, ry1,
+              rx2, ry2);
+
+      vec_jdmul_aff(rx3, ry3,
+                    curve,
+                    curve->gx, curve->gy, scalar1,
+                    bx, by, scalar2);
+      assert(vec_eq(rx1, ry1, rx3, ry3));
+
+      vec_jfdmul_aff(rx3, ry3,
+                     curve,
+                     table_ptr, scalar1,
+                     bx, by, scalar2);
+      assert(vec_eq(rx1, ry1, rx3, ry3));
+
+      mpz_set(bx, rx2);
+      mpz_set(by, ry2);
+
+      mpz_mul(scalar1, scalar1, scalar2);
+      mpz_mod(scalar1, scalar1, curve->n);
+      mpz_mul(scalar2, scalar2, scalar2);
+      mpz_mod(scalar2, scalar2, curve->n);
+
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  vec_jfmul_free_aff(curve, table_ptr);
+
+  mpz_clear(scalar2);
+  mpz_clear(scalar1);
+
+  mpz_clear(by);
+  mpz_clear(bx);
+
+  mpz_clear(Oy);
+  mpz_clear(Ox);
+
+  vec_scratch_clear_mpz_t(scratch);
+
+  mpz_clear(ry3);
+  mpz_clear(rx3);
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+}
+
 void
 test_jsmul(vec_curve *curve)
 {
@@ -772,125 +983,2112 @@ test_jsmul(vec_curve *curve)
 }
 
 void
-test_jfmul(vec_curve *curve)
+test_jsmul_bucket(vec_curve *curve)
 {
+
   int t;
+  size_t len;
+  size_t i;
 
   mpz_t rx1;
   mpz_t ry1;
+
   mpz_t rx2;
   mpz_t ry2;
+  mpz_t rz2;
 
-  vec_scratch_mpz_t scratch;
-  vec_jfmul_tab_ptr table_ptr;
+  mpz_t *basesx;
+  mpz_t *basesy;
+  mpz_t *basesz;
+  mpz_t *scalars;
 
   mpz_t scalar;
 
   mpz_init(rx1);
   mpz_init(ry1);
+
   mpz_init(rx2);
   mpz_init(ry2);
-
-  vec_scratch_init_mpz_t(scratch);
+  mpz_init(rz2);
 
   mpz_init(scalar);
 
-  t = clock();
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
 
-  table_ptr = vec_jfmul_precomp_aff(curve, curve->gx, curve->gy, 1000);
+  len = 1;
 
-  /* Test multiplication with unit element. */
-  mpz_set_ui(scalar, 0);
+  t = clock();
+  do
+    {
 
-  vec_mul(rx1, ry1,
-          curve,
-          curve->gx, curve->gy,
-          scalar);
+      /* Generate "random" bases and scalars. */
+      basesx = vec_array_alloc_init(len);
+      basesy = vec_array_alloc_init(len);
+      basesz = vec_array_alloc_init(len);
+      scalars = vec_array_alloc_init(len);
 
-  vec_jfmul_aff(rx2, ry2,
+      for (i = 0; i < len; i++) {
+
+        vec_mul(basesx[i], basesy[i],
                 curve,
-                table_ptr,
+                curve->gx, curve->gy,
                 scalar);
 
-  assert(vec_eq(rx1, ry1, rx2, ry2));
-
-  /* Test general multiplication. */
+        mpz_mul(scalar, scalar, scalar);
+        mpz_mod(scalar, scalar, curve->n);
+        mpz_set(scalars[i], scalar);
+      }
 
-  mpz_set_ui(scalar, 1);
-  mpz_mul_2exp(scalar, scalar, 100000);
-  mpz_mod(scalar, scalar, curve->n);
+      /* Compute simultaneous multiplication affinely. */
+      vec_smul(rx1, ry1,
+               curve,
+               basesx, basesy,
+               scalars,
+               len);
 
-  do
-    {
+      /* Compute simultaneous multiplication with buckets. */
+      for (i = 0; i < len; i++) {
+        vec_affj(basesx[i], basesy[i], basesz[i]);
+      }
 
-      vec_mul(rx1, ry1,
-              curve,
-              curve->gx, curve->gy,
-              scalar);
+      curve->jsmul_bucket(rx2, ry2, rz2,
+                          curve,
+                          basesx, basesy, basesz,
+                          scalars,
+                          len);
 
-      vec_jfmul_aff(rx2, ry2,
-                    curve,
-                    table_ptr,
-                    scalar);
+      vec_jaff(rx2, ry2, rz2, curve);
 
-      assert(vec_eq(rx1, ry1, rx2, ry2));
+      assert(vec_eq(rx2, ry2, rx1, ry1));
 
-      mpz_mul(scalar, scalar, scalar);
-      mpz_mod(scalar, scalar, curve->n);
+      vec_array_clear_free(scalars, len);
+      vec_array_clear_free(basesz, len);
+      vec_array_clear_free(basesy, len);
+      vec_array_clear_free(basesx, len);
 
+      len <<= 1;
     }
   while (!vec_done(t, DEFAULT_TEST_TIME));
 
-  vec_jfmul_free_aff(curve, table_ptr);
-
   mpz_clear(scalar);
 
-  vec_scratch_clear_mpz_t(scratch);
-
+  mpz_clear(rz2);
   mpz_clear(ry2);
   mpz_clear(rx2);
   mpz_clear(ry1);
   mpz_clear(rx1);
+
 }
 
 void
-test_sqrt(mpz_t p) {
+test_jsmul_par(vec_curve *curve)
+{
 
   int t;
+  size_t len;
+  size_t i;
 
-  mpz_t a;
-  mpz_t z;
-  mpz_t res;
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rz1;
 
-  mpz_init(a);
-  mpz_init(z);
-  mpz_init(res);
+  mpz_t rx2;
+  mpz_t ry2;
+  mpz_t rz2;
 
-  t = clock();
+  mpz_t *basesx;
+  mpz_t *basesy;
+  mpz_t *basesz;
+  mpz_t *scalars;
 
-  mpz_set_si(a, 1);
-  mpz_mul_2exp(a, a, 1000);
-  mpz_mod(a, a, p);
+  mpz_t scalar;
 
-  mpz_set_si(z, 2);
-  while (mpz_legendre(z, p) == 1)
-    {
-      mpz_add_ui(z, z, 1);
-    }
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rz1);
 
-  mpz_mul(a, a, a);
-  mpz_mod(a, a, p);
+  mpz_init(rx2);
+  mpz_init(ry2);
+  mpz_init(rz2);
 
-  do
+  mpz_init(scalar);
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  len = 1;
+
+  t = clock();
+  do
+    {
+
+      /* Generate "random" bases and scalars. */
+      basesx = vec_array_alloc_init(len);
+      basesy = vec_array_alloc_init(len);
+      basesz = vec_array_alloc_init(len);
+      scalars = vec_array_alloc_init(len);
+
+      for (i = 0; i < len; i++) {
+
+        vec_mul(basesx[i], basesy[i],
+                curve,
+                curve->gx, curve->gy,
+                scalar);
+        vec_affj(basesx[i], basesy[i], basesz[i]);
+
+        mpz_mul(scalar, scalar, scalar);
+        mpz_mod(scalar, scalar, curve->n);
+        mpz_set(scalars[i], scalar);
+      }
+
+      /* Compute simultaneous multiplication in a single thread. */
+      curve->jsmul(rx1, ry1, rz1,
+                   curve,
+                   basesx, basesy, basesz,
+                   scalars,
+                   len);
+      vec_jaff(rx1, ry1, rz1, curve);
+
+      /* Compute simultaneous multiplication with a fixed number of
+         threads and with one thread per core. */
+      vec_jsmul_par(rx2, ry2, rz2,
+                    curve,
+                    basesx, basesy, basesz,
+                    scalars,
+                    len,
+                    3);
+      vec_jaff(rx2, ry2, rz2, curve);
+
+      assert(vec_eq(rx2, ry2, rx1, ry1));
+
+      vec_jsmul_par(rx2, ry2, rz2,
+                    curve,
+                    basesx, basesy, basesz,
+                    scalars,
+                    len,
+                    0);
+      vec_jaff(rx2, ry2, rz2, curve);
+
+      assert(vec_eq(rx2, ry2, rx1, ry1));
+
+      vec_array_clear_free(scalars, len);
+      vec_array_clear_free(basesz, len);
+      vec_array_clear_free(basesy, len);
+      vec_array_clear_free(basesx, len);
+
+      len <<= 1;
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  mpz_clear(scalar);
+
+  mpz_clear(rz2);
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(rz1);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+
+}
+
+void
+test_jfmul(vec_curve *curve)
+{
+  int t;
+
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rx2;
+  mpz_t ry2;
+
+  vec_scratch_mpz_t scratch;
+  vec_jfmul_tab_ptr table_ptr;
+
+  mpz_t scalar;
+
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rx2);
+  mpz_init(ry2);
+
+  vec_scratch_init_mpz_t(scratch);
+
+  mpz_init(scalar);
+
+  t = clock();
+
+  table_ptr = vec_jfmul_precomp_aff(curve, curve->gx, curve->gy, 1000);
+
+  /* Test multiplication with unit element. */
+  mpz_set_ui(scalar, 0);
+
+  vec_mul(rx1, ry1,
+          curve,
+          curve->gx, curve->gy,
+          scalar);
+
+  vec_jfmul_aff(rx2, ry2,
+                curve,
+                table_ptr,
+                scalar);
+
+  assert(vec_eq(rx1, ry1, rx2, ry2));
+
+  /* Test general multiplication. */
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  do
+    {
+
+      vec_mul(rx1, ry1,
+              curve,
+              curve->gx, curve->gy,
+              scalar);
+
+      vec_jfmul_aff(rx2, ry2,
+                    curve,
+                    table_ptr,
+                    scalar);
+
+      assert(vec_eq(rx1, ry1, rx2, ry2));
+
+      mpz_mul(scalar, scalar, scalar);
+      mpz_mod(scalar, scalar, curve->n);
+
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  vec_jfmul_free_aff(curve, table_ptr);
+
+  mpz_clear(scalar);
+
+  vec_scratch_clear_mpz_t(scratch);
+
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+}
+
+void
+test_jfcomb(vec_curve *curve)
+{
+  int t;
+  int i;
+
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rx2;
+  mpz_t ry2;
+
+  vec_jfcomb_tab_ptr table_ptr[3];
+  size_t max_bytes[3] = {0, 1 << 16, 1 << 22};
+
+  mpz_t scalar;
+  mpz_t tmp;
+
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rx2);
+  mpz_init(ry2);
+
+  mpz_init(scalar);
+  mpz_init(tmp);
+
+  t = clock();
+
+  /* The smallest comb, a comb within a budget, and a large comb. */
+  for (i = 0; i < 3; i++)
+    {
+      table_ptr[i] = vec_jfcomb_precomp_aff(curve,
+                                            curve->gx, curve->gy,
+                                            1000,
+                                            max_bytes[i]);
+    }
+
+  /* Test multiplication with unit element. */
+  mpz_set_ui(scalar, 0);
+
+  vec_mul(rx1, ry1,
+          curve,
+          curve->gx, curve->gy,
+          scalar);
+
+  for (i = 0; i < 3; i++)
+    {
+      vec_jfcomb_aff(rx2, ry2,
+                     curve,
+                     table_ptr[i],
+                     scalar);
+
+      assert(vec_eq(rx1, ry1, rx2, ry2));
+    }
+
+  /* Test general multiplication. */
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  do
+    {
+
+      vec_mul(rx1, ry1,
+              curve,
+              curve->gx, curve->gy,
+              scalar);
+
+      for (i = 0; i < 3; i++)
+        {
+          vec_jfcomb_aff(rx2, ry2,
+                         curve,
+                         table_ptr[i],
+                         scalar);
+
+          assert(vec_eq(rx1, ry1, rx2, ry2));
+        }
+
+      /* The scalar need not be reduced. */
+      mpz_add(tmp, scalar, curve->n);
+      vec_jfcomb_aff(rx2, ry2,
+                     curve,
+                     table_ptr[1],
+                     tmp);
+
+      assert(vec_eq(rx1, ry1, rx2, ry2));
+
+      mpz_mul(scalar, scalar, scalar);
+      mpz_mod(scalar, scalar, curve->n);
+
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  for (i = 0; i < 3; i++)
+    {
+      vec_jfcomb_free_aff(curve, table_ptr[i]);
+    }
+
+  mpz_clear(tmp);
+  mpz_clear(scalar);
+
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+}
+
+void
+test_jfmul_batch(vec_curve *curve)
+{
+  int t;
+  size_t len;
+  size_t i;
+  size_t threads;
+
+  mpz_t x;
+  mpz_t y;
+  mpz_t z;
+
+  mpz_t *rx1;
+  mpz_t *ry1;
+  mpz_t *rz1;
+  mpz_t *rx2;
+  mpz_t *ry2;
+  mpz_t *rz2;
+  mpz_t *scalars;
+
+  vec_jfmul_tab_ptr table_ptr;
+
+  mpz_t scalar;
+
+  mpz_init(x);
+  mpz_init(y);
+  mpz_init(z);
+
+  mpz_init(scalar);
+
+  mpz_set(x, curve->gx);
+  mpz_set(y, curve->gy);
+  vec_affj(x, y, z);
+
+  table_ptr = curve->jfmul_precomp(curve, x, y, z, 1000);
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  len = 1;
+
+  t = clock();
+  do
+    {
+
+      /* Generate "random" scalars, the first of which is zero. */
+      rx1 = vec_array_alloc_init(len);
+      ry1 = vec_array_alloc_init(len);
+      rz1 = vec_array_alloc_init(len);
+      rx2 = vec_array_alloc_init(len);
+      ry2 = vec_array_alloc_init(len);
+      rz2 = vec_array_alloc_init(len);
+      scalars = vec_array_alloc_init(len);
+
+      for (i = 1; i < len; i++) {
+        mpz_mul(scalar, scalar, scalar);
+        mpz_mod(scalar, scalar, curve->n);
+        mpz_set(scalars[i], scalar);
+      }
+
+      /* Compute fixed basis multiplications one by one. */
+      for (i = 0; i < len; i++) {
+        curve->jfmul(rx1[i], ry1[i], rz1[i], curve, table_ptr, scalars[i]);
+        vec_jaff(rx1[i], ry1[i], rz1[i], curve);
+      }
+
+      /* Compute fixed basis multiplications as a batch in a single
+         thread and in several threads. */
+      for (threads = 1; threads <= 3; threads += 2) {
+
+        vec_jfmul_batch(rx2, ry2, rz2,
+                        curve,
+                        table_ptr,
+                        scalars,
+                        len,
+                        threads);
+
+        for (i = 0; i < len; i++) {
+          vec_jaff(rx2[i], ry2[i], rz2[i], curve);
+          assert(vec_eq(rx1[i], ry1[i], rx2[i], ry2[i]));
+        }
+      }
+
+      vec_array_clear_free(scalars, len);
+      vec_array_clear_free(rz2, len);
+      vec_array_clear_free(ry2, len);
+      vec_array_clear_free(rx2, len);
+      vec_array_clear_free(rz1, len);
+      vec_array_clear_free(ry1, len);
+      vec_array_clear_free(rx1, len);
+
+      len <<= 1;
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  curve->jfmul_free(table_ptr);
+
+  mpz_clear(scalar);
+
+  mpz_clear(z);
+  mpz_clear(y);
+  mpz_clear(x);
+}
+
+void
+test_jfmul_precomp_par(vec_curve *curve)
+{
+  int i;
+  size_t len;
+  size_t threads;
+
+  mpz_t x;
+  mpz_t y;
+  mpz_t z;
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rz1;
+  mpz_t rx2;
+  mpz_t ry2;
+  mpz_t rz2;
+
+  vec_jfmul_tab_ptr table_ptr;
+  vec_jfmul_tab_ptr par_ptr;
+
+  mpz_t scalar;
+
+  mpz_init(x);
+  mpz_init(y);
+  mpz_init(z);
+
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rz1);
+  mpz_init(rx2);
+  mpz_init(ry2);
+  mpz_init(rz2);
+
+  mpz_init(scalar);
+
+  mpz_set(x, curve->gx);
+  mpz_set(y, curve->gy);
+  vec_affj(x, y, z);
+
+  /* Tables of increasing width computed with different numbers of
+     threads, including one thread per core, give the same results as
+     tables computed sequentially. */
+  for (len = 1; len <= 10000; len *= 100)
+    {
+      table_ptr = curve->jfmul_precomp(curve, x, y, z, len);
+
+      for (threads = 0; threads <= 3; threads++)
+        {
+          par_ptr = curve->jfmul_precomp_par(curve, x, y, z, len, threads);
+
+          /* The first scalar is zero and the second is minus one. */
+          mpz_set_ui(scalar, 0);
+          for (i = 0; i < 10; i++)
+            {
+              curve->jfmul(rx1, ry1, rz1, curve, table_ptr, scalar);
+              vec_jaff(rx1, ry1, rz1, curve);
+
+              curve->jfmul(rx2, ry2, rz2, curve, par_ptr, scalar);
+              vec_jaff(rx2, ry2, rz2, curve);
+
+              assert(vec_eq(rx1, ry1, rx2, ry2));
+
+              if (i == 0)
+                {
+                  mpz_sub_ui(scalar, curve->n, 1);
+                }
+              else
+                {
+                  mpz_mul(scalar, scalar, scalar);
+                  mpz_add_ui(scalar, scalar, i);
+                  mpz_mod(scalar, scalar, curve->n);
+                }
+            }
+
+          curve->jfmul_free(par_ptr);
+        }
+
+      curve->jfmul_free(table_ptr);
+    }
+
+  mpz_clear(scalar);
+
+  mpz_clear(rz2);
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(rz1);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+
+  mpz_clear(z);
+  mpz_clear(y);
+  mpz_clear(x);
+}
+
+/* Offsets of the width and slice length in the header of a table
+   file, and the length of the header including padding. */
+#define TEST_JFMUL_FILE_ELEMENT_BYTES 72
+#define TEST_JFMUL_FILE_BLOCK_WIDTH 80
+#define TEST_JFMUL_FILE_SLICE_BIT_LEN 88
+#define TEST_JFMUL_FILE_TAB_LEN 96
+#define TEST_JFMUL_FILE_HEADER_LEN 128
+
+/* Returns the width of the table stored in the file. */
+static uint64_t
+test_jfmul_file_width(const char *path)
+{
+  FILE *fp;
+  size_t read;
+  uint64_t block_width;
+
+  fp = fopen(path, "rb");
+  assert(fp != NULL);
+  fseek(fp, TEST_JFMUL_FILE_BLOCK_WIDTH, SEEK_SET);
+  read = fread(&block_width, 8, 1, fp);
+  assert(read == 1);
+  fclose(fp);
+
+  VEC_UNUSED(read);
+
+  return block_width;
+}
+
+/* Writes a copy of the table file with the given width and slice
+   length in its header, padded to the length the header claims, and
+   returns the result of loading it. */
+static int
+test_jfmul_file_header(vec_curve *curve, const char *path,
+                       uint64_t block_width, uint64_t slice_bit_len)
+{
+  int res;
+  int fd;
+  FILE *fp;
+  long len;
+  long done;
+  uint64_t element_bytes;
+  uint64_t tab_len;
+  uint64_t array_len;
+  unsigned char *buf;
+  char copy[] = "/tmp/vec_jfmul_XXXXXX";
+  vec_jfmul_tab_ptr table_ptr;
+
+  fp = fopen(path, "rb");
+  assert(fp != NULL);
+  fseek(fp, 0, SEEK_END);
+  len = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  buf = (unsigned char *)malloc(len);
+  done = fread(buf, len, 1, fp);
+  assert(done == 1);
+  fclose(fp);
+
+  memcpy(&element_bytes, buf + TEST_JFMUL_FILE_ELEMENT_BYTES, 8);
+  tab_len = ((uint64_t)1) << block_width;
+  memcpy(buf + TEST_JFMUL_FILE_BLOCK_WIDTH, &block_width, 8);
+  memcpy(buf + TEST_JFMUL_FILE_SLICE_BIT_LEN, &slice_bit_len, 8);
+  memcpy(buf + TEST_JFMUL_FILE_TAB_LEN, &tab_len, 8);
+
+  fd = mkstemp(copy);
+  assert(fd >= 0);
+  done = write(fd, buf, len);
+  assert(done == len);
+
+  /* Make the file long enough for the claimed table, so that only
+     the header itself can be rejected. */
+  array_len = (tab_len * element_bytes + 63) / 64 * 64;
+  done = ftruncate(fd, TEST_JFMUL_FILE_HEADER_LEN + 3 * array_len);
+  assert(done == 0);
+  close(fd);
+
+  VEC_UNUSED(done);
+
+  res = curve->jfmul_load(&table_ptr, curve, copy);
+  if (res == 0)
+    {
+      curve->jfmul_free(table_ptr);
+    }
+
+  unlink(copy);
+  free(buf);
+
+  return res;
+}
+
+void
+test_jfmul_file(vec_curve *curve)
+{
+  int t;
+  int fd;
+  int ret;
+  char path[] = "/tmp/vec_jfmul_XXXXXX";
+
+  mpz_t x;
+  mpz_t y;
+  mpz_t z;
+
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rz1;
+  mpz_t rx2;
+  mpz_t ry2;
+  mpz_t rz2;
+
+  vec_jfmul_tab_ptr table_ptr;
+  vec_jfmul_tab_ptr mapped_ptr;
+
+  mpz_t scalar;
+
+  mpz_init(x);
+  mpz_init(y);
+  mpz_init(z);
+
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rz1);
+  mpz_init(rx2);
+  mpz_init(ry2);
+  mpz_init(rz2);
+
+  mpz_init(scalar);
+
+  mpz_set(x, curve->gx);
+  mpz_set(y, curve->gy);
+  vec_affj(x, y, z);
+
+  table_ptr = curve->jfmul_precomp(curve, x, y, z, 1000);
+
+  /* Write the table to a file and map it back. */
+  fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  ret = curve->jfmul_save(curve, table_ptr, path);
+  assert(ret == 0);
+  ret = curve->jfmul_load(&mapped_ptr, curve, path);
+  assert(ret == 0);
+
+  /* Tables of other curves and missing files are rejected. */
+  if (strcmp(curve->name, "P-256") != 0)
+    {
+      vec_curve *other = vec_curve_get_named("P-256", 0);
+      ret = other->jfmul_load(&table_ptr, other, path);
+      assert(ret != 0);
+      vec_curve_free(other);
+    }
+  ret = curve->jfmul_load(&table_ptr, curve, "/nonexistent/vec");
+  assert(ret != 0);
+
+  /* Headers with a width too large for the transposed scalars, or
+     slices too short for the scalars, are rejected. */
+  {
+    uint64_t width = test_jfmul_file_width(path);
+    uint64_t bitlen = mpz_sizeinbase(curve->n, 2);
+    uint64_t slice = (bitlen + width - 1) / width;
+
+    ret = test_jfmul_file_header(curve, path, width, slice);
+    assert(ret == 0);
+    ret = test_jfmul_file_header(curve, path,
+                                 VEC_TRANSPOSE_MAX_WIDTH + 1, slice);
+    assert(ret != 0);
+    ret = test_jfmul_file_header(curve, path, width, slice - 1);
+    assert(ret != 0);
+  }
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  t = clock();
+  do
+    {
+
+      curve->jfmul(rx1, ry1, rz1, curve, table_ptr, scalar);
+      vec_jaff(rx1, ry1, rz1, curve);
+
+      curve->jfmul(rx2, ry2, rz2, curve, mapped_ptr, scalar);
+      vec_jaff(rx2, ry2, rz2, curve);
+
+      assert(vec_eq(rx1, ry1, rx2, ry2));
+
+      mpz_mul(scalar, scalar, scalar);
+      mpz_mod(scalar, scalar, curve->n);
+
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  curve->jfmul_free(mapped_ptr);
+  curve->jfmul_free(table_ptr);
+
+  unlink(path);
+
+  /* The return values are only read by assertions. */
+  VEC_UNUSED(ret);
+
+  mpz_clear(scalar);
+
+  mpz_clear(rz2);
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(rz1);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+
+  mpz_clear(z);
+  mpz_clear(y);
+  mpz_clear(x);
+}
+
+void
+test_jfsmul(vec_curve *curve)
+{
+  int t;
+  int fd;
+  int ret;
+  size_t i;
+  size_t j;
+  size_t len = 37;
+  char path[] = "/tmp/vec_jfsmul_XXXXXX";
+
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rx2;
+  mpz_t ry2;
+
+  mpz_t *basesx;
+  mpz_t *basesy;
+  mpz_t *scalars;
+  mpz_t *unreduced;
+
+  vec_jfsmul_tab_ptr table_ptr[3];
+  vec_jfsmul_tab_ptr mapped_ptr;
+  size_t max_bytes[3] = {0, 1 << 16, 1 << 22};
+
+  mpz_t scalar;
+
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rx2);
+  mpz_init(ry2);
+
+  mpz_init(scalar);
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  /* Generate "random" bases. */
+  basesx = vec_array_alloc_init(len);
+  basesy = vec_array_alloc_init(len);
+  scalars = vec_array_alloc_init(len);
+  unreduced = vec_array_alloc_init(len);
+
+  for (i = 0; i < len; i++)
+    {
+      vec_mul(basesx[i], basesy[i],
+              curve,
+              curve->gx, curve->gy,
+              scalar);
+
+      mpz_mul(scalar, scalar, scalar);
+      mpz_mod(scalar, scalar, curve->n);
+    }
+
+  /* The narrowest table, a table within a budget, and a wide table. */
+  for (j = 0; j < 3; j++)
+    {
+      table_ptr[j] = vec_jfsmul_precomp_aff(curve,
+                                            basesx, basesy,
+                                            len,
+                                            1000,
+                                            max_bytes[j]);
+    }
+
+  /* Write the wide table to a file and map it back. */
+  fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  ret = curve->jfsmul_save(curve, table_ptr[2], path);
+  assert(ret == 0);
+  ret = curve->jfsmul_load(&mapped_ptr, curve, path);
+  assert(ret == 0);
+
+  /* Tables of other curves and missing files are rejected. */
+  if (strcmp(curve->name, "P-256") != 0)
+    {
+      vec_curve *other = vec_curve_get_named("P-256", 0);
+      ret = other->jfsmul_load(&table_ptr[0], other, path);
+      assert(ret != 0);
+      vec_curve_free(other);
+    }
+  ret = curve->jfsmul_load(&table_ptr[0], curve, "/nonexistent/vec");
+  assert(ret != 0);
+
+  t = clock();
+  do
+    {
+
+      /* New scalars for the same bases. Some scalars are zero and
+         some are short. */
+      for (i = 0; i < len; i++)
+        {
+          mpz_mul(scalar, scalar, scalar);
+          mpz_mod(scalar, scalar, curve->n);
+
+          if (i % 5 == 0)
+            {
+              mpz_set_ui(scalars[i], 0);
+            }
+          else if (i % 5 == 1)
+            {
+              mpz_tdiv_r_2exp(scalars[i], scalar, 64);
+            }
+          else
+            {
+              mpz_set(scalars[i], scalar);
+            }
+
+          /* Scalars need not be reduced modulo the order. */
+          if (i % 2 == 0)
+            {
+              mpz_sub(unreduced[i], scalars[i], curve->n);
+            }
+          else
+            {
+              mpz_add(unreduced[i], scalars[i], curve->n);
+            }
+        }
+
+      vec_smul(rx1, ry1,
+               curve,
+               basesx, basesy,
+               scalars,
+               len);
+
+      for (j = 0; j < 3; j++)
+        {
+          vec_jfsmul_aff(rx2, ry2, curve, table_ptr[j], scalars);
+          assert(vec_eq(rx1, ry1, rx2, ry2));
+        }
+
+      vec_jfsmul_aff(rx2, ry2, curve, table_ptr[1], unreduced);
+      assert(vec_eq(rx1, ry1, rx2, ry2));
+
+      vec_jfsmul_aff(rx2, ry2, curve, mapped_ptr, scalars);
+      assert(vec_eq(rx1, ry1, rx2, ry2));
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  /* The sum is the unit element if all scalars are zero. */
+  for (i = 0; i < len; i++)
+    {
+      mpz_set_ui(scalars[i], 0);
+    }
+  vec_jfsmul_aff(rx2, ry2, curve, table_ptr[1], scalars);
+  assert(mpz_cmp_si(rx2, -1) == 0 && mpz_cmp_si(ry2, -1) == 0);
+
+  vec_jfsmul_free_aff(curve, mapped_ptr);
+  for (j = 0; j < 3; j++)
+    {
+      vec_jfsmul_free_aff(curve, table_ptr[j]);
+    }
+
+  unlink(path);
+
+  /* The return values are only read by assertions. */
+  VEC_UNUSED(ret);
+
+  vec_array_clear_free(unreduced, len);
+  vec_array_clear_free(scalars, len);
+  vec_array_clear_free(basesy, len);
+  vec_array_clear_free(basesx, len);
+
+  mpz_clear(scalar);
+
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+}
+
+void
+test_scalars_transpose(vec_curve *curve)
+{
+  int t;
+  size_t i;
+  size_t j;
+  size_t k;
+  size_t block_width;
+  size_t tabs_len;
+  size_t bit_length;
+  size_t len = 37;
+  uint16_t mask;
+  uint16_t *masks;
+  mpz_t *scalars;
+  mpz_t modulus;
+
+  mpz_init(modulus);
+
+  /* Scalars longer than the order are used to cover many bytes. */
+  mpz_pow_ui(modulus, curve->n, 3);
+  bit_length = mpz_sizeinbase(modulus, 2);
+
+  scalars = vec_array_alloc_init(len);
+  masks = (uint16_t *)malloc(bit_length * len * sizeof(uint16_t));
+
+  mpz_set_ui(scalars[0], 1);
+  mpz_mul_2exp(scalars[0], scalars[0], 1000);
+  mpz_mod(scalars[0], scalars[0], modulus);
+
+  t = clock();
+
+  do
+    {
+
+      /* Short and zero scalars are mixed with long scalars. */
+      for (i = 1; i < len; i++)
+        {
+          mpz_mul(scalars[i], scalars[i - 1], scalars[i - 1]);
+          mpz_add_ui(scalars[i], scalars[i], i);
+          mpz_mod(scalars[i], scalars[i], modulus);
+        }
+      mpz_tdiv_q_2exp(scalars[3], scalars[3], bit_length / 2);
+      mpz_set_ui(scalars[5], 0);
+
+      for (block_width = 1;
+           block_width <= VEC_TRANSPOSE_MAX_WIDTH;
+           block_width++)
+        {
+
+          tabs_len = (len + block_width - 1) / block_width;
+
+          vec_scalars_transpose(masks, scalars, len,
+                                block_width, bit_length);
+
+          for (i = 0; i < bit_length; i++)
+            {
+              for (j = 0; j < tabs_len; j++)
+                {
+                  mask = 0;
+                  for (k = 0;
+                       k < block_width && j * block_width + k < len;
+                       k++)
+                    {
+                      if (mpz_tstbit(scalars[j * block_width + k], i))
+                        {
+                          mask |= (uint16_t)(1 << k);
+                        }
+                    }
+                  assert(masks[i * tabs_len + j] == mask);
+                }
+            }
+        }
+
+      mpz_set(scalars[0], scalars[len - 1]);
+
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  free(masks);
+  vec_array_clear_free(scalars, len);
+
+  mpz_clear(modulus);
+}
+
+void
+test_tuning(vec_curve *curve)
+{
+  int t;
+  int i;
+  int ret;
+  int fd;
+  char path[] = "/tmp/vec_tuning_XXXXXX";
+  size_t len;
+  size_t j;
+  size_t block_width;
+  size_t batch_len;
+
+  vec_tuning *tuning;
+  vec_tuning *loaded;
+  vec_tuning_record *record;
+  vec_tuning_record *other;
+  vec_jfmul_tab_ptr table_ptr;
+
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rx2;
+  mpz_t ry2;
+
+  mpz_t *basesx;
+  mpz_t *basesy;
+  mpz_t *scalars;
+
+  mpz_t scalar;
+
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rx2);
+  mpz_init(ry2);
+
+  mpz_init(scalar);
+
+  /* Measure the costs and derive parameters. */
+  tuning = vec_tuning_alloc();
+  record = vec_tune(tuning, curve, 1);
+
+  assert(tuning->len == 1);
+  assert(record == &tuning->records[0]);
+
+  assert(strcmp(record->costs.curve, curve->name) == 0);
+  assert(record->costs.dbl > 0);
+  assert(record->costs.add > 0);
+  assert(record->costs.madd > 0);
+  assert(record->bit_length == (int)mpz_sizeinbase(curve->n, 2));
+
+  for (i = 0; i < VEC_TUNING_LENS; i++)
+    {
+      assert(record->smul_block_width[i] >= 1);
+      assert(record->smul_block_width[i] <= VEC_TRANSPOSE_MAX_WIDTH);
+      assert(record->smul_batch_len[i] >= 1);
+      assert(record->smul_batch_len[i] <= ((size_t)1) << i);
+      assert(record->fmul_block_width[i] >= 2);
+      assert(record->fmul_block_width[i] <= VEC_TRANSPOSE_MAX_WIDTH);
+    }
+
+  /* Inserting a record of the same implementation replaces it. */
+  other = vec_tuning_insert(tuning, record);
+  assert(other == record);
+  assert(tuning->len == 1);
+
+  /* Write the tuning to a file and read it back. */
+  fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  ret = vec_tuning_save(tuning, path);
+  assert(ret == 0);
+
+  loaded = vec_tuning_alloc();
+  ret = vec_tuning_load(loaded, path);
+  assert(ret == 0);
+  assert(loaded->len == 1);
+
+  other = vec_tuning_find(loaded, curve->name, record->costs.backend);
+  assert(other != NULL);
+  assert(other->bit_length == record->bit_length);
+  assert(memcmp(other->smul_block_width, record->smul_block_width,
+                sizeof(record->smul_block_width)) == 0);
+  assert(memcmp(other->smul_batch_len, record->smul_batch_len,
+                sizeof(record->smul_batch_len)) == 0);
+  assert(memcmp(other->fmul_block_width, record->fmul_block_width,
+                sizeof(record->fmul_block_width)) == 0);
+
+  ret = vec_tuning_load(loaded, "/nonexistent/vec");
+  assert(ret != 0);
+
+  unlink(path);
+
+  /* Other implementations fall back on the analytic cost models,
+     whereas other bit lengths are derived from the costs. */
+  ret = vec_tuning_smul(&block_width, &batch_len, NULL,
+                        curve->name, record->costs.backend,
+                        record->bit_length, 100);
+  assert(ret == 0);
+  ret = vec_tuning_fmul(loaded, curve->name, "none",
+                        record->bit_length, 100);
+  assert(ret == 0);
+  ret = vec_tuning_smul(&block_width, &batch_len, loaded,
+                        curve->name, record->costs.backend,
+                        record->bit_length / 2, 100);
+  assert(ret != 0);
+  assert(block_width >= 1 && batch_len >= 1 && batch_len <= 100);
+
+  /* The multiplication functions consult the tuning of the curve. */
+  curve->tuning = loaded;
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  len = 1;
+
+  t = clock();
+  do
+    {
+
+      /* Generate "random" bases and scalars. */
+      basesx = vec_array_alloc_init(len);
+      basesy = vec_array_alloc_init(len);
+      scalars = vec_array_alloc_init(len);
+
+      for (j = 0; j < len; j++) {
+
+        vec_mul(basesx[j], basesy[j],
+                curve,
+                curve->gx, curve->gy,
+                scalar);
+
+        mpz_mul(scalar, scalar, scalar);
+        mpz_mod(scalar, scalar, curve->n);
+        mpz_set(scalars[j], scalar);
+      }
+
+      vec_smul(rx1, ry1,
+               curve,
+               basesx, basesy,
+               scalars,
+               len);
+
+      vec_jsmul_aff(rx2, ry2,
+                    curve,
+                    basesx, basesy,
+                    scalars,
+                    len);
+
+      assert(vec_eq(rx2, ry2, rx1, ry1));
+
+      /* Fixed basis tables tuned for len multiplications. */
+      table_ptr = vec_jfmul_precomp_aff(curve, basesx[0], basesy[0], len);
+
+      vec_mul(rx1, ry1,
+              curve,
+              basesx[0], basesy[0],
+              scalar);
+
+      vec_jfmul_aff(rx2, ry2,
+                    curve,
+                    table_ptr,
+                    scalar);
+
+      assert(vec_eq(rx1, ry1, rx2, ry2));
+
+      vec_jfmul_free_aff(curve, table_ptr);
+
+      vec_array_clear_free(scalars, len);
+      vec_array_clear_free(basesy, len);
+      vec_array_clear_free(basesx, len);
+
+      len <<= 1;
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  curve->tuning = NULL;
+
+  /* The return values and records are only read by assertions. */
+  VEC_UNUSED(ret);
+  VEC_UNUSED(other);
+
+  vec_tuning_free(loaded);
+  vec_tuning_free(tuning);
+
+  mpz_clear(scalar);
+
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+}
+
+void
+test_stats(vec_curve *curve)
+{
+  size_t len = 8;
+  size_t i;
+
+  vec_stats stats;
+
+  mpz_t rx;
+  mpz_t ry;
+
+  mpz_t *basesx;
+  mpz_t *basesy;
+  mpz_t *scalars;
+
+  mpz_t scalar;
+
+  mpz_init(rx);
+  mpz_init(ry);
+
+  mpz_init_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  basesx = vec_array_alloc_init(len);
+  basesy = vec_array_alloc_init(len);
+  scalars = vec_array_alloc_init(len);
+
+  for (i = 0; i < len; i++) {
+
+    vec_mul(basesx[i], basesy[i],
+            curve,
+            curve->gx, curve->gy,
+            scalar);
+
+    mpz_mul(scalar, scalar, scalar);
+    mpz_mod(scalar, scalar, curve->n);
+    mpz_set(scalars[i], scalar);
+  }
+
+  /* Nothing is counted after a reset. */
+  vec_stats_reset(curve);
+  vec_stats_snapshot(&stats, curve);
+  assert(stats.dbl == 0 && stats.add == 0 && stats.madd == 0);
+  assert(stats.inversions == 0 && stats.table_entries == 0);
+  assert(stats.mallocs == 0 && stats.bytes == 0);
+  assert(stats.precomp_cycles == 0 && stats.main_cycles == 0);
+
+  vec_jmul_aff(rx, ry, curve, basesx[0], basesy[0], scalars[0]);
+  vec_jsmul_aff(rx, ry, curve, basesx, basesy, scalars, len);
+
+  vec_stats_snapshot(&stats, curve);
+
+  if (vec_stats_enabled())
+    {
+
+      /* Both multiplications double and add, build tables, and
+         convert the result to affine coordinates. */
+      assert(stats.dbl > 0);
+      assert(stats.add + stats.madd > 0);
+      assert(stats.inversions >= 2);
+      assert(stats.table_entries > 0);
+      assert(stats.mallocs > 0 && stats.bytes > 0);
+      assert(stats.precomp_cycles > 0 && stats.main_cycles > 0);
+    }
+  else
+    {
+      assert(stats.dbl == 0 && stats.add == 0 && stats.madd == 0);
+      assert(stats.inversions == 0 && stats.mallocs == 0);
+      assert(stats.main_cycles == 0);
+    }
+
+  vec_stats_reset(curve);
+  vec_stats_snapshot(&stats, curve);
+  assert(stats.dbl == 0 && stats.main_cycles == 0);
+
+  vec_array_clear_free(scalars, len);
+  vec_array_clear_free(basesy, len);
+  vec_array_clear_free(basesx, len);
+
+  mpz_clear(scalar);
+  mpz_clear(ry);
+  mpz_clear(rx);
+}
+
+void
+test_workspace(vec_curve *curve)
+{
+  size_t len = 250;
+  size_t i;
+  int j;
+
+  vec_workspace *ws;
+  void *table;
+  uint16_t *masks;
+  vec_stats stats;
+  uint64_t mallocs;
+
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rx2;
+  mpz_t ry2;
+
+  mpz_t *basesx;
+  mpz_t *basesy;
+  mpz_t *scalars;
+
+  mpz_t scalar;
+
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rx2);
+  mpz_init(ry2);
+
+  mpz_init_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  basesx = vec_array_alloc_init(len);
+  basesy = vec_array_alloc_init(len);
+  scalars = vec_array_alloc_init(len);
+
+  for (i = 0; i < len; i++) {
+
+    vec_mul(basesx[i], basesy[i],
+            curve,
+            curve->gx, curve->gy,
+            scalar);
+
+    mpz_mul(scalar, scalar, scalar);
+    mpz_mod(scalar, scalar, curve->n);
+    mpz_set(scalars[i], scalar);
+  }
+
+  vec_smul(rx1, ry1, curve, basesx, basesy, scalars, len);
+
+  ws = vec_workspace_alloc();
+  vec_workspace_use(ws);
+  assert(vec_workspace_get() == ws);
+
+  /* The first call fills the workspace, and later calls of the same
+     size reuse its table and masks, including for the shorter last
+     batch. */
+  vec_jsmul_aff(rx2, ry2, curve, basesx, basesy, scalars, len);
+  assert(vec_eq(rx2, ry2, rx1, ry1));
+
+  /* Many bases may be multiplied using buckets instead, e.g., when
+     the scalars are split by an endomorphism, in which case the
+     workspace is not used. */
+  table = ws->table;
+  masks = ws->masks;
+  assert((table == NULL) == (masks == NULL));
+
+  vec_stats_snapshot(&stats, curve);
+  mallocs = stats.mallocs;
+
+  for (j = 0; j < 3; j++)
+    {
+      vec_jsmul_aff(rx2, ry2, curve, basesx, basesy, scalars, len);
+      assert(vec_eq(rx2, ry2, rx1, ry1));
+      assert(ws->table == table);
+      assert(ws->masks == masks);
+    }
+
+  /* Nothing is allocated by calls that use a warm workspace. */
+  vec_stats_snapshot(&stats, curve);
+  assert(table == NULL || stats.mallocs == mallocs);
+
+  /* Shorter calls use a view of the cached table. */
+  vec_smul(rx1, ry1, curve, basesx, basesy, scalars, 7);
+  vec_jsmul_aff(rx2, ry2, curve, basesx, basesy, scalars, 7);
+  assert(vec_eq(rx2, ry2, rx1, ry1));
+
+  /* A cleared workspace is still usable. */
+  vec_workspace_clear(ws);
+  assert(ws->table == NULL && ws->masks == NULL);
+  vec_jsmul_aff(rx2, ry2, curve, basesx, basesy, scalars, 7);
+  assert(vec_eq(rx2, ry2, rx1, ry1));
+  assert(ws->table != NULL);
+
+  /* Fall back on the default workspace of the thread. */
+  vec_workspace_use(NULL);
+  assert(vec_workspace_get() != ws);
+  vec_workspace_free(ws);
+
+  /* The cached pointers and counts are only read by assertions. */
+  VEC_UNUSED(table);
+  VEC_UNUSED(masks);
+  VEC_UNUSED(mallocs);
+
+  vec_array_clear_free(scalars, len);
+  vec_array_clear_free(basesy, len);
+  vec_array_clear_free(basesx, len);
+
+  mpz_clear(scalar);
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+}
+
+/* Computes the multiplications given by the masks of each lane, read
+   as integers, and compares them with the results of the lanes. */
+static void
+test_lanes_func(vec_curve *curve, vec_lanes_tab *lt,
+                vec_lanes_jfmul_func jfmul, size_t width,
+                uint16_t *masks, size_t bitlen)
+{
+  size_t i;
+  size_t l;
+
+  mpz_t x;
+  mpz_t y;
+  mpz_t scalar;
+  mpz_t X[VEC_LANES_MAX_WIDTH];
+  mpz_t Y[VEC_LANES_MAX_WIDTH];
+  mpz_t Z[VEC_LANES_MAX_WIDTH];
+
+  mpz_init(x);
+  mpz_init(y);
+  mpz_init(scalar);
+  for (l = 0; l < width; l++) {
+    mpz_init(X[l]);
+    mpz_init(Y[l]);
+    mpz_init(Z[l]);
+  }
+
+  /* The function of the table always exists, but the other may be
+     missing in the build. */
+  if (jfmul(X, Y, Z, lt, masks, bitlen)) {
+
+    for (l = 0; l < width; l++) {
+
+      mpz_set_ui(scalar, 0);
+      for (i = bitlen; i > 0; i--) {
+        mpz_mul_2exp(scalar, scalar, 1);
+        mpz_add_ui(scalar, scalar, masks[l * bitlen + i - 1]);
+      }
+      vec_mul(x, y, curve, curve->gx, curve->gy, scalar);
+
+      vec_jaff(X[l], Y[l], Z[l], curve);
+      assert(vec_eq(X[l], Y[l], x, y));
+    }
+  } else {
+    assert(jfmul != lt->jfmul);
+  }
+
+  for (l = 0; l < width; l++) {
+    mpz_clear(Z[l]);
+    mpz_clear(Y[l]);
+    mpz_clear(X[l]);
+  }
+  mpz_clear(scalar);
+  mpz_clear(y);
+  mpz_clear(x);
+}
+
+void
+test_lanes(vec_curve *curve)
+{
+  size_t w = 4;
+  size_t tab_len = ((size_t)1) << w;
+  size_t bitlen = 40;
+  size_t i;
+  size_t l;
+  int j;
+  int ret;
+
+  vec_lanes_tab *lt;
+  uint16_t *masks;
+
+  vec_lanes_jfmul_func funcs[2] = {vec_lanes_jfmul_avx2,
+                                   vec_lanes_jfmul_avx512};
+  size_t widths[2] = {4, 8};
+
+  mpz_t x;
+  mpz_t y;
+  mpz_t scalar;
+  mpz_t *X;
+  mpz_t *Y;
+  mpz_t *Z;
+
+  lt = vec_lanes_tab_alloc(curve, tab_len);
+
+  /* Nothing to test if the processor lacks the instructions. */
+  if (lt == NULL) {
+    return;
+  }
+
+  mpz_init(x);
+  mpz_init(y);
+  mpz_init(scalar);
+
+  /* Entry m of the table is m times the generator. */
+  for (i = 1; i < tab_len; i++) {
+    mpz_set_ui(scalar, i);
+    vec_mul(x, y, curve, curve->gx, curve->gy, scalar);
+    vec_lanes_tab_set(lt, i, x, y);
+  }
+
+  masks = (uint16_t *)malloc(VEC_LANES_MAX_WIDTH * bitlen * sizeof(uint16_t));
+
+  for (j = 0; j < 2 && widths[j] <= lt->width; j++) {
+
+    /* The first lane gives the point at infinity. The mask of the
+       most significant bit of every other lane is at least half the
+       size of the table, so no entry is ever added to an equal or
+       opposite point. */
+    for (l = 0; l < widths[j]; l++) {
+      for (i = 0; i < bitlen; i++) {
+        masks[l * bitlen + i] = l == 0 ? 0 : (7 * l + 5 * i * i) % tab_len;
+      }
+      if (l > 0) {
+        masks[l * bitlen + bitlen - 1] |= tab_len / 2;
+      }
+    }
+    test_lanes_func(curve, lt, funcs[j], widths[j], masks, bitlen);
+  }
+
+  /* Adding the second entry to twice the first is not handled by
+     the lanes. */
+  memset(masks, 0, VEC_LANES_MAX_WIDTH * bitlen * sizeof(uint16_t));
+  masks[bitlen + 1] = 1;
+  masks[bitlen] = 2;
+  X = vec_array_alloc_init(VEC_LANES_MAX_WIDTH);
+  Y = vec_array_alloc_init(VEC_LANES_MAX_WIDTH);
+  Z = vec_array_alloc_init(VEC_LANES_MAX_WIDTH);
+  ret = lt->jfmul(X, Y, Z, lt, masks, bitlen);
+  assert(!ret);
+  VEC_UNUSED(ret);
+  vec_array_clear_free(Z, VEC_LANES_MAX_WIDTH);
+  vec_array_clear_free(Y, VEC_LANES_MAX_WIDTH);
+  vec_array_clear_free(X, VEC_LANES_MAX_WIDTH);
+
+  free(masks);
+  vec_lanes_tab_free(lt);
+
+  mpz_clear(scalar);
+  mpz_clear(y);
+  mpz_clear(x);
+}
+
+void
+test_arithmetic(vec_curve *curve)
+{
+  const char *native = vec_mulx_supported() ? "mulx" : "portable";
+
+  VEC_UNUSED(native);
+
+  assert(curve->arithmetic != NULL);
+
+  /* Only P-256 has a version for MULX and ADX, which is selected
+     at load. */
+  if (curve->jtune == vec_jtune_nistp256)
+    {
+      assert(strcmp(curve->arithmetic, native) == 0);
+    }
+  else if (curve->jtune == vec_jtune_nistp224
+           || curve->jtune == vec_jtune_nistp384
+           || curve->jtune == vec_jtune_nistp521)
+    {
+      assert(strcmp(curve->arithmetic, "portable") == 0);
+    }
+  else
+    {
+      assert(strcmp(curve->arithmetic, "mpz") == 0
+             || strcmp(curve->arithmetic, "mpn") == 0);
+    }
+}
+
+void
+test_glv_split(vec_curve *curve)
+{
+  int t;
+  size_t half_bitlen;
+
+  mpz_t scalar;
+  mpz_t k1;
+  mpz_t k2;
+  mpz_t tmp;
+
+  mpz_init(scalar);
+  mpz_init(k1);
+  mpz_init(k2);
+  mpz_init(tmp);
+
+  half_bitlen = (mpz_sizeinbase(curve->n, 2) + 1) / 2 + 2;
+  VEC_UNUSED(half_bitlen);
+
+  t = clock();
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 1000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  do
+    {
+
+      vec_glv_split(k1, k2, curve, scalar);
+
+      /* The parts are short ... */
+      assert(mpz_sizeinbase(k1, 2) <= half_bitlen);
+      assert(mpz_sizeinbase(k2, 2) <= half_bitlen);
+
+      /* ... and scalar = k1 + k2 * lambda mod n. */
+      mpz_mul(tmp, k2, curve->glv->lambda);
+      mpz_add(tmp, tmp, k1);
+      mpz_sub(tmp, tmp, scalar);
+      mpz_mod(tmp, tmp, curve->n);
+      assert(mpz_sgn(tmp) == 0);
+
+      mpz_mul(scalar, scalar, scalar);
+      mpz_add_ui(scalar, scalar, 1);
+      mpz_mod(scalar, scalar, curve->n);
+
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  mpz_clear(tmp);
+  mpz_clear(k2);
+  mpz_clear(k1);
+  mpz_clear(scalar);
+}
+
+void
+test_jaff_batch(vec_curve *curve)
+{
+  int t;
+  size_t len;
+  size_t i;
+
+  mpz_t *X1;
+  mpz_t *Y1;
+  mpz_t *Z1;
+  mpz_t *X2;
+  mpz_t *Y2;
+  mpz_t *Z2;
+
+  mpz_t one;
+  mpz_t scalar;
+
+  mpz_init(one);
+  mpz_init(scalar);
+
+  mpz_set_ui(one, 1);
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  len = 1;
+
+  t = clock();
+  do
+    {
+
+      X1 = vec_array_alloc_init(len);
+      Y1 = vec_array_alloc_init(len);
+      Z1 = vec_array_alloc_init(len);
+      X2 = vec_array_alloc_init(len);
+      Y2 = vec_array_alloc_init(len);
+      Z2 = vec_array_alloc_init(len);
+
+      /* Generate "random" points with non-trivial z-coordinates and
+         put the point at infinity in some positions. */
+      for (i = 0; i < len; i++)
+        {
+          if (i % 5 == 3)
+            {
+              mpz_set_ui(X1[i], 0);
+              mpz_set_ui(Y1[i], 1);
+              mpz_set_ui(Z1[i], 0);
+            }
+          else
+            {
+              curve->jmul(X1[i], Y1[i], Z1[i],
+                          curve,
+                          curve->gx, curve->gy, one,
+                          scalar);
+            }
+
+          mpz_set(X2[i], X1[i]);
+          mpz_set(Y2[i], Y1[i]);
+          mpz_set(Z2[i], Z1[i]);
+
+          mpz_mul(scalar, scalar, scalar);
+          mpz_mod(scalar, scalar, curve->n);
+        }
+
+      vec_jaff_batch(X2, Y2, Z2, len, curve);
+
+      for (i = 0; i < len; i++)
+        {
+          vec_jaff(X1[i], Y1[i], Z1[i], curve);
+          assert(vec_eq(X1[i], Y1[i], X2[i], Y2[i]));
+        }
+
+      vec_array_clear_free(Z2, len);
+      vec_array_clear_free(Y2, len);
+      vec_array_clear_free(X2, len);
+      vec_array_clear_free(Z1, len);
+      vec_array_clear_free(Y1, len);
+      vec_array_clear_free(X1, len);
+
+      len <<= 1;
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  mpz_clear(scalar);
+  mpz_clear(one);
+}
+
+void
+test_jmul_aff_output(vec_curve *curve)
+{
+  int t;
+  int i;
+
+  mpz_t X;
+  mpz_t Y;
+  mpz_t Z;
+  mpz_t rx;
+  mpz_t ry;
+  mpz_t one;
+  mpz_t scalar;
+  vec_jfmul_tab_ptr table_ptr;
+
+  mpz_init(X);
+  mpz_init(Y);
+  mpz_init(Z);
+  mpz_init(rx);
+  mpz_init(ry);
+  mpz_init(one);
+  mpz_init(scalar);
+
+  mpz_set_ui(one, 1);
+
+  table_ptr = curve->jfmul_precomp(curve, curve->gx, curve->gy, one, 10);
+
+  /* The first two scalars give the point at infinity. */
+  i = 0;
+  t = clock();
+  do
+    {
+      if (i == 0)
+        {
+          mpz_set_ui(scalar, 0);
+        }
+      else if (i == 1)
+        {
+          mpz_set(scalar, curve->n);
+        }
+      else
+        {
+          mpz_set_ui(scalar, i);
+          mpz_mul_2exp(scalar, scalar, 100 * i);
+          mpz_mod(scalar, scalar, curve->n);
+        }
+
+      curve->jmul(X, Y, Z, curve, curve->gx, curve->gy, one, scalar);
+      vec_jaff(X, Y, Z, curve);
+
+      curve->jmul_aff(rx, ry, curve, curve->gx, curve->gy, one, scalar);
+      assert(mpz_cmp(X, rx) == 0 && mpz_cmp(Y, ry) == 0);
+
+      curve->jsmul_aff(rx, ry, curve, &curve->gx, &curve->gy, &one,
+                       &scalar, 1);
+      assert(mpz_cmp(X, rx) == 0 && mpz_cmp(Y, ry) == 0);
+
+      curve->jfmul_aff(rx, ry, curve, table_ptr, scalar);
+      assert(mpz_cmp(X, rx) == 0 && mpz_cmp(Y, ry) == 0);
+
+      i++;
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  curve->jfmul_free(table_ptr);
+
+  mpz_clear(scalar);
+  mpz_clear(one);
+  mpz_clear(ry);
+  mpz_clear(rx);
+  mpz_clear(Z);
+  mpz_clear(Y);
+  mpz_clear(X);
+}
+
+void
+test_point_array(vec_curve *curve)
+{
+  int t;
+  int ret;
+  size_t len;
+  size_t half;
+  size_t i;
+  size_t n;
+
+  mpz_t rx1;
+  mpz_t ry1;
+  mpz_t rx2;
+  mpz_t ry2;
+  mpz_t rz2;
+
+  mpz_t *basesx;
+  mpz_t *basesy;
+  mpz_t *basesz;
+  mpz_t *scalars;
+  mpz_t *X;
+  mpz_t *Y;
+  mpz_t *Z;
+
+  unsigned char *bytes;
+
+  mpz_t scalar;
+
+  vec_point_array *array;
+  vec_point_array *rop;
+
+  vec_scratch_mpz_t scratch;
+
+  mpz_init(rx1);
+  mpz_init(ry1);
+  mpz_init(rx2);
+  mpz_init(ry2);
+  mpz_init(rz2);
+
+  mpz_init(scalar);
+
+  vec_scratch_init_mpz_t(scratch);
+
+  n = (mpz_sizeinbase(curve->modulus, 2) + 7) / 8;
+
+  /* Test that all zeros is imported as the unit element. */
+  bytes = (unsigned char *)calloc(2 * n, 1);
+  array = vec_point_array_alloc(curve, 1);
+  ret = vec_point_array_import_bytes(array, 0, bytes, 1);
+  assert(ret == 0);
+
+  /* Test that points beyond the end of the array are rejected. */
+  ret = vec_point_array_import_bytes(array, 1, bytes, 1);
+  assert(ret != 0);
+  ret = vec_point_array_import_bytes(array, 0, bytes, 2);
+  assert(ret != 0);
+
+  mpz_set_ui(scalar, 7);
+  vec_jmul_array(array, array, &scalar);
+  vec_point_array_export(&rx2, &ry2, &rz2, array);
+  assert(mpz_sgn(rz2) == 0);
+
+  /* Test that points that are not on the curve and unreduced
+     coordinates are rejected. The latter is tested with the
+     x-coordinate of the generator plus the modulus if it fits in the
+     encoding. */
+  mpz_export(bytes + n - (mpz_sizeinbase(curve->gx, 2) + 7) / 8,
+             NULL, 1, 1, 1, 0, curve->gx);
+  mpz_export(bytes + 2 * n - (mpz_sizeinbase(curve->gy, 2) + 7) / 8,
+             NULL, 1, 1, 1, 0, curve->gy);
+  ret = vec_point_array_import_bytes(array, 0, bytes, 1);
+  assert(ret == 0);
+
+  bytes[2 * n - 1] ^= 1;
+  ret = vec_point_array_import_bytes(array, 0, bytes, 1);
+  assert(ret != 0);
+  bytes[2 * n - 1] ^= 1;
+
+  mpz_add(rx1, curve->gx, curve->modulus);
+  if (mpz_sizeinbase(rx1, 256) <= n)
+    {
+      mpz_export(bytes + n - (mpz_sizeinbase(rx1, 2) + 7) / 8,
+                 NULL, 1, 1, 1, 0, rx1);
+      ret = vec_point_array_import_bytes(array, 0, bytes, 1);
+      assert(ret != 0);
+    }
+
+  vec_point_array_free(array);
+  free(bytes);
+
+  mpz_set_ui(scalar, 1);
+  mpz_mul_2exp(scalar, scalar, 100000);
+  mpz_mod(scalar, scalar, curve->n);
+
+  len = 1;
+
+  t = clock();
+  do
+    {
+
+      /* Generate "random" bases and scalars. */
+      basesx = vec_array_alloc_init(len);
+      basesy = vec_array_alloc_init(len);
+      basesz = vec_array_alloc_init(len);
+      scalars = vec_array_alloc_init(len);
+
+      X = vec_array_alloc_init(len);
+      Y = vec_array_alloc_init(len);
+      Z = vec_array_alloc_init(len);
+
+      bytes = (unsigned char *)calloc(2 * n * len, 1);
+
+      for (i = 0; i < len; i++) {
+
+        vec_mul(basesx[i], basesy[i],
+                curve,
+                curve->gx, curve->gy,
+                scalar);
+        mpz_set_ui(basesz[i], 1);
+
+        mpz_export(bytes + (2 * i + 1) * n
+                   - (mpz_sizeinbase(basesx[i], 2) + 7) / 8,
+                   NULL, 1, 1, 1, 0, basesx[i]);
+        mpz_export(bytes + (2 * i + 2) * n
+                   - (mpz_sizeinbase(basesy[i], 2) + 7) / 8,
+                   NULL, 1, 1, 1, 0, basesy[i]);
+
+        mpz_mul(scalar, scalar, scalar);
+        mpz_mod(scalar, scalar, curve->n);
+        mpz_set(scalars[i], scalar);
+      }
+
+      /* Import the first half from bytes and the rest from mpz_t. */
+      half = len / 2;
+
+      array = vec_point_array_alloc(curve, len);
+      rop = vec_point_array_alloc(curve, len);
+
+      ret = vec_point_array_import_bytes(array, 0, bytes, half);
+      assert(ret == 0);
+      vec_point_array_import(array, half,
+                             basesx + half, basesy + half, basesz + half,
+                             len - half);
+
+      /* Simultaneous multiplication. */
+      vec_smul(rx1, ry1,
+               curve,
+               basesx, basesy,
+               scalars,
+               len);
+
+      vec_jsmul_array(rx2, ry2, rz2, array, scalars);
+      vec_jaff(rx2, ry2, rz2, curve);
+
+      assert(vec_eq(rx2, ry2, rx1, ry1));
+
+      /* Pointwise multiplication and addition. */
+      vec_jmul_array(rop, array, scalars);
+      vec_jadd_array(rop, rop, array);
+      vec_point_array_export(X, Y, Z, rop);
+
+      for (i = 0; i < len; i++)
+        {
+          vec_mul(rx1, ry1,
+                  curve,
+                  basesx[i], basesy[i],
+                  scalars[i]);
+          vec_add(scratch,
+                  rx1, ry1,
+                  curve,
+                  rx1, ry1,
+                  basesx[i], basesy[i]);
+
+          vec_jaff(X[i], Y[i], Z[i], curve);
+
+          assert(vec_eq(X[i], Y[i], rx1, ry1));
+        }
+
+      vec_point_array_free(rop);
+      vec_point_array_free(array);
+
+      free(bytes);
+
+      vec_array_clear_free(Z, len);
+      vec_array_clear_free(Y, len);
+      vec_array_clear_free(X, len);
+
+      vec_array_clear_free(scalars, len);
+      vec_array_clear_free(basesz, len);
+      vec_array_clear_free(basesy, len);
+      vec_array_clear_free(basesx, len);
+
+      len <<= 1;
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  /* The return values are only read by assertions. */
+  VEC_UNUSED(ret);
+
+  vec_scratch_clear_mpz_t(scratch);
+
+  mpz_clear(scalar);
+
+  mpz_clear(rz2);
+  mpz_clear(ry2);
+  mpz_clear(rx2);
+  mpz_clear(ry1);
+  mpz_clear(rx1);
+}
+
+void
+test_sqrt(mpz_t p) {
+
+  int t;
+  int ret;
+
+  mpz_t a;
+  mpz_t z;
+  mpz_t res;
+
+  mpz_init(a);
+  mpz_init(z);
+  mpz_init(res);
+
+  t = clock();
+
+  mpz_set_si(a, 1);
+  mpz_mul_2exp(a, a, 1000);
+  mpz_mod(a, a, p);
+
+  mpz_set_si(z, 2);
+  while (mpz_legendre(z, p) == 1)
+    {
+      mpz_add_ui(z, z, 1);
+    }
+
+  mpz_mul(a, a, a);
+  mpz_mod(a, a, p);
+
+  do
     {
 
-      vec_sqrt(res, a, p);
+      ret = vec_sqrt(res, a, p);
+      assert(ret == 0);
 
       mpz_mul(res, res, res);
       mpz_mod(res, res, p);
 
       assert(mpz_cmp(res, a) == 0);
 
+      /* A non-residue times a square is a non-residue. */
+      mpz_mul(res, a, z);
+      mpz_mod(res, res, p);
+      ret = vec_sqrt(res, res, p);
+      assert(mpz_cmp_si(a, 0) == 0 || ret == -1);
+
       /* Randomize a new square */
       mpz_powm(a, a, a, p);
       mpz_mul(a, a, a);
@@ -899,11 +3097,156 @@ test_sqrt(mpz_t p) {
     }
   while (!vec_done(t, DEFAULT_TEST_TIME));
 
+  /* The return values are only read by assertions. */
+  VEC_UNUSED(ret);
+
   mpz_clear(res);
   mpz_clear(z);
   mpz_clear(a);
 }
 
+void
+test_sqrt_batch(vec_curve *curve)
+{
+  int t;
+  int ret;
+  size_t i;
+  size_t len;
+
+  mpz_t e;
+  mpz_t nonres;
+  mpz_t *ops;
+  mpz_t *rops;
+  mpz_t *squares;
+
+  mpz_init(e);
+  mpz_init(nonres);
+
+  /* Least quadratic non-residue. */
+  mpz_set_ui(nonres, 2);
+  while (mpz_legendre(nonres, curve->modulus) != -1)
+    {
+      mpz_add_ui(nonres, nonres, 1);
+    }
+
+  t = clock();
+
+  len = 1;
+  do
+    {
+      ops = vec_array_alloc_init(len);
+      rops = vec_array_alloc_init(len);
+      squares = vec_array_alloc_init(len);
+
+      /* Generate "random" elements, the first of which is zero. */
+      mpz_set_ui(e, 1);
+      mpz_mul_2exp(e, e, 1000 + len);
+      mpz_mod(e, e, curve->modulus);
+      for (i = 1; i < len; i++)
+        {
+          mpz_mul(e, e, e);
+          mpz_add_ui(e, e, i);
+          mpz_mod(e, e, curve->modulus);
+          mpz_set(ops[i], e);
+        }
+
+      /* Exponentiation agrees with GMP for the exponent zero, one,
+         and the exponents used for square roots. */
+      mpz_set_ui(e, 0);
+      curve->fpowm(rops, ops, e, len, curve);
+      for (i = 0; i < len; i++)
+        {
+          assert(mpz_cmp_ui(rops[i], 1) == 0);
+        }
+
+      mpz_set_ui(e, 1);
+      curve->fpowm(rops, ops, e, len, curve);
+      for (i = 0; i < len; i++)
+        {
+          assert(mpz_cmp(rops[i], ops[i]) == 0);
+        }
+
+      curve->fpowm(rops, ops, curve->sqrt_ctx->e, len, curve);
+      for (i = 0; i < len; i++)
+        {
+          mpz_powm(e, ops[i], curve->sqrt_ctx->e, curve->modulus);
+          assert(mpz_cmp(rops[i], e) == 0);
+        }
+
+      /* Square roots of squares, which need not be reduced. */
+      for (i = 0; i < len; i++)
+        {
+          mpz_mul(squares[i], ops[i], ops[i]);
+          mpz_mod(squares[i], squares[i], curve->modulus);
+          mpz_set(ops[i], squares[i]);
+          if (i % 2 == 1)
+            {
+              mpz_add(ops[i], ops[i], curve->modulus);
+            }
+        }
+
+      ret = vec_sqrt_batch(rops, ops, len, curve);
+      assert(ret == 0);
+
+      for (i = 0; i < len; i++)
+        {
+          mpz_mul(rops[i], rops[i], rops[i]);
+          mpz_mod(rops[i], rops[i], curve->modulus);
+          assert(mpz_cmp(rops[i], squares[i]) == 0);
+        }
+
+      /* A single square root uses the same constants. */
+      ret = vec_sqrt_curve(e, ops[len - 1], curve);
+      assert(ret == 0);
+      mpz_mul(e, e, e);
+      mpz_mod(e, e, curve->modulus);
+      assert(mpz_cmp(e, squares[len - 1]) == 0);
+
+      /* The outputs may be the inputs. */
+      ret = vec_sqrt_batch(ops, ops, len, curve);
+      assert(ret == 0);
+
+      for (i = 0; i < len; i++)
+        {
+          mpz_mul(ops[i], ops[i], ops[i]);
+          mpz_mod(ops[i], ops[i], curve->modulus);
+          assert(mpz_cmp(ops[i], squares[i]) == 0);
+        }
+
+      /* A non-residue in the last position fails the batch, but
+         the square roots of the other inputs are computed. */
+      mpz_set(ops[len - 1], nonres);
+      for (i = 0; i + 1 < len; i++)
+        {
+          mpz_set(ops[i], squares[i]);
+        }
+      ret = vec_sqrt_batch(rops, ops, len, curve);
+      assert(ret == -1);
+      ret = vec_sqrt_curve(e, nonres, curve);
+      assert(ret == -1);
+
+      for (i = 0; i + 1 < len; i++)
+        {
+          mpz_mul(rops[i], rops[i], rops[i]);
+          mpz_mod(rops[i], rops[i], curve->modulus);
+          assert(mpz_cmp(rops[i], squares[i]) == 0);
+        }
+
+      vec_array_clear_free(squares, len);
+      vec_array_clear_free(rops, len);
+      vec_array_clear_free(ops, len);
+
+      len <<= 1;
+    }
+  while (!vec_done(t, DEFAULT_TEST_TIME));
+
+  /* The return values are only read by assertions. */
+  VEC_UNUSED(ret);
+
+  mpz_clear(nonres);
+  mpz_clear(e);
+}
+
 
 /* These are timing routines and not tested beyond using them. */
 /* LCOV_EXCL_START */
@@ -1429,6 +3772,9 @@ test_curve(char *name)
   print_test("Sqrt (solving quadratic equations)");
   test_sqrt(curve->modulus);
 
+  print_test("Batched sqrt with cached constants");
+  test_sqrt_batch(curve);
+
   print_test("Affine doubling and adding");
   test_dbl_add(curve);
 
@@ -1444,33 +3790,73 @@ test_curve(char *name)
   print_test("Jacobi adding");
   test_jadd(curve);
 
-  print_test("Jacobi sliding-window multiplication");
+  print_test("Jacobi wNAF multiplication");
   test_jmul(curve);
 
+  print_test("Jacobi sliding-window multiplication");
+  test_jmulsw(curve);
+
+  print_test("Jacobi double-scalar multiplication");
+  test_jdmul(curve);
+
   print_test("Jacobi simultaneous multiplication");
   test_jsmul(curve);
 
+  print_test("Jacobi bucket multiplication");
+  test_jsmul_bucket(curve);
+
+  print_test("Jacobi parallel simultaneous multiplication");
+  test_jsmul_par(curve);
+
   print_test("Jacobi fixed-basis multiplication");
   test_jfmul(curve);
 
+  print_test("Jacobi batched fixed-basis multiplication");
+  test_jfmul_batch(curve);
+
+  print_test("Jacobi parallel fixed-basis precomputation");
+  test_jfmul_precomp_par(curve);
+
+  print_test("Jacobi fixed-basis table file");
+  test_jfmul_file(curve);
+
+  print_test("Jacobi fixed-basis comb multiplication");
+  test_jfcomb(curve);
+
+  print_test("Jacobi fixed-bases simultaneous multiplication");
+  test_jfsmul(curve);
+
+  print_test("Scalar bit-matrix transpose");
+  test_scalars_transpose(curve);
+
   vec_curve_free(curve);
 
   curve = vec_curve_get_named(name, 1);
 
   if ((curve->jdbl != vec_jdbl_generic
-       && curve->jdbl != vec_jdbl_a_eq_neg3_generic)
+       && curve->jdbl != vec_jdbl_a_eq_neg3_generic
+       && curve->jdbl != vec_jdbl_a_eq_0_generic)
       || (curve->jadd != vec_jadd_generic
-          && curve->jadd != vec_jadd_a_eq_neg3_generic)
-      || (curve->jmul != vec_jmulsw_generic
-          && curve->jmul != vec_jmulsw_a_eq_neg3_generic)
+          && curve->jadd != vec_jadd_a_eq_neg3_generic
+          && curve->jadd != vec_jadd_a_eq_0_generic)
+      || (curve->jmul != vec_jmulwnaf_generic
+          && curve->jmul != vec_jmulwnaf_a_eq_neg3_generic
+          && curve->jmul != vec_jmulwnaf_a_eq_0_generic)
       || (curve->jsmul != vec_jsmul_generic
-          && curve->jsmul != vec_jsmul_a_eq_neg3_generic))
+          && curve->jsmul != vec_jsmul_a_eq_neg3_generic
+          && curve->jsmul != vec_jsmul_a_eq_0_generic))
     {
       printf("\nTesting optimized code for this curve.\n\n");
     }
 
+  if (curve->fpowm != vec_fpowm_generic)
+    {
+      print_test("Batched sqrt with cached constants");
+      test_sqrt_batch(curve);
+    }
   if (curve->jdbl != vec_jdbl_generic
-      && curve->jdbl != vec_jdbl_a_eq_neg3_generic)
+      && curve->jdbl != vec_jdbl_a_eq_neg3_generic
+      && curve->jdbl != vec_jdbl_a_eq_0_generic)
     {
       print_test("Jacobi doubling");
       test_jdbl(curve);
@@ -1480,23 +3866,89 @@ test_curve(char *name)
       print_test("Jacobi adding");
       test_jadd(curve);
     }
-  if (curve->jmul != vec_jmulsw_generic
-      && curve->jmul != vec_jmulsw_a_eq_neg3_generic)
+  if (curve->jmul != vec_jmulwnaf_generic
+      && curve->jmul != vec_jmulwnaf_a_eq_neg3_generic
+      && curve->jmul != vec_jmulwnaf_a_eq_0_generic)
     {
-      print_test("Jacobi sliding-window multiplication");
+      print_test("Jacobi multiplication");
       test_jmul(curve);
+
+      print_test("Jacobi double-scalar multiplication");
+      test_jdmul(curve);
     }
   if (curve->jsmul != vec_jsmul_generic)
     {
       print_test("Jacobi simultaneous multiplication");
       test_jsmul(curve);
+
+      print_test("Jacobi parallel simultaneous multiplication");
+      test_jsmul_par(curve);
+    }
+  if (curve->jsmul_bucket != vec_jsmul_bucket_generic
+      && curve->jsmul_bucket != vec_jsmul_bucket_a_eq_neg3_generic
+      && curve->jsmul_bucket != vec_jsmul_bucket_a_eq_0_generic)
+    {
+      print_test("Jacobi bucket multiplication");
+      test_jsmul_bucket(curve);
     }
   if (curve->jfmul != vec_jfmul_generic)
     {
       print_test("Jacobi fixed-basis multiplication");
       test_jfmul(curve);
+
+      print_test("Jacobi batched fixed-basis multiplication");
+      test_jfmul_batch(curve);
+
+      print_test("Jacobi parallel fixed-basis precomputation");
+      test_jfmul_precomp_par(curve);
+
+      print_test("Jacobi fixed-basis table file");
+      test_jfmul_file(curve);
+    }
+  if (curve->jfcomb != vec_jfcomb_generic
+      && curve->jfcomb != vec_jfcomb_a_eq_neg3_generic
+      && curve->jfcomb != vec_jfcomb_a_eq_0_generic)
+    {
+      print_test("Jacobi fixed-basis comb multiplication");
+      test_jfcomb(curve);
+    }
+  if (curve->jfsmul != vec_jfsmul_generic
+      && curve->jfsmul != vec_jfsmul_a_eq_neg3_generic
+      && curve->jfsmul != vec_jfsmul_a_eq_0_generic)
+    {
+      print_test("Jacobi fixed-bases simultaneous multiplication");
+      test_jfsmul(curve);
+    }
+  if (curve->glv != NULL)
+    {
+      print_test("GLV scalar decomposition");
+      test_glv_split(curve);
     }
 
+  print_test("Batch affine conversion");
+  test_jaff_batch(curve);
+
+  print_test("Affine output of multiplications");
+  test_jmul_aff_output(curve);
+
+  print_test("Arrays of points in native representation");
+  test_point_array(curve);
+
+  print_test("Tuning of multiplication");
+  test_tuning(curve);
+
+  print_test("Operation counters");
+  test_stats(curve);
+
+  print_test("Reusable workspaces");
+  test_workspace(curve);
+
+  print_test("Multi-lane fixed-basis multiplication");
+  test_lanes(curve);
+
+  print_test("Selected field arithmetic");
+  test_arithmetic(curve);
+
   vec_curve_free(curve);
 }
 
@@ -1524,8 +3976,8 @@ time_curve(char *name, long millisecs)
   /* Jacobi. */
   print_doublings("Jacobi", time_jdbl(curve, millisecs));
   print_additions("Jacobi", time_jadd(curve, millisecs));
-  print_multiplications("Jacobi sliding window", time_jmul(curve, millisecs));
-  print_multiplications("Affined Jacobi sliding window",
+  print_multiplications("Jacobi wNAF", time_jmul(curve, millisecs));
+  print_multiplications("Affined Jacobi wNAF",
                         time_mul(curve, curve->jmul, millisecs));
   print_multiplications("Affined Jacobi fixed-basis",
                         time_jfmul(curve, millisecs));
@@ -1536,7 +3988,7 @@ time_curve(char *name, long millisecs)
 
   if (curve->jdbl != vec_jdbl_generic
       || curve->jadd != vec_jadd_generic
-      || curve->jmul != vec_jmulsw_generic
+      || curve->jmul != vec_jmulwnaf_generic
       || curve->jsmul != vec_jsmul_generic)
     {
 
@@ -1562,11 +4014,11 @@ time_curve(char *name, long millisecs)
         {
           print_additions("Jacobi", time_jadd(curve, millisecs));
         }
-      if (curve->jmul != vec_jmulsw_generic)
+      if (curve->jmul != vec_jmulwnaf_generic)
         {
-          print_multiplications("Jacobi sliding window",
+          print_multiplications("Jacobi",
                                 time_jmul(curve, millisecs));
-          print_multiplications("Affined Jacobi sliding window",
+          print_multiplications("Affined Jacobi",
                                 time_mul(curve, curve->jmul, millisecs));
         }
       if (curve->jdbl != vec_jdbl_generic
@@ -1582,9 +4034,594 @@ time_curve(char *name, long millisecs)
   vec_curve_free(curve);
 }
 
+/*
+ * Machine-readable benchmarks. Each case is repeated a number of
+ * times, and each repetition calls the benchmarked function until at
+ * least BENCH_MIN_TIME milliseconds have passed. The times are wall
+ * clock times per element, i.e., per base of a simultaneous
+ * multiplication, per multiplication of a batch, or per point of a
+ * conversion, so that sweeps over lengths are directly comparable.
+ */
+
+#define BENCH_MIN_TIME 20
+
+#define BENCH_JSON 0
+#define BENCH_CSV 1
+
+/* Options and state of the output of benchmarks. */
+typedef struct
+{
+  int format;              /* BENCH_JSON or BENCH_CSV. */
+  int reps;                /* Number of repetitions of each case. */
+  size_t max_len;          /* Maximal length of sweeps. */
+  int records;             /* Number of records written so far. */
+} bench_ctx;
+
+/* Inputs and outputs of a benchmarked function. */
+typedef struct
+{
+  vec_curve *curve;
+  size_t len;              /* Number of elements used. */
+  size_t width;            /* Width of table or zero. */
+  mpz_t *X;
+  mpz_t *Y;
+  mpz_t *Z;
+  mpz_t *scalars;
+  mpz_t *RX;
+  mpz_t *RY;
+  mpz_t *RZ;
+  mpz_t modulus;
+  vec_scratch_mpz_t scratch;
+  vec_jfmul_tab_ptr table;
+  vec_jfsmul_tab_ptr fstable;
+  vec_point_array *array;
+} bench_arg;
+
+/* Benchmarked function. Returns the number of elements processed. */
+typedef size_t (*bench_func)(bench_arg *arg);
+
+static double
+bench_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static long
+bench_peak_rss_kb(void)
+{
+  struct rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+static int
+bench_cmp(const void *a, const void *b)
+{
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+
+  return (x > y) - (x < y);
+}
+
+/* Returns the given percentile of the sorted samples using the
+   nearest rank. */
+static double
+bench_percentile(double *samples, int len, int percentile)
+{
+  int i = (percentile * len + 99) / 100 - 1;
+
+  return samples[i < 0 ? 0 : i];
+}
+
+static void
+bench_record(bench_ctx *ctx,
+             vec_curve *curve, const char *backend,
+             const char *op, bench_arg *arg,
+             double *samples)
+{
+  double p50;
+
+  qsort(samples, ctx->reps, sizeof(double), bench_cmp);
+  p50 = bench_percentile(samples, ctx->reps, 50);
+
+  if (ctx->format == BENCH_JSON)
+    {
+      printf("%s\n  {\"curve\": \"%s\", \"backend\": \"%s\", "
+             "\"arithmetic\": \"%s\", \"op\": \"%s\", "
+             "\"len\": %lu, \"width\": %lu, "
+             "\"reps\": %d, \"ns_min\": %.1f, \"ns_p50\": %.1f, "
+             "\"ns_p90\": %.1f, \"ns_max\": %.1f, \"ops_per_sec\": %.1f, "
+             "\"peak_rss_kb\": %ld}",
+             ctx->records == 0 ? "[" : ",",
+             curve->name, backend, curve->arithmetic, op,
+             (unsigned long)arg->len, (unsigned long)arg->width,
+             ctx->reps,
+             samples[0], p50,
+             bench_percentile(samples, ctx->reps, 90),
+             samples[ctx->reps - 1],
+             1e9 / p50,
+             bench_peak_rss_kb());
+    }
+  else
+    {
+      if (ctx->records == 0)
+        {
+          printf("curve,backend,arithmetic,op,len,width,reps,ns_min,"
+                 "ns_p50,ns_p90,ns_max,ops_per_sec,peak_rss_kb\n");
+        }
+      printf("%s,%s,%s,%s,%lu,%lu,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%ld\n",
+             curve->name, backend, curve->arithmetic, op,
+             (unsigned long)arg->len, (unsigned long)arg->width,
+             ctx->reps,
+             samples[0], p50,
+             bench_percentile(samples, ctx->reps, 90),
+             samples[ctx->reps - 1],
+             1e9 / p50,
+             bench_peak_rss_kb());
+    }
+  fflush(stdout);
+
+  ctx->records++;
+}
+
+/* Runs a case and writes a record of the nanoseconds per element. */
+static void
+bench_case(bench_ctx *ctx,
+           vec_curve *curve, const char *backend,
+           const char *op, bench_func func, bench_arg *arg)
+{
+  int r;
+  long i;
+  long calls;
+  size_t elements;
+  double start;
+  double *samples = (double *)malloc(ctx->reps * sizeof(double));
+
+  /* Warm up and find the number of calls of each repetition. */
+  calls = 0;
+  start = bench_ns();
+  do
+    {
+      func(arg);
+      calls++;
+    }
+  while (bench_ns() - start < BENCH_MIN_TIME * 1e6);
+
+  for (r = 0; r < ctx->reps; r++)
+    {
+      elements = 0;
+      start = bench_ns();
+      for (i = 0; i < calls; i++)
+        {
+          elements += func(arg);
+        }
+      samples[r] = (bench_ns() - start) / elements;
+    }
+
+  bench_record(ctx, curve, backend, op, arg, samples);
+
+  free(samples);
+}
+
+static size_t
+bench_jdbl(bench_arg *arg)
+{
+  arg->curve->jdbl(arg->scratch,
+                   arg->RX[0], arg->RY[0], arg->RZ[0],
+                   arg->curve,
+                   arg->RX[0], arg->RY[0], arg->RZ[0]);
+  return 1;
+}
+
+static size_t
+bench_jadd(bench_arg *arg)
+{
+  arg->curve->jadd(arg->scratch,
+                   arg->RX[0], arg->RY[0], arg->RZ[0],
+                   arg->curve,
+                   arg->RX[0], arg->RY[0], arg->RZ[0],
+                   arg->X[0], arg->Y[0], arg->Z[0]);
+  return 1;
+}
+
+static size_t
+bench_jmul(bench_arg *arg)
+{
+  arg->curve->jmul(arg->RX[0], arg->RY[0], arg->RZ[0],
+                   arg->curve,
+                   arg->X[0], arg->Y[0], arg->Z[0],
+                   arg->scalars[0]);
+  return 1;
+}
+
+static size_t
+bench_jmul_aff(bench_arg *arg)
+{
+  arg->curve->jmul_aff(arg->RX[0], arg->RY[0],
+                       arg->curve,
+                       arg->X[0], arg->Y[0], arg->Z[0],
+                       arg->scalars[0]);
+  return 1;
+}
+
+static size_t
+bench_jsmul(bench_arg *arg)
+{
+  arg->curve->jsmul(arg->RX[0], arg->RY[0], arg->RZ[0],
+                    arg->curve,
+                    arg->X, arg->Y, arg->Z,
+                    arg->scalars,
+                    arg->len);
+  return arg->len;
+}
+
+static size_t
+bench_jfmul_precomp(bench_arg *arg)
+{
+  vec_jfmul_tab_ptr table;
+
+  table = arg->curve->jfmul_precomp(arg->curve,
+                                    arg->X[0], arg->Y[0], arg->Z[0],
+                                    arg->len);
+  arg->curve->jfmul_free(table);
+  return 1;
+}
+
+static size_t
+bench_jfmul_precomp_par(bench_arg *arg)
+{
+  vec_jfmul_tab_ptr table;
+
+  table = arg->curve->jfmul_precomp_par(arg->curve,
+                                        arg->X[0], arg->Y[0], arg->Z[0],
+                                        arg->len,
+                                        0);
+  arg->curve->jfmul_free(table);
+  return 1;
+}
+
+static size_t
+bench_jfmul(bench_arg *arg)
+{
+  arg->curve->jfmul(arg->RX[0], arg->RY[0], arg->RZ[0],
+                    arg->curve,
+                    arg->table,
+                    arg->scalars[0]);
+  return 1;
+}
+
+static size_t
+bench_jfmul_batch(bench_arg *arg)
+{
+  arg->curve->jfmul_batch(arg->RX, arg->RY, arg->RZ,
+                          arg->curve,
+                          arg->table,
+                          arg->scalars,
+                          arg->len);
+  return arg->len;
+}
+
+static size_t
+bench_jfsmul(bench_arg *arg)
+{
+  arg->curve->jfsmul(arg->RX[0], arg->RY[0], arg->RZ[0],
+                     arg->curve,
+                     arg->fstable,
+                     arg->scalars);
+  return arg->len;
+}
+
+static size_t
+bench_jaff(bench_arg *arg)
+{
+  size_t i;
+
+  for (i = 0; i < arg->len; i++)
+    {
+      mpz_set(arg->RX[i], arg->X[i]);
+      mpz_set(arg->RY[i], arg->Y[i]);
+      mpz_set(arg->RZ[i], arg->Z[i]);
+      vec_jaff(arg->RX[i], arg->RY[i], arg->RZ[i], arg->curve);
+    }
+  return arg->len;
+}
+
+static size_t
+bench_jaff_batch(bench_arg *arg)
+{
+  size_t i;
+
+  for (i = 0; i < arg->len; i++)
+    {
+      mpz_set(arg->RX[i], arg->X[i]);
+      mpz_set(arg->RY[i], arg->Y[i]);
+      mpz_set(arg->RZ[i], arg->Z[i]);
+    }
+  arg->curve->jaff_batch(arg->RX, arg->RY, arg->RZ, arg->len, arg->curve);
+  return arg->len;
+}
+
+static size_t
+bench_import(bench_arg *arg)
+{
+  vec_point_array_import(arg->array, 0, arg->X, arg->Y, arg->Z, arg->len);
+  return arg->len;
+}
+
+static size_t
+bench_export(bench_arg *arg)
+{
+  vec_point_array_export(arg->RX, arg->RY, arg->RZ, arg->array);
+  return arg->len;
+}
+
+static size_t
+bench_sqrt(bench_arg *arg)
+{
+  size_t i;
+
+  for (i = 0; i < arg->len; i++)
+    {
+      vec_sqrt_curve(arg->RY[i], arg->RX[i], arg->curve);
+    }
+  return arg->len;
+}
+
+static size_t
+bench_sqrt_batch(bench_arg *arg)
+{
+  vec_sqrt_batch(arg->RY, arg->RX, arg->len, arg->curve);
+  return arg->len;
+}
+
+/* Returns the name of the implementation of the curve. */
+static const char *
+bench_backend(vec_curve *curve)
+{
+  if (curve->jtune == vec_jtune_a_eq_neg3_generic)
+    return "a_eq_neg3_generic";
+  if (curve->jtune == vec_jtune_a_eq_0_generic)
+    return "a_eq_0_generic";
+  if (curve->jtune == vec_jtune_nistp224)
+    return "nistp224";
+  if (curve->jtune == vec_jtune_nistp256)
+    return "nistp256";
+  if (curve->jtune == vec_jtune_nistp384)
+    return "nistp384";
+  if (curve->jtune == vec_jtune_nistp521)
+    return "nistp521";
+  if (curve->jtune == vec_jtune_mont)
+    return curve->glv != NULL ? "mont_glv" : "mont";
+  return "generic";
+}
+
+/* Runs all benchmarks of an implementation of a curve. */
+static void
+bench_curve(bench_ctx *ctx, vec_curve *curve)
+{
+  size_t i;
+  size_t len;
+  size_t max_len;
+  size_t batch;
+  size_t table_len;
+  int width;
+  int prev_width;
+  int bit_length;
+  const char *backend = bench_backend(curve);
+  gmp_randstate_t rstate;
+  bench_arg arg;
+
+  /* The sweeps over batch sizes need at least this many elements. */
+  max_len = ctx->max_len < 1000 ? 1000 : ctx->max_len;
+
+  arg.curve = curve;
+  arg.width = 0;
+  arg.X = vec_array_alloc_init(max_len);
+  arg.Y = vec_array_alloc_init(max_len);
+  arg.Z = vec_array_alloc_init(max_len);
+  arg.scalars = vec_array_alloc_init(max_len);
+  arg.RX = vec_array_alloc_init(max_len);
+  arg.RY = vec_array_alloc_init(max_len);
+  arg.RZ = vec_array_alloc_init(max_len);
+  mpz_init_set(arg.modulus, curve->modulus);
+  vec_scratch_init_mpz_t(arg.scratch);
+
+  gmp_randinit_default(rstate);
+  gmp_randseed_ui(rstate, 1);
+
+  /* Distinct bases G, 2G, 3G, ... in Jacobi coordinates with
+     non-trivial z-coordinates, and random scalars. */
+  mpz_set(arg.X[0], curve->gx);
+  mpz_set(arg.Y[0], curve->gy);
+  vec_affj(arg.X[0], arg.Y[0], arg.Z[0]);
+  for (i = 1; i < max_len; i++)
+    {
+      curve->jadd(arg.scratch,
+                  arg.X[i], arg.Y[i], arg.Z[i],
+                  curve,
+                  arg.X[i - 1], arg.Y[i - 1], arg.Z[i - 1],
+                  arg.X[0], arg.Y[0], arg.Z[0]);
+    }
+  for (i = 0; i < max_len; i++)
+    {
+      mpz_urandomm(arg.scalars[i], rstate, curve->n);
+    }
+
+  /* Single operations. */
+  arg.len = 1;
+  mpz_set(arg.RX[0], arg.X[1]);
+  mpz_set(arg.RY[0], arg.Y[1]);
+  mpz_set(arg.RZ[0], arg.Z[1]);
+  bench_case(ctx, curve, backend, "jdbl", bench_jdbl, &arg);
+  bench_case(ctx, curve, backend, "jadd", bench_jadd, &arg);
+  bench_case(ctx, curve, backend, "jmul", bench_jmul, &arg);
+  bench_case(ctx, curve, backend, "jmul_aff", bench_jmul_aff, &arg);
+
+  /* Conversions. */
+  arg.len = 1000;
+  bench_case(ctx, curve, backend, "jaff", bench_jaff, &arg);
+  bench_case(ctx, curve, backend, "jaff_batch", bench_jaff_batch, &arg);
+
+  arg.array = vec_point_array_alloc(curve, arg.len);
+  bench_case(ctx, curve, backend, "import", bench_import, &arg);
+  bench_case(ctx, curve, backend, "export", bench_export, &arg);
+  vec_point_array_free(arg.array);
+
+  /* Square roots of the x-coordinates of affine points. */
+  curve->jaff_batch(arg.RX, arg.RY, arg.RZ, arg.len, curve);
+  for (i = 0; i < arg.len; i++)
+    {
+      mpz_mul(arg.RX[i], arg.RY[i], arg.RY[i]);
+      mpz_mod(arg.RX[i], arg.RX[i], curve->modulus);
+    }
+  bench_case(ctx, curve, backend, "sqrt", bench_sqrt, &arg);
+  bench_case(ctx, curve, backend, "sqrt_batch", bench_sqrt_batch, &arg);
+
+  /* Simultaneous multiplication. */
+  for (len = 10; len <= ctx->max_len; len *= 10)
+    {
+      arg.len = len;
+      bench_case(ctx, curve, backend, "jsmul", bench_jsmul, &arg);
+    }
+
+  /* Simultaneous multiplication of fixed bases with tables of at
+     most 64 MB built in advance. */
+  for (len = 10; len <= ctx->max_len && len <= 1000; len *= 10)
+    {
+      arg.len = len;
+      arg.fstable = curve->jfsmul_precomp(curve,
+                                          arg.X, arg.Y, arg.Z,
+                                          len, 1000, 1 << 26);
+      bench_case(ctx, curve, backend, "jfsmul", bench_jfsmul, &arg);
+      curve->jfsmul_free(arg.fstable);
+    }
+
+  /* Fixed basis multiplication for each width reached by tables
+     amortized over increasing numbers of multiplications. */
+  bit_length = mpz_sizeinbase(curve->n, 2);
+  prev_width = 0;
+  for (table_len = 1; table_len <= (1UL << 30); table_len <<= 1)
+    {
+      width = vec_fmul_block_width(bit_length, table_len);
+      if (width == prev_width)
+        {
+          continue;
+        }
+      prev_width = width;
+
+      arg.width = width;
+      arg.len = table_len;
+      bench_case(ctx, curve, backend, "jfmul_precomp",
+                 bench_jfmul_precomp, &arg);
+      bench_case(ctx, curve, backend, "jfmul_precomp_par",
+                 bench_jfmul_precomp_par, &arg);
+
+      arg.table = curve->jfmul_precomp(curve,
+                                       arg.X[0], arg.Y[0], arg.Z[0],
+                                       table_len);
+
+      arg.len = 1;
+      bench_case(ctx, curve, backend, "jfmul", bench_jfmul, &arg);
+
+      for (batch = 10; batch <= 1000; batch *= 10)
+        {
+          arg.len = batch;
+          bench_case(ctx, curve, backend, "jfmul_batch",
+                     bench_jfmul_batch, &arg);
+        }
+
+      curve->jfmul_free(arg.table);
+    }
+
+  gmp_randclear(rstate);
+
+  vec_scratch_clear_mpz_t(arg.scratch);
+  mpz_clear(arg.modulus);
+  vec_array_clear_free(arg.RZ, max_len);
+  vec_array_clear_free(arg.RY, max_len);
+  vec_array_clear_free(arg.RX, max_len);
+  vec_array_clear_free(arg.scalars, max_len);
+  vec_array_clear_free(arg.Z, max_len);
+  vec_array_clear_free(arg.Y, max_len);
+  vec_array_clear_free(arg.X, max_len);
+}
+
+/* Benchmarks the generic and, if available, optimized implementation
+   of the named curve. */
+void
+bench_curve_name(bench_ctx *ctx, char *name)
+{
+  vec_curve *curve = vec_curve_get_named(name, 0);
+
+  if (curve == NULL)
+    {
+      fprintf(stderr, "Unknown curve name!\n");
+      exit(1);
+    }
+  bench_curve(ctx, curve);
+  vec_curve_free(curve);
+
+  curve = vec_curve_get_named(name, 1);
+  if (curve->jtune != vec_jtune_generic
+      && curve->jtune != vec_jtune_a_eq_neg3_generic
+      && curve->jtune != vec_jtune_a_eq_0_generic)
+    {
+      bench_curve(ctx, curve);
+    }
+  vec_curve_free(curve);
+}
+
+/*
+ * Tunes the optimized implementation of the named curve and inserts
+ * the result into the tuning.
+ */
+void
+tune_curve(vec_tuning *tuning, char *name, long millisecs)
+{
+  int i;
+  vec_tuning_record *record;
+  vec_curve *curve = vec_curve_get_named(name, 1);
+
+  if (curve == NULL)
+    {
+      fprintf(stderr, "Unknown curve name!\n");
+      exit(1);
+    }
+
+  record = vec_tune(tuning, curve, millisecs);
+
+  printf("\n%s (%s)\n", curve->name, record->costs.backend);
+  printf("  dbl %.1f ns, add %.1f ns, madd %.1f ns, lookup %.1f ns\n",
+         record->costs.dbl, record->costs.add, record->costs.madd,
+         record->costs.lookup);
+  printf("  penalty %.1f ns beyond L2 (%lu bytes), "
+         "%.1f ns beyond L3 (%lu bytes)\n",
+         record->costs.l2_penalty, (unsigned long)record->costs.l2_bytes,
+         record->costs.l3_penalty, (unsigned long)record->costs.l3_bytes);
+  printf("  %10s %12s %12s %12s\n",
+         "len", "smul width", "smul batch", "fmul width");
+  for (i = 0; i < VEC_TUNING_LENS; i += 2)
+    {
+      printf("  %10lu %12lu %12lu %12d\n",
+             1UL << i,
+             (unsigned long)record->smul_block_width[i],
+             (unsigned long)record->smul_batch_len[i],
+             record->fmul_block_width[i]);
+    }
+
+  vec_curve_free(curve);
+}
+
 void
 usage(char *command_name) {
   printf("Usage: %s check|speed [name ...]\n", command_name);
+  printf("       %s tune file [name ...]\n", command_name);
+  printf("       %s bench json|csv [-m max_len] [-r reps] [name ...]\n",
+         command_name);
   exit(0);
 }
 /* LCOV_EXCL_STOP */
@@ -1596,6 +4633,7 @@ main(int args, char *argv[]) {
   char *name = NULL;
   int test = 0;
   long millisecs = DEFAULT_SPEED_TIME;
+  vec_tuning *tuning;
 
   /* Command line */
   /* LCOV_EXCL_START */
@@ -1604,7 +4642,99 @@ main(int args, char *argv[]) {
       usage(argv[0]);
     }
 
-  if (strcmp(argv[1], "check") == 0)
+  if (strcmp(argv[1], "tune") == 0)
+    {
+      if (args < 3)
+        {
+          usage(argv[0]);
+        }
+
+      /* Records of curves that are not tuned again are kept. */
+      tuning = vec_tuning_alloc();
+      vec_tuning_load(tuning, argv[2]);
+
+      if (args > 3)
+        {
+          for (i = 3; i < args; i++)
+            {
+              tune_curve(tuning, argv[i], DEFAULT_TUNE_TIME);
+            }
+        }
+      else
+        {
+          i = 0;
+          while ((name = vec_curve_get_name(i)) != NULL)
+            {
+              tune_curve(tuning, name, DEFAULT_TUNE_TIME);
+              i++;
+            }
+        }
+
+      if (vec_tuning_save(tuning, argv[2]) != 0)
+        {
+          fprintf(stderr, "Failed to write tuning file!\n");
+          exit(1);
+        }
+      vec_tuning_free(tuning);
+
+      return 0;
+    }
+  else if (strcmp(argv[1], "bench") == 0)
+    {
+      bench_ctx ctx;
+
+      if (args < 3
+          || (strcmp(argv[2], "json") != 0 && strcmp(argv[2], "csv") != 0))
+        {
+          usage(argv[0]);
+        }
+
+      ctx.format = strcmp(argv[2], "json") == 0 ? BENCH_JSON : BENCH_CSV;
+      ctx.reps = 5;
+      ctx.max_len = 1000000;
+      ctx.records = 0;
+
+      for (i = 3; i + 1 < args && argv[i][0] == '-'; i += 2)
+        {
+          if (strcmp(argv[i], "-m") == 0 && atol(argv[i + 1]) >= 10)
+            {
+              ctx.max_len = atol(argv[i + 1]);
+            }
+          else if (strcmp(argv[i], "-r") == 0 && atoi(argv[i + 1]) >= 1)
+            {
+              ctx.reps = atoi(argv[i + 1]);
+            }
+          else
+            {
+              usage(argv[0]);
+            }
+        }
+
+      if (i < args)
+        {
+          for (; i < args; i++)
+            {
+              bench_curve_name(&ctx, argv[i]);
+            }
+        }
+      else
+        {
+          i = 0;
+          while ((name = vec_curve_get_name(i)) != NULL)
+            {
+              bench_curve_name(&ctx, name);
+              i++;
+            }
+        }
+
+      if (ctx.format == BENCH_JSON)
+        {
+          printf("%s\n]\n", ctx.records == 0 ? "[" : "");
+        }
+
+      return 0;
+    }
+  else if (strcmp(argv[1], "check") == 0)
     {
       test = 1;
     }
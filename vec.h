@@ -33,6 +33,7 @@
 #ifndef VEC_H
 #define VEC_H
 
+#include <stdint.h>
 #include <gmp.h>
 
 /*
@@ -40,11 +41,15 @@
  */
 
 /**
- * Computes the modular square root of the input. The behaviour is
- * undefined for quadratic non-residues. This is used to embed
- * arbitrary strings into group elements.
+ * Computes the modular square root of the input modulo the prime
+ * p. This is used to embed arbitrary strings into group elements. The
+ * constants of the algorithm are computed for each call, so
+ * vec_sqrt_curve should be used for the modulus of a curve.
+ *
+ * @return 0 on success and -1 if the input is a quadratic
+ * non-residue, in which case the output is undefined.
  */
-void
+int
 vec_sqrt(mpz_t res, mpz_t a, mpz_t p);
 
 /**
@@ -56,6 +61,13 @@ vec_sqrt(mpz_t res, mpz_t a, mpz_t p);
 int
 vec_done(long start_time, long interval);
 
+/**
+ * Returns non-zero if the processor supports the MULX and ADX
+ * instructions and the library is built to use them.
+ */
+int
+vec_mulx_supported(void);
+
 /**
  * Allocates an array of uninitialized mpz_t instances.
  *
@@ -81,6 +93,62 @@ vec_array_alloc_init(size_t len);
 void
 vec_array_clear_free(mpz_t *a, size_t len);
 
+/**
+ * Allocates an array of read-only mpz_t instances that refer to
+ * consecutive limb arrays of the given size, e.g., in a memory
+ * mapped file. The array is freed using free() and the instances
+ * must never be modified or cleared.
+ *
+ * @param limbs Consecutive limb arrays.
+ * @param len Number of instances.
+ * @param size Number of limbs of each instance.
+ */
+mpz_t *
+vec_array_map(const void *limbs, size_t len, size_t size);
+
+/**
+ * Alignment in bytes of memory allocated by vec_table_alloc(), i.e.,
+ * the size of a cache line.
+ */
+#define VEC_TABLE_ALIGN 64
+
+/**
+ * Memory of at least this many bytes allocated by vec_table_alloc()
+ * is backed by huge pages if the platform supports it.
+ */
+#define VEC_TABLE_HUGE_BYTES (1 << 21)
+
+/**
+ * Allocates zeroed memory aligned to VEC_TABLE_ALIGN bytes for a
+ * table of points in native representation.
+ *
+ * @param bytes Number of bytes.
+ * @return Allocated memory.
+ */
+void *
+vec_table_alloc(size_t bytes);
+
+/**
+ * Frees memory allocated by vec_table_alloc().
+ *
+ * @param table Allocated memory.
+ * @param bytes Number of bytes given when allocating.
+ */
+void
+vec_table_free(void *table, size_t bytes);
+
+/**
+ * Writes the limbs of the input reduced modulo the modulus to a limb
+ * array of the given size, padded with zero limbs.
+ *
+ * @param limbs Destination limb array.
+ * @param size Number of limbs of the destination.
+ * @param op Integer to write.
+ * @param modulus Modulus.
+ */
+void
+vec_limbs_write(void *limbs, size_t size, mpz_t op, mpz_t modulus);
+
 
 /**
  * Block of temporary variables used by doubling and adding algorithms
@@ -132,6 +200,22 @@ typedef long (*coretimer_func)(int test_time, mpz_t X, mpz_t Y);
  */
 struct vec_curve;
 
+/**
+ * Precomputed constants for Montgomery arithmetic modulo the modulus
+ * of a curve.
+ */
+struct vec_mont_ctx;
+
+/**
+ * Measured costs of the operations of an implementation of a curve.
+ */
+struct vec_tuning_costs;
+
+/**
+ * Parameters of multiplication algorithms tuned to the platform.
+ */
+struct vec_tuning;
+
 /**
  * Union "pointer" to distinct structs. This is convenient when
  * passing pointers over a Java Native Interface (JNI).
@@ -141,10 +225,42 @@ typedef union
   struct _vec_jfmul_tab_generic_inner *generic;   /**< Generic table. */
   struct _vec_jfmul_tab_nistp224_inner *nistp224; /**< nistp224 table. */
   struct _vec_jfmul_tab_nistp256_inner *nistp256; /**< nistp256 table. */
+  struct _vec_jfmul_tab_nistp384_inner *nistp384; /**< nistp384 table. */
   struct _vec_jfmul_tab_nistp521_inner *nistp521; /**< nistp521 table. */
+  struct _vec_jfmul_tab_mont_inner *mont;         /**< Montgomery table. */
 
 } vec_jfmul_tab_ptr;
 
+/**
+ * Union "pointer" to distinct structs of combs for fixed basis
+ * multiplication.
+ */
+typedef union
+{
+  struct _vec_jfcomb_tab_generic_inner *generic;   /**< Generic table. */
+  struct _vec_jfcomb_tab_nistp224_inner *nistp224; /**< nistp224 table. */
+  struct _vec_jfcomb_tab_nistp256_inner *nistp256; /**< nistp256 table. */
+  struct _vec_jfcomb_tab_nistp384_inner *nistp384; /**< nistp384 table. */
+  struct _vec_jfcomb_tab_nistp521_inner *nistp521; /**< nistp521 table. */
+  struct _vec_jfcomb_tab_mont_inner *mont;         /**< Montgomery table. */
+
+} vec_jfcomb_tab_ptr;
+
+/**
+ * Union "pointer" to distinct structs of tables for simultaneous
+ * multiplication with fixed bases.
+ */
+typedef union
+{
+  struct _vec_jfsmul_tab_generic_inner *generic;   /**< Generic table. */
+  struct _vec_jfsmul_tab_nistp224_inner *nistp224; /**< nistp224 table. */
+  struct _vec_jfsmul_tab_nistp256_inner *nistp256; /**< nistp256 table. */
+  struct _vec_jfsmul_tab_nistp384_inner *nistp384; /**< nistp384 table. */
+  struct _vec_jfsmul_tab_nistp521_inner *nistp521; /**< nistp521 table. */
+  struct _vec_jfsmul_tab_mont_inner *mont;         /**< Montgomery table. */
+
+} vec_jfsmul_tab_ptr;
+
 /**
  * Doubling algorithm using Jacobi coordinates.
  */
@@ -170,6 +286,17 @@ typedef void (*jmul_func)(mpz_t RX, mpz_t RY, mpz_t RZ,
                           mpz_t X, mpz_t Y, mpz_t Z,
                           mpz_t scalar);
 
+/**
+ * Double-scalar multiplication algorithm using Jacobi coordinates,
+ * i.e., computes scalar1 * (X1, Y1, Z1) + scalar2 * (X2, Y2, Z2).
+ */
+typedef void (*jdmul_func)(mpz_t RX, mpz_t RY, mpz_t RZ,
+                           struct vec_curve *curve,
+                           mpz_t X1, mpz_t Y1, mpz_t Z1,
+                           mpz_t scalar1,
+                           mpz_t X2, mpz_t Y2, mpz_t Z2,
+                           mpz_t scalar2);
+
 /**
  * Simultaneous multiplication algorithm using Jacobi coordinates.
  */
@@ -187,6 +314,16 @@ typedef vec_jfmul_tab_ptr (*jfmul_precomp_func)(struct vec_curve *curve,
                                                 mpz_t X, mpz_t Y, mpz_t Z,
                                                 size_t len);
 
+/**
+ * Precomputation for fixed basis multiplication algorithm using
+ * Jacobi coordinates and the given number of threads.
+ */
+typedef vec_jfmul_tab_ptr
+(*jfmul_precomp_par_func)(struct vec_curve *curve,
+                          mpz_t X, mpz_t Y, mpz_t Z,
+                          size_t len,
+                          size_t threads);
+
 /**
  * Algorithm for fixed basis multiplication algorithm using Jacobi
  * coordinates.
@@ -196,12 +333,524 @@ typedef void (*jfmul_func)(mpz_t RX, mpz_t RY, mpz_t RZ,
                            vec_jfmul_tab_ptr ptr,
                            mpz_t scalar);
 
+/**
+ * Algorithm for fixed basis multiplication of many scalars using
+ * Jacobi coordinates.
+ */
+typedef void (*jfmul_batch_func)(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                                 struct vec_curve *curve,
+                                 vec_jfmul_tab_ptr ptr,
+                                 mpz_t *scalars,
+                                 size_t len);
+
+/**
+ * Double-scalar multiplication algorithm using Jacobi coordinates
+ * where the first point is fixed and given by a table for fixed basis
+ * multiplication.
+ */
+typedef void (*jfdmul_func)(mpz_t RX, mpz_t RY, mpz_t RZ,
+                            struct vec_curve *curve,
+                            vec_jfmul_tab_ptr ptr,
+                            mpz_t scalar1,
+                            mpz_t X2, mpz_t Y2, mpz_t Z2,
+                            mpz_t scalar2);
+
 /**
  * Algorithm for freeing resources allocated during precomputation for
  * fixed basis multiplication.
  */
 typedef void (*jfmul_free_func)(vec_jfmul_tab_ptr table);
 
+/**
+ * Algorithm for writing a table for fixed basis multiplication to a
+ * file. Returns 0 on success and -1 on failure.
+ */
+typedef int (*jfmul_save_func)(struct vec_curve *curve,
+                               vec_jfmul_tab_ptr ptr,
+                               const char *path);
+
+/**
+ * Algorithm for memory mapping a table for fixed basis
+ * multiplication from a file. Returns 0 on success and -1 if the
+ * file can not be mapped or was not written for the same curve and
+ * implementation on the same platform.
+ */
+typedef int (*jfmul_load_func)(vec_jfmul_tab_ptr *ptr,
+                               struct vec_curve *curve,
+                               const char *path);
+
+/**
+ * Precomputation of a comb for fixed basis multiplication using
+ * Jacobi coordinates, amortized over len multiplications and using
+ * at most max_bytes bytes for the tables.
+ */
+typedef vec_jfcomb_tab_ptr (*jfcomb_precomp_func)(struct vec_curve *curve,
+                                                  mpz_t X, mpz_t Y, mpz_t Z,
+                                                  size_t len,
+                                                  size_t max_bytes);
+
+/**
+ * Algorithm for fixed basis multiplication using a comb and Jacobi
+ * coordinates.
+ */
+typedef void (*jfcomb_func)(mpz_t RX, mpz_t RY, mpz_t RZ,
+                            struct vec_curve *curve,
+                            vec_jfcomb_tab_ptr ptr,
+                            mpz_t scalar);
+
+/**
+ * Algorithm for freeing a comb for fixed basis multiplication.
+ */
+typedef void (*jfcomb_free_func)(vec_jfcomb_tab_ptr ptr);
+
+/**
+ * Precomputation of a table for simultaneous multiplication of a
+ * fixed list of bases_len bases using Jacobi coordinates, amortized
+ * over len multiplications and using at most max_bytes bytes for the
+ * table.
+ */
+typedef vec_jfsmul_tab_ptr (*jfsmul_precomp_func)(struct vec_curve *curve,
+                                                  mpz_t *X, mpz_t *Y,
+                                                  mpz_t *Z,
+                                                  size_t bases_len,
+                                                  size_t len,
+                                                  size_t max_bytes);
+
+/**
+ * Algorithm for simultaneous multiplication of fixed bases using
+ * Jacobi coordinates. There is one scalar for each base of the table.
+ */
+typedef void (*jfsmul_func)(mpz_t RX, mpz_t RY, mpz_t RZ,
+                            struct vec_curve *curve,
+                            vec_jfsmul_tab_ptr ptr,
+                            mpz_t *scalars);
+
+/**
+ * Algorithm for freeing a table for simultaneous multiplication of
+ * fixed bases.
+ */
+typedef void (*jfsmul_free_func)(vec_jfsmul_tab_ptr ptr);
+
+/**
+ * Algorithm for writing a table for simultaneous multiplication of
+ * fixed bases to a file. Returns 0 on success and -1 on failure.
+ */
+typedef int (*jfsmul_save_func)(struct vec_curve *curve,
+                                vec_jfsmul_tab_ptr ptr,
+                                const char *path);
+
+/**
+ * Algorithm for memory mapping a table for simultaneous
+ * multiplication of fixed bases from a file. Returns 0 on success and
+ * -1 if the file can not be mapped or was not written for the same
+ * curve and implementation on the same platform.
+ */
+typedef int (*jfsmul_load_func)(vec_jfsmul_tab_ptr *ptr,
+                                struct vec_curve *curve,
+                                const char *path);
+
+/**
+ * Conversion of many points from Jacobi to affine coordinates.
+ */
+typedef void (*jaff_batch_func)(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                                size_t len,
+                                struct vec_curve *curve);
+
+/**
+ * Exponentiation of many reduced field elements with the same
+ * exponent.
+ */
+typedef void (*fpowm_func)(mpz_t *rops,
+                           mpz_t *bases,
+                           mpz_t exponent,
+                           size_t len,
+                           struct vec_curve *curve);
+
+/**
+ * Multiplication algorithm using Jacobi coordinates for the input
+ * and affine coordinates for the output.
+ */
+typedef void (*jmul_aff_func)(mpz_t rx, mpz_t ry,
+                              struct vec_curve *curve,
+                              mpz_t X, mpz_t Y, mpz_t Z,
+                              mpz_t scalar);
+
+/**
+ * Simultaneous multiplication algorithm using Jacobi coordinates for
+ * the input and affine coordinates for the output.
+ */
+typedef void (*jsmul_aff_func)(mpz_t rx, mpz_t ry,
+                               struct vec_curve *curve,
+                               mpz_t *X, mpz_t *Y, mpz_t *Z,
+                               mpz_t *scalars,
+                               size_t len);
+
+/**
+ * Algorithm for fixed basis multiplication with affine coordinates
+ * for the output.
+ */
+typedef void (*jfmul_aff_func)(mpz_t rx, mpz_t ry,
+                               struct vec_curve *curve,
+                               vec_jfmul_tab_ptr ptr,
+                               mpz_t scalar);
+
+/**
+ * Algorithm for measuring the costs of the operations used by the
+ * multiplication algorithms. Each operation is timed for at least
+ * the given number of milliseconds.
+ */
+typedef void (*jtune_func)(struct vec_tuning_costs *costs,
+                           struct vec_curve *curve,
+                           long millisecs);
+
+/**
+ * Array of points in Jacobi coordinates kept in the native
+ * representation of the implementation of the curve, i.e., the
+ * representation used for bases in simultaneous multiplication. This
+ * avoids converting to and from mpz_t in each call.
+ */
+typedef struct vec_point_array {
+  struct vec_curve *curve;  /**< Curve of the points. */
+  size_t len;               /**< Number of points. */
+  void *x;                  /**< Native x-coordinates. */
+  void *y;                  /**< Native y-coordinates. */
+  void *z;                  /**< Native z-coordinates. */
+} vec_point_array;
+
+/**
+ * Operations on arrays of points in native representation. Each
+ * implementation of a curve has its own instance.
+ */
+typedef struct vec_point_array_ops {
+
+  /** Allocates the coordinates of the array. */
+  void (*init)(vec_point_array *array);
+
+  /** Frees the coordinates of the array. */
+  void (*clear)(vec_point_array *array);
+
+  /** Converts len points to native representation starting at the
+      given offset. */
+  void (*from_mpz)(vec_point_array *array,
+                   size_t offset,
+                   mpz_t *X, mpz_t *Y, mpz_t *Z,
+                   size_t len);
+
+  /** Converts all points from native representation. */
+  void (*to_mpz)(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                 vec_point_array *array);
+
+  /** Multiplies each point by the corresponding scalar. */
+  void (*jmul)(vec_point_array *rop,
+               vec_point_array *array,
+               mpz_t *scalars);
+
+  /** Adds the points of two arrays pointwise. */
+  void (*jadd)(vec_point_array *rop,
+               vec_point_array *array1,
+               vec_point_array *array2);
+
+  /** Simultaneous multiplication of the points and scalars. */
+  void (*jsmul)(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_point_array *array,
+                mpz_t *scalars);
+
+} vec_point_array_ops;
+
+
+/*
+ * ********************* OPERATION COUNTERS *************************
+ */
+
+
+/**
+ * Counters of the operations performed by the multiplication
+ * functions of a curve. The counters are only updated if the library
+ * is configured with --enable-stats, but the struct is always part of
+ * a curve to keep its layout independent of the configuration.
+ */
+typedef struct vec_stats {
+  uint64_t dbl;             /**< Doublings. */
+  uint64_t add;             /**< Additions in Jacobi coordinates. */
+  uint64_t madd;            /**< Mixed additions with affine points. */
+  uint64_t inversions;      /**< Inversions in the field. */
+  uint64_t table_entries;   /**< Entries of pre-computed tables. */
+  uint64_t mallocs;         /**< Allocations of tables and buffers. */
+  uint64_t bytes;           /**< Bytes requested by the allocations,
+                               excluding limbs allocated by GMP. */
+  uint64_t precomp_cycles;  /**< Cycles spent building tables. */
+  uint64_t main_cycles;     /**< Cycles spent in main loops. */
+} vec_stats;
+
+/**
+ * Returns non-zero if the library counts operations, i.e., if it is
+ * configured with --enable-stats.
+ *
+ * @return Non-zero if operations are counted.
+ */
+int
+vec_stats_enabled(void);
+
+/**
+ * Copies the counters of the curve. Cycles are counted using the time
+ * stamp counter on x86 platforms and in nanoseconds elsewhere.
+ *
+ * @param stats Destination of the counters.
+ * @param curve Curve.
+ */
+void
+vec_stats_snapshot(vec_stats *stats, struct vec_curve *curve);
+
+/**
+ * Sets all counters of the curve to zero.
+ *
+ * @param curve Curve.
+ */
+void
+vec_stats_reset(struct vec_curve *curve);
+
+
+/*
+ * ************************ WORKSPACES ******************************
+ */
+
+
+/**
+ * Buffers and tables kept across calls to the simultaneous and fixed
+ * basis multiplication functions, so that calls with recurring sizes
+ * do not allocate any memory once the workspace is warm. A workspace
+ * caches a single table of simultaneous multiplication. The table is
+ * only replaced if it belongs to another implementation, uses another
+ * block width, or is too small. A workspace must not be used by two
+ * threads at the same time.
+ */
+typedef struct vec_workspace {
+  void *table;                   /**< Cached table, or NULL. */
+  void (*table_free)(void *table); /**< Frees the cached table. This
+                                      also identifies the
+                                      implementation that owns it. */
+  size_t table_len;              /**< Number of bases of the table. */
+  size_t table_block_width;      /**< Block width of the table. */
+  uint16_t *masks;               /**< Transposed scalars. */
+  size_t masks_len;              /**< Number of masks allocated. */
+  mpz_t *slices;                 /**< Slices of scalars. */
+  size_t slices_len;             /**< Number of slices allocated. */
+  mpz_t tmp;                     /**< Temporary variable. */
+} vec_workspace;
+
+/**
+ * Allocates an empty workspace.
+ *
+ * @return Workspace.
+ */
+vec_workspace *
+vec_workspace_alloc(void);
+
+/**
+ * Frees the tables and buffers of the workspace, but keeps the
+ * workspace itself usable.
+ *
+ * @param ws Workspace.
+ */
+void
+vec_workspace_clear(vec_workspace *ws);
+
+/**
+ * Frees the workspace and everything it holds.
+ *
+ * @param ws Workspace.
+ */
+void
+vec_workspace_free(vec_workspace *ws);
+
+/**
+ * Makes the multiplication functions called by the current thread
+ * use the given workspace. The workspace is owned by the caller. If
+ * it is NULL, then the thread falls back on a default workspace
+ * which is allocated on first use and freed when the thread exits.
+ *
+ * @param ws Workspace or NULL.
+ */
+void
+vec_workspace_use(vec_workspace *ws);
+
+/**
+ * Returns the workspace used by the current thread.
+ *
+ * @return Workspace of the current thread.
+ */
+vec_workspace *
+vec_workspace_get(void);
+
+/**
+ * Returns room for at least len masks held by the workspace.
+ *
+ * @param ws Workspace.
+ * @param len Number of masks.
+ * @return Masks.
+ */
+uint16_t *
+vec_workspace_masks(vec_workspace *ws, size_t len);
+
+/**
+ * Returns at least len initialized integers held by the workspace. New
+ * integers are allocated with room for the given number of bits.
+ *
+ * @param ws Workspace.
+ * @param len Number of integers.
+ * @param bits Initial size of new integers.
+ * @return Integers.
+ */
+mpz_t *
+vec_workspace_slices(vec_workspace *ws, size_t len, size_t bits);
+
+
+/*
+ * ******************** MULTI-LANE ARITHMETIC ***********************
+ */
+
+
+/**
+ * Bit length of the limbs of elements in the multi-lane arithmetic.
+ */
+#define VEC_LANES_RADIX 26
+
+/**
+ * Maximal number of limbs of an element in the multi-lane arithmetic,
+ * which suffices for moduli of up to 544 bits.
+ */
+#define VEC_LANES_MAX_LIMBS 21
+
+/**
+ * Maximal number of lanes, i.e., of independent operations computed
+ * at once.
+ */
+#define VEC_LANES_MAX_WIDTH 8
+
+struct vec_lanes_tab;
+
+/**
+ * Computes fixed basis multiplications for as many scalars as there
+ * are lanes, given the transposed slices of each scalar.
+ */
+typedef int (*vec_lanes_jfmul_func)(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                                    struct vec_lanes_tab *lt,
+                                    uint16_t *masks,
+                                    size_t bitlen);
+
+/**
+ * Copy of a table of affine points for fixed basis multiplication in
+ * the representation of the multi-lane arithmetic. Each field element
+ * is stored in Montgomery representation as limbs of VEC_LANES_RADIX
+ * bits in uint32_t, and the lanes compute independent operations
+ * using SIMD instructions, e.g., four lanes with AVX2 and eight lanes
+ * with AVX-512.
+ */
+typedef struct vec_lanes_tab {
+  size_t width;               /**< Number of lanes. */
+  size_t limbs;               /**< Number of limbs of each element. */
+  size_t tab_len;             /**< Number of entries in the table. */
+  uint32_t *entries;          /**< The x- and y-coordinate of each entry
+                                 in turn. */
+  size_t entries_bytes;       /**< Size of the entries in bytes. */
+  uint32_t p[VEC_LANES_MAX_LIMBS];   /**< Modulus. */
+  uint32_t p2[VEC_LANES_MAX_LIMBS];  /**< Twice the modulus. */
+  uint32_t one[VEC_LANES_MAX_LIMBS]; /**< One in Montgomery form. */
+  uint32_t a[VEC_LANES_MAX_LIMBS];   /**< x-coefficient in Montgomery
+                                        form. */
+  uint32_t n0;                /**< Negated inverse of the modulus modulo
+                                 two to the radix. */
+  int a_type;                 /**< Zero if a is arbitrary, one if a is
+                                 zero, and two if a is -3. */
+  mpz_t modulus;              /**< Modulus. */
+  vec_lanes_jfmul_func jfmul; /**< Multiplication function of the
+                                 instruction set used. */
+} vec_lanes_tab;
+
+/**
+ * Returns the number of lanes supported by the processor, or zero if
+ * the multi-lane arithmetic can not be used. This is decided at
+ * runtime, so a library built with support for AVX-512 falls back on
+ * AVX2, or on the scalar code of the curves, on older processors.
+ *
+ * @return Number of lanes.
+ */
+size_t
+vec_lanes_width(void);
+
+/**
+ * Writes the limbs of the input to an array of the given number of
+ * limbs of VEC_LANES_RADIX bits.
+ *
+ * @param limbs Destination limbs.
+ * @param len Number of limbs.
+ * @param op Non-negative integer that fits in the limbs.
+ */
+void
+vec_lanes_limbs(uint32_t *limbs, size_t len, mpz_t op);
+
+/**
+ * Allocates a multi-lane table with the given number of entries for
+ * the curve. NULL is returned if the processor lacks the needed
+ * instructions, or if the modulus is too large.
+ *
+ * @param curve Curve.
+ * @param tab_len Number of entries.
+ * @return Table or NULL.
+ */
+vec_lanes_tab *
+vec_lanes_tab_alloc(struct vec_curve *curve, size_t tab_len);
+
+/**
+ * Sets an entry of a multi-lane table to the given affine point.
+ *
+ * @param lt Table.
+ * @param index Index of the entry.
+ * @param x x-coordinate.
+ * @param y y-coordinate.
+ */
+void
+vec_lanes_tab_set(vec_lanes_tab *lt, size_t index, mpz_t x, mpz_t y);
+
+/**
+ * Frees a multi-lane table.
+ *
+ * @param lt Table.
+ */
+void
+vec_lanes_tab_free(vec_lanes_tab *lt);
+
+/**
+ * Computes width fixed basis multiplications at once using AVX2. The
+ * scalars are given as width consecutive arrays of bitlen masks, each
+ * indexing the table, and entry zero is the point at infinity. The
+ * results are written in Jacobi coordinates, and a point at infinity
+ * has z-coordinate zero. Zero is returned if the addition formulas
+ * are not applicable to the inputs, or if the library is built
+ * without support for the instruction set, in which case the caller
+ * must compute the results otherwise.
+ *
+ * @param X x-coordinates of the results.
+ * @param Y y-coordinates of the results.
+ * @param Z z-coordinates of the results.
+ * @param lt Table.
+ * @param masks Transposed slices of the scalars.
+ * @param bitlen Number of masks of each scalar.
+ * @return Non-zero if the results were computed.
+ */
+int
+vec_lanes_jfmul_avx2(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                     vec_lanes_tab *lt,
+                     uint16_t *masks,
+                     size_t bitlen);
+
+/*! @copydoc vec_lanes_jfmul_avx2() */
+int
+vec_lanes_jfmul_avx512(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       vec_lanes_tab *lt,
+                       uint16_t *masks,
+                       size_t bitlen);
+
 
 /*
  * ********************* CURVE MANIPULATION *************************
@@ -224,13 +873,77 @@ struct vec_curve {
   jdbl_func jdbl;                    /**< Doubling function. */
   jadd_func jadd;                    /**< Addition function. */
   jmul_func jmul;                    /**< Multiplication function. */
+  jdmul_func jdmul;                  /**< Double-scalar multiplication
+                                        function. */
   jsmul_func jsmul;                  /**< Simultaneous multiplication
                                         function. */
+  jsmul_func jsmul_bucket;           /**< Simultaneous multiplication
+                                        function using buckets. */
   jfmul_precomp_func jfmul_precomp;  /**< Fixed base pre-computation function.*/
+  jfmul_precomp_par_func jfmul_precomp_par; /**< Fixed base
+                                               pre-computation function
+                                               using threads.*/
   jfmul_func jfmul;                  /**< Fixed base multiplication function.*/
+  jfmul_batch_func jfmul_batch;      /**< Fixed base multiplication function
+                                        for many scalars.*/
+  jfdmul_func jfdmul;                /**< Double-scalar multiplication
+                                        function with fixed first
+                                        base.*/
   jfmul_free_func jfmul_free;        /**< Free fixed base table function.*/
+  jfmul_save_func jfmul_save;        /**< Write fixed base table to file
+                                        function.*/
+  jfmul_load_func jfmul_load;        /**< Map fixed base table from file
+                                        function.*/
+  jfcomb_precomp_func jfcomb_precomp; /**< Fixed base comb pre-computation
+                                         function.*/
+  jfcomb_func jfcomb;                /**< Fixed base comb multiplication
+                                        function.*/
+  jfcomb_free_func jfcomb_free;      /**< Free fixed base comb function.*/
+  jfsmul_precomp_func jfsmul_precomp; /**< Fixed bases simultaneous
+                                         pre-computation function.*/
+  jfsmul_func jfsmul;                /**< Fixed bases simultaneous
+                                        multiplication function.*/
+  jfsmul_free_func jfsmul_free;      /**< Free fixed bases table
+                                        function.*/
+  jfsmul_save_func jfsmul_save;      /**< Write fixed bases table to
+                                        file function.*/
+  jfsmul_load_func jfsmul_load;      /**< Map fixed bases table from
+                                        file function.*/
+  jaff_batch_func jaff_batch;        /**< Batch affine conversion
+                                        function.*/
+  fpowm_func fpowm;                  /**< Batch field exponentiation
+                                        function.*/
+  jmul_aff_func jmul_aff;            /**< Multiplication function with
+                                        affine output.*/
+  jsmul_aff_func jsmul_aff;          /**< Simultaneous multiplication
+                                        function with affine output.*/
+  jfmul_aff_func jfmul_aff;          /**< Fixed base multiplication
+                                        function with affine output.*/
+  jtune_func jtune;                  /**< Measures the costs of
+                                        operations.*/
   coretimer_func jdbl_timer;         /**< Timer function for doubling.*/
   coretimer_func jadd_timer;         /**< Timer function for addition.*/
+  struct vec_mont_ctx *mont;         /**< Montgomery constants, or NULL if
+                                        Montgomery arithmetic is not
+                                        used. */
+  struct vec_glv_ctx *glv;           /**< GLV constants, or NULL if the
+                                        GLV endomorphism is not used. */
+  struct vec_sqrt_ctx *sqrt_ctx;     /**< Square root constants of the
+                                        modulus, or NULL if they are
+                                        not cached. */
+  struct vec_tuning *tuning;         /**< Tuned parameters consulted by
+                                        the multiplication functions,
+                                        or NULL to use the analytic
+                                        cost models. This is not
+                                        owned by the curve. */
+  const vec_point_array_ops *array_ops; /**< Operations on arrays of
+                                           points in native
+                                           representation. */
+  const char *arithmetic;            /**< Name of the implementation of
+                                        the field arithmetic, i.e.,
+                                        "mpz", "mpn", "portable", or
+                                        "mulx". */
+  vec_stats stats;                   /**< Counters of operations. */
 };
 
 /**
@@ -294,7 +1007,14 @@ int
 vec_curve_a_eq_neg3(vec_curve *curve);
 
 /**
- * Equality predicate for points in affine coordinates.
+ * Predicate for the property that a = 0, where a is the linear curve
+ * coefficient.
+ */
+int
+vec_curve_a_eq_0(vec_curve *curve);
+
+/**
+ * Equality predicate for points in affine coordinates.
  */
 int
 vec_eq(mpz_t x1, mpz_t y1, mpz_t x2, mpz_t y2);
@@ -319,6 +1039,107 @@ vec_smul_block_width(int scalars_bitlen, int batch_len);
 int
 vec_fmul_block_width(int bit_length, int len);
 
+/**
+ * Maximal width of the tables of a comb used for fixed basis
+ * multiplication.
+ */
+#define VEC_COMB_MAX_WIDTH 16
+
+/**
+ * Computes the width and number of tables of a comb for fixed basis
+ * multiplication of scalars of the given bit length, amortized over
+ * len multiplications. The tables hold tabs * 2^(width - 1) entries of
+ * entry_bytes bytes each, and the total is at most max_bytes unless
+ * even the smallest comb does not fit.
+ */
+void
+vec_fmul_comb_width(int *width, int *tabs,
+                    int bit_length, int len,
+                    size_t entry_bytes, size_t max_bytes);
+
+/**
+ * Computes the block width of a table for simultaneous multiplication
+ * of bases_len fixed bases by scalars of the given bit length,
+ * amortized over len multiplications. The table holds
+ * ceil(bases_len / width) * 2^width entries of entry_bytes bytes
+ * each, and the total is at most max_bytes unless even width one
+ * does not fit.
+ */
+int
+vec_fsmul_block_width(int bit_length, size_t bases_len, size_t len,
+                      size_t entry_bytes, size_t max_bytes);
+
+/**
+ * Computes the optimal window width to be used during simultaneous
+ * multiplication with buckets.
+ */
+int
+vec_bucket_width(int scalars_bitlen, size_t len);
+
+/**
+ * Returns non-zero if simultaneous multiplication with buckets is
+ * expected to be faster than with block-wise tables for the given
+ * number of bases.
+ */
+int
+vec_smul_use_bucket(int scalars_bitlen, size_t len);
+
+/**
+ * Returns non-zero if converting the tables used during simultaneous
+ * multiplication with the given block width to affine coordinates is
+ * expected to be paid for by the cheaper mixed additions.
+ */
+int
+vec_smul_use_affine(int scalars_bitlen, int block_width);
+
+/**
+ * Maximal width of the windows of a wNAF. This ensures that the
+ * digits fit in a signed char.
+ */
+#define VEC_WNAF_MAX_WIDTH 8
+
+/**
+ * Computes the optimal window width for multiplication of a single
+ * point by a scalar of the given bit length, with signed digits if
+ * signed_digits is non-zero and unsigned digits otherwise.
+ */
+int
+vec_mul_window_width(int bit_length, int signed_digits);
+
+/**
+ * Computes the width-w non-adjacent form of a non-negative scalar,
+ * i.e., digits[i] is zero or odd with absolute value less than
+ * 2^(width - 1), and at most one of any width consecutive digits is
+ * non-zero. The array must have room for one digit more than the bit
+ * length of the scalar. Returns the index of the most significant
+ * non-zero digit plus one, or zero if the scalar is zero.
+ */
+size_t
+vec_wnaf(signed char *digits, mpz_t scalar, int width);
+
+/**
+ * Maximal block width supported by vec_scalars_transpose(). This
+ * ensures that a mask fits in a uint16_t.
+ */
+#define VEC_TRANSPOSE_MAX_WIDTH 16
+
+/**
+ * Transposes a batch of non-negative scalars viewed as a bit
+ * matrix. The scalars are divided into blocks of block_width
+ * consecutive scalars, where the last block may be shorter, and
+ * masks[index * tabs_len + i] is set to the integer whose jth bit is
+ * the bit at the given index of the jth scalar of the ith block,
+ * where tabs_len is the number of blocks and 0 <= index <
+ * bit_length. Thus, the array must have room for bit_length *
+ * tabs_len masks. The block width must be at most
+ * VEC_TRANSPOSE_MAX_WIDTH.
+ */
+void
+vec_scalars_transpose(uint16_t *masks,
+                      mpz_t *scalars, size_t len,
+                      size_t block_width,
+                      size_t bit_length);
+
 /**
  * Computes the doubling of the input point in affine coordinates.
  */
@@ -461,6 +1282,29 @@ vec_jmulsw_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
                    mpz_t X, mpz_t Y, mpz_t Z,
                    mpz_t scalar);
 
+/**
+ * Compute the scalar multiple of the input point in Jacobi
+ * coordinates using a width-w non-adjacent form of the scalar.
+ */
+void
+vec_jmulwnaf_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                     vec_curve *curve,
+                     mpz_t X, mpz_t Y, mpz_t Z,
+                     mpz_t scalar);
+
+/**
+ * Computes scalar1 * (X1, Y1, Z1) + scalar2 * (X2, Y2, Z2) in Jacobi
+ * coordinates using interleaved width-w non-adjacent forms of the
+ * scalars, i.e., the doublings are shared.
+ */
+void
+vec_jdmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                  vec_curve *curve,
+                  mpz_t X1, mpz_t Y1, mpz_t Z1,
+                  mpz_t scalar1,
+                  mpz_t X2, mpz_t Y2, mpz_t Z2,
+                  mpz_t scalar2);
+
 
 /**
  * Computes the simultaneous multiplication of the points and scalars.
@@ -472,6 +1316,18 @@ vec_jsmul_generic(mpz_t ropx, mpz_t ropy, mpz_t ropz,
                   mpz_t *scalars,
                   size_t len);
 
+/**
+ * Computes the simultaneous multiplication of the points and scalars
+ * using buckets (Pippenger's method). This is faster than
+ * vec_jsmul_generic() for large numbers of bases.
+ */
+void
+vec_jsmul_bucket_generic(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                         vec_curve *curve,
+                         mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+                         mpz_t *scalars,
+                         size_t len);
+
 /**
  * Computes the doubling of the input point in Jacobi coordinates.
  */
@@ -519,6 +1375,15 @@ vec_jsmul_a_eq_neg3_generic(mpz_t ropx, mpz_t ropy, mpz_t ropz,
                             mpz_t *scalars,
                             size_t len);
 
+/*! @copydoc vec_jsmul_bucket_generic() */
+void
+vec_jsmul_bucket_a_eq_neg3_generic(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                                   vec_curve *curve,
+                                   mpz_t *basesx, mpz_t *basesy,
+                                   mpz_t *basesz,
+                                   mpz_t *scalars,
+                                   size_t len);
+
 
 
 
@@ -554,6 +1419,23 @@ vec_jmulsw_a_eq_neg3_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
                      vec_curve *curve,
                      mpz_t X, mpz_t Y, mpz_t Z,
                      mpz_t scalar);
+
+/*! @copydoc vec_jmulwnaf_generic() */
+void
+vec_jmulwnaf_a_eq_neg3_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                               vec_curve *curve,
+                               mpz_t X, mpz_t Y, mpz_t Z,
+                               mpz_t scalar);
+
+/*! @copydoc vec_jdmul_generic() */
+void
+vec_jdmul_a_eq_neg3_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                            vec_curve *curve,
+                            mpz_t X1, mpz_t Y1, mpz_t Z1,
+                            mpz_t scalar1,
+                            mpz_t X2, mpz_t Y2, mpz_t Z2,
+                            mpz_t scalar2);
+
 /**
  * Computes the simultaneous multiplication of the points and scalars.
  */
@@ -573,6 +1455,20 @@ vec_jfmul_precomp_generic(vec_curve *curve,
                           mpz_t X, mpz_t Y, mpz_t Z,
                           size_t len);
 
+/**
+ * Performs precomputation for fixed basis multiplication in Jacobi
+ * coordinates using the given number of threads, or one thread per
+ * online core if it is zero. The entries of the table are split by
+ * the high bits of their indices and computed independently by the
+ * threads. The result is identical to that of
+ * vec_jfmul_precomp_generic.
+ */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_generic(vec_curve *curve,
+                              mpz_t X, mpz_t Y, mpz_t Z,
+                              size_t len,
+                              size_t threads);
+
 /**
  * Computes a fixed basis multiplication in Jacobi coordinates.
  */
@@ -581,6 +1477,28 @@ vec_jfmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
                   vec_curve *curve, vec_jfmul_tab_ptr table,
                   mpz_t scalar);
 
+/**
+ * Computes fixed basis multiplications of many scalars in Jacobi
+ * coordinates. The slicing buffers are reused for all scalars.
+ */
+void
+vec_jfmul_batch_generic(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                        vec_curve *curve, vec_jfmul_tab_ptr table,
+                        mpz_t *scalars,
+                        size_t len);
+
+/**
+ * Computes scalar1 * B + scalar2 * (X2, Y2, Z2) in Jacobi coordinates,
+ * where B is the fixed basis of the table. The comb of the table is
+ * interleaved with a width-w non-adjacent form of the second scalar.
+ */
+void
+vec_jfdmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve, vec_jfmul_tab_ptr table,
+                   mpz_t scalar1,
+                   mpz_t X2, mpz_t Y2, mpz_t Z2,
+                   mpz_t scalar2);
+
 /**
  * Frees allocated memory for fixed basis multiplication in Jacobi
  * coordinates.
@@ -588,6 +1506,170 @@ vec_jfmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
 void
 vec_jfmul_free_generic(vec_jfmul_tab_ptr ptr);
 
+/**
+ * Writes a table for fixed basis multiplication in Jacobi
+ * coordinates to a file. Returns 0 on success and -1 on failure.
+ */
+int
+vec_jfmul_save_generic(vec_curve *curve,
+                       vec_jfmul_tab_ptr table,
+                       const char *path);
+
+/**
+ * Memory maps a table for fixed basis multiplication in Jacobi
+ * coordinates from a file written by vec_jfmul_save_generic(). The
+ * mapping is read-only and shared, so processes loading the same
+ * file share its physical pages. The table is freed with
+ * vec_jfmul_free_generic() as usual. Returns 0 on success and -1 on
+ * failure.
+ */
+int
+vec_jfmul_load_generic(vec_jfmul_tab_ptr *table,
+                       vec_curve *curve,
+                       const char *path);
+
+/**
+ * Performs precomputation of a comb for fixed basis multiplication in
+ * Jacobi coordinates. The comb consists of several tables with signed
+ * digits. Its width and number of tables are chosen for len
+ * multiplications such that the tables use at most max_bytes bytes,
+ * unless even the smallest comb does not fit.
+ */
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_generic(vec_curve *curve,
+                           mpz_t X, mpz_t Y, mpz_t Z,
+                           size_t len,
+                           size_t max_bytes);
+
+/**
+ * Computes a fixed basis multiplication in Jacobi coordinates using a
+ * comb. The scalar need not be reduced modulo the order.
+ */
+void
+vec_jfcomb_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve, vec_jfcomb_tab_ptr table,
+                   mpz_t scalar);
+
+/**
+ * Frees allocated memory of a comb for fixed basis multiplication.
+ */
+void
+vec_jfcomb_free_generic(vec_jfcomb_tab_ptr ptr);
+
+/**
+ * Performs precomputation of a table for simultaneous multiplication
+ * of a fixed list of bases in Jacobi coordinates, e.g., the
+ * generators of vector Pedersen commitments. The subtables of all
+ * blocks of bases are computed once and converted to affine
+ * coordinates. The block width is chosen for len multiplications
+ * such that the table uses at most max_bytes bytes, unless even the
+ * narrowest table does not fit. The list of bases must be non-empty.
+ */
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_generic(vec_curve *curve,
+                           mpz_t *X, mpz_t *Y, mpz_t *Z,
+                           size_t bases_len,
+                           size_t len,
+                           size_t max_bytes);
+
+/**
+ * Computes the simultaneous multiplication of the fixed bases of the
+ * table and the scalars in Jacobi coordinates. There must be one
+ * scalar for each base. The scalars need not be reduced modulo the
+ * order.
+ */
+void
+vec_jfsmul_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve, vec_jfsmul_tab_ptr table,
+                   mpz_t *scalars);
+
+/**
+ * Frees allocated memory of a table for simultaneous multiplication
+ * of fixed bases.
+ */
+void
+vec_jfsmul_free_generic(vec_jfsmul_tab_ptr ptr);
+
+/**
+ * Writes a table for simultaneous multiplication of fixed bases to a
+ * file. Returns 0 on success and -1 on failure.
+ */
+int
+vec_jfsmul_save_generic(vec_curve *curve,
+                        vec_jfsmul_tab_ptr table,
+                        const char *path);
+
+/**
+ * Memory maps a table for simultaneous multiplication of fixed bases
+ * from a file written by vec_jfsmul_save_generic(). As for fixed
+ * basis multiplication, the mapping is read-only and shared, and the
+ * table is freed with vec_jfsmul_free_generic(). Returns 0 on success
+ * and -1 on failure.
+ */
+int
+vec_jfsmul_load_generic(vec_jfsmul_tab_ptr *table,
+                        vec_curve *curve,
+                        const char *path);
+
+/**
+ * Measures the costs of doubling, addition, mixed addition, and
+ * table lookups of the generic implementation.
+ */
+void
+vec_jtune_generic(struct vec_tuning_costs *costs,
+                  vec_curve *curve,
+                  long millisecs);
+
+/**
+ * Batch affine conversion using the generic implementation.
+ */
+void
+vec_jaff_batch_generic(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       size_t len,
+                       vec_curve *curve);
+
+/**
+ * Raises each reduced field element to the exponent using GMP.
+ */
+void
+vec_fpowm_generic(mpz_t *rops,
+                  mpz_t *bases,
+                  mpz_t exponent,
+                  size_t len,
+                  vec_curve *curve);
+
+/**
+ * Computes the scalar multiple of a point in Jacobi coordinates and
+ * writes the result in affine coordinates, i.e., (-1, -1) for the
+ * point at infinity. The generic implementation is also used when
+ * a = -3 or a = 0.
+ */
+void
+vec_jmul_aff_generic(mpz_t rx, mpz_t ry,
+                     vec_curve *curve,
+                     mpz_t X, mpz_t Y, mpz_t Z,
+                     mpz_t scalar);
+
+/**
+ * Computes the simultaneous multiplication of points in Jacobi
+ * coordinates and writes the result in affine coordinates.
+ */
+void
+vec_jsmul_aff_generic(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t *X, mpz_t *Y, mpz_t *Z,
+                      mpz_t *scalars,
+                      size_t len);
+
+/**
+ * Computes a fixed basis multiplication and writes the result in
+ * affine coordinates.
+ */
+void
+vec_jfmul_aff_generic(mpz_t rx, mpz_t ry,
+                      vec_curve *curve, vec_jfmul_tab_ptr table,
+                      mpz_t scalar);
+
 /**
  * Performs precomputation for fixed basis multiplication in Jacobi
  * coordinates.
@@ -597,6 +1679,13 @@ vec_jfmul_precomp_a_eq_neg3_generic(vec_curve *curve,
                                     mpz_t X, mpz_t Y, mpz_t Z,
                                     size_t len);
 
+/*! @copydoc vec_jfmul_precomp_par_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_a_eq_neg3_generic(vec_curve *curve,
+                                        mpz_t X, mpz_t Y, mpz_t Z,
+                                        size_t len,
+                                        size_t threads);
+
 /**
  * Computes a fixed basis multiplication in Jacobi coordinates.
  */
@@ -605,6 +1694,21 @@ vec_jfmul_a_eq_neg3_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
                             vec_curve *curve, vec_jfmul_tab_ptr table,
                             mpz_t scalar);
 
+/*! @copydoc vec_jfmul_batch_generic() */
+void
+vec_jfmul_batch_a_eq_neg3_generic(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                                  vec_curve *curve, vec_jfmul_tab_ptr table,
+                                  mpz_t *scalars,
+                                  size_t len);
+
+/*! @copydoc vec_jfdmul_generic() */
+void
+vec_jfdmul_a_eq_neg3_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                             vec_curve *curve, vec_jfmul_tab_ptr table,
+                             mpz_t scalar1,
+                             mpz_t X2, mpz_t Y2, mpz_t Z2,
+                             mpz_t scalar2);
+
 /**
  * Frees allocated memory for fixed basis multiplication in Jacobi
  * coordinates.
@@ -612,6 +1716,71 @@ vec_jfmul_a_eq_neg3_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
 void
 vec_jfmul_free_a_eq_neg3_generic(vec_jfmul_tab_ptr ptr);
 
+/*! @copydoc vec_jfmul_save_generic() */
+int
+vec_jfmul_save_a_eq_neg3_generic(vec_curve *curve,
+                                 vec_jfmul_tab_ptr table,
+                                 const char *path);
+
+/*! @copydoc vec_jfmul_load_generic() */
+int
+vec_jfmul_load_a_eq_neg3_generic(vec_jfmul_tab_ptr *table,
+                                 vec_curve *curve,
+                                 const char *path);
+
+/*! @copydoc vec_jfcomb_precomp_generic() */
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_a_eq_neg3_generic(vec_curve *curve,
+                                     mpz_t X, mpz_t Y, mpz_t Z,
+                                     size_t len,
+                                     size_t max_bytes);
+
+/*! @copydoc vec_jfcomb_generic() */
+void
+vec_jfcomb_a_eq_neg3_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                             vec_curve *curve, vec_jfcomb_tab_ptr table,
+                             mpz_t scalar);
+
+/*! @copydoc vec_jfcomb_free_generic() */
+void
+vec_jfcomb_free_a_eq_neg3_generic(vec_jfcomb_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_precomp_generic() */
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_a_eq_neg3_generic(vec_curve *curve,
+                                     mpz_t *X, mpz_t *Y, mpz_t *Z,
+                                     size_t bases_len,
+                                     size_t len,
+                                     size_t max_bytes);
+
+/*! @copydoc vec_jfsmul_generic() */
+void
+vec_jfsmul_a_eq_neg3_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                             vec_curve *curve, vec_jfsmul_tab_ptr table,
+                             mpz_t *scalars);
+
+/*! @copydoc vec_jfsmul_free_generic() */
+void
+vec_jfsmul_free_a_eq_neg3_generic(vec_jfsmul_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_save_generic() */
+int
+vec_jfsmul_save_a_eq_neg3_generic(vec_curve *curve,
+                                  vec_jfsmul_tab_ptr table,
+                                  const char *path);
+
+/*! @copydoc vec_jfsmul_load_generic() */
+int
+vec_jfsmul_load_a_eq_neg3_generic(vec_jfsmul_tab_ptr *table,
+                                  vec_curve *curve,
+                                  const char *path);
+
+/*! @copydoc vec_jtune_generic() */
+void
+vec_jtune_a_eq_neg3_generic(struct vec_tuning_costs *costs,
+                            vec_curve *curve,
+                            long millisecs);
+
 /**
  * Transforms the point to the standard affine form, i.e., Z=1 and X
  * and Y positive, or X and Y are both -1 to indicate the point at
@@ -620,6 +1789,15 @@ vec_jfmul_free_a_eq_neg3_generic(vec_jfmul_tab_ptr ptr);
 void
 vec_jaff(mpz_t X, mpz_t Y, mpz_t Z, vec_curve *curve);
 
+/**
+ * Transforms the points to the standard affine form like vec_jaff(),
+ * except that Z=1 for points that are not at infinity. This uses
+ * Montgomery's simultaneous inversion, i.e., a single inversion and
+ * roughly 3 * len multiplications instead of len inversions.
+ */
+void
+vec_jaff_batch(mpz_t *X, mpz_t *Y, mpz_t *Z, size_t len, vec_curve *curve);
+
 /**
  * Transforms the point to the standard Jacobi form, i.e., Z=1 or Z=0
  * (in the case of the unit point input).
@@ -659,6 +1837,19 @@ vec_jmul_aff(mpz_t rx, mpz_t ry,
              mpz_t x, mpz_t y,
              mpz_t scalar);
 
+/**
+ * Computes scalar1 * (x1, y1) + scalar2 * (x2, y2) using Jacobi
+ * coordinates internally and then converts the result to affine
+ * coordinates.
+ */
+void
+vec_jdmul_aff(mpz_t rx, mpz_t ry,
+              vec_curve *curve,
+              mpz_t x1, mpz_t y1,
+              mpz_t scalar1,
+              mpz_t x2, mpz_t y2,
+              mpz_t scalar2);
+
 /**
  * Compute the simultaneous multiplication of the input points and
  * scalars using Jacobi coordinates internally and then converts the
@@ -690,6 +1881,19 @@ vec_jfmul_aff(mpz_t rx, mpz_t ry,
               vec_jfmul_tab_ptr table,
               mpz_t scalar);
 
+/**
+ * Computes scalar1 * B + scalar2 * (x2, y2), where B is the fixed
+ * basis of the table, using Jacobi coordinates internally and then
+ * converts the result to affine coordinates.
+ */
+void
+vec_jfdmul_aff(mpz_t rx, mpz_t ry,
+               vec_curve *curve,
+               vec_jfmul_tab_ptr table,
+               mpz_t scalar1,
+               mpz_t x2, mpz_t y2,
+               mpz_t scalar2);
+
 /**
  * Frees the memory allocated for the table for fixed basis
  * multiplication.
@@ -697,71 +1901,497 @@ vec_jfmul_aff(mpz_t rx, mpz_t ry,
 void
 vec_jfmul_free_aff(vec_curve *curve, vec_jfmul_tab_ptr ptr);
 
+/**
+ * Perform precomputation of a comb for fixed basis multiplication
+ * using Jacobi coordinates internally.
+ */
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_aff(vec_curve *curve,
+                       mpz_t x, mpz_t y,
+                       size_t len,
+                       size_t max_bytes);
 
+/**
+ * Compute the fixed basis scalar multiple using a comb and Jacobi
+ * coordinates internally and then converts the result to affine
+ * coordinates.
+ */
+void
+vec_jfcomb_aff(mpz_t rx, mpz_t ry,
+               vec_curve *curve,
+               vec_jfcomb_tab_ptr table,
+               mpz_t scalar);
 
+/**
+ * Frees the memory allocated for a comb for fixed basis
+ * multiplication.
+ */
+void
+vec_jfcomb_free_aff(vec_curve *curve, vec_jfcomb_tab_ptr ptr);
 
-/*******************************************************************
- ***** OPTIMIZED ARITHMETIC FOR CURVES IN JACOBI COORDINATES *******
- *******************************************************************/
+/**
+ * Perform precomputation of a table for simultaneous multiplication
+ * of a fixed list of bases using Jacobi coordinates internally.
+ */
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_aff(vec_curve *curve,
+                       mpz_t *basesx, mpz_t *basesy,
+                       size_t bases_len,
+                       size_t len,
+                       size_t max_bytes);
 
-/*
- * Emilia Käsper's implementation of nistp256/P-256.
+/**
+ * Compute the simultaneous multiplication of the fixed bases and the
+ * scalars using Jacobi coordinates internally and then converts the
+ * result to affine coordinates.
+ */
+void
+vec_jfsmul_aff(mpz_t rx, mpz_t ry,
+               vec_curve *curve,
+               vec_jfsmul_tab_ptr table,
+               mpz_t *scalars);
+
+/**
+ * Frees the memory allocated for a table for simultaneous
+ * multiplication of fixed bases.
  */
+void
+vec_jfsmul_free_aff(vec_curve *curve, vec_jfsmul_tab_ptr ptr);
+
+
+/*******************************************************************
+ ***** ARITHMETIC FOR CURVES WITH a = 0 IN JACOBI COORDINATES ******
+ *******************************************************************/
 
 /*! @copydoc vec_jdbl_generic() */
 void
-vec_jdbl_nistp224(vec_scratch_mpz_t scratch,
-                  mpz_t X3, mpz_t Y3, mpz_t Z3,
-                  vec_curve *curve,
-                  mpz_t X1, mpz_t Y1, mpz_t Z1);
+vec_jdbl_a_eq_0_generic(vec_scratch_mpz_t scratch,
+                        mpz_t X3, mpz_t Y3, mpz_t Z3,
+                        vec_curve *curve,
+                        mpz_t X1, mpz_t Y1, mpz_t Z1);
 
 /*! @copydoc vec_jadd_generic() */
 void
-vec_jadd_nistp224(vec_scratch_mpz_t scratch,
-                  mpz_t X3, mpz_t Y3, mpz_t Z3,
-                  vec_curve *curve,
-                  mpz_t X1, mpz_t Y1, mpz_t Z1,
-                  mpz_t X2, mpz_t Y2, mpz_t Z2);
+vec_jadd_a_eq_0_generic(vec_scratch_mpz_t scratch,
+                        mpz_t X3, mpz_t Y3, mpz_t Z3,
+                        vec_curve *curve,
+                        mpz_t X1, mpz_t Y1, mpz_t Z1,
+                        mpz_t X2, mpz_t Y2, mpz_t Z2);
 
-/* Naive version of multiplication. Only used during development.
+/*! @copydoc vec_jmulsw_generic() */
 void
-vec_jmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
-                  vec_curve *curve,
-                  mpz_t X, mpz_t Y, mpz_t Z,
-                  mpz_t scalar);
-*/
+vec_jmulsw_a_eq_0_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                          vec_curve *curve,
+                          mpz_t X, mpz_t Y, mpz_t Z,
+                          mpz_t scalar);
 
-/*! @copydoc vec_jmulsw_generic() */
+/*! @copydoc vec_jmulwnaf_generic() */
 void
-vec_jmulsw_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
-                    vec_curve *curve,
-                    mpz_t X, mpz_t Y, mpz_t Z,
-                    mpz_t scalar);
+vec_jmulwnaf_a_eq_0_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                            vec_curve *curve,
+                            mpz_t X, mpz_t Y, mpz_t Z,
+                            mpz_t scalar);
+
+/*! @copydoc vec_jdmul_generic() */
+void
+vec_jdmul_a_eq_0_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                         vec_curve *curve,
+                         mpz_t X1, mpz_t Y1, mpz_t Z1,
+                         mpz_t scalar1,
+                         mpz_t X2, mpz_t Y2, mpz_t Z2,
+                         mpz_t scalar2);
 
 /*! @copydoc vec_jsmul_generic() */
 void
-vec_jsmul_nistp224(mpz_t ropx, mpz_t ropy, mpz_t ropz,
-                   vec_curve *curve,
-                   mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+vec_jsmul_a_eq_0_generic(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                         vec_curve *curve,
+                         mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+                         mpz_t *scalars,
+                         size_t len);
+
+/*! @copydoc vec_jsmul_bucket_generic() */
+void
+vec_jsmul_bucket_a_eq_0_generic(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                                vec_curve *curve,
+                                mpz_t *basesx, mpz_t *basesy,
+                                mpz_t *basesz,
+                                mpz_t *scalars,
+                                size_t len);
+
+/*! @copydoc vec_jfmul_precomp_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_a_eq_0_generic(vec_curve *curve,
+                                 mpz_t X, mpz_t Y, mpz_t Z,
+                                 size_t len);
+
+/*! @copydoc vec_jfmul_precomp_par_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_a_eq_0_generic(vec_curve *curve,
+                                     mpz_t X, mpz_t Y, mpz_t Z,
+                                     size_t len,
+                                     size_t threads);
+
+/*! @copydoc vec_jfmul_generic() */
+void
+vec_jfmul_a_eq_0_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                         vec_curve *curve, vec_jfmul_tab_ptr table,
+                         mpz_t scalar);
+
+/*! @copydoc vec_jfmul_batch_generic() */
+void
+vec_jfmul_batch_a_eq_0_generic(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                               vec_curve *curve, vec_jfmul_tab_ptr table,
+                               mpz_t *scalars,
+                               size_t len);
+
+/*! @copydoc vec_jfdmul_generic() */
+void
+vec_jfdmul_a_eq_0_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                          vec_curve *curve, vec_jfmul_tab_ptr table,
+                          mpz_t scalar1,
+                          mpz_t X2, mpz_t Y2, mpz_t Z2,
+                          mpz_t scalar2);
+
+/*! @copydoc vec_jfmul_free_generic() */
+void
+vec_jfmul_free_a_eq_0_generic(vec_jfmul_tab_ptr ptr);
+
+/*! @copydoc vec_jfmul_save_generic() */
+int
+vec_jfmul_save_a_eq_0_generic(vec_curve *curve,
+                              vec_jfmul_tab_ptr table,
+                              const char *path);
+
+/*! @copydoc vec_jfmul_load_generic() */
+int
+vec_jfmul_load_a_eq_0_generic(vec_jfmul_tab_ptr *table,
+                              vec_curve *curve,
+                              const char *path);
+
+/*! @copydoc vec_jfcomb_precomp_generic() */
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_a_eq_0_generic(vec_curve *curve,
+                                  mpz_t X, mpz_t Y, mpz_t Z,
+                                  size_t len,
+                                  size_t max_bytes);
+
+/*! @copydoc vec_jfcomb_generic() */
+void
+vec_jfcomb_a_eq_0_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                          vec_curve *curve, vec_jfcomb_tab_ptr table,
+                          mpz_t scalar);
+
+/*! @copydoc vec_jfcomb_free_generic() */
+void
+vec_jfcomb_free_a_eq_0_generic(vec_jfcomb_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_precomp_generic() */
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_a_eq_0_generic(vec_curve *curve,
+                                  mpz_t *X, mpz_t *Y, mpz_t *Z,
+                                  size_t bases_len,
+                                  size_t len,
+                                  size_t max_bytes);
+
+/*! @copydoc vec_jfsmul_generic() */
+void
+vec_jfsmul_a_eq_0_generic(mpz_t RX, mpz_t RY, mpz_t RZ,
+                          vec_curve *curve, vec_jfsmul_tab_ptr table,
+                          mpz_t *scalars);
+
+/*! @copydoc vec_jfsmul_free_generic() */
+void
+vec_jfsmul_free_a_eq_0_generic(vec_jfsmul_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_save_generic() */
+int
+vec_jfsmul_save_a_eq_0_generic(vec_curve *curve,
+                               vec_jfsmul_tab_ptr table,
+                               const char *path);
+
+/*! @copydoc vec_jfsmul_load_generic() */
+int
+vec_jfsmul_load_a_eq_0_generic(vec_jfsmul_tab_ptr *table,
+                               vec_curve *curve,
+                               const char *path);
+
+/*! @copydoc vec_jtune_generic() */
+void
+vec_jtune_a_eq_0_generic(struct vec_tuning_costs *costs,
+                         vec_curve *curve,
+                         long millisecs);
+
+
+
+
+/*******************************************************************
+ ******** PARALLEL ARITHMETIC FOR CURVES IN JACOBI COORDINATES *****
+ *******************************************************************/
+
+/**
+ * Returns the given number of threads, or the number of online cores
+ * if it is zero.
+ */
+size_t
+vec_threads(size_t threads);
+
+/**
+ * Runs the worker on each of the jobs_len jobs, each of the given
+ * size in bytes, stored consecutively at jobs. The calling thread
+ * processes the first job, and every other job is processed in a
+ * thread of its own, or in the calling thread if no thread can be
+ * created. Returns when all jobs are done.
+ */
+void
+vec_par_run(void *jobs, size_t jobs_len, size_t size,
+            void *(*worker)(void *));
+
+/**
+ * Computes the simultaneous multiplication of the input points and
+ * scalars using the given number of threads, or one thread per
+ * online core if it is zero. Each thread is given a contiguous range
+ * of batches which it processes using the simultaneous
+ * multiplication function of the curve, and the partial results are
+ * combined using a tree of additions.
+ */
+void
+vec_jsmul_par(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+              vec_curve *curve,
+              mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+              mpz_t *scalars,
+              size_t len,
+              size_t threads);
+
+/**
+ * Computes fixed basis multiplications of many scalars using the
+ * given number of threads, or one thread per online core if it is
+ * zero. Each thread is given a contiguous range of the scalars which
+ * it processes using the batched fixed basis multiplication function
+ * of the curve. The table is only read, so it is shared by all
+ * threads.
+ */
+void
+vec_jfmul_batch(mpz_t *ropsx, mpz_t *ropsy, mpz_t *ropsz,
+                vec_curve *curve,
+                vec_jfmul_tab_ptr table,
+                mpz_t *scalars,
+                size_t len,
+                size_t threads);
+
+
+
+
+/*******************************************************************
+ ***** OPTIMIZED ARITHMETIC FOR CURVES IN JACOBI COORDINATES *******
+ *******************************************************************/
+
+/*
+ * Emilia Käsper's implementation of nistp256/P-256.
+ */
+
+/*! @copydoc vec_jdbl_generic() */
+void
+vec_jdbl_nistp224(vec_scratch_mpz_t scratch,
+                  mpz_t X3, mpz_t Y3, mpz_t Z3,
+                  vec_curve *curve,
+                  mpz_t X1, mpz_t Y1, mpz_t Z1);
+
+/*! @copydoc vec_jadd_generic() */
+void
+vec_jadd_nistp224(vec_scratch_mpz_t scratch,
+                  mpz_t X3, mpz_t Y3, mpz_t Z3,
+                  vec_curve *curve,
+                  mpz_t X1, mpz_t Y1, mpz_t Z1,
+                  mpz_t X2, mpz_t Y2, mpz_t Z2);
+
+/* Naive version of multiplication. Only used during development.
+void
+vec_jmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                  vec_curve *curve,
+                  mpz_t X, mpz_t Y, mpz_t Z,
+                  mpz_t scalar);
+*/
+
+/*! @copydoc vec_jmulsw_generic() */
+void
+vec_jmulsw_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    mpz_t X, mpz_t Y, mpz_t Z,
+                    mpz_t scalar);
+
+/*! @copydoc vec_jmulwnaf_generic() */
+void
+vec_jmulwnaf_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar);
+
+/*! @copydoc vec_jdmul_generic() */
+void
+vec_jdmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   mpz_t X1, mpz_t Y1, mpz_t Z1,
+                   mpz_t scalar1,
+                   mpz_t X2, mpz_t Y2, mpz_t Z2,
+                   mpz_t scalar2);
+
+/*! @copydoc vec_jsmul_generic() */
+void
+vec_jsmul_nistp224(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                   vec_curve *curve,
+                   mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
                    mpz_t *scalars,
                    size_t len);
 
+/*! @copydoc vec_jsmul_bucket_generic() */
+void
+vec_jsmul_bucket_nistp224(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                          vec_curve *curve,
+                          mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+                          mpz_t *scalars,
+                          size_t len);
+
 /*! @copydoc vec_jfmul_precomp_generic() */
 vec_jfmul_tab_ptr
 vec_jfmul_precomp_nistp224(vec_curve *curve,
                            mpz_t X, mpz_t Y, mpz_t Z,
                            size_t len);
 
+/*! @copydoc vec_jfmul_precomp_par_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_nistp224(vec_curve *curve,
+                               mpz_t X, mpz_t Y, mpz_t Z,
+                               size_t len,
+                               size_t threads);
+
 /*! @copydoc vec_jfmul_generic() */
 void
 vec_jfmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
                    vec_curve *curve, vec_jfmul_tab_ptr ptr,
                    mpz_t scalar);
 
+/*! @copydoc vec_jfmul_batch_generic() */
+void
+vec_jfmul_batch_nistp224(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                         vec_curve *curve, vec_jfmul_tab_ptr table,
+                         mpz_t *scalars,
+                         size_t len);
+
+/*! @copydoc vec_jfdmul_generic() */
+void
+vec_jfdmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfmul_tab_ptr table,
+                    mpz_t scalar1,
+                    mpz_t X2, mpz_t Y2, mpz_t Z2,
+                    mpz_t scalar2);
+
 /*! @copydoc vec_jfmul_free_generic() */
 void
 vec_jfmul_free_nistp224(vec_jfmul_tab_ptr ptr);
 
+/*! @copydoc vec_jfmul_save_generic() */
+int
+vec_jfmul_save_nistp224(vec_curve *curve,
+                        vec_jfmul_tab_ptr table,
+                        const char *path);
+
+/*! @copydoc vec_jfmul_load_generic() */
+int
+vec_jfmul_load_nistp224(vec_jfmul_tab_ptr *table,
+                        vec_curve *curve,
+                        const char *path);
+
+/*! @copydoc vec_jfcomb_precomp_generic() */
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_nistp224(vec_curve *curve,
+                            mpz_t X, mpz_t Y, mpz_t Z,
+                            size_t len,
+                            size_t max_bytes);
+
+/*! @copydoc vec_jfcomb_generic() */
+void
+vec_jfcomb_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfcomb_tab_ptr table,
+                    mpz_t scalar);
+
+/*! @copydoc vec_jfcomb_free_generic() */
+void
+vec_jfcomb_free_nistp224(vec_jfcomb_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_precomp_generic() */
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_nistp224(vec_curve *curve,
+                            mpz_t *X, mpz_t *Y, mpz_t *Z,
+                            size_t bases_len,
+                            size_t len,
+                            size_t max_bytes);
+
+/*! @copydoc vec_jfsmul_generic() */
+void
+vec_jfsmul_nistp224(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfsmul_tab_ptr table,
+                    mpz_t *scalars);
+
+/*! @copydoc vec_jfsmul_free_generic() */
+void
+vec_jfsmul_free_nistp224(vec_jfsmul_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_save_generic() */
+int
+vec_jfsmul_save_nistp224(vec_curve *curve,
+                         vec_jfsmul_tab_ptr table,
+                         const char *path);
+
+/*! @copydoc vec_jfsmul_load_generic() */
+int
+vec_jfsmul_load_nistp224(vec_jfsmul_tab_ptr *table,
+                         vec_curve *curve,
+                         const char *path);
+
+/*! @copydoc vec_jtune_generic() */
+void
+vec_jtune_nistp224(struct vec_tuning_costs *costs,
+                   vec_curve *curve,
+                   long millisecs);
+
+/*! @copydoc vec_jaff_batch_generic() */
+void
+vec_jaff_batch_nistp224(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                        size_t len,
+                        vec_curve *curve);
+
+/**
+ * Raises each reduced field element to the exponent using the
+ * native arithmetic of the curve and windows of fixed width.
+ */
+void
+vec_fpowm_nistp224(mpz_t *rops,
+                   mpz_t *bases,
+                   mpz_t exponent,
+                   size_t len,
+                   vec_curve *curve);
+
+/*! @copydoc vec_jmul_aff_generic() */
+void
+vec_jmul_aff_nistp224(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar);
+
+/*! @copydoc vec_jsmul_aff_generic() */
+void
+vec_jsmul_aff_nistp224(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       mpz_t *scalars,
+                       size_t len);
+
+/*! @copydoc vec_jfmul_aff_generic() */
+void
+vec_jfmul_aff_nistp224(mpz_t rx, mpz_t ry,
+                       vec_curve *curve, vec_jfmul_tab_ptr table,
+                       mpz_t scalar);
+
 
 
 /*
@@ -798,6 +2428,22 @@ vec_jmulsw_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
                     mpz_t X, mpz_t Y, mpz_t Z,
                     mpz_t scalar);
 
+/*! @copydoc vec_jmulwnaf_generic() */
+void
+vec_jmulwnaf_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar);
+
+/*! @copydoc vec_jdmul_generic() */
+void
+vec_jdmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   mpz_t X1, mpz_t Y1, mpz_t Z1,
+                   mpz_t scalar1,
+                   mpz_t X2, mpz_t Y2, mpz_t Z2,
+                   mpz_t scalar2);
+
 /*! @copydoc vec_jsmul_generic() */
 void
 vec_jsmul_nistp256(mpz_t ropx, mpz_t ropy, mpz_t ropz,
@@ -806,37 +2452,168 @@ vec_jsmul_nistp256(mpz_t ropx, mpz_t ropy, mpz_t ropz,
                    mpz_t *scalars,
                    size_t len);
 
+/*! @copydoc vec_jsmul_bucket_generic() */
+void
+vec_jsmul_bucket_nistp256(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                          vec_curve *curve,
+                          mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+                          mpz_t *scalars,
+                          size_t len);
+
 /*! @copydoc vec_jfmul_precomp_generic() */
 vec_jfmul_tab_ptr
 vec_jfmul_precomp_nistp256(vec_curve *curve,
                            mpz_t X, mpz_t Y, mpz_t Z,
                            size_t len);
 
+/*! @copydoc vec_jfmul_precomp_par_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_nistp256(vec_curve *curve,
+                               mpz_t X, mpz_t Y, mpz_t Z,
+                               size_t len,
+                               size_t threads);
+
 /*! @copydoc vec_jfmul_generic() */
 void
 vec_jfmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
                    vec_curve *curve, vec_jfmul_tab_ptr ptr,
                    mpz_t scalar);
 
+/*! @copydoc vec_jfmul_batch_generic() */
+void
+vec_jfmul_batch_nistp256(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                         vec_curve *curve, vec_jfmul_tab_ptr table,
+                         mpz_t *scalars,
+                         size_t len);
+
+/*! @copydoc vec_jfdmul_generic() */
+void
+vec_jfdmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfmul_tab_ptr table,
+                    mpz_t scalar1,
+                    mpz_t X2, mpz_t Y2, mpz_t Z2,
+                    mpz_t scalar2);
+
 /*! @copydoc vec_jfmul_free_generic() */
 void
 vec_jfmul_free_nistp256(vec_jfmul_tab_ptr ptr);
 
+/*! @copydoc vec_jfmul_save_generic() */
+int
+vec_jfmul_save_nistp256(vec_curve *curve,
+                        vec_jfmul_tab_ptr table,
+                        const char *path);
+
+/*! @copydoc vec_jfmul_load_generic() */
+int
+vec_jfmul_load_nistp256(vec_jfmul_tab_ptr *table,
+                        vec_curve *curve,
+                        const char *path);
+
+/*! @copydoc vec_jfcomb_precomp_generic() */
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_nistp256(vec_curve *curve,
+                            mpz_t X, mpz_t Y, mpz_t Z,
+                            size_t len,
+                            size_t max_bytes);
+
+/*! @copydoc vec_jfcomb_generic() */
+void
+vec_jfcomb_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfcomb_tab_ptr table,
+                    mpz_t scalar);
+
+/*! @copydoc vec_jfcomb_free_generic() */
+void
+vec_jfcomb_free_nistp256(vec_jfcomb_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_precomp_generic() */
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_nistp256(vec_curve *curve,
+                            mpz_t *X, mpz_t *Y, mpz_t *Z,
+                            size_t bases_len,
+                            size_t len,
+                            size_t max_bytes);
+
+/*! @copydoc vec_jfsmul_generic() */
+void
+vec_jfsmul_nistp256(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfsmul_tab_ptr table,
+                    mpz_t *scalars);
+
+/*! @copydoc vec_jfsmul_free_generic() */
+void
+vec_jfsmul_free_nistp256(vec_jfsmul_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_save_generic() */
+int
+vec_jfsmul_save_nistp256(vec_curve *curve,
+                         vec_jfsmul_tab_ptr table,
+                         const char *path);
+
+/*! @copydoc vec_jfsmul_load_generic() */
+int
+vec_jfsmul_load_nistp256(vec_jfsmul_tab_ptr *table,
+                         vec_curve *curve,
+                         const char *path);
+
+/*! @copydoc vec_jtune_generic() */
+void
+vec_jtune_nistp256(struct vec_tuning_costs *costs,
+                   vec_curve *curve,
+                   long millisecs);
+
+/*! @copydoc vec_jaff_batch_generic() */
+void
+vec_jaff_batch_nistp256(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                        size_t len,
+                        vec_curve *curve);
+
+/*! @copydoc vec_fpowm_nistp224() */
+void
+vec_fpowm_nistp256(mpz_t *rops,
+                   mpz_t *bases,
+                   mpz_t exponent,
+                   size_t len,
+                   vec_curve *curve);
+
+/*! @copydoc vec_jmul_aff_generic() */
+void
+vec_jmul_aff_nistp256(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar);
+
+/*! @copydoc vec_jsmul_aff_generic() */
+void
+vec_jsmul_aff_nistp256(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       mpz_t *scalars,
+                       size_t len);
+
+/*! @copydoc vec_jfmul_aff_generic() */
+void
+vec_jfmul_aff_nistp256(mpz_t rx, mpz_t ry,
+                       vec_curve *curve, vec_jfmul_tab_ptr table,
+                       mpz_t scalar);
+
 
 /*
- * Adam Langley's implementation of nistp521/P-521.
+ * Implementation of nistp384/P-384 written in the style of the
+ * OpenSSL code above, using eight signed 48-bit limbs.
  */
 
 /*! @copydoc vec_jdbl_generic() */
 void
-vec_jdbl_nistp521(vec_scratch_mpz_t scratch,
+vec_jdbl_nistp384(vec_scratch_mpz_t scratch,
                   mpz_t X3, mpz_t Y3, mpz_t Z3,
                   vec_curve *curve,
                   mpz_t X1, mpz_t Y1, mpz_t Z1);
 
 /*! @copydoc vec_jadd_generic() */
 void
-vec_jadd_nistp521(vec_scratch_mpz_t scratch,
+vec_jadd_nistp384(vec_scratch_mpz_t scratch,
                   mpz_t X3, mpz_t Y3, mpz_t Z3,
                   vec_curve *curve,
                   mpz_t X1, mpz_t Y1, mpz_t Z1,
@@ -844,7 +2621,7 @@ vec_jadd_nistp521(vec_scratch_mpz_t scratch,
 
 /* Naive version of multiplication. Only used during development.
 void
-vec_jmul_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+vec_jmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
                   vec_curve *curve,
                   mpz_t X, mpz_t Y, mpz_t Z,
                   mpz_t scalar);
@@ -852,71 +2629,1113 @@ vec_jmul_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
 
 /*! @copydoc vec_jmulsw_generic() */
 void
-vec_jmulsw_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+vec_jmulsw_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
                     vec_curve *curve,
                     mpz_t X, mpz_t Y, mpz_t Z,
                     mpz_t scalar);
 
+/*! @copydoc vec_jmulwnaf_generic() */
+void
+vec_jmulwnaf_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar);
+
+/*! @copydoc vec_jdmul_generic() */
+void
+vec_jdmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   mpz_t X1, mpz_t Y1, mpz_t Z1,
+                   mpz_t scalar1,
+                   mpz_t X2, mpz_t Y2, mpz_t Z2,
+                   mpz_t scalar2);
+
 /*! @copydoc vec_jsmul_generic() */
 void
-vec_jsmul_nistp521(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+vec_jsmul_nistp384(mpz_t ropx, mpz_t ropy, mpz_t ropz,
                    vec_curve *curve,
                    mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
                    mpz_t *scalars,
                    size_t len);
 
+/*! @copydoc vec_jsmul_bucket_generic() */
+void
+vec_jsmul_bucket_nistp384(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                          vec_curve *curve,
+                          mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+                          mpz_t *scalars,
+                          size_t len);
+
 /*! @copydoc vec_jfmul_precomp_generic() */
 vec_jfmul_tab_ptr
-vec_jfmul_precomp_nistp521(vec_curve *curve,
+vec_jfmul_precomp_nistp384(vec_curve *curve,
                            mpz_t X, mpz_t Y, mpz_t Z,
                            size_t len);
 
+/*! @copydoc vec_jfmul_precomp_par_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_nistp384(vec_curve *curve,
+                               mpz_t X, mpz_t Y, mpz_t Z,
+                               size_t len,
+                               size_t threads);
+
 /*! @copydoc vec_jfmul_generic() */
 void
-vec_jfmul_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+vec_jfmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
                    vec_curve *curve, vec_jfmul_tab_ptr ptr,
                    mpz_t scalar);
 
+/*! @copydoc vec_jfmul_batch_generic() */
+void
+vec_jfmul_batch_nistp384(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                         vec_curve *curve, vec_jfmul_tab_ptr table,
+                         mpz_t *scalars,
+                         size_t len);
+
+/*! @copydoc vec_jfdmul_generic() */
+void
+vec_jfdmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfmul_tab_ptr table,
+                    mpz_t scalar1,
+                    mpz_t X2, mpz_t Y2, mpz_t Z2,
+                    mpz_t scalar2);
+
 /*! @copydoc vec_jfmul_free_generic() */
 void
-vec_jfmul_free_nistp521(vec_jfmul_tab_ptr ptr);
+vec_jfmul_free_nistp384(vec_jfmul_tab_ptr ptr);
 
+/*! @copydoc vec_jfmul_save_generic() */
+int
+vec_jfmul_save_nistp384(vec_curve *curve,
+                        vec_jfmul_tab_ptr table,
+                        const char *path);
 
+/*! @copydoc vec_jfmul_load_generic() */
+int
+vec_jfmul_load_nistp384(vec_jfmul_tab_ptr *table,
+                        vec_curve *curve,
+                        const char *path);
+
+/*! @copydoc vec_jfcomb_precomp_generic() */
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_nistp384(vec_curve *curve,
+                            mpz_t X, mpz_t Y, mpz_t Z,
+                            size_t len,
+                            size_t max_bytes);
+
+/*! @copydoc vec_jfcomb_generic() */
+void
+vec_jfcomb_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfcomb_tab_ptr table,
+                    mpz_t scalar);
 
+/*! @copydoc vec_jfcomb_free_generic() */
+void
+vec_jfcomb_free_nistp384(vec_jfcomb_tab_ptr ptr);
 
-/*
- * **** TIMING FUNCTIONS ********
- */
+/*! @copydoc vec_jfsmul_precomp_generic() */
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_nistp384(vec_curve *curve,
+                            mpz_t *X, mpz_t *Y, mpz_t *Z,
+                            size_t bases_len,
+                            size_t len,
+                            size_t max_bytes);
 
-/**
- * Time doubling in Jacobi coordinates.
- */
-long
-time_jdbl_generic(int test_time, mpz_t X, mpz_t Y);
+/*! @copydoc vec_jfsmul_generic() */
+void
+vec_jfsmul_nistp384(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfsmul_tab_ptr table,
+                    mpz_t *scalars);
 
-/**
- * Time addition in Jacobi coordinates.
- */
-long
-time_jadd_generic(int test_time, mpz_t X, mpz_t Y);
+/*! @copydoc vec_jfsmul_free_generic() */
+void
+vec_jfsmul_free_nistp384(vec_jfsmul_tab_ptr ptr);
 
+/*! @copydoc vec_jfsmul_save_generic() */
+int
+vec_jfsmul_save_nistp384(vec_curve *curve,
+                         vec_jfsmul_tab_ptr table,
+                         const char *path);
 
-/**
- * Time doubling in Jacobi coordinates for P-224.
- */
-long
-time_jdbl_nistp224(int test_time, mpz_t X, mpz_t Y);
+/*! @copydoc vec_jfsmul_load_generic() */
+int
+vec_jfsmul_load_nistp384(vec_jfsmul_tab_ptr *table,
+                         vec_curve *curve,
+                         const char *path);
 
-/**
- * Time addition in Jacobi coordinates for P-224.
- */
-long
-time_jadd_nistp224(int test_time, mpz_t X, mpz_t Y);
+/*! @copydoc vec_jtune_generic() */
+void
+vec_jtune_nistp384(struct vec_tuning_costs *costs,
+                   vec_curve *curve,
+                   long millisecs);
 
+/*! @copydoc vec_jaff_batch_generic() */
+void
+vec_jaff_batch_nistp384(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                        size_t len,
+                        vec_curve *curve);
 
-/**
- * Time doubling in Jacobi coordinates for P-256.
- */
+/*! @copydoc vec_jmul_aff_generic() */
+void
+vec_jmul_aff_nistp384(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar);
+
+/*! @copydoc vec_jsmul_aff_generic() */
+void
+vec_jsmul_aff_nistp384(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       mpz_t *scalars,
+                       size_t len);
+
+/*! @copydoc vec_jfmul_aff_generic() */
+void
+vec_jfmul_aff_nistp384(mpz_t rx, mpz_t ry,
+                       vec_curve *curve, vec_jfmul_tab_ptr table,
+                       mpz_t scalar);
+
+
+/*
+ * Adam Langley's implementation of nistp521/P-521.
+ */
+
+/*! @copydoc vec_jdbl_generic() */
+void
+vec_jdbl_nistp521(vec_scratch_mpz_t scratch,
+                  mpz_t X3, mpz_t Y3, mpz_t Z3,
+                  vec_curve *curve,
+                  mpz_t X1, mpz_t Y1, mpz_t Z1);
+
+/*! @copydoc vec_jadd_generic() */
+void
+vec_jadd_nistp521(vec_scratch_mpz_t scratch,
+                  mpz_t X3, mpz_t Y3, mpz_t Z3,
+                  vec_curve *curve,
+                  mpz_t X1, mpz_t Y1, mpz_t Z1,
+                  mpz_t X2, mpz_t Y2, mpz_t Z2);
+
+/* Naive version of multiplication. Only used during development.
+void
+vec_jmul_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+                  vec_curve *curve,
+                  mpz_t X, mpz_t Y, mpz_t Z,
+                  mpz_t scalar);
+*/
+
+/*! @copydoc vec_jmulsw_generic() */
+void
+vec_jmulsw_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve,
+                    mpz_t X, mpz_t Y, mpz_t Z,
+                    mpz_t scalar);
+
+/*! @copydoc vec_jmulwnaf_generic() */
+void
+vec_jmulwnaf_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar);
+
+/*! @copydoc vec_jdmul_generic() */
+void
+vec_jdmul_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve,
+                   mpz_t X1, mpz_t Y1, mpz_t Z1,
+                   mpz_t scalar1,
+                   mpz_t X2, mpz_t Y2, mpz_t Z2,
+                   mpz_t scalar2);
+
+/*! @copydoc vec_jsmul_generic() */
+void
+vec_jsmul_nistp521(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                   vec_curve *curve,
+                   mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+                   mpz_t *scalars,
+                   size_t len);
+
+/*! @copydoc vec_jsmul_bucket_generic() */
+void
+vec_jsmul_bucket_nistp521(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                          vec_curve *curve,
+                          mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+                          mpz_t *scalars,
+                          size_t len);
+
+/*! @copydoc vec_jfmul_precomp_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_nistp521(vec_curve *curve,
+                           mpz_t X, mpz_t Y, mpz_t Z,
+                           size_t len);
+
+/*! @copydoc vec_jfmul_precomp_par_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_nistp521(vec_curve *curve,
+                               mpz_t X, mpz_t Y, mpz_t Z,
+                               size_t len,
+                               size_t threads);
+
+/*! @copydoc vec_jfmul_generic() */
+void
+vec_jfmul_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+                   vec_curve *curve, vec_jfmul_tab_ptr ptr,
+                   mpz_t scalar);
+
+/*! @copydoc vec_jfmul_batch_generic() */
+void
+vec_jfmul_batch_nistp521(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                         vec_curve *curve, vec_jfmul_tab_ptr table,
+                         mpz_t *scalars,
+                         size_t len);
+
+/*! @copydoc vec_jfdmul_generic() */
+void
+vec_jfdmul_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfmul_tab_ptr table,
+                    mpz_t scalar1,
+                    mpz_t X2, mpz_t Y2, mpz_t Z2,
+                    mpz_t scalar2);
+
+/*! @copydoc vec_jfmul_free_generic() */
+void
+vec_jfmul_free_nistp521(vec_jfmul_tab_ptr ptr);
+
+/*! @copydoc vec_jfmul_save_generic() */
+int
+vec_jfmul_save_nistp521(vec_curve *curve,
+                        vec_jfmul_tab_ptr table,
+                        const char *path);
+
+/*! @copydoc vec_jfmul_load_generic() */
+int
+vec_jfmul_load_nistp521(vec_jfmul_tab_ptr *table,
+                        vec_curve *curve,
+                        const char *path);
+
+/*! @copydoc vec_jfcomb_precomp_generic() */
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_nistp521(vec_curve *curve,
+                            mpz_t X, mpz_t Y, mpz_t Z,
+                            size_t len,
+                            size_t max_bytes);
+
+/*! @copydoc vec_jfcomb_generic() */
+void
+vec_jfcomb_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfcomb_tab_ptr table,
+                    mpz_t scalar);
+
+/*! @copydoc vec_jfcomb_free_generic() */
+void
+vec_jfcomb_free_nistp521(vec_jfcomb_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_precomp_generic() */
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_nistp521(vec_curve *curve,
+                            mpz_t *X, mpz_t *Y, mpz_t *Z,
+                            size_t bases_len,
+                            size_t len,
+                            size_t max_bytes);
+
+/*! @copydoc vec_jfsmul_generic() */
+void
+vec_jfsmul_nistp521(mpz_t RX, mpz_t RY, mpz_t RZ,
+                    vec_curve *curve, vec_jfsmul_tab_ptr table,
+                    mpz_t *scalars);
+
+/*! @copydoc vec_jfsmul_free_generic() */
+void
+vec_jfsmul_free_nistp521(vec_jfsmul_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_save_generic() */
+int
+vec_jfsmul_save_nistp521(vec_curve *curve,
+                         vec_jfsmul_tab_ptr table,
+                         const char *path);
+
+/*! @copydoc vec_jfsmul_load_generic() */
+int
+vec_jfsmul_load_nistp521(vec_jfsmul_tab_ptr *table,
+                         vec_curve *curve,
+                         const char *path);
+
+/*! @copydoc vec_jtune_generic() */
+void
+vec_jtune_nistp521(struct vec_tuning_costs *costs,
+                   vec_curve *curve,
+                   long millisecs);
+
+/*! @copydoc vec_jaff_batch_generic() */
+void
+vec_jaff_batch_nistp521(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                        size_t len,
+                        vec_curve *curve);
+
+/*! @copydoc vec_fpowm_nistp224() */
+void
+vec_fpowm_nistp521(mpz_t *rops,
+                   mpz_t *bases,
+                   mpz_t exponent,
+                   size_t len,
+                   vec_curve *curve);
+
+/*! @copydoc vec_jmul_aff_generic() */
+void
+vec_jmul_aff_nistp521(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar);
+
+/*! @copydoc vec_jsmul_aff_generic() */
+void
+vec_jsmul_aff_nistp521(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       mpz_t *scalars,
+                       size_t len);
+
+/*! @copydoc vec_jfmul_aff_generic() */
+void
+vec_jfmul_aff_nistp521(mpz_t rx, mpz_t ry,
+                       vec_curve *curve, vec_jfmul_tab_ptr table,
+                       mpz_t scalar);
+
+
+
+
+/*******************************************************************
+ ***** MONTGOMERY ARITHMETIC FOR CURVES IN JACOBI COORDINATES ******
+ *******************************************************************/
+
+/*
+ * Fixed-width Montgomery arithmetic using the mpn layer of GMP for
+ * curves over prime fields of at most 521 bits without special code.
+ */
+
+/**
+ * Allocates and computes the Montgomery constants of the curve, or
+ * returns NULL if the modulus is not supported.
+ */
+struct vec_mont_ctx *
+vec_mont_ctx_alloc(vec_curve *curve);
+
+/**
+ * Frees the Montgomery constants of a curve.
+ */
+void
+vec_mont_ctx_free(struct vec_mont_ctx *ctx);
+
+/*! @copydoc vec_jdbl_generic() */
+void
+vec_jdbl_mont(vec_scratch_mpz_t scratch,
+              mpz_t X3, mpz_t Y3, mpz_t Z3,
+              vec_curve *curve,
+              mpz_t X1, mpz_t Y1, mpz_t Z1);
+
+/*! @copydoc vec_jadd_generic() */
+void
+vec_jadd_mont(vec_scratch_mpz_t scratch,
+              mpz_t X3, mpz_t Y3, mpz_t Z3,
+              vec_curve *curve,
+              mpz_t X1, mpz_t Y1, mpz_t Z1,
+              mpz_t X2, mpz_t Y2, mpz_t Z2);
+
+/*! @copydoc vec_jmulsw_generic() */
+void
+vec_jmulsw_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_curve *curve,
+                mpz_t X, mpz_t Y, mpz_t Z,
+                mpz_t scalar);
+
+/*! @copydoc vec_jmulwnaf_generic() */
+void
+vec_jmulwnaf_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                  vec_curve *curve,
+                  mpz_t X, mpz_t Y, mpz_t Z,
+                  mpz_t scalar);
+
+/*! @copydoc vec_jdmul_generic() */
+void
+vec_jdmul_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+               vec_curve *curve,
+               mpz_t X1, mpz_t Y1, mpz_t Z1,
+               mpz_t scalar1,
+               mpz_t X2, mpz_t Y2, mpz_t Z2,
+               mpz_t scalar2);
+
+/*! @copydoc vec_jsmul_generic() */
+void
+vec_jsmul_mont(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+               vec_curve *curve,
+               mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+               mpz_t *scalars,
+               size_t len);
+
+/*! @copydoc vec_jsmul_bucket_generic() */
+void
+vec_jsmul_bucket_mont(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                      vec_curve *curve,
+                      mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+                      mpz_t *scalars,
+                      size_t len);
+
+/*! @copydoc vec_jfmul_precomp_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_mont(vec_curve *curve,
+                       mpz_t X, mpz_t Y, mpz_t Z,
+                       size_t len);
+
+/*! @copydoc vec_jfmul_precomp_par_generic() */
+vec_jfmul_tab_ptr
+vec_jfmul_precomp_par_mont(vec_curve *curve,
+                           mpz_t X, mpz_t Y, mpz_t Z,
+                           size_t len,
+                           size_t threads);
+
+/*! @copydoc vec_jfmul_generic() */
+void
+vec_jfmul_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+               vec_curve *curve, vec_jfmul_tab_ptr table,
+               mpz_t scalar);
+
+/*! @copydoc vec_jfmul_batch_generic() */
+void
+vec_jfmul_batch_mont(mpz_t *RX, mpz_t *RY, mpz_t *RZ,
+                     vec_curve *curve, vec_jfmul_tab_ptr table,
+                     mpz_t *scalars,
+                     size_t len);
+
+/*! @copydoc vec_jfdmul_generic() */
+void
+vec_jfdmul_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_curve *curve, vec_jfmul_tab_ptr table,
+                mpz_t scalar1,
+                mpz_t X2, mpz_t Y2, mpz_t Z2,
+                mpz_t scalar2);
+
+/*! @copydoc vec_jfmul_free_generic() */
+void
+vec_jfmul_free_mont(vec_jfmul_tab_ptr ptr);
+
+/*! @copydoc vec_jfmul_save_generic() */
+int
+vec_jfmul_save_mont(vec_curve *curve,
+                    vec_jfmul_tab_ptr table,
+                    const char *path);
+
+/*! @copydoc vec_jfmul_load_generic() */
+int
+vec_jfmul_load_mont(vec_jfmul_tab_ptr *table,
+                    vec_curve *curve,
+                    const char *path);
+
+/*! @copydoc vec_jfcomb_precomp_generic() */
+vec_jfcomb_tab_ptr
+vec_jfcomb_precomp_mont(vec_curve *curve,
+                        mpz_t X, mpz_t Y, mpz_t Z,
+                        size_t len,
+                        size_t max_bytes);
+
+/*! @copydoc vec_jfcomb_generic() */
+void
+vec_jfcomb_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_curve *curve, vec_jfcomb_tab_ptr table,
+                mpz_t scalar);
+
+/*! @copydoc vec_jfcomb_free_generic() */
+void
+vec_jfcomb_free_mont(vec_jfcomb_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_precomp_generic() */
+vec_jfsmul_tab_ptr
+vec_jfsmul_precomp_mont(vec_curve *curve,
+                        mpz_t *X, mpz_t *Y, mpz_t *Z,
+                        size_t bases_len,
+                        size_t len,
+                        size_t max_bytes);
+
+/*! @copydoc vec_jfsmul_generic() */
+void
+vec_jfsmul_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_curve *curve, vec_jfsmul_tab_ptr table,
+                mpz_t *scalars);
+
+/*! @copydoc vec_jfsmul_free_generic() */
+void
+vec_jfsmul_free_mont(vec_jfsmul_tab_ptr ptr);
+
+/*! @copydoc vec_jfsmul_save_generic() */
+int
+vec_jfsmul_save_mont(vec_curve *curve,
+                     vec_jfsmul_tab_ptr table,
+                     const char *path);
+
+/*! @copydoc vec_jfsmul_load_generic() */
+int
+vec_jfsmul_load_mont(vec_jfsmul_tab_ptr *table,
+                     vec_curve *curve,
+                     const char *path);
+
+/*! @copydoc vec_jtune_generic() */
+void
+vec_jtune_mont(struct vec_tuning_costs *costs,
+               vec_curve *curve,
+               long millisecs);
+
+/*! @copydoc vec_jaff_batch_generic() */
+void
+vec_jaff_batch_mont(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                    size_t len,
+                    vec_curve *curve);
+
+/*! @copydoc vec_jmul_aff_generic() */
+void
+vec_jmul_aff_mont(mpz_t rx, mpz_t ry,
+                  vec_curve *curve,
+                  mpz_t X, mpz_t Y, mpz_t Z,
+                  mpz_t scalar);
+
+/*! @copydoc vec_jsmul_aff_generic() */
+void
+vec_jsmul_aff_mont(mpz_t rx, mpz_t ry,
+                   vec_curve *curve,
+                   mpz_t *X, mpz_t *Y, mpz_t *Z,
+                   mpz_t *scalars,
+                   size_t len);
+
+/*! @copydoc vec_jfmul_aff_generic() */
+void
+vec_jfmul_aff_mont(mpz_t rx, mpz_t ry,
+                   vec_curve *curve, vec_jfmul_tab_ptr table,
+                   mpz_t scalar);
+
+
+/*******************************************************************
+ ***** TUNING OF MULTIPLICATION ALGORITHMS *************************
+ *******************************************************************/
+
+/*
+ * The block widths and batch lengths chosen by vec_smul_block_width()
+ * and vec_fmul_block_width() follow analytic cost models in which
+ * doublings and additions cost the same and memory is free. A tuning
+ * instead holds the measured costs of the operations of an
+ * implementation of a curve on the current platform and the
+ * parameters derived from them. It can be saved to and loaded from a
+ * text file, and the simultaneous and fixed basis multiplication
+ * functions of a curve consult the tuning of the curve if it is set.
+ */
+
+/**
+ * Number of lengths for which parameters are derived, i.e., lengths
+ * 1, 2, 4, ..., 2^(VEC_TUNING_LENS - 1).
+ */
+#define VEC_TUNING_LENS 21
+
+/**
+ * Upper bound of the size in bytes of the tables used to measure the
+ * cost of lookups that miss the caches.
+ */
+#define VEC_TUNING_MAX_TABLE_BYTES (1 << 26)
+
+/**
+ * Measured costs of the operations of an implementation of a curve
+ * in nanoseconds.
+ */
+typedef struct vec_tuning_costs {
+  char curve[32];         /**< Name of the curve. */
+  char backend[32];       /**< Implementation of the curve. */
+  size_t entry_bytes;     /**< Size of a point in a table. */
+  size_t l2_bytes;        /**< Size of the L2 cache. */
+  size_t l3_bytes;        /**< Size of the L3 cache. */
+  double dbl;             /**< Doubling. */
+  double add;             /**< Addition. */
+  double madd;            /**< Mixed addition. */
+  double lookup;          /**< Lookup in a table that fits in the L1
+                             cache, in addition to the mixed addition
+                             using the entry. */
+  double l2_penalty;      /**< Additional cost of a lookup in a table
+                             that does not fit in the L2 cache. */
+  double l3_penalty;      /**< Additional cost of a lookup in a table
+                             that does not fit in the L3 cache. */
+} vec_tuning_costs;
+
+/**
+ * Costs and derived parameters of an implementation of a curve. The
+ * parameters at index i are used for lengths in [2^i, 2^(i + 1)),
+ * where the last index is also used for all longer lengths.
+ */
+typedef struct vec_tuning_record {
+  vec_tuning_costs costs;                    /**< Measured costs. */
+  int bit_length;                            /**< Bit length of scalars
+                                                of the parameters. */
+  size_t smul_block_width[VEC_TUNING_LENS];  /**< Block width of
+                                                simultaneous
+                                                multiplication. */
+  size_t smul_batch_len[VEC_TUNING_LENS];    /**< Batch length of
+                                                simultaneous
+                                                multiplication. */
+  int fmul_block_width[VEC_TUNING_LENS];     /**< Block width of fixed
+                                                basis multiplication. */
+} vec_tuning_record;
+
+/**
+ * Tuning of any number of implementations of curves.
+ */
+typedef struct vec_tuning {
+  vec_tuning_record *records;  /**< Records of implementations. */
+  size_t len;                  /**< Number of records. */
+} vec_tuning;
+
+/**
+ * Allocates an empty tuning.
+ */
+vec_tuning *
+vec_tuning_alloc(void);
+
+/**
+ * Frees a tuning.
+ */
+void
+vec_tuning_free(vec_tuning *tuning);
+
+/**
+ * Returns the record of the given curve and implementation, or NULL
+ * if there is none.
+ */
+vec_tuning_record *
+vec_tuning_find(vec_tuning *tuning, const char *curve, const char *backend);
+
+/**
+ * Adds a copy of the record to the tuning, replacing any record of
+ * the same curve and implementation, and returns the copy.
+ */
+vec_tuning_record *
+vec_tuning_insert(vec_tuning *tuning, vec_tuning_record *record);
+
+/**
+ * Computes the block width and batch length of simultaneous
+ * multiplication of len bases by scalars of the given bit length
+ * that minimize the amortized cost per base given the costs.
+ */
+void
+vec_tuning_smul_params(size_t *block_width, size_t *batch_len,
+                       vec_tuning_costs *costs,
+                       int bit_length, size_t len);
+
+/**
+ * Computes the block width of fixed basis multiplication of scalars
+ * of the given bit length that minimizes the cost of len
+ * multiplications given the costs.
+ */
+int
+vec_tuning_fmul_width(vec_tuning_costs *costs, int bit_length, size_t len);
+
+/**
+ * Returns the cost of a lookup in a table of the given size in bytes
+ * given the costs, in addition to the mixed addition using the
+ * entry.
+ */
+double
+vec_tuning_lookup(vec_tuning_costs *costs, double bytes);
+
+/**
+ * Derives the parameters of the record from its costs and bit
+ * length.
+ */
+void
+vec_tuning_derive(vec_tuning_record *record);
+
+/**
+ * Measures the costs of the operations of the implementation of the
+ * curve, derives parameters for scalars of the bit length of the
+ * order, and inserts the result into the tuning. Each operation is
+ * timed for at least the given number of milliseconds. Returns the
+ * inserted record.
+ */
+vec_tuning_record *
+vec_tune(vec_tuning *tuning, vec_curve *curve, long millisecs);
+
+/**
+ * Looks up the block width and batch length of simultaneous
+ * multiplication for the given curve and implementation. The
+ * parameters are computed from the measured costs if the bit length
+ * differs from that of the record. Returns zero and leaves the
+ * outputs unchanged if the tuning is NULL or has no record of the
+ * implementation, and non-zero otherwise.
+ */
+int
+vec_tuning_smul(size_t *block_width, size_t *batch_len,
+                vec_tuning *tuning,
+                const char *curve, const char *backend,
+                int bit_length, size_t len);
+
+/**
+ * Looks up the block width of fixed basis multiplication for the
+ * given curve and implementation in the same way as
+ * vec_tuning_smul(). Returns zero if the tuning is NULL or has no
+ * record of the implementation.
+ */
+int
+vec_tuning_fmul(vec_tuning *tuning,
+                const char *curve, const char *backend,
+                int bit_length, size_t len);
+
+/**
+ * Writes the tuning to a text file. Returns 0 on success and -1 on
+ * failure.
+ */
+int
+vec_tuning_save(vec_tuning *tuning, const char *path);
+
+/**
+ * Reads a text file written by vec_tuning_save() and inserts its
+ * records into the tuning. Returns 0 on success and -1 if the file
+ * can not be read or is malformed, in which case the records read
+ * before the error are kept.
+ */
+int
+vec_tuning_load(vec_tuning *tuning, const char *path);
+
+
+/*******************************************************************
+ ***** SQUARE ROOTS IN THE FIELDS OF CURVES ************************
+ *******************************************************************/
+
+/*
+ * Square roots are used to embed arbitrary strings into group
+ * elements, so many are computed modulo the same prime. The constants
+ * of the algorithm only depend on the prime and are computed once for
+ * each curve, and all exponentiations use the same exponent.
+ */
+
+/**
+ * Constants for computing square roots modulo a prime p, where p - 1
+ * = 2^s * q with q odd.
+ */
+typedef struct vec_sqrt_ctx {
+  mpz_t modulus; /**< Prime modulus. */
+  int s;         /**< Exponent of two in p - 1. */
+  mpz_t e;       /**< Exponent (p + 1)/4 if s = 1, i.e., if p = 3 mod
+                    4, and (q - 1)/2 otherwise. */
+  mpz_t z;       /**< Quadratic non-residue, or zero if s = 1. */
+  mpz_t c;       /**< z^q, or zero if s = 1. */
+} vec_sqrt_ctx;
+
+/**
+ * Allocates and computes the square root constants of the prime
+ * modulus. This searches for the least quadratic non-residue if the
+ * modulus is one modulo four.
+ */
+vec_sqrt_ctx *
+vec_sqrt_ctx_alloc(mpz_t modulus);
+
+/**
+ * Frees the square root constants.
+ */
+void
+vec_sqrt_ctx_free(vec_sqrt_ctx *ctx);
+
+/**
+ * Completes the square root of a modulo the modulus of the
+ * constants, where a is reduced and r = a^e on input.
+ *
+ * @return 0 on success and -1 if a is a quadratic non-residue, in
+ * which case r is undefined.
+ */
+int
+vec_sqrt_ctx_finish(mpz_t r, mpz_t a, vec_sqrt_ctx *ctx);
+
+/**
+ * Computes modular square roots of the inputs modulo the modulus of
+ * the curve using the cached constants of the curve and its
+ * exponentiation function. The outputs may be the inputs.
+ *
+ * @return 0 on success and -1 if any input is a quadratic
+ * non-residue, in which case its output is undefined. The outputs of
+ * the other inputs are still their square roots.
+ */
+int
+vec_sqrt_batch(mpz_t *rops, mpz_t *ops, size_t len, vec_curve *curve);
+
+/**
+ * Computes the modular square root of the input modulo the modulus
+ * of the curve in the same way as vec_sqrt_batch.
+ *
+ * @return 0 on success and -1 if the input is a quadratic
+ * non-residue, in which case the output is undefined.
+ */
+int
+vec_sqrt_curve(mpz_t res, mpz_t a, vec_curve *curve);
+
+
+/*******************************************************************
+ ***** GLV ENDOMORPHISM FOR CURVES IN JACOBI COORDINATES ***********
+ *******************************************************************/
+
+/*
+ * Curves such as secp256k1 with a = 0 over a prime field where p = 1
+ * mod 3 have the efficiently computable endomorphism (x, y) -> (beta
+ * * x, y), where beta is a cube root of unity modulo p. It acts as
+ * multiplication by a cube root of unity lambda modulo n, so a scalar
+ * k can be written as k1 + k2 * lambda with k1 and k2 of half the
+ * size (Gallant, Lambert, and Vanstone). This halves the number of
+ * doublings.
+ */
+
+/**
+ * Constants of the GLV endomorphism of a curve.
+ */
+typedef struct vec_glv_ctx {
+  mpz_t beta;    /**< Cube root of unity modulo the modulus. */
+  mpz_t lambda;  /**< Cube root of unity modulo the order, where
+                    lambda * (x, y) = (beta * x, y). */
+  mpz_t a1;      /**< First coordinate of first basis vector. */
+  mpz_t b1;      /**< Second coordinate of first basis vector. */
+  mpz_t a2;      /**< First coordinate of second basis vector. */
+  mpz_t b2;      /**< Second coordinate of second basis vector. */
+} vec_glv_ctx;
+
+/**
+ * Allocates and computes the GLV constants of the curve, or returns
+ * NULL if the curve has no such endomorphism. This multiplies the
+ * generator using the multiplication function of the curve.
+ */
+vec_glv_ctx *
+vec_glv_ctx_alloc(vec_curve *curve);
+
+/**
+ * Frees the GLV constants of a curve.
+ */
+void
+vec_glv_ctx_free(vec_glv_ctx *ctx);
+
+/**
+ * Splits the scalar into k1 and k2 of roughly half the bit length of
+ * the order such that scalar = k1 + k2 * lambda modulo the order. The
+ * outputs may be negative.
+ */
+void
+vec_glv_split(mpz_t k1, mpz_t k2, vec_curve *curve, mpz_t scalar);
+
+/**
+ * Computes the scalar multiple of the input point in Jacobi
+ * coordinates using the GLV endomorphism and Montgomery arithmetic,
+ * i.e., as a double multiplication with interleaved sliding windows
+ * and scalars of half size.
+ */
+void
+vec_jmul_glv_mont(mpz_t RX, mpz_t RY, mpz_t RZ,
+                  vec_curve *curve,
+                  mpz_t X, mpz_t Y, mpz_t Z,
+                  mpz_t scalar);
+
+/**
+ * Computes the simultaneous multiplication of the points and scalars
+ * using the GLV endomorphism and Montgomery arithmetic, i.e., as a
+ * simultaneous multiplication of twice as many points with scalars
+ * of half size.
+ */
+void
+vec_jsmul_glv_mont(mpz_t ropx, mpz_t ropy, mpz_t ropz,
+                   vec_curve *curve,
+                   mpz_t *basesx, mpz_t *basesy, mpz_t *basesz,
+                   mpz_t *scalars,
+                   size_t len);
+
+/**
+ * Same as vec_jmul_glv_mont(), except that the result is written in
+ * affine coordinates.
+ */
+void
+vec_jmul_aff_glv_mont(mpz_t rx, mpz_t ry,
+                      vec_curve *curve,
+                      mpz_t X, mpz_t Y, mpz_t Z,
+                      mpz_t scalar);
+
+/**
+ * Same as vec_jsmul_glv_mont(), except that the result is written in
+ * affine coordinates.
+ */
+void
+vec_jsmul_aff_glv_mont(mpz_t rx, mpz_t ry,
+                       vec_curve *curve,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       mpz_t *scalars,
+                       size_t len);
+
+
+/*******************************************************************
+ ***** ARRAYS OF POINTS IN NATIVE REPRESENTATION *******************
+ *******************************************************************/
+
+/*
+ * The functions above convert their inputs and outputs between mpz_t
+ * and the native representation of the implementation in each
+ * call. Callers that keep operating on the same points can instead
+ * hold them in a vec_point_array and convert only once.
+ */
+
+/**
+ * Allocates an array of len points in the native representation of
+ * the implementation of the curve. The points are undefined until
+ * they are imported.
+ */
+vec_point_array *
+vec_point_array_alloc(vec_curve *curve, size_t len);
+
+/**
+ * Frees an array of points.
+ */
+void
+vec_point_array_free(vec_point_array *array);
+
+/**
+ * Imports len points in Jacobi coordinates into the array starting at
+ * the given offset. The coordinates must be reduced modulo the
+ * modulus.
+ */
+void
+vec_point_array_import(vec_point_array *array,
+                       size_t offset,
+                       mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       size_t len);
+
+/**
+ * Imports len points in affine coordinates into the array starting at
+ * the given offset. Each point is encoded as x || y, where each
+ * coordinate is written big-endian using as many bytes as the
+ * modulus. A point encoded as all zeros is the point at infinity.
+ * Returns 0 on success and -1 if the points do not fit in the array
+ * from the offset, if a coordinate is not reduced modulo the modulus,
+ * or if a point is not on the curve, in which case nothing is
+ * imported.
+ */
+int
+vec_point_array_import_bytes(vec_point_array *array,
+                             size_t offset,
+                             const unsigned char *bytes,
+                             size_t len);
+
+/**
+ * Exports all points of the array in Jacobi coordinates. The output
+ * arrays must have the length of the array.
+ */
+void
+vec_point_array_export(mpz_t *X, mpz_t *Y, mpz_t *Z,
+                       vec_point_array *array);
+
+/**
+ * Multiplies each point of the array by the corresponding scalar and
+ * stores the results in rop, which must have the same length. The
+ * arrays may be identical.
+ */
+void
+vec_jmul_array(vec_point_array *rop,
+               vec_point_array *array,
+               mpz_t *scalars);
+
+/**
+ * Adds the points of two arrays pointwise and stores the results in
+ * rop. All arrays must have the same length and may be identical.
+ */
+void
+vec_jadd_array(vec_point_array *rop,
+               vec_point_array *array1,
+               vec_point_array *array2);
+
+/**
+ * Computes the simultaneous multiplication of the points of the array
+ * and the scalars.
+ */
+void
+vec_jsmul_array(mpz_t RX, mpz_t RY, mpz_t RZ,
+                vec_point_array *array,
+                mpz_t *scalars);
+
+/**
+ * Operations on arrays of points for the generic implementation.
+ */
+extern const vec_point_array_ops vec_point_array_ops_generic_inner;
+
+/*! @copydoc vec_point_array_ops_generic_inner */
+extern const vec_point_array_ops vec_point_array_ops_a_eq_neg3_generic_inner;
+
+/*! @copydoc vec_point_array_ops_generic_inner */
+extern const vec_point_array_ops vec_point_array_ops_a_eq_0_generic_inner;
+
+/*! @copydoc vec_point_array_ops_generic_inner */
+extern const vec_point_array_ops vec_point_array_ops_nistp224_inner;
+
+/*! @copydoc vec_point_array_ops_generic_inner */
+extern const vec_point_array_ops vec_point_array_ops_nistp256_inner;
+
+/*! @copydoc vec_point_array_ops_generic_inner */
+extern const vec_point_array_ops vec_point_array_ops_nistp384_inner;
+
+/*! @copydoc vec_point_array_ops_generic_inner */
+extern const vec_point_array_ops vec_point_array_ops_nistp521_inner;
+
+/*! @copydoc vec_point_array_ops_generic_inner */
+extern const vec_point_array_ops vec_point_array_ops_mont_inner;
+
+
+/**
+ * Returns the name of the implementation of the field arithmetic of
+ * the curve selected for the processor when the library is loaded,
+ * i.e., "mulx" if the field multiplication and squaring use the MULX
+ * and ADX instructions, which is only implemented for P-256, and
+ * "portable" otherwise.
+ */
+const char *
+vec_arithmetic_nistp224(void);
+
+/*! @copydoc vec_arithmetic_nistp224() */
+const char *
+vec_arithmetic_nistp256(void);
+
+/*! @copydoc vec_arithmetic_nistp224() */
+const char *
+vec_arithmetic_nistp384(void);
+
+/*! @copydoc vec_arithmetic_nistp224() */
+const char *
+vec_arithmetic_nistp521(void);
+
+
+/*
+ * **** TIMING FUNCTIONS ********
+ */
+
+/**
+ * Time doubling in Jacobi coordinates.
+ */
+long
+time_jdbl_generic(int test_time, mpz_t X, mpz_t Y);
+
+/**
+ * Time addition in Jacobi coordinates.
+ */
+long
+time_jadd_generic(int test_time, mpz_t X, mpz_t Y);
+
+
+/**
+ * Time doubling in Jacobi coordinates for P-224.
+ */
+long
+time_jdbl_nistp224(int test_time, mpz_t X, mpz_t Y);
+
+/**
+ * Time addition in Jacobi coordinates for P-224.
+ */
+long
+time_jadd_nistp224(int test_time, mpz_t X, mpz_t Y);
+
+
+/**
+ * Time doubling in Jacobi coordinates for P-256.
+ */
 long
 time_jdbl_nistp256(int test_time, mpz_t X, mpz_t Y);
 
@@ -927,6 +3746,19 @@ long
 time_jadd_nistp256(int test_time, mpz_t X, mpz_t Y);
 
 
+/**
+ * Time doubling in Jacobi coordinates for P-384.
+ */
+long
+time_jdbl_nistp384(int test_time, mpz_t X, mpz_t Y);
+
+/**
+ * Time addition in Jacobi coordinates for P-384.
+ */
+long
+time_jadd_nistp384(int test_time, mpz_t X, mpz_t Y);
+
+
 /**
  * Time doubling in Jacobi coordinates for P-521.
  */
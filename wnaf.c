@@ -0,0 +1,85 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <string.h>
+#include <gmp.h>
+#include "vec.h"
+
+/* Returns the count bits of the scalar starting at the given index,
+   where count is smaller than the number of bits in a limb. */
+static int
+getbits(mpz_t scalar, size_t index, int count)
+{
+  size_t limb = index / GMP_NUMB_BITS;
+  size_t offset = index % GMP_NUMB_BITS;
+  mp_limb_t bits;
+
+  /* Limbs beyond the size of the scalar are read as zero. */
+  bits = mpz_getlimbn(scalar, limb) >> offset;
+  if (offset + count > GMP_NUMB_BITS)
+    {
+      bits |= mpz_getlimbn(scalar, limb + 1) << (GMP_NUMB_BITS - offset);
+    }
+  return (int)(bits & ((((mp_limb_t)1) << count) - 1));
+}
+
+size_t
+vec_wnaf(signed char *digits, mpz_t scalar, int width)
+{
+  size_t len = mpz_sizeinbase(scalar, 2) + 1;
+  size_t bit = 0;
+  size_t last = 0;
+  int carry = 0;
+  int word;
+
+  memset(digits, 0, len);
+
+  if (mpz_sgn(scalar) == 0)
+    {
+      return 0;
+    }
+
+  /* A carry represents a negative digit, which has been compensated
+     by adding one at the position following the window. */
+  while (bit < len)
+    {
+      if (getbits(scalar, bit, 1) == carry)
+        {
+          bit++;
+          continue;
+        }
+
+      word = getbits(scalar, bit, width) + carry;
+      carry = (word >> (width - 1)) & 1;
+      word -= carry << width;
+
+      digits[bit] = (signed char)word;
+      last = bit + 1;
+
+      bit += width;
+    }
+
+  return last;
+}
@@ -0,0 +1,76 @@
+
+/* Copyright 2008-2019 Douglas Wikstrom
+ *
+ * This file is part of Verificatum Elliptic Curve library (VEC).
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <gmp.h>
+#include "vec.h"
+
+/* Workspace set explicitly by each thread, and default workspace of
+   each thread which is freed when the thread exits. */
+static pthread_key_t vec_workspace_current_key;
+static pthread_key_t vec_workspace_default_key;
+static pthread_once_t vec_workspace_once = PTHREAD_ONCE_INIT;
+
+static void
+vec_workspace_destroy(void *ws)
+{
+  vec_workspace_free((vec_workspace *)ws);
+}
+
+static void
+vec_workspace_keys(void)
+{
+  pthread_key_create(&vec_workspace_current_key, NULL);
+  pthread_key_create(&vec_workspace_default_key, vec_workspace_destroy);
+}
+
+void
+vec_workspace_use(vec_workspace *ws)
+{
+  pthread_once(&vec_workspace_once, vec_workspace_keys);
+  pthread_setspecific(vec_workspace_current_key, ws);
+}
+
+vec_workspace *
+vec_workspace_get(void)
+{
+  vec_workspace *ws;
+
+  pthread_once(&vec_workspace_once, vec_workspace_keys);
+
+  ws = (vec_workspace *)pthread_getspecific(vec_workspace_current_key);
+  if (ws == NULL)
+    {
+      ws = (vec_workspace *)pthread_getspecific(vec_workspace_default_key);
+      if (ws == NULL)
+        {
+          ws = vec_workspace_alloc();
+          pthread_setspecific(vec_workspace_default_key, ws);
+        }
+    }
+  return ws;
+}